@@ -40,10 +40,21 @@
 
 #include <Wire.h>
 #include <Adafruit_PWMServoDriver.h>
+#include <pca9685_batch.h>
+#include <servo_lut.h>
+#include <servo_output.h>
 #include "animation_config.h"
 
 // Servo driver
 Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(I2C_ADDRESS);
+PCA9685Batch servoBatch(I2C_ADDRESS);
+ServoOutput<4> servos(servoBatch);  // LS, LE, RS, RE; only changed pulses are sent
+
+// Degrees (0-90) to pulse, one PROGMEM table per calibrated servo
+typedef ServoPulseTable<LEFT_SHOULDER_MIN_PULSE, LEFT_SHOULDER_MAX_PULSE> LeftShoulderTable;
+typedef ServoPulseTable<LEFT_ELBOW_MIN_PULSE, LEFT_ELBOW_MAX_PULSE> LeftElbowTable;
+typedef ServoPulseTable<RIGHT_SHOULDER_MIN_PULSE, RIGHT_SHOULDER_MAX_PULSE> RightShoulderTable;
+typedef ServoPulseTable<RIGHT_ELBOW_MIN_PULSE, RIGHT_ELBOW_MAX_PULSE> RightElbowTable;
 
 // Animation state
 int currentAnimation = DEFAULT_ANIMATION;
@@ -51,12 +62,6 @@ unsigned long animationStartTime = 0;
 bool animationActive = false;
 bool lastTriggerState = HIGH;
 
-// Servo position cache
-int lastLeftShoulder = -1;
-int lastLeftElbow = -1;
-int lastRightShoulder = -1;
-int lastRightElbow = -1;
-
 void setup() {
   Serial.begin(115200);
   while (!Serial && millis() < 3000);  // Wait up to 3s for serial
@@ -70,6 +75,10 @@ void setup() {
   // Initialize PWM driver
   pwm.begin();
   pwm.setPWMFreq(SERVO_FREQ);
+  servos.attach(0, LEFT_SHOULDER_CHANNEL, SERVO_CALIBRATION(LeftShoulderTable));
+  servos.attach(1, LEFT_ELBOW_CHANNEL, SERVO_CALIBRATION(LeftElbowTable));
+  servos.attach(2, RIGHT_SHOULDER_CHANNEL, SERVO_CALIBRATION(RightShoulderTable));
+  servos.attach(3, RIGHT_ELBOW_CHANNEL, SERVO_CALIBRATION(RightElbowTable));
   delay(10);
 
   Serial.print(F("Available animations: "));
@@ -192,34 +201,13 @@ void updateAnimation() {
 }
 
 void moveLegs(int leftShoulder, int leftElbow, int rightShoulder, int rightElbow) {
-  // Only move servos if position changed (reduce jitter)
-  if (leftShoulder != lastLeftShoulder) {
-    setServo(LEFT_SHOULDER_CHANNEL, leftShoulder, LEFT_SHOULDER_MIN_PULSE, LEFT_SHOULDER_MAX_PULSE);
-    lastLeftShoulder = leftShoulder;
-  }
-
-  if (leftElbow != lastLeftElbow) {
-    setServo(LEFT_ELBOW_CHANNEL, leftElbow, LEFT_ELBOW_MIN_PULSE, LEFT_ELBOW_MAX_PULSE);
-    lastLeftElbow = leftElbow;
-  }
-
-  if (rightShoulder != lastRightShoulder) {
-    setServo(RIGHT_SHOULDER_CHANNEL, rightShoulder, RIGHT_SHOULDER_MIN_PULSE, RIGHT_SHOULDER_MAX_PULSE);
-    lastRightShoulder = rightShoulder;
-  }
-
-  if (rightElbow != lastRightElbow) {
-    setServo(RIGHT_ELBOW_CHANNEL, rightElbow, RIGHT_ELBOW_MIN_PULSE, RIGHT_ELBOW_MAX_PULSE);
-    lastRightElbow = rightElbow;
-  }
-}
-
-void setServo(int channel, int degrees, int minPulse, int maxPulse) {
-  // Convert degrees (0-90°) to pulse width
-  // Calibrated ranges support 0-90° movement
-  degrees = constrain(degrees, 0, 90);
-  int pulse = map(degrees, 0, 90, minPulse, maxPulse);
-  pwm.setPWM(channel, 0, pulse);
+  // Degrees (0-90°, clamped) through each servo's calibrated table; only
+  // servos whose pulse changed are sent (reduces jitter)
+  servos.write(0, leftShoulder);
+  servos.write(1, leftElbow);
+  servos.write(2, rightShoulder);
+  servos.write(3, rightElbow);
+  servos.flush();
 }
 
 void moveToResting() {
@@ -6,10 +6,10 @@
 #define ANIMATION_CONFIG_H
 
 // Hardware Configuration
-#define I2C_ADDRESS 0x40
+#define I2C_ADDRESS 0x40  // First board
 #define SERVO_FREQ 50
 
-// Left Leg Servos
+// Left Leg Servos (the first egg; every prop's default)
 #define LEFT_SHOULDER_CHANNEL 14
 #define LEFT_ELBOW_CHANNEL 15
 #define LEFT_SHOULDER_MIN_PULSE 440
@@ -27,6 +27,77 @@
 
 #define TRIGGER_PIN 9
 
+// Boards and Joints (hardware.boards / hardware.props)
+// Each prop's four joints play the animation's tracks (ls, le, rs, re);
+// a joint is a PCA9685 board and channel with its own pulse table
+#define BOARD_COUNT 1
+#define BOARD_LIST(X) X(0x40)
+#define PROP_COUNT 1
+#define JOINT_COUNT 4
+#define JOINT_MAX_DEGREES 90
+
+const uint16_t JOINT_PULSES_440_300[JOINT_MAX_DEGREES + 1] PROGMEM = {
+  440, 439, 437, 436, 434, 433, 431, 430, 428, 426, 425, 423, 422,
+  420, 419, 417, 416, 414, 412, 411, 409, 408, 406, 405, 403, 402,
+  400, 398, 397, 395, 394, 392, 391, 389, 388, 386, 384, 383, 381,
+  380, 378, 377, 375, 374, 372, 370, 369, 367, 366, 364, 363, 361,
+  360, 358, 356, 355, 353, 352, 350, 349, 347, 346, 344, 342, 341,
+  339, 338, 336, 335, 333, 332, 330, 328, 327, 325, 324, 322, 321,
+  319, 318, 316, 314, 313, 311, 310, 308, 307, 305, 304, 302, 300,
+};
+const uint16_t JOINT_PULSES_530_360[JOINT_MAX_DEGREES + 1] PROGMEM = {
+  530, 529, 527, 525, 523, 521, 519, 517, 515, 513, 512, 510, 508,
+  506, 504, 502, 500, 498, 496, 495, 493, 491, 489, 487, 485, 483,
+  481, 479, 478, 476, 474, 472, 470, 468, 466, 464, 462, 461, 459,
+  457, 455, 453, 451, 449, 447, 445, 444, 442, 440, 438, 436, 434,
+  432, 430, 428, 427, 425, 423, 421, 419, 417, 415, 413, 411, 410,
+  408, 406, 404, 402, 400, 398, 396, 394, 393, 391, 389, 387, 385,
+  383, 381, 379, 377, 376, 374, 372, 370, 368, 366, 364, 362, 360,
+};
+const uint16_t JOINT_PULSES_150_280[JOINT_MAX_DEGREES + 1] PROGMEM = {
+  150, 151, 152, 154, 155, 157, 158, 160, 161, 163, 164, 165, 167,
+  168, 170, 171, 173, 174, 176, 177, 178, 180, 181, 183, 184, 186,
+  187, 189, 190, 191, 193, 194, 196, 197, 199, 200, 202, 203, 204,
+  206, 207, 209, 210, 212, 213, 215, 216, 217, 219, 220, 222, 223,
+  225, 226, 228, 229, 230, 232, 233, 235, 236, 238, 239, 241, 242,
+  243, 245, 246, 248, 249, 251, 252, 254, 255, 256, 258, 259, 261,
+  262, 264, 265, 267, 268, 269, 271, 272, 274, 275, 277, 278, 280,
+};
+const uint16_t JOINT_PULSES_150_330[JOINT_MAX_DEGREES + 1] PROGMEM = {
+  150, 152, 154, 156, 158, 160, 162, 164, 166, 168, 170, 172, 174,
+  176, 178, 180, 182, 184, 186, 188, 190, 192, 194, 196, 198, 200,
+  202, 204, 206, 208, 210, 212, 214, 216, 218, 220, 222, 224, 226,
+  228, 230, 232, 234, 236, 238, 240, 242, 244, 246, 248, 250, 252,
+  254, 256, 258, 260, 262, 264, 266, 268, 270, 272, 274, 276, 278,
+  280, 282, 284, 286, 288, 290, 292, 294, 296, 298, 300, 302, 304,
+  306, 308, 310, 312, 314, 316, 318, 320, 322, 324, 326, 328, 330,
+};
+
+struct JointConfig {
+  uint8_t board;           // BOARD_LIST index
+  uint8_t channel;         // PCA9685 channel 0-15
+  uint8_t track;           // Pose index the joint follows
+  const uint16_t* pulses;  // PROGMEM: ticks at 0-JOINT_MAX_DEGREES
+};
+
+const JointConfig JOINTS[JOINT_COUNT] PROGMEM = {
+  {0, 14, 0, JOINT_PULSES_440_300},  // egg left_shoulder
+  {0, 15, 1, JOINT_PULSES_530_360},  // egg left_elbow
+  {0, 1, 2, JOINT_PULSES_150_280},  // egg right_shoulder
+  {0, 0, 3, JOINT_PULSES_150_330},  // egg right_elbow
+};
+
+// I2C bus (i2c_bus.h): SCL rate, bus time per frame, and the tracks whose
+// joints wait a frame when a frame's writes would run past it
+#define I2C_CLOCK_HZ 400000UL
+#define I2C_FRAME_BUDGET_MICROS 4000
+#define LOW_PRIORITY_TRACKS 0x0A  // left_elbow, right_elbow
+
+// Servo current (servo_power.h): each track's servo as (idle mA, full-speed
+// mA, degrees per second), and the estimated total every frame stays under
+#define CURRENT_BUDGET_MILLIAMPS 4500
+#define TRACK_CURRENT_LIST(X) X(20, 2000, 400) X(10, 600, 315) X(20, 2000, 400) X(10, 600, 315)  // DS-3225MG, HS-322HD, DS-3225MG, HS-322HD
+
 // Kinematics
 #define UPPER_SEGMENT_LENGTH 80
 #define LOWER_SEGMENT_LENGTH 100
@@ -35,21 +106,30 @@
 #define ELBOW_MIN_ANGLE 0
 #define ELBOW_MAX_ANGLE 90
 
-// Animation Keyframe Structure
-struct Keyframe {
-  unsigned long time_ms;
-  int left_shoulder_deg;
-  int left_elbow_deg;
-  int right_shoulder_deg;
-  int right_elbow_deg;
-};
+// Packed Animation Format (decoded by animation_player.h)
+// Dense:  keyframe_count x [uint16 delta_ms, uint8 ls, le, rs, re]
+// Sparse: 4 tracks (ls, le, rs, re) x [uint8 count, count x [uint16 delta_ms, uint8 angle]]
+// delta_ms is the time since the previous key on the same track (first key: since 0)
+#define KEY_U16(ms) (uint8_t)((ms) & 0xFF), (uint8_t)((ms) >> 8)
+#define ANIM_FLAG_LOOP 0x01
+#define ANIM_FLAG_SPARSE 0x02
+
+// Baked: frame_count x [uint8 ls, le, rs, re] PCA9685 ticks above BAKE_TICK_BASE_*,
+// one frame per BAKE_FRAME_MS of animation time ("playback": "baked" in the JSON)
+#define ANIM_FLAG_BAKED 0x04
+#define BAKE_FRAME_MS 20
+#define BAKE_FRAME_RECIP 3277  // frame = (elapsed * RECIP) >> 16
+#define BAKE_TICK_BASE_LEFT_SHOULDER 300
+#define BAKE_TICK_BASE_LEFT_ELBOW 360
+#define BAKE_TICK_BASE_RIGHT_SHOULDER 150
+#define BAKE_TICK_BASE_RIGHT_ELBOW 150
 
 struct Animation {
   const char* name;
-  unsigned long duration_ms;
-  bool loop;
-  int keyframe_count;
-  const Keyframe* keyframes;
+  const uint8_t* data;
+  uint16_t duration_ms;
+  uint8_t flags;
+  uint8_t keyframe_count;  // Dense only
 };
 
 const char ZERO_NAME[] PROGMEM = "Zero Position (Reference)";
@@ -60,84 +140,200 @@ const char BREAKING_THROUGH_NAME[] PROGMEM = "Breaking Through (Violent Pushing)
 const char GRASPING_NAME[] PROGMEM = "Grasping (Reaching and Pulling)";
 const char STABBING_NAME[] PROGMEM = "Stabbing (Asymmetric Poking)";
 
-// Zero Position (Reference)
-const Keyframe ZERO_KEYFRAMES[] PROGMEM = {
-  {0, 0, 0, 0, 0},
-};
-
-// Max Position (Reference)
-const Keyframe MAX_KEYFRAMES[] PROGMEM = {
-  {0, 90, 90, 90, 90},
-};
-
-// Resting (Curled Inside Egg)
-const Keyframe RESTING_KEYFRAMES[] PROGMEM = {
-  {0, 5, 8, 5, 8},
-  {1500, 8, 10, 8, 10},
-  {3000, 5, 8, 5, 8},
-};
-
-// Slow Struggle (Testing the Shell)
-const Keyframe SLOW_STRUGGLE_KEYFRAMES[] PROGMEM = {
-  {0, 15, 10, 15, 10},
-  {1200, 35, 20, 35, 20},
-  {2000, 25, 30, 25, 30},
-  {3200, 45, 40, 45, 40},
-  {4500, 15, 10, 15, 10},
-};
-
-// Breaking Through (Violent Pushing)
-const Keyframe BREAKING_THROUGH_KEYFRAMES[] PROGMEM = {
-  {0, 25, 20, 25, 20},
-  {350, 20, 70, 20, 70},
-  {600, 30, 30, 30, 30},
-  {950, 65, 65, 65, 65},
-  {1200, 35, 35, 35, 35},
-  {1550, 15, 70, 15, 70},
-  {1800, 70, 60, 70, 60},
-  {2400, 25, 20, 25, 20},
-};
-
-// Grasping (Reaching and Pulling)
-const Keyframe GRASPING_KEYFRAMES[] PROGMEM = {
-  {0, 40, 25, 40, 25},
-  {800, 25, 70, 25, 70},
-  {1400, 50, 45, 50, 45},
-  {1800, 30, 65, 30, 65},
-  {2400, 65, 70, 65, 70},
-  {3000, 50, 50, 50, 50},
-  {3500, 40, 25, 40, 25},
-};
-
-// Stabbing (Asymmetric Poking)
-const Keyframe STABBING_KEYFRAMES[] PROGMEM = {
-  {0, 0, 90, 0, 90},
-  {200, 35, 50, 0, 90},
-  {350, 25, 40, 0, 90},
-  {500, 40, 60, 0, 90},
-  {650, 30, 45, 0, 90},
-  {800, 45, 65, 0, 90},
-  {1000, 0, 90, 0, 90},
-  {1400, 0, 90, 0, 90},
-  {1600, 0, 90, 35, 50},
-  {1750, 0, 90, 25, 40},
-  {1900, 0, 90, 40, 60},
-  {2050, 0, 90, 30, 45},
-  {2200, 0, 90, 45, 65},
-  {2400, 0, 90, 0, 90},
-  {4000, 0, 90, 0, 90},
+// Zero Position (Reference) (dense)
+const uint8_t ZERO_DATA[] PROGMEM = {
+  KEY_U16(0), 0, 0, 0, 0,  // 0 ms
+};
+
+// Max Position (Reference) (dense)
+const uint8_t MAX_DATA[] PROGMEM = {
+  KEY_U16(0), 90, 90, 90, 90,  // 0 ms
+};
+
+// Resting (Curled Inside Egg) (baked, 150 frames)
+const uint8_t RESTING_DATA[] PROGMEM = {
+  133, 155, 7, 16, 133, 155, 7, 16, 133, 155, 7, 16, 133, 155, 7, 16,  // 0 ms
+  133, 155, 7, 16, 133, 155, 7, 16, 133, 155, 7, 16, 132, 155, 7, 16,  // 80 ms
+  132, 155, 7, 16, 132, 155, 7, 16, 132, 154, 7, 17, 132, 154, 7, 17,  // 160 ms
+  132, 154, 7, 17, 132, 154, 8, 17, 132, 154, 8, 17, 132, 154, 8, 17,  // 240 ms
+  132, 154, 8, 17, 132, 154, 8, 17, 132, 154, 8, 17, 131, 154, 8, 17,  // 320 ms
+  131, 154, 8, 17, 131, 154, 8, 17, 131, 154, 8, 17, 131, 154, 8, 17,  // 400 ms
+  131, 154, 8, 17, 131, 154, 8, 17, 131, 154, 8, 17, 131, 154, 8, 17,  // 480 ms
+  131, 154, 8, 17, 131, 153, 8, 18, 131, 153, 8, 18, 131, 153, 8, 18,  // 560 ms
+  131, 153, 9, 18, 131, 153, 9, 18, 131, 153, 9, 18, 131, 153, 9, 18,  // 640 ms
+  131, 153, 9, 18, 131, 153, 9, 18, 130, 153, 9, 18, 130, 153, 9, 18,  // 720 ms
+  130, 153, 9, 18, 130, 153, 9, 18, 130, 153, 9, 18, 130, 153, 9, 18,  // 800 ms
+  130, 153, 10, 18, 130, 153, 10, 18, 130, 153, 10, 18, 130, 153, 10, 19,  // 880 ms
+  130, 153, 10, 19, 130, 153, 10, 19, 130, 153, 10, 19, 130, 153, 10, 19,  // 960 ms
+  130, 153, 10, 19, 130, 153, 10, 19, 130, 153, 10, 19, 130, 153, 10, 19,  // 1040 ms
+  130, 153, 10, 19, 129, 152, 10, 19, 129, 152, 10, 19, 129, 152, 10, 19,  // 1120 ms
+  129, 152, 10, 19, 129, 152, 10, 19, 129, 152, 10, 19, 129, 152, 11, 19,  // 1200 ms
+  129, 152, 11, 19, 129, 152, 11, 19, 129, 152, 11, 20, 129, 152, 11, 20,  // 1280 ms
+  129, 152, 11, 20, 128, 152, 11, 20, 128, 152, 11, 20, 128, 152, 11, 20,  // 1360 ms
+  128, 152, 11, 20, 128, 152, 11, 20, 128, 152, 11, 20, 128, 152, 11, 20,  // 1440 ms
+  128, 152, 11, 20, 128, 152, 11, 20, 128, 152, 11, 20, 128, 152, 11, 20,  // 1520 ms
+  128, 152, 11, 20, 128, 152, 11, 20, 129, 152, 11, 20, 129, 152, 11, 20,  // 1600 ms
+  129, 152, 11, 20, 129, 152, 11, 19, 129, 152, 11, 19, 129, 152, 11, 19,  // 1680 ms
+  129, 152, 10, 19, 129, 152, 10, 19, 129, 152, 10, 19, 129, 152, 10, 19,  // 1760 ms
+  129, 152, 10, 19, 129, 152, 10, 19, 130, 153, 10, 19, 130, 153, 10, 19,  // 1840 ms
+  130, 153, 10, 19, 130, 153, 10, 19, 130, 153, 10, 19, 130, 153, 10, 19,  // 1920 ms
+  130, 153, 10, 19, 130, 153, 10, 19, 130, 153, 10, 19, 130, 153, 10, 19,  // 2000 ms
+  130, 153, 10, 18, 130, 153, 10, 18, 130, 153, 10, 18, 130, 153, 9, 18,  // 2080 ms
+  130, 153, 9, 18, 130, 153, 9, 18, 130, 153, 9, 18, 130, 153, 9, 18,  // 2160 ms
+  130, 153, 9, 18, 131, 153, 9, 18, 131, 153, 9, 18, 131, 153, 9, 18,  // 2240 ms
+  131, 153, 9, 18, 131, 153, 9, 18, 131, 153, 9, 18, 131, 153, 8, 18,  // 2320 ms
+  131, 153, 8, 18, 131, 153, 8, 18, 131, 154, 8, 17, 131, 154, 8, 17,  // 2400 ms
+  131, 154, 8, 17, 131, 154, 8, 17, 131, 154, 8, 17, 131, 154, 8, 17,  // 2480 ms
+  131, 154, 8, 17, 131, 154, 8, 17, 131, 154, 8, 17, 131, 154, 8, 17,  // 2560 ms
+  132, 154, 8, 17, 132, 154, 8, 17, 132, 154, 8, 17, 132, 154, 8, 17,  // 2640 ms
+  132, 154, 8, 17, 132, 154, 8, 17, 132, 154, 7, 17, 132, 154, 7, 17,  // 2720 ms
+  132, 154, 7, 17, 132, 155, 7, 16, 132, 155, 7, 16, 132, 155, 7, 16,  // 2800 ms
+  133, 155, 7, 16, 133, 155, 7, 16, 133, 155, 7, 16, 133, 155, 7, 16,  // 2880 ms
+  133, 155, 7, 16, 133, 155, 7, 16,  // 2960 ms
+};
+#ifdef ANIMATION_CONFIG_LIVE_TABLE
+const uint8_t RESTING_KEYS[] = {
+  KEY_U16(0), 5, 8, 5, 8,  // 0 ms
+  KEY_U16(1500), 8, 10, 8, 10,  // 1500 ms
+  KEY_U16(1500), 5, 8, 5, 8,  // 3000 ms
+};
+#endif
+
+// Slow Struggle (Testing the Shell) (baked, 225 frames)
+const uint8_t SLOW_STRUGGLE_DATA[] PROGMEM = {
+  117, 152, 21, 20, 117, 152, 22, 20, 116, 151, 22, 21, 116, 151, 23, 21,  // 0 ms
+  115, 151, 23, 21, 115, 150, 24, 22, 114, 150, 24, 22, 113, 150, 25, 22,  // 80 ms
+  113, 149, 25, 23, 112, 149, 26, 23, 112, 149, 26, 23, 111, 148, 27, 24,  // 160 ms
+  111, 148, 27, 24, 110, 148, 27, 24, 110, 147, 28, 25, 109, 147, 28, 25,  // 240 ms
+  109, 147, 29, 25, 108, 146, 29, 26, 108, 146, 30, 26, 107, 146, 30, 26,  // 320 ms
+  107, 145, 31, 27, 106, 145, 31, 27, 106, 145, 32, 27, 105, 144, 32, 28,  // 400 ms
+  105, 144, 33, 28, 104, 144, 33, 28, 104, 143, 34, 29, 103, 143, 34, 29,  // 480 ms
+  103, 143, 35, 29, 102, 142, 35, 30, 102, 142, 36, 30, 101, 142, 36, 30,  // 560 ms
+  101, 141, 37, 31, 100, 141, 37, 31, 99, 141, 38, 31, 99, 140, 38, 32,  // 640 ms
+  98, 140, 39, 32, 98, 140, 39, 32, 97, 139, 40, 33, 97, 139, 40, 33,  // 720 ms
+  96, 139, 40, 33, 96, 138, 41, 34, 95, 138, 41, 34, 95, 138, 42, 34,  // 800 ms
+  94, 137, 42, 35, 94, 137, 43, 35, 93, 137, 43, 35, 93, 136, 44, 36,  // 880 ms
+  92, 136, 44, 36, 92, 136, 45, 36, 91, 136, 45, 37, 91, 136, 46, 37,  // 960 ms
+  90, 135, 46, 37, 90, 135, 47, 38, 89, 135, 47, 38, 89, 135, 48, 38,  // 1040 ms
+  88, 134, 48, 39, 88, 134, 49, 39, 87, 134, 49, 39, 87, 133, 50, 40,  // 1120 ms
+  86, 133, 50, 40, 87, 133, 50, 41, 87, 132, 50, 41, 88, 132, 49, 42,  // 1200 ms
+  88, 131, 49, 42, 88, 131, 49, 43, 89, 130, 48, 43, 89, 130, 48, 44,  // 1280 ms
+  89, 129, 47, 44, 90, 129, 47, 45, 90, 128, 47, 45, 91, 128, 46, 46,  // 1360 ms
+  91, 127, 46, 46, 91, 127, 46, 47, 92, 126, 45, 47, 92, 126, 45, 48,  // 1440 ms
+  92, 125, 44, 48, 93, 125, 44, 49, 93, 124, 44, 49, 94, 124, 43, 50,  // 1520 ms
+  94, 123, 43, 50, 94, 123, 43, 51, 95, 122, 42, 51, 95, 122, 42, 52,  // 1600 ms
+  95, 121, 41, 52, 96, 121, 41, 53, 96, 120, 41, 53, 97, 120, 40, 54,  // 1680 ms
+  97, 119, 40, 54, 97, 119, 40, 55, 98, 119, 40, 55, 98, 118, 39, 56,  // 1760 ms
+  98, 118, 39, 56, 99, 118, 39, 57, 99, 117, 38, 57, 100, 117, 38, 58,  // 1840 ms
+  100, 116, 37, 58, 101, 116, 37, 59, 101, 115, 37, 59, 102, 115, 36, 60,  // 1920 ms
+  102, 114, 36, 60, 101, 114, 36, 60, 101, 113, 37, 61, 100, 113, 37, 61,  // 2000 ms
+  99, 113, 38, 61, 99, 112, 38, 62, 98, 112, 39, 62, 98, 112, 39, 62,  // 2080 ms
+  97, 111, 40, 63, 97, 111, 40, 63, 96, 111, 40, 63, 96, 110, 41, 64,  // 2160 ms
+  95, 110, 41, 64, 95, 110, 42, 64, 94, 109, 42, 65, 94, 109, 43, 65,  // 2240 ms
+  93, 109, 43, 65, 93, 108, 44, 66, 92, 108, 44, 66, 92, 108, 45, 66,  // 2320 ms
+  91, 107, 45, 67, 91, 107, 46, 67, 90, 107, 46, 67, 90, 106, 47, 68,  // 2400 ms
+  89, 106, 47, 68, 89, 106, 48, 68, 88, 105, 48, 69, 88, 105, 49, 69,  // 2480 ms
+  87, 105, 49, 69, 87, 104, 50, 70, 86, 104, 50, 70, 85, 104, 51, 70,  // 2560 ms
+  85, 103, 51, 71, 84, 103, 52, 71, 84, 103, 52, 71, 83, 102, 53, 72,  // 2640 ms
+  83, 102, 53, 72, 82, 102, 53, 72, 82, 102, 54, 73, 81, 102, 54, 73,  // 2720 ms
+  81, 101, 55, 73, 80, 101, 55, 74, 80, 101, 56, 74, 79, 101, 56, 74,  // 2800 ms
+  79, 100, 57, 75, 78, 100, 57, 75, 78, 100, 58, 75, 77, 99, 58, 76,  // 2880 ms
+  77, 99, 59, 76, 76, 99, 59, 76, 76, 98, 60, 77, 75, 98, 60, 77,  // 2960 ms
+  75, 98, 61, 77, 74, 97, 61, 78, 74, 97, 62, 78, 73, 97, 62, 78,  // 3040 ms
+  73, 96, 63, 79, 72, 96, 63, 79, 71, 96, 64, 79, 71, 95, 64, 80,  // 3120 ms
+  70, 95, 65, 80, 71, 96, 64, 79, 72, 97, 63, 78, 73, 98, 63, 77,  // 3200 ms
+  74, 99, 62, 76, 74, 100, 61, 75, 75, 101, 60, 74, 75, 101, 60, 74,  // 3280 ms
+  76, 102, 59, 73, 77, 102, 59, 72, 78, 103, 58, 71, 78, 104, 57, 70,  // 3360 ms
+  79, 105, 56, 69, 80, 106, 56, 68, 80, 107, 55, 67, 81, 108, 54, 66,  // 3440 ms
+  82, 109, 54, 65, 83, 110, 53, 64, 83, 111, 53, 63, 84, 112, 52, 62,  // 3520 ms
+  84, 112, 52, 62, 85, 113, 51, 61, 86, 114, 50, 60, 87, 115, 49, 59,  // 3600 ms
+  88, 116, 49, 58, 89, 117, 48, 57, 89, 118, 47, 56, 90, 118, 47, 55,  // 3680 ms
+  91, 119, 46, 54, 91, 120, 45, 53, 92, 121, 44, 52, 93, 122, 44, 51,  // 3760 ms
+  94, 123, 43, 50, 94, 123, 43, 50, 95, 124, 42, 49, 95, 125, 41, 48,  // 3840 ms
+  96, 126, 40, 47, 97, 127, 40, 46, 98, 128, 39, 45, 98, 129, 39, 44,  // 3920 ms
+  99, 130, 38, 43, 100, 131, 37, 42, 101, 132, 37, 41, 102, 133, 36, 40,  // 4000 ms
+  102, 134, 35, 39, 103, 135, 34, 38, 103, 135, 34, 38, 104, 136, 33, 37,  // 4080 ms
+  105, 136, 33, 36, 106, 137, 32, 35, 106, 138, 31, 34, 107, 139, 30, 33,  // 4160 ms
+  108, 140, 30, 32, 108, 141, 29, 31, 109, 142, 28, 30, 110, 143, 28, 29,  // 4240 ms
+  111, 144, 27, 28, 111, 145, 27, 27, 112, 146, 26, 26, 112, 146, 26, 26,  // 4320 ms
+  113, 147, 25, 25, 114, 148, 24, 24, 115, 149, 23, 23, 116, 150, 23, 22,  // 4400 ms
+  117, 151, 22, 21,  // 4480 ms
+};
+#ifdef ANIMATION_CONFIG_LIVE_TABLE
+const uint8_t SLOW_STRUGGLE_KEYS[] = {
+  KEY_U16(0), 15, 10, 15, 10,  // 0 ms
+  KEY_U16(1200), 35, 20, 35, 20,  // 1200 ms
+  KEY_U16(800), 25, 30, 25, 30,  // 2000 ms
+  KEY_U16(1200), 45, 40, 45, 40,  // 3200 ms
+  KEY_U16(1300), 15, 10, 15, 10,  // 4500 ms
+};
+#endif
+
+// Breaking Through (Violent Pushing) (dense)
+const uint8_t BREAKING_THROUGH_DATA[] PROGMEM = {
+  KEY_U16(0), 25, 20, 25, 20,  // 0 ms
+  KEY_U16(350), 20, 70, 20, 70,  // 350 ms
+  KEY_U16(250), 30, 30, 30, 30,  // 600 ms
+  KEY_U16(350), 65, 65, 65, 65,  // 950 ms
+  KEY_U16(250), 35, 35, 35, 35,  // 1200 ms
+  KEY_U16(350), 15, 70, 15, 70,  // 1550 ms
+  KEY_U16(250), 70, 60, 70, 60,  // 1800 ms
+  KEY_U16(600), 25, 20, 25, 20,  // 2400 ms
+};
+
+// Grasping (Reaching and Pulling) (dense)
+const uint8_t GRASPING_DATA[] PROGMEM = {
+  KEY_U16(0), 40, 25, 40, 25,  // 0 ms
+  KEY_U16(800), 25, 70, 25, 70,  // 800 ms
+  KEY_U16(600), 50, 45, 50, 45,  // 1400 ms
+  KEY_U16(400), 30, 65, 30, 65,  // 1800 ms
+  KEY_U16(600), 65, 70, 65, 70,  // 2400 ms
+  KEY_U16(600), 50, 50, 50, 50,  // 3000 ms
+  KEY_U16(500), 40, 25, 40, 25,  // 3500 ms
+};
+
+// Stabbing (Asymmetric Poking) (dense)
+const uint8_t STABBING_DATA[] PROGMEM = {
+  KEY_U16(0), 0, 90, 0, 90,  // 0 ms
+  KEY_U16(200), 35, 50, 0, 90,  // 200 ms
+  KEY_U16(150), 25, 40, 0, 90,  // 350 ms
+  KEY_U16(150), 40, 60, 0, 90,  // 500 ms
+  KEY_U16(150), 30, 45, 0, 90,  // 650 ms
+  KEY_U16(150), 45, 65, 0, 90,  // 800 ms
+  KEY_U16(200), 0, 90, 0, 90,  // 1000 ms
+  KEY_U16(400), 0, 90, 0, 90,  // 1400 ms
+  KEY_U16(200), 0, 90, 35, 50,  // 1600 ms
+  KEY_U16(150), 0, 90, 25, 40,  // 1750 ms
+  KEY_U16(150), 0, 90, 40, 60,  // 1900 ms
+  KEY_U16(150), 0, 90, 30, 45,  // 2050 ms
+  KEY_U16(150), 0, 90, 45, 65,  // 2200 ms
+  KEY_U16(200), 0, 90, 0, 90,  // 2400 ms
+  KEY_U16(1600), 0, 90, 0, 90,  // 4000 ms
 };
 
 // Animation Definitions
 const Animation ANIMATIONS[] PROGMEM = {
-  {ZERO_NAME, 1000, true, 1, ZERO_KEYFRAMES},
-  {MAX_NAME, 1000, true, 1, MAX_KEYFRAMES},
-  {RESTING_NAME, 3000, true, 3, RESTING_KEYFRAMES},
-  {SLOW_STRUGGLE_NAME, 4500, true, 5, SLOW_STRUGGLE_KEYFRAMES},
-  {BREAKING_THROUGH_NAME, 2400, true, 8, BREAKING_THROUGH_KEYFRAMES},
-  {GRASPING_NAME, 3500, true, 7, GRASPING_KEYFRAMES},
-  {STABBING_NAME, 4000, true, 15, STABBING_KEYFRAMES},
+  {ZERO_NAME, ZERO_DATA, 1000, ANIM_FLAG_LOOP, 1},
+  {MAX_NAME, MAX_DATA, 1000, ANIM_FLAG_LOOP, 1},
+  {RESTING_NAME, RESTING_DATA, 3000, ANIM_FLAG_LOOP | ANIM_FLAG_BAKED, 0},
+  {SLOW_STRUGGLE_NAME, SLOW_STRUGGLE_DATA, 4500, ANIM_FLAG_LOOP | ANIM_FLAG_BAKED, 0},
+  {BREAKING_THROUGH_NAME, BREAKING_THROUGH_DATA, 2400, ANIM_FLAG_LOOP, 8},
+  {GRASPING_NAME, GRASPING_DATA, 3500, ANIM_FLAG_LOOP, 7},
+  {STABBING_NAME, STABBING_DATA, 4000, ANIM_FLAG_LOOP, 15},
+};
+
+#ifdef ANIMATION_CONFIG_LIVE_TABLE
+// Host only: every animation as keyframes, baked ones included
+const Animation LIVE_ANIMATIONS[] = {
+  {ZERO_NAME, ZERO_DATA, 1000, ANIM_FLAG_LOOP, 1},
+  {MAX_NAME, MAX_DATA, 1000, ANIM_FLAG_LOOP, 1},
+  {RESTING_NAME, RESTING_KEYS, 3000, ANIM_FLAG_LOOP, 3},
+  {SLOW_STRUGGLE_NAME, SLOW_STRUGGLE_KEYS, 4500, ANIM_FLAG_LOOP, 5},
+  {BREAKING_THROUGH_NAME, BREAKING_THROUGH_DATA, 2400, ANIM_FLAG_LOOP, 8},
+  {GRASPING_NAME, GRASPING_DATA, 3500, ANIM_FLAG_LOOP, 7},
+  {STABBING_NAME, STABBING_DATA, 4000, ANIM_FLAG_LOOP, 15},
 };
+#endif
 
 #define ANIMATION_COUNT 7
 #define DEFAULT_ANIMATION 3  // slow_struggle
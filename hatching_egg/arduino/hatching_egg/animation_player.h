@@ -0,0 +1,338 @@
+/*
+ * Animation Player Math - Pure Functions (No Hardware Dependencies)
+ *
+ * Integer/fixed-point replacements for the float math in updateAnimation().
+ * The ATmega32U4 has no FPU, so every float multiply or divide is a
+ * soft-float library call; everything here is integer shifts, 16x16
+ * multiplies and at most one integer divide per update.
+ *
+ * Formats:
+ * - Playback speed: Q8 (256 = 1.0x). Shifting by 8 is a byte move on AVR.
+ * - Interpolation fraction: Q15 (0 = start of segment, 32768 = end).
+ * - Output angle: Q8 degrees (256 = 1 degree), so the servo tables can
+ *   place a pulse between whole degrees.
+ *
+ * Keyframe lookup uses a cursor that only moves forward with time, so the
+ * current segment's endpoints are read from PROGMEM once per segment
+ * instead of rescanning from keyframe 0 on every loop. Keyframes are
+ * stored packed (uint16 time deltas, uint8 angles) by
+ * generate_arduino_config.py and decoded here. Animations marked
+ * "playback": "baked" skip all of this and read pre-rendered ticks.
+ *
+ * Can be included in both Arduino sketches and local test programs.
+ */
+
+#ifndef ANIMATION_PLAYER_H
+#define ANIMATION_PLAYER_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <string.h>
+// PROGMEM is plain memory on the host
+#ifndef PROGMEM
+#define PROGMEM
+inline uint8_t host_pgm_read_byte(const void* addr) { uint8_t v; memcpy(&v, addr, 1); return v; }
+inline uint16_t host_pgm_read_word(const void* addr) { uint16_t v; memcpy(&v, addr, 2); return v; }
+inline uint32_t host_pgm_read_dword(const void* addr) { uint32_t v; memcpy(&v, addr, 4); return v; }
+inline void* host_pgm_read_ptr(const void* addr) { void* v; memcpy(&v, addr, sizeof(v)); return v; }
+#define pgm_read_byte(addr) host_pgm_read_byte(addr)
+#define pgm_read_word(addr) host_pgm_read_word(addr)
+#define pgm_read_dword(addr) host_pgm_read_dword(addr)
+#define pgm_read_ptr(addr) host_pgm_read_ptr(addr)
+#endif
+#endif
+
+#include "animation_config.h"
+
+// Playback speed multiplier in Q8 fixed point
+typedef uint16_t SpeedQ8;
+#define SPEED_Q8_SHIFT 8
+#define SPEED_Q8(x) ((SpeedQ8)((x) * 256 + 0.5))  // Compile-time only
+
+// Interpolation fraction in Q15 fixed point
+#define FRAC_Q15_SHIFT 15
+#define FRAC_Q15_ONE 32768
+
+/**
+ * Animation time for a given wall-clock time at playback speed
+ * (elapsed * speed). Valid while realElapsedMs * speed fits 32 bits
+ * (~6700 s at 2.5x).
+ */
+inline uint32_t scaleElapsed(uint32_t realElapsedMs, SpeedQ8 speed) {
+  return (realElapsedMs * speed) >> SPEED_Q8_SHIFT;
+}
+
+/**
+ * Wall-clock duration of an animation at playback speed (duration / speed).
+ * Has a divide, so call it once per animation start, not per update.
+ */
+inline uint32_t scaleDuration(uint32_t durationMs, SpeedQ8 speed) {
+  if (speed == 0) return 0xFFFFFFFFUL;
+  return (durationMs << SPEED_Q8_SHIFT) / speed;
+}
+
+/**
+ * Fractional part of a Q8 speed in hundredths, for printing "1.50x"
+ */
+inline uint8_t speedHundredths(SpeedQ8 speed) {
+  uint16_t hundredths = ((uint16_t)(speed & 0xFF) * 100 + 128) >> SPEED_Q8_SHIFT;
+  return hundredths > 99 ? 99 : (uint8_t)hundredths;
+}
+
+/**
+ * Position within a keyframe segment as a Q15 fraction
+ * (replaces: t = (elapsed - t1) / (t2 - t1), constrained to 0-1)
+ */
+inline uint16_t segmentFraction(uint32_t elapsed, uint32_t t1, uint32_t t2) {
+  if (elapsed <= t1 || t2 <= t1) return 0;
+  uint32_t span = t2 - t1;
+  uint32_t dt = elapsed - t1;
+  if (dt >= span) return FRAC_Q15_ONE;
+  while (span > 0xFFFF) {
+    // Keep dt << 15 inside 32 bits for very long segments
+    span >>= 1;
+    dt >>= 1;
+  }
+  return (uint16_t)((dt << FRAC_Q15_SHIFT) / span);
+}
+
+/**
+ * Interpolate between two angles with a Q15 fraction.
+ * Truncates toward zero, like the float version's (int)((b - a) * t).
+ */
+inline int lerpQ15(int a, int b, uint16_t frac) {
+  int32_t product = (int32_t)(b - a) * frac;
+  if (product < 0) {
+    return a - (int)((-product) >> FRAC_Q15_SHIFT);
+  }
+  return a + (int)(product >> FRAC_Q15_SHIFT);
+}
+
+/**
+ * Sub-degree angle in Q8 fixed point (0-255 degrees fit 16 bits)
+ */
+typedef uint16_t AngleQ8;
+#define ANGLE_Q8_SHIFT 8
+
+/**
+ * Interpolate between two angles with a Q15 fraction, keeping 8 fraction
+ * bits (rounded to nearest) instead of truncating to whole degrees
+ */
+inline AngleQ8 lerpQ15Q8(uint8_t a, uint8_t b, uint16_t frac) {
+  int32_t product = (int32_t)((int16_t)b - (int16_t)a) * frac;  // Q15 degrees
+  const int32_t half = (int32_t)1 << (FRAC_Q15_SHIFT - ANGLE_Q8_SHIFT - 1);
+  AngleQ8 base = (AngleQ8)a << ANGLE_Q8_SHIFT;
+  if (product < 0) {
+    return base - (AngleQ8)((-product + half) >> (FRAC_Q15_SHIFT - ANGLE_Q8_SHIFT));
+  }
+  return base + (AngleQ8)((product + half) >> (FRAC_Q15_SHIFT - ANGLE_Q8_SHIFT));
+}
+
+/**
+ * Keyframe cursor - one track per joint, current segment cached in RAM
+ *
+ * Reads the packed format from animation_config.h. Dense and sparse
+ * animations decode the same way: a track is a run of keys `stride` bytes
+ * apart, each a uint16 time delta followed (at `angleOffset`) by the angle.
+ */
+#define POSE_JOINTS 4
+#define DENSE_KEY_BYTES (2 + POSE_JOINTS)
+#define SPARSE_KEY_BYTES 3
+
+struct TrackCursor {
+  const uint8_t* first;  // PROGMEM: first key of the track
+  const uint8_t* next;   // PROGMEM: key after `to`
+  uint8_t count;         // Keys in the track
+  uint8_t remaining;     // Keys after `to`
+  uint8_t stride;        // Bytes from one key to the next
+  uint8_t angleOffset;   // Byte offset of the angle within a key
+  uint32_t t1;           // Segment start/end (animation time, ms)
+  uint32_t t2;
+  uint32_t invSpan;      // 2^31 / (t2 - t1) rounded up, 0 if segment is empty or > 65535 ms
+  int16_t from;
+  int16_t to;
+};
+
+struct KeyframeCursor {
+  TrackCursor tracks[POSE_JOINTS];  // left_shoulder, left_elbow, right_shoulder, right_elbow
+  bool dense;                       // Tracks share key times: track 0 decides every seek
+};
+
+/**
+ * Cache the segment's reciprocal. Rounding up keeps fractions that land on
+ * a whole Q15 step (e.g. exact midpoints) identical to the divide.
+ */
+inline void trackLoadSpan(TrackCursor* track) {
+  uint32_t span = track->t2 - track->t1;
+  track->invSpan = (track->t2 > track->t1 && span <= 0xFFFF) ? (0x80000000UL + span - 1) / span : 0;
+}
+
+/**
+ * Point a track at its first segment
+ */
+inline void trackReset(TrackCursor* track) {
+  const uint8_t* key = track->first;
+  track->t1 = pgm_read_word(key);
+  track->from = pgm_read_byte(key + track->angleOffset);
+  if (track->count > 1) {
+    key += track->stride;
+    track->t2 = track->t1 + pgm_read_word(key);
+    track->to = pgm_read_byte(key + track->angleOffset);
+    track->remaining = track->count - 2;
+  } else {
+    // Single key: hold the pose
+    track->t2 = track->t1;
+    track->to = track->from;
+    track->remaining = 0;
+  }
+  track->next = key + track->stride;
+  trackLoadSpan(track);
+}
+
+/**
+ * Advance a track to the segment containing `elapsed`. If time moves back
+ * the track restarts from its first key; past its last key it holds.
+ */
+inline void trackSeek(TrackCursor* track, uint32_t elapsed) {
+  if (elapsed < track->t1 && track->remaining + 2 < track->count) {
+    trackReset(track);
+  }
+  while (elapsed >= track->t2 && track->remaining) {
+    // Old end becomes new start; only the new end comes from PROGMEM
+    track->t1 = track->t2;
+    track->from = track->to;
+    track->t2 += pgm_read_word(track->next);
+    track->to = pgm_read_byte(track->next + track->angleOffset);
+    track->next += track->stride;
+    track->remaining--;
+    trackLoadSpan(track);
+  }
+}
+
+/**
+ * Q15 fraction of the track's segment at `elapsed`, using the cached
+ * reciprocal (one multiply) instead of a divide per update
+ */
+inline uint16_t trackFraction(const TrackCursor* track, uint32_t elapsed) {
+  if (elapsed <= track->t1) return 0;
+  if (elapsed >= track->t2) return FRAC_Q15_ONE;
+  if (track->invSpan == 0) return segmentFraction(elapsed, track->t1, track->t2);
+  return (uint16_t)(((elapsed - track->t1) * track->invSpan) >> 16);
+}
+
+/**
+ * Point the cursor at the start of an animation (call on start).
+ * `animation` is an entry of the PROGMEM ANIMATIONS table.
+ */
+inline void cursorReset(KeyframeCursor* cursor, const Animation* animation) {
+  const uint8_t* data = (const uint8_t*)pgm_read_ptr(&(animation->data));
+  bool sparse = pgm_read_byte(&(animation->flags)) & ANIM_FLAG_SPARSE;
+  uint8_t denseCount = pgm_read_byte(&(animation->keyframe_count));
+
+  for (uint8_t j = 0; j < POSE_JOINTS; j++) {
+    TrackCursor* track = &cursor->tracks[j];
+    if (sparse) {
+      // [count][keys...] per track, one after another
+      track->count = pgm_read_byte(data);
+      track->first = data + 1;
+      track->stride = SPARSE_KEY_BYTES;
+      track->angleOffset = 2;
+      data += 1 + track->count * SPARSE_KEY_BYTES;
+    } else {
+      // All tracks share each key's time delta
+      track->count = denseCount;
+      track->first = data;
+      track->stride = DENSE_KEY_BYTES;
+      track->angleOffset = 2 + j;
+    }
+    trackReset(track);
+  }
+  cursor->dense = !sparse;
+}
+
+/**
+ * Advance every track to `elapsed` (time normally only moves forward)
+ */
+inline void cursorSeek(KeyframeCursor* cursor, uint32_t elapsed) {
+  const TrackCursor* lead = &cursor->tracks[0];
+  if (cursor->dense && elapsed >= lead->t1 && (elapsed < lead->t2 || !lead->remaining)) {
+    return;  // Still inside the current segment
+  }
+  for (uint8_t j = 0; j < POSE_JOINTS; j++) {
+    trackSeek(&cursor->tracks[j], elapsed);
+  }
+}
+
+/**
+ * Interpolated pose at `elapsed` (seek first). Dense tracks share one
+ * segment, so the fraction is only recomputed when the segment differs.
+ */
+inline void cursorPose(const KeyframeCursor* cursor, uint32_t elapsed, int* pose) {
+  const TrackCursor* shared = 0;
+  uint16_t t = 0;
+  for (uint8_t j = 0; j < POSE_JOINTS; j++) {
+    const TrackCursor* track = &cursor->tracks[j];
+    if (!shared || track->t1 != shared->t1 || track->t2 != shared->t2) {
+      shared = track;
+      t = trackFraction(track, elapsed);
+    }
+    pose[j] = lerpQ15(track->from, track->to, t);
+  }
+}
+
+/**
+ * Same as cursorPose(), but in Q8 degrees for sub-degree servo output
+ */
+inline void cursorPoseQ8(const KeyframeCursor* cursor, uint32_t elapsed, AngleQ8* pose) {
+  const TrackCursor* shared = 0;
+  uint16_t t = 0;
+  for (uint8_t j = 0; j < POSE_JOINTS; j++) {
+    const TrackCursor* track = &cursor->tracks[j];
+    if (!shared || track->t1 != shared->t1 || track->t2 != shared->t2) {
+      shared = track;
+      t = trackFraction(track, elapsed);
+    }
+    pose[j] = lerpQ15Q8((uint8_t)track->from, (uint8_t)track->to, t);
+  }
+}
+
+/**
+ * Baked animations (ANIM_FLAG_BAKED) are pre-rendered by
+ * generate_arduino_config.py into one frame of PCA9685 ticks per
+ * BAKE_FRAME_MS of animation time, so playback is a table walk: no seek,
+ * no interpolation, no servo table lookup. Each frame is one byte per
+ * joint above that joint's BAKE_TICK_BASE_*.
+ */
+#define BAKED_FRAME_BYTES POSE_JOINTS
+
+inline bool animationBaked(const Animation* animation) {
+  return pgm_read_byte(&(animation->flags)) & ANIM_FLAG_BAKED;
+}
+
+/**
+ * Frame holding animation time `elapsed` (elapsed / BAKE_FRAME_MS as a
+ * multiply and shift; the generator checks it is exact for every baked
+ * animation's duration)
+ */
+inline uint16_t bakedFrameIndex(uint32_t elapsed) {
+  return (uint16_t)((elapsed * BAKE_FRAME_RECIP) >> 16);
+}
+
+/**
+ * PCA9685 ticks of a baked animation at `elapsed` (holds the last frame
+ * past the end). Output order is the same as cursorPoseQ8().
+ */
+inline void bakedPose(const Animation* animation, uint32_t elapsed, uint16_t* ticks) {
+  uint16_t duration = pgm_read_word(&(animation->duration_ms));
+  if (elapsed >= duration) elapsed = duration - 1;
+  const uint8_t* frame = (const uint8_t*)pgm_read_ptr(&(animation->data))
+      + bakedFrameIndex(elapsed) * BAKED_FRAME_BYTES;
+  ticks[0] = BAKE_TICK_BASE_LEFT_SHOULDER + pgm_read_byte(frame);
+  ticks[1] = BAKE_TICK_BASE_LEFT_ELBOW + pgm_read_byte(frame + 1);
+  ticks[2] = BAKE_TICK_BASE_RIGHT_SHOULDER + pgm_read_byte(frame + 2);
+  ticks[3] = BAKE_TICK_BASE_RIGHT_ELBOW + pgm_read_byte(frame + 3);
+}
+
+#endif // ANIMATION_PLAYER_H
@@ -32,25 +32,94 @@
  *
  * Hardware:
  * - DFRobot Beetle (Leonardo) on Pin 9 trigger
- * - PCA9685 PWM Servo Driver (I2C)
- * - 4x Servos with calibrated ranges:
+ * - PCA9685 PWM Servo Driver(s) (I2C), one or more boards
+ * - 4x Servos per egg with calibrated ranges (first egg):
  *   - Right Elbow (CH0): PWM 150-330 (0-90°)
  *   - Right Shoulder (CH1): PWM 150-280 (0-90°)
  *   - Left Shoulder (CH14): PWM 440-300 (0-90°, inverted)
  *   - Left Elbow (CH15): PWM 530-360 (0-90°, inverted)
  *
+ * A clutch of eggs runs from the same sketch: hardware.boards and
+ * hardware.props in animation-config.json become the generated JOINTS
+ * table, one (board, channel, track, pulse table) per servo. Every frame
+ * computes one pose (four tracks) and each joint takes its track from it,
+ * so all eggs play the same animation. The generator refuses a layout
+ * whose I2C writes can't fit one frame with every joint moving.
+ *
+ * Servo writes go through servo_output.h and are batched per frame
+ * (../../libraries/HalloweenProps): only changed register bytes go out, in
+ * as few I2C transactions per board as possible. The bus runs at
+ * I2C_CLOCK_HZ (400 kHz fast mode; Wire's default is 100 kHz) and each
+ * frame's writes get I2C_FRAME_BUDGET_MICROS of it (i2c_bus.h): past that,
+ * the low_priority_joints (elbows) wait for the next frame rather than
+ * holding up the loop. Bus bytes, transactions and time per frame are
+ * logged with the frame histograms, and printed in the serial status.
+ *
+ * Supply current is budgeted too (servo_power.h): each joint's servo has a
+ * current model (hardware.servo_current: idle, flat out, top speed) and
+ * every frame's estimated total stays under CURRENT_BUDGET_MILLIAMPS. No
+ * joint moves faster than its servo can turn in a frame, and when all of
+ * them moving at once would pass the budget (breaking_through at 2.5x)
+ * some are slowed or wait a frame, in turn, instead of browning out the
+ * Beetle. Average and peak current are logged with the frame histograms.
+ * Poses are interpolated to 1/256 degree and mapped straight to PCA9685
+ * ticks, so slow moves step one tick at a time; a servo is written only
+ * when its tick value changes.
+ *
+ * Poses are computed once per 20ms PWM period by a FrameScheduler; between
+ * frames the CPU sleeps. Frame lateness/compute histograms are logged when
+ * a triggered sequence starts and ends.
+ *
+ * The trigger is taken on a pin change interrupt (edge_capture.h): edges
+ * are timestamped in the ISR and debounced on those timestamps, so a press
+ * shorter than a loop pass still counts, contact bounce can't restart the
+ * sequence, and the sequence starts on the next loop pass. The time from
+ * the press to the first servo write is logged with each trigger, and kept
+ * (last, min, max) for the serial status: send 's' at any log level,
+ * production build included.
+ *
+ * Runtime messages are binary event records (log_events.h) queued in RAM
+ * and sent between frames only as fast as USB serial takes them, so a full
+ * serial buffer never stalls the animation. Decode the port with
+ * pixi run decode-log. Messages have levels (log_level.h): the production
+ * build strips everything below WARN, text and records alike.
+ *
  * Configuration auto-generated from animation-config.json
  * To update: pixi run generate-config
  *
  * Calibrated: 2025-10-28
  */
 
+// Production default: warnings and errors only, runtime log compiled out.
+// pixi run upload-debug builds with LOG_LEVEL_DEBUG for decode-log.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_WARN
+#endif
+
 #include <Wire.h>
 #include <Adafruit_PWMServoDriver.h>
+#include <pca9685_batch.h>
+#include <servo_lut.h>
+#include <servo_output.h>
+#include <i2c_bus.h>
+#include <servo_power.h>
+#include <frame_scheduler.h>
+#include <event_log.h>
+#include <log_level.h>
+#include <edge_capture.h>
 #include "animation_config.h"
-
-// Servo driver
-Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(I2C_ADDRESS);
+#include "animation_player.h"
+#include "log_events.h"
+
+// Servo drivers, one per board in BOARD_LIST (animation_config.h)
+#define BOARD_DRIVER(address) Adafruit_PWMServoDriver(address),
+#define BOARD_BATCH(address) PCA9685Batch(address),
+Adafruit_PWMServoDriver pwm[BOARD_COUNT] = {BOARD_LIST(BOARD_DRIVER)};
+PCA9685Batch servoBatch[BOARD_COUNT] = {BOARD_LIST(BOARD_BATCH)};  // Stage a frame's servo writes
+ServoOutput<JOINT_COUNT, BOARD_COUNT> servos(servoBatch);  // JOINTS order
+uint8_t jointTracks[JOINT_COUNT];  // Pose index each joint follows
+I2CBus bus(I2C_CLOCK_HZ, I2C_FRAME_BUDGET_MICROS);  // Per-frame servo write budget
+ServoPower power(CURRENT_BUDGET_MILLIAMPS);  // Estimated servo current per frame
 
 // Animation indices (from animation-config.json order)
 #define ANIM_RESTING 2
@@ -86,88 +155,153 @@ const int triggeredSequence[TRIGGERED_SEQUENCE_LENGTH] = {
 
 // Playback speed multiplier for each step (makes animations faster and jerkier)
 // 1.0 = normal speed, 2.0 = 2x faster (half the duration), 0.3 = very slow (more duration)
-const float triggeredSequenceSpeed[TRIGGERED_SEQUENCE_LENGTH] = {
-  1.0,  // Step 0 - Normal
-  1.0,  // Step 1 - Normal
-  1.0,  // Step 2 - Normal
-  1.0,  // Step 3 - Normal
-  1.0,  // Step 4 - Normal
-  1.0,  // Step 5 - Normal
-  1.0,  // Step 6 - Normal
-  1.5,  // Step 7 - Faster
-  1.5,  // Step 8 - Faster
-  2.0,  // Step 9 - Very fast
-  2.0,  // Step 10 - Very fast
-  2.5,  // Step 11 - Violent/jerky
-  2.5,  // Step 12 - Violent/jerky
-  0.3   // Step 13 - Very slow/exhausted
+// Stored as Q8 fixed point (256 = 1.0x) so playback needs no float math
+const SpeedQ8 triggeredSequenceSpeed[TRIGGERED_SEQUENCE_LENGTH] = {
+  SPEED_Q8(1.0),  // Step 0 - Normal
+  SPEED_Q8(1.0),  // Step 1 - Normal
+  SPEED_Q8(1.0),  // Step 2 - Normal
+  SPEED_Q8(1.0),  // Step 3 - Normal
+  SPEED_Q8(1.0),  // Step 4 - Normal
+  SPEED_Q8(1.0),  // Step 5 - Normal
+  SPEED_Q8(1.0),  // Step 6 - Normal
+  SPEED_Q8(1.5),  // Step 7 - Faster
+  SPEED_Q8(1.5),  // Step 8 - Faster
+  SPEED_Q8(2.0),  // Step 9 - Very fast
+  SPEED_Q8(2.0),  // Step 10 - Very fast
+  SPEED_Q8(2.5),  // Step 11 - Violent/jerky
+  SPEED_Q8(2.5),  // Step 12 - Violent/jerky
+  SPEED_Q8(0.3)   // Step 13 - Very slow/exhausted
 };
 
 // Animation state
 int currentAnimation = ANIM_RESTING;
 unsigned long animationStartTime = 0;
 bool animationActive = true;  // Start immediately with resting
-bool lastTriggerState = HIGH;
 AnimationMode currentMode = MODE_IDLE_CYCLE;
 int triggeredStep = 0;  // Current step in triggered sequence (0-13)
-float playbackSpeed = 1.0;  // Animation playback speed multiplier
+SpeedQ8 playbackSpeed = SPEED_Q8(1.0);  // Animation playback speed multiplier (Q8)
+unsigned long adjustedDuration = 0;  // Wall-clock duration at playbackSpeed
+KeyframeCursor cursor;  // Current keyframe segment of the playing animation
+bool animationBakedFrames = false;  // Playing pre-rendered ticks instead of keyframes
+
+// One pose per servo PWM period (20ms at 50Hz) - the servo can't see more
+FrameScheduler frames(FRAME_PERIOD_MICROS(SERVO_FREQ, 1));
+
+// Trigger edges from the pin change ISR; a press locks out bounce for 20ms
+#define TRIGGER_DEBOUNCE_MICROS 20000UL
+PinEdgeCapture<8> trigger(TRIGGER_DEBOUNCE_MICROS);
+unsigned long triggerMicros = 0;  // When the last press happened (ISR time)
+bool triggerLatencyPending = false;  // Waiting for its first servo write
+unsigned long triggerLatencyLast = 0;  // Press (ISR) to first servo write, us (status)
+unsigned long triggerLatencyMin = 0;
+unsigned long triggerLatencyMax = 0;
+uint16_t triggerLatencyCount = 0;
+
+ISR(PCINT0_vect) {
+  trigger.onPinChange();
+}
 
-// Servo position cache
-int lastLeftShoulder = -1;
-int lastLeftElbow = -1;
-int lastRightShoulder = -1;
-int lastRightElbow = -1;
+// Runtime messages, sent from idle time (drops counted if serial backs up)
+EventLog<LOG_EVENT_CAPACITY(32)> eventLog;
+
+// Function prototypes (arduino-cli generates these; host builds need them)
+void startTriggeredSequence(unsigned long pressMicros);
+void startAnimation(int animIndex);
+void updateAnimation();
+void moveJoints(const AngleQ8* pose);
+void moveJointsTicks(const uint16_t* ticks);
+void flushServos();
+void handleAnimationComplete();
+void printStatus();
 
 void setup() {
   Serial.begin(115200);
-  while (!Serial && millis() < 3000);  // Wait up to 3s for serial
+  if (LogInfo::enabled) {
+    while (!Serial && millis() < 3000);  // Wait up to 3s for serial
+  }
 
-  Serial.println(F("Hatching Egg Spider"));
-  Serial.println(F("==================="));
+  LogInfo::println(F("Hatching Egg Spider"));
+  LogInfo::println(F("==================="));
 
-  // Initialize trigger pin
-  pinMode(TRIGGER_PIN, INPUT_PULLUP);
+  // Initialize trigger pin (INPUT_PULLUP, pin change interrupt)
+  trigger.begin(TRIGGER_PIN);
 
-  // Initialize PWM driver
-  pwm.begin();
-  pwm.setPWMFreq(SERVO_FREQ);
+  // Initialize PWM drivers
+  for (uint8_t b = 0; b < BOARD_COUNT; b++) {
+    pwm[b].begin();
+    pwm[b].setPWMFreq(SERVO_FREQ);
+  }
+  bus.begin();  // After pwm.begin(): Wire.begin() resets SCL to 100 kHz
   delay(10);
+  #define TRACK_CURRENT(idle, fullSpeed, degreesPerSecond) {idle, fullSpeed, degreesPerSecond},
+  const ServoCurrentModel trackCurrent[POSE_JOINTS] = {TRACK_CURRENT_LIST(TRACK_CURRENT)};
+  for (uint8_t j = 0; j < JOINT_COUNT; j++) {
+    ServoCalibration calibration = {(const uint16_t*)pgm_read_ptr(&JOINTS[j].pulses), JOINT_MAX_DEGREES};
+    servos.attach(j, pgm_read_byte(&JOINTS[j].board), pgm_read_byte(&JOINTS[j].channel), calibration);
+    jointTracks[j] = pgm_read_byte(&JOINTS[j].track);
+    servos.setLowPriority(j, LOW_PRIORITY_TRACKS & (1 << jointTracks[j]));
+    servos.setCurrentModel(j, trackCurrent[jointTracks[j]], SERVO_FREQ);
+  }
+  servos.setPower(power);
 
-  Serial.print(F("Animations: "));
-  Serial.println(ANIMATION_COUNT);
+  LogInfo::print(F("Animations: "));
+  LogInfo::println(ANIMATION_COUNT);
 
-  Serial.println(F("Mode: Idle Cycle (resting <-> slow_struggle)"));
-  Serial.println(F("Trigger: 14-step sequence with progressive speed:"));
-  Serial.println(F("  Steps 1-7: Normal speed"));
-  Serial.println(F("  Steps 8-9: 1.5x faster"));
-  Serial.println(F("  Steps 10-11: 2.0x very fast"));
-  Serial.println(F("  Steps 12-13: 2.5x violent/jerky"));
-  Serial.println(F("  Step 14: 0.3x very slow/exhausted"));
-  Serial.println();
+  LogInfo::println(F("Mode: Idle Cycle (resting <-> slow_struggle)"));
+  LogInfo::println(F("Trigger: 14-step sequence with progressive speed:"));
+  LogInfo::println(F("  Steps 1-7: Normal speed"));
+  LogInfo::println(F("  Steps 8-9: 1.5x faster"));
+  LogInfo::println(F("  Steps 10-11: 2.0x very fast"));
+  LogInfo::println(F("  Steps 12-13: 2.5x violent/jerky"));
+  LogInfo::println(F("  Step 14: 0.3x very slow/exhausted"));
+  LogInfo::println(F("Log: binary events from here on (pixi run decode-log)"));
+  LogInfo::println();
 
   // Start with resting animation
   startAnimation(ANIM_RESTING);
 }
 
 void loop() {
-  // Check trigger button
-  bool triggerState = digitalRead(TRIGGER_PIN);
-
-  if (triggerState == LOW && lastTriggerState == HIGH) {
-    // Trigger pressed - start triggered sequence
-    Serial.println(F("TRIGGERED! Starting 14-step sequence with progressive speed..."));
-    currentMode = MODE_TRIGGERED;
-    triggeredStep = 0;
-    playbackSpeed = triggeredSequenceSpeed[0];  // Set speed for first animation
-    startAnimation(triggeredSequence[0]);
+  // Debounced trigger edges queued by the ISR since the last pass
+  PinEdge edge;
+  while (trigger.poll(edge)) {
+    if (edge.level == LOW) {
+      startTriggeredSequence(edge.micros);
+    }
   }
 
-  lastTriggerState = triggerState;
+  // Status request from the serial monitor ('s'), whatever the log level
+  while (Serial.available()) {
+    if (Serial.read() == 's') printStatus();
+  }
 
-  // Update animation
-  if (animationActive) {
+  // Update animation once per frame
+  if (animationActive && frames.beginFrame()) {
+    bus.beginFrame();
     updateAnimation();
+    frames.endFrame();
   }
+
+  // Send queued log records the USB buffer has room for, then sleep until
+  // the next timer tick or trigger edge
+  if (LogInfo::enabled) eventLog.drain(Serial);
+  frames.idle();
+}
+
+void startTriggeredSequence(unsigned long pressMicros) {
+  LogInfo::event(eventLog, EVT_TRIGGERED);
+  if (LogDebug::enabled) frames.logStats(eventLog, EVT_IDLE_FRAMES);
+  if (LogDebug::enabled) bus.logStats(eventLog, EVT_IDLE_BUS);
+  if (LogDebug::enabled) power.logStats(eventLog, EVT_IDLE_POWER);
+  frames.resetStats();
+  bus.resetStats();
+  power.resetStats();
+  currentMode = MODE_TRIGGERED;
+  triggeredStep = 0;
+  playbackSpeed = triggeredSequenceSpeed[0];  // Set speed for first animation
+  triggerMicros = pressMicros;
+  triggerLatencyPending = true;
+  startAnimation(triggeredSequence[0]);
 }
 
 void startAnimation(int animIndex) {
@@ -178,123 +312,95 @@ void startAnimation(int animIndex) {
   currentAnimation = animIndex;
   animationStartTime = millis();
   animationActive = true;
+  frames.restart();  // First pose goes out immediately
 
-  // Read animation name from PROGMEM
-  char name[64];  // Increased from 32 to 64 bytes
-  strcpy_P(name, (char*)pgm_read_ptr(&(ANIMATIONS[animIndex].name)));
+  // At 2x speed, animation finishes in half the time (one divide per start)
+  unsigned long duration = pgm_read_word(&(ANIMATIONS[animIndex].duration_ms));
+  adjustedDuration = scaleDuration(duration, playbackSpeed);
 
-  Serial.print(F("Starting: "));
-  Serial.println(name);
+  // Baked animations are a frame table; the rest rewind the keyframe cursor
+  animationBakedFrames = animationBaked(&ANIMATIONS[animIndex]);
+  if (!animationBakedFrames) {
+    cursorReset(&cursor, &ANIMATIONS[animIndex]);
+  }
+
+  LogInfo::event(eventLog, EVT_ANIM_START, animIndex);  // Decoder prints the name
 }
 
 void updateAnimation() {
-  // Read animation from PROGMEM
-  unsigned long duration = pgm_read_dword(&(ANIMATIONS[currentAnimation].duration_ms));
-  bool loop = pgm_read_byte(&(ANIMATIONS[currentAnimation].loop));
-
-  // Calculate elapsed time with playback speed multiplier
-  // Higher speed = faster playback (elapsed time passes faster)
   unsigned long realElapsed = millis() - animationStartTime;
-  unsigned long elapsed = (unsigned long)(realElapsed * playbackSpeed);
 
-  // Adjust duration check for playback speed
-  // At 2x speed, animation finishes in half the time
-  unsigned long adjustedDuration = (unsigned long)(duration / playbackSpeed);
-
-  // Check if animation finished
+  // Check if animation finished (adjustedDuration set in startAnimation)
   if (realElapsed >= adjustedDuration) {
     // Animation complete - determine next animation
     handleAnimationComplete();
     return;
   }
 
-  // Interpolate between keyframes
-  int kfCount = pgm_read_word(&(ANIMATIONS[currentAnimation].keyframe_count));
-  const Keyframe* keyframes = (const Keyframe*)pgm_read_ptr(&(ANIMATIONS[currentAnimation].keyframes));
-
-  // Find surrounding keyframes
-  int kf1 = 0;
-  int kf2 = 1;
-
-  for (int i = 0; i < kfCount - 1; i++) {
-    unsigned long t1 = pgm_read_dword(&(keyframes[i].time_ms));
-    unsigned long t2 = pgm_read_dword(&(keyframes[i + 1].time_ms));
+  // Calculate elapsed time with playback speed multiplier
+  // Higher speed = faster playback (elapsed time passes faster)
+  unsigned long elapsed = scaleElapsed(realElapsed, playbackSpeed);
 
-    if (elapsed >= t1 && elapsed < t2) {
-      kf1 = i;
-      kf2 = i + 1;
-      break;
-    }
+  if (animationBakedFrames) {
+    // Pre-rendered PCA9685 ticks for this frame: no interpolation or mapping
+    uint16_t ticks[POSE_JOINTS];
+    bakedPose(&ANIMATIONS[currentAnimation], elapsed, ticks);
+    moveJointsTicks(ticks);
+    return;
   }
 
-  // Read keyframe data
-  unsigned long t1 = pgm_read_dword(&(keyframes[kf1].time_ms));
-  unsigned long t2 = pgm_read_dword(&(keyframes[kf2].time_ms));
-
-  int ls1 = pgm_read_word(&(keyframes[kf1].left_shoulder_deg));
-  int le1 = pgm_read_word(&(keyframes[kf1].left_elbow_deg));
-  int rs1 = pgm_read_word(&(keyframes[kf1].right_shoulder_deg));
-  int re1 = pgm_read_word(&(keyframes[kf1].right_elbow_deg));
-
-  int ls2 = pgm_read_word(&(keyframes[kf2].left_shoulder_deg));
-  int le2 = pgm_read_word(&(keyframes[kf2].left_elbow_deg));
-  int rs2 = pgm_read_word(&(keyframes[kf2].right_shoulder_deg));
-  int re2 = pgm_read_word(&(keyframes[kf2].right_elbow_deg));
+  // Advance to the current segment (endpoints cached in the cursor)
+  cursorSeek(&cursor, elapsed);
 
-  // Interpolate
-  float t = (float)(elapsed - t1) / (float)(t2 - t1);
-  t = constrain(t, 0.0, 1.0);
-
-  int leftShoulder = ls1 + (int)((ls2 - ls1) * t);
-  int leftElbow = le1 + (int)((le2 - le1) * t);
-  int rightShoulder = rs1 + (int)((rs2 - rs1) * t);
-  int rightElbow = re1 + (int)((re2 - re1) * t);
+  // Interpolate (Q15 fraction, constrained to 0-1) to sub-degree angles
+  AngleQ8 pose[POSE_JOINTS];
+  cursorPoseQ8(&cursor, elapsed, pose);
 
   // Move servos
-  moveLegs(leftShoulder, leftElbow, rightShoulder, rightElbow);
+  moveJoints(pose);
 }
 
-void moveLegs(int leftShoulder, int leftElbow, int rightShoulder, int rightElbow) {
-  // Only move servos if position changed (reduce jitter)
-  if (leftShoulder != lastLeftShoulder) {
-    setServo(LEFT_SHOULDER_CHANNEL, leftShoulder, LEFT_SHOULDER_MIN_PULSE, LEFT_SHOULDER_MAX_PULSE);
-    lastLeftShoulder = leftShoulder;
-  }
-
-  if (leftElbow != lastLeftElbow) {
-    setServo(LEFT_ELBOW_CHANNEL, leftElbow, LEFT_ELBOW_MIN_PULSE, LEFT_ELBOW_MAX_PULSE);
-    lastLeftElbow = leftElbow;
-  }
-
-  if (rightShoulder != lastRightShoulder) {
-    setServo(RIGHT_SHOULDER_CHANNEL, rightShoulder, RIGHT_SHOULDER_MIN_PULSE, RIGHT_SHOULDER_MAX_PULSE);
-    lastRightShoulder = rightShoulder;
-  }
+void moveJoints(const AngleQ8* pose) {
+  // Q8 degrees (0-90°, clamped) through each joint's calibrated table.
+  // Interpolating between table entries uses every tick of the range, and
+  // a servo is only staged when its pulse moves by at least one tick.
+  for (uint8_t j = 0; j < JOINT_COUNT; j++) servos.writeQ8(j, pose[jointTracks[j]]);
+  flushServos();
+}
 
-  if (rightElbow != lastRightElbow) {
-    setServo(RIGHT_ELBOW_CHANNEL, rightElbow, RIGHT_ELBOW_MIN_PULSE, RIGHT_ELBOW_MAX_PULSE);
-    lastRightElbow = rightElbow;
-  }
+void moveJointsTicks(const uint16_t* ticks) {
+  // Same joints and cache as moveJoints(), pulses already in ticks
+  for (uint8_t j = 0; j < JOINT_COUNT; j++) servos.writeTicks(j, ticks[jointTracks[j]]);
+  flushServos();
 }
 
-void setServo(int channel, int degrees, int minPulse, int maxPulse) {
-  // Convert degrees (0-90°) to pulse width
-  // Calibrated ranges support 0-90° movement
-  degrees = constrain(degrees, 0, 90);
-  int pulse = map(degrees, 0, 90, minPulse, maxPulse);
-  pwm.setPWM(channel, 0, pulse);
+void flushServos() {
+  // Send all changed channels together, board by board (first egg's legs
+  // on 0/1 and 14/15), within the frame's bus budget
+  unsigned long flushMicros = micros();
+  if (servos.flush(bus) == 0 || !triggerLatencyPending) return;
+
+  // First servo write since the press: trigger-to-motion latency
+  triggerLatencyPending = false;
+  unsigned long latency = flushMicros - triggerMicros;
+  triggerLatencyLast = latency;
+  if (triggerLatencyCount == 0 || latency < triggerLatencyMin) triggerLatencyMin = latency;
+  if (latency > triggerLatencyMax) triggerLatencyMax = latency;
+  if (triggerLatencyCount != 0xFFFF) triggerLatencyCount++;
+  LogInfo::event(eventLog, EVT_TRIGGER_LATENCY, 0, trigger.bounces(),
+                 latency > 0xFFFF ? 0xFFFF : (uint16_t)latency);
 }
 
 void handleAnimationComplete() {
-  Serial.println(F("Animation complete"));
+  LogInfo::event(eventLog, EVT_ANIM_COMPLETE, currentAnimation);
 
   if (currentMode == MODE_IDLE_CYCLE) {
     // Cycle between resting and slow_struggle
     if (currentAnimation == ANIM_RESTING) {
-      Serial.println(F("-> slow_struggle"));
+      LogInfo::event(eventLog, EVT_IDLE_NEXT, ANIM_SLOW_STRUGGLE);
       startAnimation(ANIM_SLOW_STRUGGLE);
     } else {
-      Serial.println(F("-> resting"));
+      LogInfo::event(eventLog, EVT_IDLE_NEXT, ANIM_RESTING);
       startAnimation(ANIM_RESTING);
     }
   } else {
@@ -305,28 +411,42 @@ void handleAnimationComplete() {
       // Continue to next step in sequence
       int nextAnim = triggeredSequence[triggeredStep];
       playbackSpeed = triggeredSequenceSpeed[triggeredStep];  // Set speed for this step
-
-      // Print animation name and speed for next step
-      char name[64];
-      strcpy_P(name, (char*)pgm_read_ptr(&(ANIMATIONS[nextAnim].name)));
-      Serial.print(F("-> Step "));
-      Serial.print(triggeredStep + 1);
-      Serial.print(F("/"));
-      Serial.print(TRIGGERED_SEQUENCE_LENGTH);
-      Serial.print(F(": "));
-      Serial.print(name);
-      Serial.print(F(" ("));
-      Serial.print(playbackSpeed);
-      Serial.println(F("x speed)"));
+      LogInfo::event(eventLog, EVT_STEP, triggeredStep + 1, playbackSpeed, nextAnim);
 
       startAnimation(nextAnim);
     } else {
       // Sequence complete, return to idle
-      Serial.println(F("-> Sequence complete, back to idle cycle (resting)"));
+      LogInfo::event(eventLog, EVT_SEQUENCE_DONE);
+      if (LogDebug::enabled) frames.logStats(eventLog, EVT_TRIGGERED_FRAMES);
+      if (LogDebug::enabled) bus.logStats(eventLog, EVT_TRIGGERED_BUS);
+      if (LogDebug::enabled) power.logStats(eventLog, EVT_TRIGGERED_POWER);
+      frames.resetStats();
+      bus.resetStats();
+      power.resetStats();
       currentMode = MODE_IDLE_CYCLE;
       triggeredStep = 0;
-      playbackSpeed = 1.0;  // Reset to normal speed for idle animations
+      playbackSpeed = SPEED_Q8(1.0);  // Reset to normal speed for idle animations
       startAnimation(ANIM_RESTING);
     }
   }
 }
+
+// Serial status ('s'): plain text, so it works in the production build
+void printStatus() {
+  Serial.print(F("Trigger-to-servo: "));
+  if (triggerLatencyCount == 0) {
+    Serial.println(F("no presses yet"));
+  } else {
+    Serial.print(triggerLatencyLast);
+    Serial.print(F(" us (min "));
+    Serial.print(triggerLatencyMin);
+    Serial.print(F(", max "));
+    Serial.print(triggerLatencyMax);
+    Serial.print(F(", "));
+    Serial.print(triggerLatencyCount);
+    Serial.println(F(" presses)"));
+  }
+
+  // Bus counters since the idle cycle or triggered sequence started
+  bus.printStats(Serial);
+}
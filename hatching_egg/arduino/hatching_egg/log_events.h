@@ -0,0 +1,31 @@
+/*
+ * Event Log Codes - hatching_egg.ino
+ *
+ * Everything the sketch reports while animating goes through the binary
+ * event log (event_log.h); the text lives only here, for the host decoder
+ * (pixi run decode-log, and the host sim). {a:name} is an animation index.
+ */
+
+#ifndef HATCHING_EGG_LOG_EVENTS_H
+#define HATCHING_EGG_LOG_EVENTS_H
+
+#include <event_log.h>
+
+#define HATCHING_EGG_EVENTS(X) \
+  X(EVT_TRIGGERED, 0x10, "TRIGGERED! Starting 14-step sequence with progressive speed...") \
+  X(EVT_IDLE_FRAMES, 0x11, "Idle Frames: {b} ({c} skipped)") \
+  X(EVT_ANIM_START, 0x12, "Starting: {a:name}") \
+  X(EVT_ANIM_COMPLETE, 0x13, "Animation complete") \
+  X(EVT_IDLE_NEXT, 0x14, "-> {a:name}") \
+  X(EVT_STEP, 0x15, "-> Step {a}/14: {c:name} ({b:q8}x speed)") \
+  X(EVT_SEQUENCE_DONE, 0x16, "-> Sequence complete, back to idle cycle (resting)") \
+  X(EVT_TRIGGERED_FRAMES, 0x17, "Triggered Frames: {b} ({c} skipped)") \
+  X(EVT_TRIGGER_LATENCY, 0x18, "Trigger-to-servo latency: {c}us ({b} bounce edges ignored so far)") \
+  X(EVT_IDLE_BUS, 0x19, "Idle I2C at {a}00 kHz: {b} frames, {c} bytes/frame") \
+  X(EVT_TRIGGERED_BUS, 0x1A, "Triggered I2C at {a}00 kHz: {b} frames, {c} bytes/frame") \
+  X(EVT_IDLE_POWER, 0x1B, "Idle servo current: avg {b} mA, peak {c} mA") \
+  X(EVT_TRIGGERED_POWER, 0x1C, "Triggered servo current: avg {b} mA, peak {c} mA")
+
+enum { HATCHING_EGG_EVENTS(EVENT_LOG_ENUM) };
+
+#endif // HATCHING_EGG_LOG_EVENTS_H
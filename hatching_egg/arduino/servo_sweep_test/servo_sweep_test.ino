@@ -21,7 +21,9 @@
 
 #include <Wire.h>
 #include <Adafruit_PWMServoDriver.h>
-#include "servo_mapping.h"
+#include <pca9685_batch.h>
+#include <servo_output.h>
+#include <servo_mapping.h>
 #include "servo_sweep_test_logic.h"
 
 #define PCA9685_ADDRESS 0x40
@@ -30,6 +32,8 @@
 #define SERVO_COUNT 4
 
 Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(PCA9685_ADDRESS);
+PCA9685Batch servoBatch(PCA9685_ADDRESS);
+ServoOutput<SERVO_COUNT> servos(servoBatch);  // Indexed by SERVO_RIGHT_ELBOW etc.
 
 // Sweep state for all 4 servos
 ServoSweepState sweepStates[SERVO_COUNT];
@@ -81,9 +85,10 @@ void setup() {
   pwm.setPWMFreq(SERVO_FREQ);
   delay(100);
 
-  // Initialize sweep states (all enabled)
+  // Initialize sweep states (all enabled) and each servo's channel and calibration
   for (int i = 0; i < SERVO_COUNT; i++) {
     sweepStates[i] = initSweepState(true);
+    servos.attach(i, getServoChannel(i), getServoCalibration(i));
   }
 
   // Move all to starting position (0°)
@@ -149,21 +154,11 @@ void loop() {
 }
 
 void updateServoPositions() {
-  // Right Elbow (CH0)
-  int pwm0 = getSweepPWM(SERVO_RIGHT_ELBOW, sweepStates[SERVO_RIGHT_ELBOW].currentAngle);
-  pwm.setPWM(CH_RIGHT_ELBOW, 0, pwm0);
-
-  // Right Shoulder (CH1)
-  int pwm1 = getSweepPWM(SERVO_RIGHT_SHOULDER, sweepStates[SERVO_RIGHT_SHOULDER].currentAngle);
-  pwm.setPWM(CH_RIGHT_SHOULDER, 0, pwm1);
-
-  // Left Shoulder (CH14)
-  int pwm14 = getSweepPWM(SERVO_LEFT_SHOULDER, sweepStates[SERVO_LEFT_SHOULDER].currentAngle);
-  pwm.setPWM(CH_LEFT_SHOULDER, 0, pwm14);
-
-  // Left Elbow (CH15)
-  int pwm15 = getSweepPWM(SERVO_LEFT_ELBOW, sweepStates[SERVO_LEFT_ELBOW].currentAngle);
-  pwm.setPWM(CH_LEFT_ELBOW, 0, pwm15);
+  // Same PWM as getSweepPWM() (the calibrated tables), all four in one flush
+  for (int i = 0; i < SERVO_COUNT; i++) {
+    servos.write(i, sweepStates[i].currentAngle);
+  }
+  servos.flush();
 }
 
 void printCurrentState() {
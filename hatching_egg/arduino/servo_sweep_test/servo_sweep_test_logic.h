@@ -9,7 +9,7 @@
 #define SERVO_SWEEP_TEST_LOGIC_H
 
 // Include servo mapping for per-servo ranges
-#include "servo_mapping.h"
+#include <servo_mapping.h>
 
 // Sweep parameters
 #define SWEEP_STEP_DEGREES 5     // Move in 5° increments
@@ -9,12 +9,7 @@
 #define SERVO_SWEEP_TEST_LOGIC_H
 
 // Include servo mapping for per-servo ranges
-#ifdef ARDUINO
-#include "../servo_mapping.h"
-#else
-// For local testing, include with correct path
-#include "servo_mapping.h"
-#endif
+#include <servo_mapping.h>
 
 // Sweep parameters
 #define SWEEP_STEP_DEGREES 5     // Move in 5° increments
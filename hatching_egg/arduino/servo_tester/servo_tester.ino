@@ -14,6 +14,9 @@
 
 #include <Wire.h>
 #include <Adafruit_PWMServoDriver.h>
+#include <pca9685_batch.h>
+#include <servo_lut.h>
+#include <servo_output.h>
 #include "servo_tester_logic.h"  // TESTED logic functions
 
 #define PCA9685_ADDRESS 0x40
@@ -21,6 +24,11 @@
 #define LED_PIN 13
 
 Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(PCA9685_ADDRESS);
+PCA9685Batch servoBatch(PCA9685_ADDRESS);
+ServoOutput<4> servos(servoBatch);
+
+// Calibration tool: every servo gets the whole safe window (0-180° = 150-600)
+typedef ServoPulseTable<SAFE_ZERO_PWM, SAFE_MAX_PWM, 180> SafeWindowTable;
 
 // Current positions (PWM values)
 int positions[4] = {SAFE_ZERO_PWM, SAFE_ZERO_PWM, SAFE_ZERO_PWM, SAFE_ZERO_PWM};
@@ -45,6 +53,9 @@ void setup() {
   pwm.begin();
   pwm.setPWMFreq(SERVO_FREQ);
   delay(100);
+  for (int i = 0; i < 4; i++) {
+    servos.attach(i, getChannel(i), SERVO_CALIBRATION(SafeWindowTable));
+  }
   
   // Set all to safe zero (PWM 150)
   Serial.println(F("Setting all servos to SAFE ZERO (PWM 150)..."));
@@ -138,10 +149,11 @@ void adjustServo(int delta) {
 }
 
 void setServoPWM(int servo, int pwmValue) {
-  // Use TESTED getChannel function
-  int channel = getChannel(servo);
-  if (channel >= 0) {
-    pwm.setPWM(channel, 0, pwmValue);
+  // Channels attached with the TESTED getChannel function; PWM clamped to
+  // the safe window
+  if (isValidServoIndex(servo)) {
+    servos.writeTicks(servo, pwmValue);
+    servos.flush();
   }
 }
 
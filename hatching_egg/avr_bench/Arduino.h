@@ -0,0 +1,16 @@
+/*
+ * Minimal Arduino.h for building kernels with bare avr-gcc (bench_avr.py)
+ *
+ * The benchmarked headers only need the fixed-width types and PROGMEM
+ * access; pulling in the real core would add its init code and ISRs to
+ * every measurement.
+ */
+
+#ifndef AVR_BENCH_ARDUINO_H
+#define AVR_BENCH_ARDUINO_H
+
+#include <stdint.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#endif // AVR_BENCH_ARDUINO_H
@@ -0,0 +1,26 @@
+/*
+ * Minimal Wire.h for building kernels with bare avr-gcc (bench_avr.py)
+ *
+ * Declarations only, with the AVR core's signatures: the kernels are
+ * compiled, never linked, so a PCA9685Batch flush shows up as calls into
+ * Wire without the TWI driver's own code in its count.
+ */
+
+#ifndef AVR_BENCH_WIRE_H
+#define AVR_BENCH_WIRE_H
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32
+
+class TwoWire {
+ public:
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(void);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t* data, size_t quantity);
+};
+
+extern TwoWire Wire;
+
+#endif // AVR_BENCH_WIRE_H
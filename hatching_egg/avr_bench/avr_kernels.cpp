@@ -0,0 +1,102 @@
+/*
+ * AVR Kernels - bench_kernels.cpp's Calls as Standalone Functions
+ *
+ * Compiled by bench_avr.py with avr-gcc -mmcu=atmega32u4 -Os (the Arduino
+ * IDE's flags). Each kernel is a noinline extern "C" function with
+ * everything it calls inlined (flatten), so its code size and instructions
+ * can be read straight from the object file; only libgcc helpers (32-bit
+ * multiply/divide) and Wire (avr_bench/Wire.h) stay calls. Nothing calls
+ * the kernels; this is never linked into a sketch.
+ */
+
+#include "Arduino.h"
+#include "servo_lut.h"
+#include "servo_output.h"
+#include "xorshift_random.h"
+#include "../arduino/servo_sweep_test/servo_sweep_test_logic.h"
+#include "../arduino/hatching_egg/animation_player.h"
+
+#define KERNEL extern "C" __attribute__((noinline, used, flatten))
+
+typedef ServoPulseTable<RIGHT_ELBOW_MIN_PULSE, RIGHT_ELBOW_MAX_PULSE> RightElbowTable;
+
+// Servo Mapping
+KERNEL int kernel_degreesToPWM(int degrees, int servoIndex) {
+  return degreesToPWM(degrees, servoIndex);
+}
+
+KERNEL bool kernel_isPWMSafe(int pwm, int servoIndex) {
+  return isPWMSafe(pwm, servoIndex);
+}
+
+KERNEL bool kernel_updateSweepState(ServoSweepState* state) {
+  return updateSweepState(state);
+}
+
+// Servo Tables
+KERNEL uint16_t kernel_tableLookup(int degrees) {
+  return RightElbowTable::lookup(degrees);
+}
+
+KERNEL uint16_t kernel_tableLookupQ8(uint16_t degreesQ8) {
+  return RightElbowTable::lookupQ8(degreesQ8);
+}
+
+// Keyframe Lookup and Interpolation
+KERNEL uint16_t kernel_segmentFraction(uint32_t elapsed, uint32_t t1, uint32_t t2) {
+  return segmentFraction(elapsed, t1, t2);
+}
+
+KERNEL uint16_t kernel_trackFraction(const TrackCursor* track, uint32_t elapsed) {
+  return trackFraction(track, elapsed);
+}
+
+KERNEL AngleQ8 kernel_lerpQ15Q8(uint8_t a, uint8_t b, uint16_t frac) {
+  return lerpQ15Q8(a, b, frac);
+}
+
+KERNEL void kernel_cursorSeek(KeyframeCursor* cursor, uint32_t elapsed) {
+  cursorSeek(cursor, elapsed);
+}
+
+KERNEL void kernel_cursorPoseQ8(const KeyframeCursor* cursor, uint32_t elapsed, AngleQ8* pose) {
+  cursorPoseQ8(cursor, elapsed, pose);
+}
+
+KERNEL void kernel_bakedPose(const Animation* animation, uint32_t elapsed, uint16_t* ticks) {
+  bakedPose(animation, elapsed, ticks);
+}
+
+KERNEL uint32_t kernel_scaleElapsed(uint32_t realElapsedMs, SpeedQ8 speed) {
+  return scaleElapsed(realElapsedMs, speed);
+}
+
+// Servo Output: one hatching_egg frame, staged and sent
+KERNEL bool kernel_servoOutputWriteQ8(ServoOutput<4>* servos, uint16_t degreesQ8) {
+  return servos->writeQ8(0, degreesQ8);
+}
+
+KERNEL uint8_t kernel_servoOutputFrame(ServoOutput<4>* servos, const uint16_t* poseQ8) {
+  for (uint8_t i = 0; i < 4; i++) servos->writeQ8(i, poseQ8[i]);
+  return servos->flush();
+}
+
+// Random Numbers
+KERNEL uint32_t kernel_xorshiftNext(XorshiftRandom* rng) {
+  return rng->next();
+}
+
+KERNEL uint16_t kernel_xorshiftBelow(XorshiftRandom* rng, uint16_t n) {
+  return rng->below(n);
+}
+
+// What Arduino random(min, max) costs: avr-libc's random() (Park-Miller,
+// Schrage's method) written out so its divides show up, then the modulo
+KERNEL long kernel_parkMillerRange(int32_t* state, long min, long max) {
+  int32_t hi = *state / 127773L;
+  int32_t lo = *state % 127773L;
+  int32_t x = 16807L * lo - 2836L * hi;
+  if (x < 0) x += 0x7FFFFFFFL;
+  *state = x;
+  return x % (max - min) + min;
+}
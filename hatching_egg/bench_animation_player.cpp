@@ -0,0 +1,298 @@
+/*
+ * Benchmark: Float vs Fixed-Point updateAnimation() Math
+ *
+ * Times the pose computation from updateAnimation() over every animation at
+ * every triggered-sequence speed:
+ *   - float:  the original code (float speed, float t, float lerp)
+ *   - fixed:  Q8 speed, Q15 fraction, integer lerp, linear keyframe scan
+ *   - cursor: fixed-point plus the keyframe cursor over the packed
+ *             PROGMEM format
+ *   - live:   cursor in Q8 degrees plus the servo table lookup, i.e. the
+ *             sketch's live path all the way to PCA9685 ticks
+ *   - baked:  the sketch's baked path (pre-rendered ticks per frame), with
+ *             every animation baked for the comparison
+ *
+ * Host numbers understate the gap - x86 has an FPU, the ATmega32U4 does
+ * not - but they catch regressions and show relative cost.
+ *
+ * Build and run:
+ *   pixi run bench
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#endif
+
+#include "Arduino.h"
+#include "servo_lut.h"
+#define ANIMATION_CONFIG_LIVE_TABLE
+#include "arduino/hatching_egg/animation_player.h"
+
+typedef ServoPulseTable<LEFT_SHOULDER_MIN_PULSE, LEFT_SHOULDER_MAX_PULSE> LeftShoulderTable;
+typedef ServoPulseTable<LEFT_ELBOW_MIN_PULSE, LEFT_ELBOW_MAX_PULSE> LeftElbowTable;
+typedef ServoPulseTable<RIGHT_SHOULDER_MIN_PULSE, RIGHT_SHOULDER_MAX_PULSE> RightShoulderTable;
+typedef ServoPulseTable<RIGHT_ELBOW_MIN_PULSE, RIGHT_ELBOW_MAX_PULSE> RightElbowTable;
+
+// Unpacked keyframes, as the float/fixed scan versions stored them
+struct Keyframe {
+  unsigned long time_ms;
+  int left_shoulder_deg;
+  int left_elbow_deg;
+  int right_shoulder_deg;
+  int right_elbow_deg;
+};
+
+struct Unpacked {
+  unsigned long duration_ms;
+  int keyframe_count;
+  std::vector<Keyframe> keyframes;
+};
+
+static std::vector<Unpacked> unpacked;
+
+// Bench animations are all dense; expand them once up front
+static void unpackAnimations() {
+  for (int i = 0; i < ANIMATION_COUNT; i++) {
+    const Animation& anim = LIVE_ANIMATIONS[i];
+    Unpacked u{anim.duration_ms, anim.keyframe_count, {}};
+    const uint8_t* p = anim.data;
+    unsigned long time = 0;
+    for (int k = 0; k < anim.keyframe_count; k++, p += DENSE_KEY_BYTES) {
+      time += p[0] | (p[1] << 8);
+      u.keyframes.push_back(Keyframe{time, p[2], p[3], p[4], p[5]});
+    }
+    unpacked.push_back(u);
+  }
+}
+
+struct Pose {
+  int ls, le, rs, re;
+};
+
+struct Sample {
+  int anim;
+  unsigned long realElapsed;
+  float speed;
+  SpeedQ8 speedQ8;
+};
+
+static volatile int sink;
+
+// Original float implementation (per update: speed multiply, duration divide, t divide)
+static bool updateFloat(const Sample& s, Pose* pose) {
+  const Unpacked& anim = unpacked[s.anim];
+  unsigned long elapsed = (unsigned long)(s.realElapsed * s.speed);
+  unsigned long adjustedDuration = (unsigned long)(anim.duration_ms / s.speed);
+  if (s.realElapsed >= adjustedDuration) return false;
+
+  int kf1 = 0, kf2 = 1;
+  for (int i = 0; i < anim.keyframe_count - 1; i++) {
+    if (elapsed >= anim.keyframes[i].time_ms && elapsed < anim.keyframes[i + 1].time_ms) {
+      kf1 = i;
+      kf2 = i + 1;
+      break;
+    }
+  }
+  const Keyframe& a = anim.keyframes[kf1];
+  const Keyframe& b = anim.keyframes[kf2];
+  float t = (float)(elapsed - a.time_ms) / (float)(b.time_ms - a.time_ms);
+  if (t < 0.0f) t = 0.0f;
+  if (t > 1.0f) t = 1.0f;
+  pose->ls = a.left_shoulder_deg + (int)((b.left_shoulder_deg - a.left_shoulder_deg) * t);
+  pose->le = a.left_elbow_deg + (int)((b.left_elbow_deg - a.left_elbow_deg) * t);
+  pose->rs = a.right_shoulder_deg + (int)((b.right_shoulder_deg - a.right_shoulder_deg) * t);
+  pose->re = a.right_elbow_deg + (int)((b.right_elbow_deg - a.right_elbow_deg) * t);
+  return true;
+}
+
+// Fixed-point implementation (adjustedDuration is computed once per start in the sketch)
+static bool updateFixed(const Sample& s, uint32_t adjustedDuration, Pose* pose) {
+  const Unpacked& anim = unpacked[s.anim];
+  if (s.realElapsed >= adjustedDuration) return false;
+  uint32_t elapsed = scaleElapsed(s.realElapsed, s.speedQ8);
+
+  int kf1 = 0, kf2 = 1;
+  for (int i = 0; i < anim.keyframe_count - 1; i++) {
+    if (elapsed >= anim.keyframes[i].time_ms && elapsed < anim.keyframes[i + 1].time_ms) {
+      kf1 = i;
+      kf2 = i + 1;
+      break;
+    }
+  }
+  const Keyframe& a = anim.keyframes[kf1];
+  const Keyframe& b = anim.keyframes[kf2];
+  uint16_t t = segmentFraction(elapsed, a.time_ms, b.time_ms);
+  pose->ls = lerpQ15(a.left_shoulder_deg, b.left_shoulder_deg, t);
+  pose->le = lerpQ15(a.left_elbow_deg, b.left_elbow_deg, t);
+  pose->rs = lerpQ15(a.right_shoulder_deg, b.right_shoulder_deg, t);
+  pose->re = lerpQ15(a.right_elbow_deg, b.right_elbow_deg, t);
+  return true;
+}
+
+// Fixed-point with the keyframe cursor (cursor reset on each animation start)
+static bool updateCursor(const Sample& s, uint32_t adjustedDuration, KeyframeCursor* cursor, Pose* pose) {
+  if (s.realElapsed >= adjustedDuration) return false;
+  uint32_t elapsed = scaleElapsed(s.realElapsed, s.speedQ8);
+  cursorSeek(cursor, elapsed);
+  int angles[POSE_JOINTS];
+  cursorPose(cursor, elapsed, angles);
+  pose->ls = angles[0];
+  pose->le = angles[1];
+  pose->rs = angles[2];
+  pose->re = angles[3];
+  return true;
+}
+
+static void liveTicks(const KeyframeCursor* cursor, uint32_t elapsed, uint16_t* ticks) {
+  AngleQ8 angles[POSE_JOINTS];
+  cursorPoseQ8(cursor, elapsed, angles);
+  ticks[0] = LeftShoulderTable::lookupQ8(angles[0]);
+  ticks[1] = LeftElbowTable::lookupQ8(angles[1]);
+  ticks[2] = RightShoulderTable::lookupQ8(angles[2]);
+  ticks[3] = RightElbowTable::lookupQ8(angles[3]);
+}
+
+// Live path to PCA9685 ticks (what updateAnimation() does for live animations)
+static bool updateLive(const Sample& s, uint32_t adjustedDuration, KeyframeCursor* cursor, Pose* pose) {
+  if (s.realElapsed >= adjustedDuration) return false;
+  uint32_t elapsed = scaleElapsed(s.realElapsed, s.speedQ8);
+  cursorSeek(cursor, elapsed);
+  uint16_t ticks[POSE_JOINTS];
+  liveTicks(cursor, elapsed, ticks);
+  pose->ls = ticks[0];
+  pose->le = ticks[1];
+  pose->rs = ticks[2];
+  pose->re = ticks[3];
+  return true;
+}
+
+// Every animation baked like generate_arduino_config.py does (test_animation_player
+// checks the generator's frames against this same live path)
+struct Baked {
+  std::vector<uint8_t> frames;
+  Animation anim;
+};
+
+static std::vector<Baked> baked;
+
+static void bakeAnimations() {
+  const uint16_t bases[POSE_JOINTS] = {BAKE_TICK_BASE_LEFT_SHOULDER, BAKE_TICK_BASE_LEFT_ELBOW,
+                                       BAKE_TICK_BASE_RIGHT_SHOULDER, BAKE_TICK_BASE_RIGHT_ELBOW};
+  baked.resize(ANIMATION_COUNT);
+  for (int i = 0; i < ANIMATION_COUNT; i++) {
+    Baked& b = baked[i];
+    KeyframeCursor cursor;
+    cursorReset(&cursor, &LIVE_ANIMATIONS[i]);
+    for (uint32_t ms = 0; ms < LIVE_ANIMATIONS[i].duration_ms; ms += BAKE_FRAME_MS) {
+      uint16_t ticks[POSE_JOINTS];
+      cursorSeek(&cursor, ms);
+      liveTicks(&cursor, ms, ticks);
+      for (int j = 0; j < POSE_JOINTS; j++) b.frames.push_back((uint8_t)(ticks[j] - bases[j]));
+    }
+    b.anim = LIVE_ANIMATIONS[i];
+    b.anim.data = b.frames.data();
+    b.anim.flags = (b.anim.flags & ~ANIM_FLAG_SPARSE) | ANIM_FLAG_BAKED;
+    b.anim.keyframe_count = 0;
+  }
+}
+
+// Baked path (what updateAnimation() does for baked animations)
+static bool updateBaked(const Sample& s, uint32_t adjustedDuration, Pose* pose) {
+  if (s.realElapsed >= adjustedDuration) return false;
+  uint32_t elapsed = scaleElapsed(s.realElapsed, s.speedQ8);
+  uint16_t ticks[POSE_JOINTS];
+  bakedPose(&baked[s.anim].anim, elapsed, ticks);
+  pose->ls = ticks[0];
+  pose->le = ticks[1];
+  pose->rs = ticks[2];
+  pose->re = ticks[3];
+  return true;
+}
+
+static uint64_t cycles() {
+#ifdef HAVE_RDTSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+template <typename Fn>
+static void report(const char* label, const std::vector<Sample>& samples, int rounds, Fn fn) {
+  auto start = std::chrono::steady_clock::now();
+  uint64_t c0 = cycles();
+  for (int r = 0; r < rounds; r++) {
+    for (const Sample& s : samples) {
+      Pose pose = {0, 0, 0, 0};
+      if (fn(s, &pose)) sink = pose.ls + pose.le + pose.rs + pose.re;
+    }
+  }
+  uint64_t c1 = cycles();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double updates = (double)samples.size() * rounds;
+  printf("%-8s %8.2f ns/update", label, seconds * 1e9 / updates);
+#ifdef HAVE_RDTSC
+  printf("  %8.1f cycles/update (TSC)", (c1 - c0) / updates);
+#endif
+  printf("\n");
+}
+
+int main() {
+  const float speeds[] = {1.0f, 1.5f, 2.0f, 2.5f, 0.3f};
+  const SpeedQ8 speedsQ8[] = {SPEED_Q8(1.0), SPEED_Q8(1.5), SPEED_Q8(2.0), SPEED_Q8(2.5), SPEED_Q8(0.3)};
+
+  unpackAnimations();
+  bakeAnimations();
+
+  // One sample per simulated millisecond of every animation at every speed
+  std::vector<Sample> samples;
+  std::vector<uint32_t> durations;
+  for (int anim = 2; anim < ANIMATION_COUNT; anim++) {  // Skip single-keyframe references
+    for (int sp = 0; sp < 5; sp++) {
+      uint32_t duration = scaleDuration(LIVE_ANIMATIONS[anim].duration_ms, speedsQ8[sp]);
+      for (unsigned long ms = 0; ms < duration; ms++) {
+        samples.push_back(Sample{anim, ms, speeds[sp], speedsQ8[sp]});
+        durations.push_back(duration);
+      }
+    }
+  }
+
+  printf("Animation update benchmark (%zu samples per round)\n", samples.size());
+  printf("==================================================\n");
+  const int rounds = 50;
+  report("float", samples, rounds, updateFloat);
+  size_t index = 0;
+  report("fixed", samples, rounds, [&](const Sample& s, Pose* pose) {
+    bool ok = updateFixed(s, durations[index], pose);
+    index = (index + 1) % samples.size();
+    return ok;
+  });
+  KeyframeCursor cursor;
+  cursorReset(&cursor, &LIVE_ANIMATIONS[samples[0].anim]);
+  index = 0;
+  report("cursor", samples, rounds, [&](const Sample& s, Pose* pose) {
+    if (s.realElapsed == 0) cursorReset(&cursor, &LIVE_ANIMATIONS[s.anim]);
+    bool ok = updateCursor(s, durations[index], &cursor, pose);
+    index = (index + 1) % samples.size();
+    return ok;
+  });
+  cursorReset(&cursor, &LIVE_ANIMATIONS[samples[0].anim]);
+  index = 0;
+  report("live", samples, rounds, [&](const Sample& s, Pose* pose) {
+    if (s.realElapsed == 0) cursorReset(&cursor, &LIVE_ANIMATIONS[s.anim]);
+    bool ok = updateLive(s, durations[index], &cursor, pose);
+    index = (index + 1) % samples.size();
+    return ok;
+  });
+  index = 0;
+  report("baked", samples, rounds, [&](const Sample& s, Pose* pose) {
+    bool ok = updateBaked(s, durations[index], pose);
+    index = (index + 1) % samples.size();
+    return ok;
+  });
+  return 0;
+}
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+AVR kernel report: code size and static cycle counts on the ATmega32U4
+
+Compiles avr_bench/avr_kernels.cpp (the calls bench_kernels.cpp times on
+the host) with avr-gcc as the Arduino IDE would (-Os, no LTO), disassembles
+the object and reports per kernel:
+- bytes and instructions
+- cycles: every instruction once at its ATmega32U4 cycle cost, branches
+  not taken. Exact for straight-line kernels; for kernels with loops it is
+  one pass through the body
+- branches (each taken one adds a cycle)
+- calls into libgcc (32-bit multiply/divide helpers), which are not
+  included in the cycle count
+
+Results go to bench_avr.json; compare two runs with compare_bench.py.
+
+avr-gcc comes with the Arduino AVR core (pixi run setup); it is looked up
+on PATH, then in .arduino15/ and ~/.arduino15/.
+
+Usage:
+  pixi run bench-avr
+  python bench_avr.py --out bench_avr.json
+"""
+
+import argparse
+import json
+import re
+import shutil
+import subprocess
+import sys
+from collections import Counter
+from pathlib import Path
+
+HERE = Path(__file__).parent
+SOURCE = HERE / 'avr_bench' / 'avr_kernels.cpp'
+MCU = 'atmega32u4'
+CXXFLAGS = ['-Os', '-std=gnu++11', '-fno-exceptions', '-fno-threadsafe-statics',
+            '-ffunction-sections', '-fdata-sections', '-DF_CPU=16000000L']
+KERNEL_PREFIX = 'kernel_'
+
+# ATmega32U4 (AVRe+, 16-bit PC) cycles per instruction; anything not listed is 1.
+# Conditional branches and skips are counted as not taken.
+CYCLES = {
+    **dict.fromkeys(['adiw', 'sbiw', 'mul', 'muls', 'mulsu', 'fmul', 'fmuls', 'fmulsu',
+                     'ld', 'ldd', 'st', 'std', 'lds', 'sts', 'push', 'pop',
+                     'rjmp', 'ijmp', 'cbi', 'sbi'], 2),
+    **dict.fromkeys(['lpm', 'elpm', 'jmp', 'rcall', 'icall'], 3),
+    **dict.fromkeys(['call', 'ret', 'reti'], 4),
+}
+BRANCHES = {'breq', 'brne', 'brcs', 'brcc', 'brsh', 'brlo', 'brmi', 'brpl', 'brge', 'brlt',
+            'brhs', 'brhc', 'brts', 'brtc', 'brvs', 'brvc', 'brie', 'brid', 'brbs', 'brbc',
+            'cpse', 'sbrc', 'sbrs', 'sbic', 'sbis'}
+
+FUNCTION_RE = re.compile(r'^[0-9a-f]+ <(\w+)>:$')
+INSTRUCTION_RE = re.compile(r'^\s*[0-9a-f]+:\t((?:[0-9a-f]{2} )+)\s*\t(\S+)')
+RELOC_RE = re.compile(r'^\s*[0-9a-f]+: (R_AVR_\w+)\s+([\w.$]+)')
+
+
+def find_tool(name):
+    """avr-gcc tool from PATH or an arduino-cli install."""
+    found = shutil.which(name)
+    if found:
+        return found
+    for root in (HERE / '.arduino15', Path.home() / '.arduino15'):
+        matches = sorted(root.glob(f'packages/arduino/tools/avr-gcc/*/bin/{name}'))
+        if matches:
+            return str(matches[-1])
+    return None
+
+
+def parse_disassembly(text):
+    """{function: {'bytes', 'instructions', 'cycles', 'branches', 'calls'}} from objdump -d -r."""
+    functions = {}
+    current = None
+    for line in text.splitlines():
+        match = FUNCTION_RE.match(line)
+        if match:
+            current = functions.setdefault(match.group(1), {
+                'bytes': 0, 'instructions': 0, 'cycles': 0, 'branches': 0, 'calls': Counter()})
+            continue
+        if current is None:
+            continue
+        match = RELOC_RE.match(line)
+        if match:
+            kind, target = match.groups()
+            if kind in ('R_AVR_CALL', 'R_AVR_13_PCREL') and target.startswith('__'):
+                current['calls'][target] += 1
+            continue
+        match = INSTRUCTION_RE.match(line)
+        if match:
+            raw, mnemonic = match.groups()
+            current['bytes'] += len(raw.split())
+            current['instructions'] += 1
+            current['cycles'] += CYCLES.get(mnemonic, 1)
+            if mnemonic in BRANCHES:
+                current['branches'] += 1
+    return functions
+
+
+def compile_kernels(gxx, obj_path):
+    include = ['-I', str(HERE / 'avr_bench'), '-I', str(HERE.parent / 'libraries' / 'HalloweenProps'),
+               '-I', str(HERE.parent / 'libraries' / 'HatchingEgg')]
+    cmd = [gxx, f'-mmcu={MCU}', *CXXFLAGS, *include, '-c', str(SOURCE), '-o', str(obj_path)]
+    subprocess.run(cmd, check=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--out', default=str(HERE / 'bench_avr.json'))
+    args = parser.parse_args()
+
+    gxx = find_tool('avr-g++')
+    objdump = find_tool('avr-objdump')
+    if not gxx or not objdump:
+        print("✗ avr-g++/avr-objdump not found (run `pixi run setup` to install the Arduino AVR core)")
+        return 1
+
+    obj_path = HERE / 'avr_bench' / 'avr_kernels.o'
+    compile_kernels(gxx, obj_path)
+    disassembly = subprocess.run([objdump, '-d', '-r', str(obj_path)], check=True,
+                                 capture_output=True, text=True).stdout
+    version = subprocess.run([gxx, '-dumpversion'], check=True, capture_output=True, text=True).stdout.strip()
+
+    kernels = {name[len(KERNEL_PREFIX):]: stats for name, stats in parse_disassembly(disassembly).items()
+               if name.startswith(KERNEL_PREFIX)}
+    if not kernels:
+        print(f"✗ no {KERNEL_PREFIX}* functions in {obj_path}")
+        return 1
+
+    print(f"AVR kernels ({MCU}, avr-gcc {version} {' '.join(CXXFLAGS[:1])})")
+    print("=" * 72)
+    print(f"{'kernel':<20} {'bytes':>6} {'insns':>6} {'cycles':>7} {'branches':>9}  libgcc calls")
+    benchmarks = []
+    for name, stats in kernels.items():
+        calls = ", ".join(f"{target} x{count}" if count > 1 else target
+                          for target, count in sorted(stats['calls'].items()))
+        print(f"{name:<20} {stats['bytes']:6d} {stats['instructions']:6d} {stats['cycles']:7d} "
+              f"{stats['branches']:9d}  {calls or '-'}")
+        benchmarks.append({'name': name, 'bytes': stats['bytes'], 'instructions': stats['instructions'],
+                           'cycles': stats['cycles'], 'branches': stats['branches'],
+                           'calls': dict(stats['calls'])})
+    print("\ncycles: one pass, branches not taken, libgcc calls excluded (16 cycles = 1 us at 16 MHz)")
+
+    report = {
+        'context': {'tool': 'bench_avr.py', 'mcu': MCU, 'compiler': f'avr-gcc {version}',
+                    'flags': ' '.join(CXXFLAGS),
+                    'cycle_model': 'static: every instruction once, branches not taken, libgcc calls excluded'},
+        'benchmarks': benchmarks,
+    }
+    with open(args.out, 'w') as f:
+        json.dump(report, f, indent=2)
+        f.write('\n')
+    print(f"✓ Wrote {args.out}")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,248 @@
+/*
+ * Benchmark: Servo Logic and Animation Kernels (Google Benchmark)
+ *
+ * Host ns/op for the per-update building blocks the sketches run:
+ *   - servo_mapping.h:          degreesToPWM(), isPWMSafe()
+ *   - servo_sweep_test_logic.h: updateSweepState()
+ *   - servo_lut.h:              ServoPulseTable lookup() / lookupQ8()
+ *   - servo_output.h:           a cached write, a 4-servo frame staged and
+ *                               flushed (to host_sim's Wire)
+ *   - animation_player.h:       keyframe lookup (cursorSeek), fraction,
+ *                               interpolation, full pose, baked frame read
+ *   - xorshift_random.h:        below() against Arduino random(min, max)
+ *
+ * avr_bench/avr_kernels.cpp wraps the same calls for avr-gcc (see
+ * bench_avr.py). Results go to bench_kernels.json; compare two runs with
+ * compare_bench.py.
+ *
+ * Build and run:
+ *   pixi run bench-kernels
+ *   pixi run bench-compare old/bench_kernels.json bench_kernels.json
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "Arduino.h"
+#include "servo_lut.h"
+#include "servo_output.h"
+#include "xorshift_random.h"
+#include "arduino/servo_sweep_test_logic.h"
+#define ANIMATION_CONFIG_LIVE_TABLE
+#include "arduino/hatching_egg/animation_player.h"
+
+typedef ServoPulseTable<RIGHT_ELBOW_MIN_PULSE, RIGHT_ELBOW_MAX_PULSE> RightElbowTable;
+
+#define STABBING_INDEX 6  // animation-config.json order, as in hatching_egg.ino
+
+// Servo Mapping
+static void BM_DegreesToPWM(benchmark::State& state) {
+  int degrees = 0;
+  int servo = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(degreesToPWM(degrees, servo));
+    degrees = degrees == 100 ? -10 : degrees + 1;  // Includes clamped inputs
+    servo = (servo + 1) & 3;
+  }
+}
+BENCHMARK(BM_DegreesToPWM);
+
+static void BM_IsPWMSafe(benchmark::State& state) {
+  int pwm = 100;
+  int servo = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(isPWMSafe(pwm, servo));
+    pwm = pwm == 600 ? 100 : pwm + 1;
+    servo = (servo + 1) & 3;
+  }
+}
+BENCHMARK(BM_IsPWMSafe);
+
+static void BM_UpdateSweepState(benchmark::State& state) {
+  ServoSweepState sweep = initSweepState();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(updateSweepState(&sweep));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_UpdateSweepState);
+
+// Servo Tables
+static void BM_TableLookup(benchmark::State& state) {
+  int degrees = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(RightElbowTable::lookup(degrees));
+    degrees = degrees == 100 ? -10 : degrees + 1;
+  }
+}
+BENCHMARK(BM_TableLookup);
+
+static void BM_TableLookupQ8(benchmark::State& state) {
+  uint16_t degreesQ8 = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(RightElbowTable::lookupQ8(degreesQ8));
+    degreesQ8 = (degreesQ8 + 37) % (91 << ANGLE_Q8_SHIFT);
+  }
+}
+BENCHMARK(BM_TableLookupQ8);
+
+// Servo Output (hatching_egg's four legs)
+static void attachLegs(ServoOutput<4>& servos) {
+  for (uint8_t i = 0; i < 4; i++) servos.attach(i, i, getServoCalibration(i));
+}
+
+static void BM_ServoOutputCachedWrite(benchmark::State& state) {
+  PCA9685Batch batch(0x40);
+  ServoOutput<4> servos(batch);
+  attachLegs(servos);
+  servos.writeQ8(0, 45 << ANGLE_Q8_SHIFT);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(servos.writeQ8(0, 45 << ANGLE_Q8_SHIFT));  // Dropped
+  }
+}
+BENCHMARK(BM_ServoOutputCachedWrite);
+
+static void BM_ServoOutputFrame(benchmark::State& state) {
+  PCA9685Batch batch(0x40);
+  ServoOutput<4> servos(batch);
+  attachLegs(servos);
+  uint16_t degreesQ8 = 0;
+  for (auto _ : state) {
+    for (uint8_t i = 0; i < 4; i++) servos.writeQ8(i, degreesQ8 + i * 300);
+    benchmark::DoNotOptimize(servos.flush());
+    degreesQ8 = (degreesQ8 + 37) % (80 << ANGLE_Q8_SHIFT);
+  }
+}
+BENCHMARK(BM_ServoOutputFrame);
+
+// Keyframe Lookup and Interpolation
+static void BM_SegmentFraction(benchmark::State& state) {
+  uint32_t elapsed = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(segmentFraction(elapsed, 1000, 2500));
+    elapsed = elapsed == 3000 ? 0 : elapsed + 1;
+  }
+}
+BENCHMARK(BM_SegmentFraction);
+
+static void BM_TrackFraction(benchmark::State& state) {
+  TrackCursor track = {};
+  track.t1 = 1000;
+  track.t2 = 2500;
+  trackLoadSpan(&track);
+  uint32_t elapsed = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(trackFraction(&track, elapsed));
+    elapsed = elapsed == 3000 ? 0 : elapsed + 1;
+  }
+}
+BENCHMARK(BM_TrackFraction);
+
+static void BM_LerpQ15Q8(benchmark::State& state) {
+  uint16_t frac = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lerpQ15Q8(10, 80, frac));
+    benchmark::DoNotOptimize(lerpQ15Q8(80, 10, frac));
+    frac = (frac + 101) & (FRAC_Q15_ONE - 1);
+  }
+}
+BENCHMARK(BM_LerpQ15Q8);
+
+// One 20 ms frame per iteration through every animation (the sketch's access pattern)
+static void BM_CursorSeek(benchmark::State& state) {
+  KeyframeCursor cursor;
+  int anim = 0;
+  uint32_t elapsed = 0;
+  cursorReset(&cursor, &LIVE_ANIMATIONS[anim]);
+  for (auto _ : state) {
+    cursorSeek(&cursor, elapsed);
+    benchmark::DoNotOptimize(cursor);
+    elapsed += BAKE_FRAME_MS;
+    if (elapsed >= LIVE_ANIMATIONS[anim].duration_ms) {
+      elapsed = 0;
+      anim = (anim + 1) % ANIMATION_COUNT;
+      cursorReset(&cursor, &LIVE_ANIMATIONS[anim]);
+    }
+  }
+}
+BENCHMARK(BM_CursorSeek);
+
+static void BM_CursorPoseQ8(benchmark::State& state) {
+  KeyframeCursor cursor;
+  cursorReset(&cursor, &LIVE_ANIMATIONS[STABBING_INDEX]);
+  cursorSeek(&cursor, 1500);
+  uint32_t elapsed = 1500;
+  AngleQ8 pose[POSE_JOINTS];
+  for (auto _ : state) {
+    cursorPoseQ8(&cursor, elapsed, pose);
+    benchmark::DoNotOptimize(pose);
+    elapsed = elapsed == 1600 ? 1500 : elapsed + 1;  // Stay in one segment
+  }
+}
+BENCHMARK(BM_CursorPoseQ8);
+
+// Keyframes to ticks, what updateAnimation() does per frame for live animations
+static void BM_LiveFrame(benchmark::State& state) {
+  KeyframeCursor cursor;
+  int anim = 0;
+  uint32_t elapsed = 0;
+  cursorReset(&cursor, &LIVE_ANIMATIONS[anim]);
+  for (auto _ : state) {
+    AngleQ8 pose[POSE_JOINTS];
+    cursorSeek(&cursor, elapsed);
+    cursorPoseQ8(&cursor, elapsed, pose);
+    uint16_t ticks = RightElbowTable::lookupQ8(pose[0]) + RightElbowTable::lookupQ8(pose[1]) +
+                     RightElbowTable::lookupQ8(pose[2]) + RightElbowTable::lookupQ8(pose[3]);
+    benchmark::DoNotOptimize(ticks);
+    elapsed += BAKE_FRAME_MS;
+    if (elapsed >= LIVE_ANIMATIONS[anim].duration_ms) {
+      elapsed = 0;
+      anim = (anim + 1) % ANIMATION_COUNT;
+      cursorReset(&cursor, &LIVE_ANIMATIONS[anim]);
+    }
+  }
+}
+BENCHMARK(BM_LiveFrame);
+
+static void BM_BakedFrame(benchmark::State& state) {
+  std::vector<int> baked;
+  for (int i = 0; i < ANIMATION_COUNT; i++) {
+    if (animationBaked(&ANIMATIONS[i])) baked.push_back(i);
+  }
+  if (baked.empty()) {
+    state.SkipWithError("no baked animations in animation_config.h");
+    return;
+  }
+  size_t anim = 0;
+  uint32_t elapsed = 0;
+  for (auto _ : state) {
+    uint16_t ticks[POSE_JOINTS];
+    bakedPose(&ANIMATIONS[baked[anim]], elapsed, ticks);
+    benchmark::DoNotOptimize(ticks);
+    elapsed += BAKE_FRAME_MS;
+    if (elapsed >= ANIMATIONS[baked[anim]].duration_ms) {
+      elapsed = 0;
+      anim = (anim + 1) % baked.size();
+    }
+  }
+}
+BENCHMARK(BM_BakedFrame);
+
+// Random Numbers
+static void BM_XorshiftBelow(benchmark::State& state) {
+  XorshiftRandom rng(1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rng.below(181));
+  }
+}
+BENCHMARK(BM_XorshiftBelow);
+
+// host_sim's random() is avr-libc's algorithm, with a 64-bit modulo here
+static void BM_ArduinoRandom(benchmark::State& state) {
+  randomSeed(1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(random(0, 181));
+  }
+}
+BENCHMARK(BM_ArduinoRandom);
+
+BENCHMARK_MAIN();
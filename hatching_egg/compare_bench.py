@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""
+Compare two benchmark runs (e.g. before and after a commit)
+
+Reads two JSON files written by either bench_kernels (Google Benchmark,
+compared on cpu_time) or bench_avr.py (compared on cycles and bytes) and
+prints old, new and change for every benchmark in both.
+
+Exits non-zero if --fail-above is given and anything got slower (or, for
+AVR runs, bigger) by more than that many percent.
+
+Usage:
+  git stash && pixi run bench-kernels && cp bench_kernels.json /tmp/old.json && git stash pop
+  pixi run bench-kernels
+  pixi run bench-compare /tmp/old.json bench_kernels.json
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNITS_NS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def load_run(path):
+    """(kind, {name: {metric: value}}) for a Google Benchmark or bench_avr.py file."""
+    with open(path) as f:
+        report = json.load(f)
+    results = {}
+    if report.get('context', {}).get('tool') == 'bench_avr.py':
+        for bench in report['benchmarks']:
+            results[bench['name']] = {'cycles': bench['cycles'], 'bytes': bench['bytes']}
+        return 'avr', results
+    for bench in report['benchmarks']:
+        if bench.get('run_type', 'iteration') != 'iteration' or 'error_occurred' in bench:
+            continue
+        scale = TIME_UNITS_NS[bench.get('time_unit', 'ns')]
+        results[bench['name']] = {'ns': bench['cpu_time'] * scale}
+    return 'host', results
+
+
+def percent(old, new):
+    return (new - old) / old * 100.0 if old else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('old')
+    parser.add_argument('new')
+    parser.add_argument('--fail-above', type=float, default=None,
+                        help='exit non-zero if any metric regresses by more than this percent')
+    args = parser.parse_args()
+
+    old_kind, old = load_run(args.old)
+    new_kind, new = load_run(args.new)
+    if old_kind != new_kind:
+        print(f"✗ Can't compare a {old_kind} run with a {new_kind} run")
+        return 1
+
+    metrics = ['ns'] if new_kind == 'host' else ['cycles', 'bytes']
+    print(f"Benchmark comparison ({new_kind}): {args.old} -> {args.new}")
+    print("=" * 72)
+    header = f"{'benchmark':<24}" + "".join(f" {m + ' old':>11} {m + ' new':>11} {'change':>8}" for m in metrics)
+    print(header)
+
+    regressions = []
+    for name in new:
+        if name not in old:
+            print(f"{name:<24} (new)")
+            continue
+        line = f"{name:<24}"
+        for metric in metrics:
+            before, after = old[name][metric], new[name][metric]
+            change = percent(before, after)
+            line += f" {before:11.1f} {after:11.1f} {change:+7.1f}%"
+            if args.fail_above is not None and change > args.fail_above:
+                regressions.append(f"{name} {metric} {change:+.1f}%")
+        print(line)
+    for name in old:
+        if name not in new:
+            print(f"{name:<24} (removed)")
+
+    if regressions:
+        print()
+        for regression in regressions:
+            print(f"✗ {regression}")
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
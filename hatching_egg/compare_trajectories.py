@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""
+Compare golden trajectories from the C++ player and the JavaScript preview
+
+Reads the CSVs written by trajectory_dump.cpp and trajectory_dump.js and
+reports:
+- per animation: worst error per joint (degrees) between the firmware's
+  fixed-point interpolation and the preview's float interpolation
+- triggered sequence: worst error per joint of what the player asked the
+  servos for at each firmware frame against the preview's pose held for
+  that frame (ticks, so up to ~0.7 degrees of quantization, plus the
+  firmware's frame landing up to a millisecond after the preview's), both
+  on the shared clock and with each step lined up on its own start (timing
+  drift removed), and the drift of every step start
+- power budget lag: how far what the servos were sent trails what the
+  player asked for. Under hardware.current_budget_ma no servo moves faster
+  than its top speed, and servos that would pass the budget together are
+  slowed or wait a frame, so fast steps (breaking_through at 2.5x) lag the
+  preview by tens of degrees. That's expected - the servos couldn't follow
+  the preview there anyway - and only reported
+- samples per second of both implementations
+
+Exits non-zero if an animation disagrees by more than --anim-tolerance
+degrees, the sequence with steps aligned by more than --seq-tolerance
+degrees, or a step starts more than --drift-tolerance ms off.
+
+Usage:
+  pixi run compare-preview
+  python compare_trajectories.py trajectory_cpp.csv trajectory_js.csv
+"""
+
+import argparse
+import bisect
+import json
+import sys
+from pathlib import Path
+
+JOINTS = ['ls', 'le', 'rs', 're']
+
+
+def load_trace(path):
+    """({'impl', 'step_ms', 'samples_per_s'}, {(kind, id, t_ms): [degrees]}, {step: start_ms})"""
+    header, samples, starts = {}, {}, {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            if line.startswith('#'):
+                fields = line[1:].split()
+                header['impl'] = fields[0]
+                header.update(field.split('=', 1) for field in fields[1:])
+                continue
+            kind, ident, t_ms, *angles = line.split(',')
+            if kind == 'start':
+                starts[int(ident)] = float(t_ms)
+            else:
+                samples[(kind, int(ident), round(float(t_ms), 3))] = [float(a) for a in angles]
+    return header, samples, starts
+
+
+def worst_errors(cpp, js, kind, ident=None):
+    """Per-joint (error, t_ms) maxima over samples present in both traces."""
+    worst = [(0.0, None)] * len(JOINTS)
+    for key, expected in js.items():
+        if key[0] != kind or (ident is not None and key[1] != ident) or key not in cpp:
+            continue
+        for j, (a, b) in enumerate(zip(cpp[key], expected)):
+            if abs(a - b) > worst[j][0]:
+                worst[j] = (abs(a - b), key[2])
+    return worst
+
+
+def held_poses(js):
+    """JS sequence frames as {step: ([t_ms], [angles])} and the same over all steps under None"""
+    frames = {}
+    for (kind, step, t_ms), angles in js.items():
+        if kind == 'seq':
+            frames.setdefault(step, []).append((t_ms, angles))
+            frames.setdefault(None, []).append((t_ms, angles))
+    for key, samples in frames.items():
+        samples.sort()
+        frames[key] = ([t for t, _ in samples], [angles for _, angles in samples])
+    return frames
+
+
+def held_pose(frames, t_ms):
+    """The preview's pose at t_ms: its last frame at or before it"""
+    times, poses = frames
+    i = bisect.bisect_right(times, t_ms + 1e-6) - 1
+    return poses[max(i, 0)]
+
+
+def sequence_errors(cpp, js, cpp_starts=None, js_starts=None):
+    """Per-joint (error, t_ms) maxima of every firmware frame against the held preview pose.
+
+    On the shared clock (no starts), each frame is looked up at its own time;
+    with starts, at the same time since its step started in the preview.
+    """
+    frames = held_poses(js)
+    worst = [(0.0, None)] * len(JOINTS)
+    for (kind, step, t_ms), actual in cpp.items():
+        if kind != 'seq':
+            continue
+        if cpp_starts is None:
+            expected = held_pose(frames[None], t_ms)
+        elif step in frames and step in cpp_starts:
+            expected = held_pose(frames[step], js_starts[step] + (t_ms - cpp_starts[step]))
+        else:
+            continue
+        for j in range(len(JOINTS)):
+            err = abs(actual[j] - expected[j])
+            if err > worst[j][0]:
+                worst[j] = (err, t_ms)
+    return worst
+
+
+def format_worst(worst):
+    joints = "  ".join(f"{name} {err:6.3f}" for name, (err, _) in zip(JOINTS, worst))
+    err, at = max(worst)
+    where = f" at {at:.0f} ms" if at is not None else ""
+    return f"{joints}  worst {err:.3f}{where}"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('cpp_trace')
+    parser.add_argument('js_trace')
+    parser.add_argument('--anim-tolerance', type=float, default=0.01,
+                        help='max per-joint difference per animation (degrees)')
+    parser.add_argument('--seq-tolerance', type=float, default=1.5,
+                        help='max per-joint difference in the sequence, steps aligned (degrees)')
+    parser.add_argument('--drift-tolerance', type=float, default=20.0,
+                        help='max step start difference (ms, default one frame)')
+    args = parser.parse_args()
+
+    cpp_header, cpp, cpp_starts = load_trace(args.cpp_trace)
+    js_header, js, js_starts = load_trace(args.js_trace)
+    if cpp_header.get('step_ms') != js_header.get('step_ms'):
+        print(f"✗ Traces use different steps ({cpp_header.get('step_ms')} vs {js_header.get('step_ms')} ms)")
+        return 1
+
+    config_path = Path(__file__).parent / 'animation-config.json'
+    with open(config_path) as f:
+        anim_ids = list(json.load(f)['animations'])
+
+    failures = []
+    print(f"Golden Trajectories: C++ player vs JS preview ({cpp_header['step_ms']} ms steps)")
+    print("=" * 72)
+    print("Animations (interpolated angle, degrees):")
+    for index, anim_id in enumerate(anim_ids):
+        worst = worst_errors(cpp, js, 'anim', index)
+        print(f"  {anim_id:<17} {format_worst(worst)}")
+        if max(worst)[0] > args.anim_tolerance:
+            failures.append(f"{anim_id} differs by {max(worst)[0]:.3f} deg")
+
+    print()
+    print("Triggered sequence (player vs preview, degrees):")
+    print(f"  {'shared clock':<17} {format_worst(sequence_errors(cpp, js))}")
+    aligned = sequence_errors(cpp, js, cpp_starts, js_starts)
+    print(f"  {'steps aligned':<17} {format_worst(aligned)}")
+    if max(aligned)[0] > args.seq_tolerance:
+        failures.append(f"sequence differs by {max(aligned)[0]:.3f} deg at {max(aligned)[1]:.0f} ms")
+
+    print()
+    print("Power budget lag (servo output vs player, degrees; expected, not checked):")
+    sent = {('seq',) + key[1:]: angles for key, angles in cpp.items() if key[0] == 'out'}
+    print(f"  {'sequence':<17} {format_worst(worst_errors(sent, cpp, 'seq'))}")
+
+    print()
+    print("Step start drift (C++ - JS):")
+    worst_drift = 0.0
+    for step in sorted(js_starts):
+        if step not in cpp_starts:
+            failures.append(f"step {step} missing from C++ trace")
+            continue
+        drift = cpp_starts[step] - js_starts[step]
+        worst_drift = max(worst_drift, abs(drift))
+        label = f"step {step}" if step < len(js_starts) - 1 else "idle"
+        print(f"  {label:<8} {cpp_starts[step]:10.1f} ms  {js_starts[step]:10.1f} ms  {drift:+7.1f} ms")
+    final = max(js_starts)
+    if final in cpp_starts:
+        print(f"  worst {worst_drift:.1f} ms, sequence length {cpp_starts[final] - js_starts[final]:+.1f} ms")
+    if worst_drift > args.drift_tolerance:
+        failures.append(f"step start drift {worst_drift:.1f} ms")
+
+    print()
+    print("Samples per second (host):")
+    for header in (cpp_header, js_header):
+        print(f"  {header['impl']:<4} {float(header['samples_per_s']):14,.0f}")
+
+    print()
+    if failures:
+        for failure in failures:
+            print(f"✗ {failure}")
+        return 1
+    print("✓ C++ player and JS preview agree")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
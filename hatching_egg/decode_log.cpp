@@ -0,0 +1,25 @@
+/*
+ * Event Log Decoder for hatching_egg.ino
+ *
+ * The sketch reports at runtime through binary event records
+ * (arduino/hatching_egg/log_events.h); this turns a serial capture back
+ * into the text lines, animation names included, with timestamps.
+ *
+ * Build and run:
+ *   pixi run decode-log                      # live from the Beetle
+ *   ./decode_log capture.bin
+ *   ./decode_log --no-timestamps < capture.bin
+ */
+
+#include "Arduino.h"
+#include "event_log_decoder.h"
+#include "arduino/hatching_egg/animation_config.h"
+#include "arduino/hatching_egg/log_events.h"
+
+static const char* animationName(uint16_t index) {
+  return index < ANIMATION_COUNT ? ANIMATIONS[index].name : nullptr;
+}
+
+int main(int argc, char** argv) {
+  return sim::decodeEventLogMain(argc, argv, {HATCHING_EGG_EVENTS(EVENT_LOG_FORMAT)}, animationName);
+}
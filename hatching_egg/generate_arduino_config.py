@@ -4,19 +4,525 @@ Generate Arduino configuration header from animation-config.json
 This ensures Arduino code uses the exact same parameters as the JavaScript preview.
 """
 
+import argparse
 import json
 import sys
 from pathlib import Path
 
-def generate_arduino_header(config_path, output_path):
-    """Generate Arduino header file from JSON config."""
+TRACKS = ['left_shoulder_deg', 'left_elbow_deg', 'right_shoulder_deg', 'right_elbow_deg']
+
+# AVR sizes of the previous unpacked format (int = 2 bytes, pointers = 2 bytes)
+LEGACY_KEYFRAME_BYTES = 4 + 4 * 2   # unsigned long time_ms + 4 int angles
+LEGACY_ANIMATION_BYTES = 2 + 4 + 1 + 2 + 2
+PACKED_ANIMATION_BYTES = 2 + 2 + 2 + 1 + 1
+DENSE_KEY_BYTES = 2 + len(TRACKS)
+SPARSE_KEY_BYTES = 3
+
+# Baked playback: one frame of PCA9685 ticks per servo PWM period
+BAKED_FRAME_BYTES = len(TRACKS)
+PULSE_KEYS = [('left_leg', 'shoulder'), ('left_leg', 'elbow'),
+              ('right_leg', 'shoulder'), ('right_leg', 'elbow')]  # TRACKS order
+BAKE_BASE_NAMES = ['LEFT_SHOULDER', 'LEFT_ELBOW', 'RIGHT_SHOULDER', 'RIGHT_ELBOW']
+FRAC_Q15_SHIFT = 15
+FRAC_Q15_ONE = 1 << FRAC_Q15_SHIFT
+ANGLE_Q8_SHIFT = 8
+SERVO_MAX_DEGREES = 90
+
+# Boards and joints: a prop (one egg) is four joints playing TRACKS
+JOINT_NAMES = ['left_shoulder', 'left_elbow', 'right_shoulder', 'right_elbow']  # TRACKS order
+PCA9685_CHANNELS = 16
+DEFAULT_PROPS = [{'name': 'egg', 'board': 0}]
+
+# I2C per frame, as PCA9685Batch sends it (pca9685_batch.h), at
+# hardware.i2c_clock_hz (default: the AVR Wire default); host_sim/Wire.h
+# charges the same bus time
+I2C_CLOCK_HZ = 100000
+I2C_MAX_CLOCK_HZ = 1000000   # 32U4 TWI at 16 MHz (TWBR = 0); PCA9685 fast mode plus
+PCA9685_REGS = PCA9685_CHANNELS * 4
+BATCH_MAX_RUN = 31   # Wire buffer minus the register byte
+BATCH_MERGE_GAP = 2
+
+# Servo current (servo_power.h): hardware.servo_current models each joint
+# type's servo, and every joint together stays under current_budget_ma
+SERVO_CURRENT_KEYS = ['idle_ma', 'full_speed_ma', 'degrees_per_second']
+
+# Per-frame work on the Beetle, from animation_player.h / servo_lut.h
+# (PROGMEM reads, 32-bit multiplies); cursor seeks are once per segment
+LIVE_FRAME_WORK = (2 * len(TRACKS), 1 + 2 * len(TRACKS))   # 8 word reads, 9 multiplies
+BAKED_FRAME_WORK = (len(TRACKS), 1)                         # 4 byte reads, 1 multiply
+
+
+def check_keyframes(anim):
+    """Validate that an animation fits the packed format's field widths."""
+    if not 0 < anim['duration_ms'] <= 0xFFFF:
+        raise ValueError(f"{anim['name']}: duration_ms {anim['duration_ms']} does not fit uint16")
+    if len(anim['keyframes']) > 0xFF:
+        raise ValueError(f"{anim['name']}: more than 255 keyframes")
+    previous = 0
+    for kf in anim['keyframes']:
+        delta = kf['time_ms'] - previous
+        if not 0 <= delta <= 0xFFFF:
+            raise ValueError(f"{anim['name']}: keyframe at {kf['time_ms']} ms is {delta} ms after "
+                             f"the previous one (must be 0-65535)")
+        previous = kf['time_ms']
+        for track in TRACKS:
+            if not 0 <= kf[track] <= 0xFF:
+                raise ValueError(f"{anim['name']}: {track} {kf[track]} does not fit uint8")
+
+
+def sparse_tracks(anim):
+    """Per-track (time_ms, angle) keys, dropping keys where a track holds still.
+
+    A key is redundant when the track has the same angle at the previous and
+    next key: interpolating between equal angles gives that angle exactly.
+    """
+    keyframes = anim['keyframes']
+    tracks = []
+    for track in TRACKS:
+        keys = []
+        for i, kf in enumerate(keyframes):
+            if 0 < i < len(keyframes) - 1:
+                if keyframes[i - 1][track] == kf[track] == keyframes[i + 1][track]:
+                    continue
+            keys.append((kf['time_ms'], kf[track]))
+        tracks.append(keys)
+    return tracks
+
+
+def encode_dense(anim):
+    """One line per keyframe: time delta then the four angles."""
+    lines = []
+    previous = 0
+    for kf in anim['keyframes']:
+        angles = ", ".join(str(kf[track]) for track in TRACKS)
+        lines.append(f"KEY_U16({kf['time_ms'] - previous}), {angles},  // {kf['time_ms']} ms")
+        previous = kf['time_ms']
+    return lines
+
+
+def encode_sparse(anim):
+    """One line per track: key count then (time delta, angle) pairs."""
+    lines = []
+    for track, keys in zip(TRACKS, sparse_tracks(anim)):
+        previous = 0
+        parts = [str(len(keys))]
+        for time_ms, angle in keys:
+            parts.append(f"KEY_U16({time_ms - previous}), {angle}")
+            previous = time_ms
+        lines.append(", ".join(parts) + f",  // {track}")
+    return lines
+
+
+def dense_bytes(anim):
+    return len(anim['keyframes']) * DENSE_KEY_BYTES
+
+
+def sparse_bytes(anim):
+    return sum(1 + len(keys) * SPARSE_KEY_BYTES for keys in sparse_tracks(anim))
+
+
+def c_div(a, b):
+    """Integer division truncating toward zero, like C."""
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b > 0) else -q
+
+
+def pulse_ranges(hw):
+    """(min_pulse, max_pulse) per track: PCA9685 ticks at 0 and 90 degrees."""
+    return [(hw[leg][f'{joint}_min_pulse'], hw[leg][f'{joint}_max_pulse']) for leg, joint in PULSE_KEYS]
+
+
+def pulse_table(min_pulse, max_pulse):
+    """ServoPulseTable entries: map(deg, 0, 90, min_pulse, max_pulse)."""
+    return [c_div(deg * (max_pulse - min_pulse), SERVO_MAX_DEGREES) + min_pulse
+            for deg in range(SERVO_MAX_DEGREES + 1)]
+
+
+def lookup_q8(table, degrees_q8):
+    """ServoPulseTable::lookupQ8(): interpolate between whole-degree entries."""
+    whole = degrees_q8 >> ANGLE_Q8_SHIFT
+    if whole >= SERVO_MAX_DEGREES:
+        return table[SERVO_MAX_DEGREES]
+    frac = degrees_q8 & 0xFF
+    lo = table[whole]
+    if not frac:
+        return lo
+    return lo + (((table[whole + 1] - lo) * frac + 128) >> 8)
+
+
+def segment_fraction(elapsed, t1, t2):
+    """segmentFraction(): Q15 position in a segment by division."""
+    if elapsed <= t1 or t2 <= t1:
+        return 0
+    span, dt = t2 - t1, elapsed - t1
+    if dt >= span:
+        return FRAC_Q15_ONE
+    while span > 0xFFFF:
+        span >>= 1
+        dt >>= 1
+    return (dt << FRAC_Q15_SHIFT) // span
+
+
+def track_fraction(elapsed, t1, t2):
+    """trackFraction(): Q15 fraction using the cursor's rounded-up reciprocal."""
+    if elapsed <= t1:
+        return 0
+    if elapsed >= t2:
+        return FRAC_Q15_ONE
+    span = t2 - t1
+    if span > 0xFFFF:
+        return segment_fraction(elapsed, t1, t2)
+    inv_span = (0x80000000 + span - 1) // span
+    return (((elapsed - t1) * inv_span) & 0xFFFFFFFF) >> 16
+
+
+def lerp_q15_q8(a, b, frac):
+    """lerpQ15Q8(): angle in Q8 degrees, rounded to nearest."""
+    product = (b - a) * frac
+    half = 1 << (FRAC_Q15_SHIFT - ANGLE_Q8_SHIFT - 1)
+    shift = FRAC_Q15_SHIFT - ANGLE_Q8_SHIFT
+    if product < 0:
+        return (a << ANGLE_Q8_SHIFT) - ((-product + half) >> shift)
+    return (a << ANGLE_Q8_SHIFT) + ((product + half) >> shift)
+
+
+def track_angle_q8(keys, elapsed):
+    """Q8 angle of one track at `elapsed`, picking the segment like trackSeek()."""
+    if len(keys) == 1:
+        return keys[0][1] << ANGLE_Q8_SHIFT
+    i = 0
+    while elapsed >= keys[i + 1][0] and i + 2 < len(keys):
+        i += 1
+    (t1, a), (t2, b) = keys[i], keys[i + 1]
+    return lerp_q15_q8(a, b, track_fraction(elapsed, t1, t2))
+
+
+def board_addresses(hw):
+    """I2C address of each PCA9685 (hardware.boards, else the one i2c_address)."""
+    if 'boards' not in hw:
+        return [int(hw['i2c_address'], 0)]
+    addresses = [int(board['i2c_address'], 0) for board in hw['boards']]
+    if not addresses:
+        raise ValueError("hardware.boards is empty")
+    if len(set(addresses)) != len(addresses):
+        raise ValueError(f"hardware.boards lists an address twice: {[hex(a) for a in addresses]}")
+    return addresses
+
+
+def joint_list(hw):
+    """Every prop's joints in order: dicts of prop, name, track, board, channel, min/max pulse.
+
+    A prop's channels and pulses come from hardware.left_leg/right_leg unless
+    the prop has its own left_leg/right_leg with the keys to override.
+    """
+    boards = board_addresses(hw)
+    joints = []
+    used = {}
+    for prop in hw.get('props', DEFAULT_PROPS):
+        if not 0 <= prop['board'] < len(boards):
+            raise ValueError(f"{prop['name']}: board {prop['board']} is not in hardware.boards")
+        for track, ((leg, joint), name) in enumerate(zip(PULSE_KEYS, JOINT_NAMES)):
+            merged = {**hw[leg], **prop.get(leg, {})}
+            channel = merged[f'{joint}_channel']
+            if not 0 <= channel < PCA9685_CHANNELS:
+                raise ValueError(f"{prop['name']} {name}: channel {channel} is not 0-15")
+            key = (prop['board'], channel)
+            if key in used:
+                raise ValueError(f"{prop['name']} {name}: board {prop['board']} channel {channel} "
+                                 f"is already {used[key]}")
+            used[key] = f"{prop['name']} {name}"
+            joints.append({'prop': prop['name'], 'name': name, 'track': track,
+                           'board': prop['board'], 'channel': channel,
+                           'min_pulse': merged[f'{joint}_min_pulse'],
+                           'max_pulse': merged[f'{joint}_max_pulse']})
+    if len(joints) > 0xFF:
+        raise ValueError(f"{len(joints)} joints; at most 255")
+    return joints
+
+
+def check_baked_calibration(animations, hw, joints):
+    """Baked frames hold ticks for hardware.left_leg/right_leg's pulses, so
+    every joint must share them while any animation is baked."""
+    baked = [anim['name'] for anim in animations.values() if is_baked(anim)]
+    if not baked:
+        return
+    ranges = pulse_ranges(hw)
+    for joint in joints:
+        if (joint['min_pulse'], joint['max_pulse']) != ranges[joint['track']]:
+            raise ValueError(f"{joint['prop']} {joint['name']}: own pulse range "
+                             f"{joint['min_pulse']}-{joint['max_pulse']}, but {baked[0]} is baked "
+                             f"for the shared calibration (use \"playback\": \"live\")")
+
+
+def batch_runs(dirty, known):
+    """PCA9685Batch::flush()'s runs: (start, end) register indexes covering
+    `dirty` registers, bridging short gaps of registers in `known` channels."""
+    runs = []
+    reg = 0
+    while reg < PCA9685_REGS:
+        if reg not in dirty:
+            reg += 1
+            continue
+        start = end = reg
+        for nxt in range(end + 1, PCA9685_REGS):
+            if nxt - start >= BATCH_MAX_RUN:
+                break
+            if nxt in dirty:
+                end = nxt
+            elif nxt - end > BATCH_MERGE_GAP or nxt // 4 not in known:
+                break
+        runs.append((start, end))
+        reg = end + 1
+    return runs
+
+
+def i2c_clock_hz(hw):
+    """SCL rate the sketch sets (i2c_bus.h)."""
+    clock = hw.get('i2c_clock_hz', I2C_CLOCK_HZ)
+    if not 10000 <= clock <= I2C_MAX_CLOCK_HZ:
+        raise ValueError(f"i2c_clock_hz {clock} is not 10000-{I2C_MAX_CLOCK_HZ}")
+    return clock
+
+
+def i2c_frame_budget_us(hw):
+    """Bus time per frame before low-priority joints wait (default: the whole frame)."""
+    frame_us = 1000000 // hw['servo_frequency']
+    budget = hw.get('i2c_frame_budget_us', frame_us)
+    if not 0 < budget <= frame_us:
+        raise ValueError(f"i2c_frame_budget_us {budget} is not 1-{frame_us} (the frame)")
+    return budget
+
+
+def low_priority_tracks(hw):
+    """Bit per track (TRACKS order) of the joints named in low_priority_joints."""
+    mask = 0
+    for name in hw.get('low_priority_joints', []):
+        if name not in JOINT_NAMES:
+            raise ValueError(f"low_priority_joints: {name} is not one of {JOINT_NAMES}")
+        mask |= 1 << JOINT_NAMES.index(name)
+    return mask
+
+
+def track_current(hw):
+    """Current model per track (TRACKS order): (idle mA, full-speed mA, deg/s, servo name)."""
+    models = []
+    for (_, joint), name in zip(PULSE_KEYS, JOINT_NAMES):
+        model = hw['servo_current'].get(joint)
+        if model is None:
+            raise ValueError(f"servo_current has no {joint} model ({name})")
+        idle, full, speed = (model[key] for key in SERVO_CURRENT_KEYS)
+        if not 0 <= idle <= full <= 0xFFFF or not 0 < speed <= 0xFFFF:
+            raise ValueError(f"servo_current.{joint}: need 0 <= idle_ma <= full_speed_ma <= 65535 "
+                             f"and degrees_per_second 1-65535")
+        models.append((idle, full, speed, model.get('servo', joint)))
+    return models
+
+
+def current_budget_ma(hw, joints):
+    """Supply current for all servos; every joint's idle draw must fit, or nothing could move."""
+    budget = hw['current_budget_ma']
+    idle = sum(track_current(hw)[j['track']][0] for j in joints)
+    if not idle < budget <= 0xFFFF:
+        raise ValueError(f"current_budget_ma {budget} is not above the {idle} mA of "
+                         f"{len(joints)} joints holding still (and at most 65535)")
+    return budget
+
+
+def frame_current(hw, joints):
+    """(every joint holding still, every joint flat out) in mA."""
+    models = track_current(hw)
+    return (sum(models[j['track']][0] for j in joints),
+            sum(models[j['track']][1] for j in joints))
+
+
+def transaction_micros(nbytes, clock_hz=I2C_CLOCK_HZ):
+    """Bus time of one write (address byte included), as host_sim/Wire.h."""
+    bits = 9 * nbytes + 2
+    return -(-bits * 1000000 // clock_hz)
+
+
+def frame_bus_load(hw, joints):
+    """Per board (address, joints, bytes, transactions, us) for a frame where
+    every joint moves: each channel's OFF_L and OFF_H change, ON stays 0."""
+    load = []
+    for board, address in enumerate(board_addresses(hw)):
+        channels = {j['channel'] for j in joints if j['board'] == board}
+        dirty = {4 * ch + i for ch in channels for i in (2, 3)}
+        runs = batch_runs(dirty, channels)
+        sizes = [end - start + 3 for start, end in runs]
+        load.append((address, len(channels), sum(sizes), len(runs),
+                     sum(transaction_micros(n, i2c_clock_hz(hw)) for n in sizes)))
+    return load
+
+
+def check_bus_budget(hw, joints):
+    """Every joint moving must fit the I2C bus in one servo frame."""
+    frame_us = 1000000 // hw['servo_frequency']
+    total = sum(us for *_, us in frame_bus_load(hw, joints))
+    if total > frame_us:
+        raise ValueError(f"{len(joints)} joints need {total} us of I2C per frame with every joint "
+                         f"moving, over the {frame_us} us frame")
+    return total
+
+
+def bake_frame_ms(hw):
+    return 1000 // hw['servo_frequency']
+
+
+def bake_recip(frame_ms):
+    """Frame index = (elapsed * recip) >> 16, recip = ceil(65536 / frame_ms)."""
+    return -(-0x10000 // frame_ms)
+
+
+def baked_frame_count(anim, frame_ms):
+    """Frames covering animation time 0 .. duration_ms - 1."""
+    return (anim['duration_ms'] - 1) // frame_ms + 1
+
+
+def baked_bytes(anim, frame_ms):
+    return baked_frame_count(anim, frame_ms) * BAKED_FRAME_BYTES
+
+
+def bake_animation(anim, hw):
+    """Pre-render an animation into per-frame PCA9685 ticks.
+
+    Sample k is the live player's output at animation time k * frame_ms,
+    stored as one byte per joint above that joint's lowest tick. Raises
+    ValueError if a joint's range or the frame index math doesn't fit.
+    """
+    check_keyframes(anim)
+    frame_ms = bake_frame_ms(hw)
+    recip = bake_recip(frame_ms)
+    for elapsed in range(anim['duration_ms']):
+        if (elapsed * recip) >> 16 != elapsed // frame_ms:
+            raise ValueError(f"{anim['name']}: {anim['duration_ms']} ms is too long to bake "
+                             f"(frame index overflows at {elapsed} ms)")
+    tables = []
+    for min_pulse, max_pulse in pulse_ranges(hw):
+        if abs(max_pulse - min_pulse) > 0xFF:
+            raise ValueError(f"pulse range {min_pulse}-{max_pulse} is over 255 ticks; "
+                             f"baked frames store one byte per joint")
+        tables.append((pulse_table(min_pulse, max_pulse), min(min_pulse, max_pulse)))
+    tracks = [[(kf['time_ms'], kf[track]) for kf in anim['keyframes']] for track in TRACKS]
+    frames = []
+    for k in range(baked_frame_count(anim, frame_ms)):
+        elapsed = k * frame_ms
+        frame = []
+        for keys, (table, base) in zip(tracks, tables):
+            frame.append(lookup_q8(table, track_angle_q8(keys, elapsed)) - base)
+        frames.append(frame)
+    return frames
+
+
+def encode_baked(frames, frame_ms, per_line=4):
+    """Frames as initializer lines, `per_line` frames per line."""
+    lines = []
+    for i in range(0, len(frames), per_line):
+        chunk = frames[i:i + per_line]
+        values = ", ".join(f"{v}" for frame in chunk for v in frame)
+        lines.append(f"{values},  // {i * frame_ms} ms")
+    return lines
+
+
+def pack_animation(anim, layout='auto'):
+    """Return (is_sparse, data lines), picking the smaller layout for 'auto'."""
+    check_keyframes(anim)
+    if layout == 'sparse' or (layout == 'auto' and sparse_bytes(anim) < dense_bytes(anim)):
+        return True, encode_sparse(anim)
+    return False, encode_dense(anim)
+
+
+def progmem_bytes(animations, packed):
+    """(legacy, packed) PROGMEM bytes for keyframes plus the animation table."""
+    legacy = len(animations) * LEGACY_ANIMATION_BYTES
+    new = len(animations) * PACKED_ANIMATION_BYTES
+    for anim_id, anim in animations.items():
+        legacy += len(anim['keyframes']) * LEGACY_KEYFRAME_BYTES
+        new += sparse_bytes(anim) if packed[anim_id][0] else dense_bytes(anim)
+    return legacy, new
+
+
+def is_baked(anim):
+    """Per-animation "playback": "baked" | "live" (default live)."""
+    playback = anim.get('playback', 'live')
+    if playback not in ('baked', 'live'):
+        raise ValueError(f"{anim['name']}: playback must be 'baked' or 'live', not {playback!r}")
+    return playback == 'baked'
+
+
+def print_bake_report(animations, packed, frame_ms):
+    """Print flash and per-frame work for live vs baked playback."""
+    live_reads, live_muls = LIVE_FRAME_WORK
+    baked_reads, baked_muls = BAKED_FRAME_WORK
+    print(f"  Playback (baked = {frame_ms} ms frames of ticks; live = interpolate + table lookup):")
+    print(f"    {'animation':<18} {'mode':<6} {'live B':>7} {'baked B':>8} {'frames':>7}")
+    total = 0
+    for anim_id, anim in animations.items():
+        live = sparse_bytes(anim) if packed[anim_id][0] else dense_bytes(anim)
+        baked = baked_bytes(anim, frame_ms)
+        mode = 'baked' if is_baked(anim) else 'live'
+        total += baked if is_baked(anim) else live
+        print(f"    {anim_id:<18} {mode:<6} {live:7d} {baked:8d} {baked_frame_count(anim, frame_ms):7d}")
+    print(f"    {'data total':<18} {'':<6} {total:7d} bytes PROGMEM")
+    print(f"    per frame: live {live_reads} PROGMEM word reads + {live_muls} multiplies, "
+          f"baked {baked_reads} byte reads + {baked_muls} multiply")
+
+
+def print_bus_report(hw, joints):
+    """Print each board's I2C time for a frame with every joint moving."""
+    frame_us = 1000000 // hw['servo_frequency']
+    print(f"  I2C per frame, every joint moving ({i2c_clock_hz(hw) // 1000} kHz):")
+    total = 0
+    for address, count, nbytes, transactions, us in frame_bus_load(hw, joints):
+        total += us
+        print(f"    board 0x{address:02X}  {count:2d} joints  {nbytes:3d} bytes  "
+              f"{transactions} transactions  {us:5d} us")
+    print(f"    total {total} us of the {frame_us} us frame ({100.0 * total / frame_us:.0f}%)")
+    low = hw.get('low_priority_joints', [])
+    print(f"    budget {i2c_frame_budget_us(hw)} us per frame"
+          + (f"; past it {', '.join(low)} wait a frame" if low else ""))
+
+
+def print_current_report(hw, joints):
+    """Print the estimated servo current against the budget."""
+    idle, full = frame_current(hw, joints)
+    budget = current_budget_ma(hw, joints)
+    print(f"  Servo current (estimated): {idle} mA holding, {full} mA with every joint flat out, "
+          f"budget {budget} mA" + ("; moves past it are slowed or wait a frame" if full > budget else ""))
+
+
+def print_progmem_report(animations, packed):
+    """Print PROGMEM used by keyframes + table, old unpacked format vs packed."""
+    print("  PROGMEM (keyframes + animation table, names unchanged):")
+    for anim_id, anim in animations.items():
+        old = len(anim['keyframes']) * LEGACY_KEYFRAME_BYTES + LEGACY_ANIMATION_BYTES
+        layout = "sparse" if packed[anim_id][0] else "dense"
+        size = sparse_bytes(anim) if packed[anim_id][0] else dense_bytes(anim)
+        print(f"    {anim_id:<18} {old:5d} -> {size + PACKED_ANIMATION_BYTES:5d} bytes ({layout}; "
+              f"dense {dense_bytes(anim)}, sparse {sparse_bytes(anim)})")
+    legacy, new = progmem_bytes(animations, packed)
+    print(f"    {'total':<18} {legacy:5d} -> {new:5d} bytes ({legacy - new} saved, "
+          f"{100.0 * (legacy - new) / legacy:.0f}%)")
+
+
+def generate_arduino_header(config_path, output_path, hardware_path=None):
+    """Generate Arduino header file from JSON config.
+
+    `hardware_path` is an optional JSON of hardware keys (boards, props...)
+    laid over the config's hardware section, for another rig with the same
+    animations.
+    """
 
     with open(config_path, 'r') as f:
         config = json.load(f)
+    if hardware_path:
+        with open(hardware_path, 'r') as f:
+            config['hardware'].update(json.load(f))
 
     header_lines = [
         "// AUTO-GENERATED - DO NOT EDIT",
-        "// Generated from animation-config.json",
+        "// Generated from animation-config.json" +
+        (f", hardware from {Path(hardware_path).name}" if hardware_path else ""),
         "// Run: pixi run generate-config",
         "",
         "#ifndef ANIMATION_CONFIG_H",
@@ -27,11 +533,16 @@ def generate_arduino_header(config_path, output_path):
 
     # Hardware config
     hw = config['hardware']
+    boards = board_addresses(hw)
+    joints = joint_list(hw)
+    check_baked_calibration(config['animations'], hw, joints)
+    check_bus_budget(hw, joints)
+    current_budget_ma(hw, joints)
     header_lines.extend([
-        f"#define I2C_ADDRESS {hw['i2c_address']}",
+        f"#define I2C_ADDRESS 0x{boards[0]:02X}  // First board",
         f"#define SERVO_FREQ {hw['servo_frequency']}",
         "",
-        "// Left Leg Servos",
+        "// Left Leg Servos (the first egg; every prop's default)",
         f"#define LEFT_SHOULDER_CHANNEL {hw['left_leg']['shoulder_channel']}",
         f"#define LEFT_ELBOW_CHANNEL {hw['left_leg']['elbow_channel']}",
         f"#define LEFT_SHOULDER_MIN_PULSE {hw['left_leg']['shoulder_min_pulse']}",
@@ -51,6 +562,57 @@ def generate_arduino_header(config_path, output_path):
         "",
     ])
 
+    # Boards and joints
+    tables = {}
+    for joint in joints:
+        tables.setdefault((joint['min_pulse'], joint['max_pulse']), None)
+    header_lines.extend([
+        "// Boards and Joints (hardware.boards / hardware.props)",
+        "// Each prop's four joints play the animation's tracks (ls, le, rs, re);",
+        "// a joint is a PCA9685 board and channel with its own pulse table",
+        f"#define BOARD_COUNT {len(boards)}",
+        f"#define BOARD_LIST(X) {' '.join(f'X(0x{a:02X})' for a in boards)}",
+        f"#define PROP_COUNT {len(hw.get('props', DEFAULT_PROPS))}",
+        f"#define JOINT_COUNT {len(joints)}",
+        f"#define JOINT_MAX_DEGREES {SERVO_MAX_DEGREES}",
+        "",
+    ])
+    for lo, hi in tables:
+        values = pulse_table(lo, hi)
+        header_lines.append(f"const uint16_t JOINT_PULSES_{lo}_{hi}[JOINT_MAX_DEGREES + 1] PROGMEM = {{")
+        for i in range(0, len(values), 13):
+            header_lines.append("  " + ", ".join(str(v) for v in values[i:i + 13]) + ",")
+        header_lines.append("};")
+    header_lines.extend([
+        "",
+        "struct JointConfig {",
+        "  uint8_t board;           // BOARD_LIST index",
+        "  uint8_t channel;         // PCA9685 channel 0-15",
+        "  uint8_t track;           // Pose index the joint follows",
+        "  const uint16_t* pulses;  // PROGMEM: ticks at 0-JOINT_MAX_DEGREES",
+        "};",
+        "",
+        "const JointConfig JOINTS[JOINT_COUNT] PROGMEM = {",
+        *[f"  {{{j['board']}, {j['channel']}, {j['track']}, JOINT_PULSES_{j['min_pulse']}_{j['max_pulse']}}},"
+          f"  // {j['prop']} {j['name']}" for j in joints],
+        "};",
+        "",
+        "// I2C bus (i2c_bus.h): SCL rate, bus time per frame, and the tracks whose",
+        "// joints wait a frame when a frame's writes would run past it",
+        f"#define I2C_CLOCK_HZ {i2c_clock_hz(hw)}UL",
+        f"#define I2C_FRAME_BUDGET_MICROS {i2c_frame_budget_us(hw)}",
+        f"#define LOW_PRIORITY_TRACKS 0x{low_priority_tracks(hw):02X}"
+        + (f"  // {', '.join(hw['low_priority_joints'])}" if hw.get('low_priority_joints') else ""),
+        "",
+        "// Servo current (servo_power.h): each track's servo as (idle mA, full-speed",
+        "// mA, degrees per second), and the estimated total every frame stays under",
+        f"#define CURRENT_BUDGET_MILLIAMPS {current_budget_ma(hw, joints)}",
+        "#define TRACK_CURRENT_LIST(X) "
+        + " ".join(f"X({idle}, {full}, {speed})" for idle, full, speed, _ in track_current(hw))
+        + f"  // {', '.join(servo for *_, servo in track_current(hw))}",
+        "",
+    ])
+
     # Kinematics
     kin = config['kinematics']
     header_lines.extend([
@@ -66,21 +628,28 @@ def generate_arduino_header(config_path, output_path):
 
     # Animation structures
     header_lines.extend([
-        "// Animation Keyframe Structure",
-        "struct Keyframe {",
-        "  unsigned long time_ms;",
-        "  int left_shoulder_deg;",
-        "  int left_elbow_deg;",
-        "  int right_shoulder_deg;",
-        "  int right_elbow_deg;",
-        "};",
+        "// Packed Animation Format (decoded by animation_player.h)",
+        "// Dense:  keyframe_count x [uint16 delta_ms, uint8 ls, le, rs, re]",
+        "// Sparse: 4 tracks (ls, le, rs, re) x [uint8 count, count x [uint16 delta_ms, uint8 angle]]",
+        "// delta_ms is the time since the previous key on the same track (first key: since 0)",
+        "#define KEY_U16(ms) (uint8_t)((ms) & 0xFF), (uint8_t)((ms) >> 8)",
+        "#define ANIM_FLAG_LOOP 0x01",
+        "#define ANIM_FLAG_SPARSE 0x02",
+        "",
+        "// Baked: frame_count x [uint8 ls, le, rs, re] PCA9685 ticks above BAKE_TICK_BASE_*,",
+        "// one frame per BAKE_FRAME_MS of animation time (\"playback\": \"baked\" in the JSON)",
+        "#define ANIM_FLAG_BAKED 0x04",
+        f"#define BAKE_FRAME_MS {bake_frame_ms(hw)}",
+        f"#define BAKE_FRAME_RECIP {bake_recip(bake_frame_ms(hw))}  // frame = (elapsed * RECIP) >> 16",
+        *[f"#define BAKE_TICK_BASE_{name} {min(lo, hi)}"
+          for name, (lo, hi) in zip(BAKE_BASE_NAMES, pulse_ranges(hw))],
         "",
         "struct Animation {",
         "  const char* name;",
-        "  unsigned long duration_ms;",
-        "  bool loop;",
-        "  int keyframe_count;",
-        "  const Keyframe* keyframes;",
+        "  const uint8_t* data;",
+        "  uint16_t duration_ms;",
+        "  uint8_t flags;",
+        "  uint8_t keyframe_count;  // Dense only",
         "};",
         "",
     ])
@@ -91,18 +660,26 @@ def generate_arduino_header(config_path, output_path):
         header_lines.append(f"const char {anim_id.upper()}_NAME[] PROGMEM = \"{anim['name']}\";")
     header_lines.append("")
 
-    # Generate keyframes for each animation
+    # Generate packed keyframes (or baked frames) for each animation
+    packed = {anim_id: pack_animation(anim) for anim_id, anim in animations.items()}
+    frame_ms = bake_frame_ms(hw)
     for anim_id, anim in animations.items():
-        header_lines.append(f"// {anim['name']}")
-        header_lines.append(f"const Keyframe {anim_id.upper()}_KEYFRAMES[] PROGMEM = {{")
-
-        for kf in anim['keyframes']:
-            header_lines.append(
-                f"  {{{kf['time_ms']}, {kf['left_shoulder_deg']}, {kf['left_elbow_deg']}, "
-                f"{kf['right_shoulder_deg']}, {kf['right_elbow_deg']}}},"
-            )
-
+        sparse, lines = packed[anim_id]
+        layout = "sparse" if sparse else "dense"
+        if is_baked(anim):
+            layout = f"baked, {baked_frame_count(anim, frame_ms)} frames"
+            lines = encode_baked(bake_animation(anim, hw), frame_ms)
+        header_lines.append(f"// {anim['name']} ({layout})")
+        header_lines.append(f"const uint8_t {anim_id.upper()}_DATA[] PROGMEM = {{")
+        header_lines.extend(f"  {line}" for line in lines)
         header_lines.append("};")
+        if is_baked(anim):
+            # Host tests check the bake against the live player's keyframes
+            header_lines.append("#ifdef ANIMATION_CONFIG_LIVE_TABLE")
+            header_lines.append(f"const uint8_t {anim_id.upper()}_KEYS[] = {{")
+            header_lines.extend(f"  {line}" for line in packed[anim_id][1])
+            header_lines.append("};")
+            header_lines.append("#endif")
         header_lines.append("")
 
     # Animation array
@@ -111,13 +688,21 @@ def generate_arduino_header(config_path, output_path):
         "const Animation ANIMATIONS[] PROGMEM = {",
     ])
 
+    def animation_entry(anim_id, anim, live):
+        baked = is_baked(anim) and not live
+        flags = ["ANIM_FLAG_LOOP"] if anim['loop'] else []
+        if baked:
+            flags.append("ANIM_FLAG_BAKED")
+        elif packed[anim_id][0]:
+            flags.append("ANIM_FLAG_SPARSE")
+        flag_str = " | ".join(flags) if flags else "0"
+        kf_count = 0 if baked else len(anim['keyframes'])
+        data = f"{anim_id.upper()}_KEYS" if is_baked(anim) and live else f"{anim_id.upper()}_DATA"
+        return (f"  {{{anim_id.upper()}_NAME, {data}, {anim['duration_ms']}, "
+                f"{flag_str}, {kf_count}}},")
+
     for anim_id, anim in animations.items():
-        loop_str = "true" if anim['loop'] else "false"
-        kf_count = len(anim['keyframes'])
-        header_lines.append(
-            f"  {{{anim_id.upper()}_NAME, {anim['duration_ms']}, {loop_str}, "
-            f"{kf_count}, {anim_id.upper()}_KEYFRAMES}},"
-        )
+        header_lines.append(animation_entry(anim_id, anim, live=False))
 
     # Find default animation index
     default_anim_name = config['default_animation']
@@ -126,6 +711,13 @@ def generate_arduino_header(config_path, output_path):
     header_lines.extend([
         "};",
         "",
+        "#ifdef ANIMATION_CONFIG_LIVE_TABLE",
+        "// Host only: every animation as keyframes, baked ones included",
+        "const Animation LIVE_ANIMATIONS[] = {",
+        *[animation_entry(anim_id, anim, live=True) for anim_id, anim in animations.items()],
+        "};",
+        "#endif",
+        "",
         f"#define ANIMATION_COUNT {len(animations)}",
         f"#define DEFAULT_ANIMATION {default_index}  // {default_anim_name}",
         "",
@@ -141,12 +733,22 @@ def generate_arduino_header(config_path, output_path):
     print(f"✓ Generated {output_path}")
     print(f"  - {len(animations)} animations")
     print(f"  - {sum(len(a['keyframes']) for a in animations.values())} total keyframes")
+    print_progmem_report(animations, packed)
+    print_bake_report(animations, packed, frame_ms)
+    print_bus_report(hw, joints)
+    print_current_report(hw, joints)
 
 if __name__ == '__main__':
-    config_path = Path(__file__).parent / 'animation-config.json'
-    output_path = Path(__file__).parent / 'arduino' / 'hatching_egg' / 'animation_config.h'
+    here = Path(__file__).parent
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--hardware', help="JSON of hardware keys to lay over the config's "
+                                           "(e.g. clutch-hardware.json)")
+    parser.add_argument('--output', default=str(here / 'arduino' / 'hatching_egg' / 'animation_config.h'))
+    args = parser.parse_args()
+    config_path = here / 'animation-config.json'
+    output_path = Path(args.output)
 
     # Create arduino directory if needed
     output_path.parent.mkdir(parents=True, exist_ok=True)
 
-    generate_arduino_header(config_path, output_path)
+    generate_arduino_header(config_path, output_path, args.hardware)
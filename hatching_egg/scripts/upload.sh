@@ -7,6 +7,13 @@ ARDUINO_CLI=".pixi/bin/arduino-cli"
 CONFIG_FILE=".arduino15/arduino-cli.yaml"
 SKETCH_DIR="arduino/hatching_egg"
 
+# LOG_LEVEL=4 (pixi run upload-debug) keeps the runtime event log;
+# unset builds the sketch's production default (warnings and errors only)
+BUILD_FLAGS=()
+if [ -n "$LOG_LEVEL" ]; then
+    BUILD_FLAGS=(--build-property "compiler.cpp.extra_flags=-DLOG_LEVEL=$LOG_LEVEL")
+fi
+
 echo "Hatching Egg - Arduino Upload"
 echo "=============================="
 echo ""
@@ -26,8 +33,8 @@ echo "✓ Found Beetle on $PORT"
 echo ""
 
 # Compile and upload
-echo "Compiling and uploading..."
-$ARDUINO_CLI compile --fqbn arduino:avr:leonardo --config-file $CONFIG_FILE $SKETCH_DIR
+echo "Compiling and uploading${LOG_LEVEL:+ (LOG_LEVEL=$LOG_LEVEL)}..."
+$ARDUINO_CLI compile --fqbn arduino:avr:leonardo --config-file $CONFIG_FILE --libraries ../libraries "${BUILD_FLAGS[@]}" $SKETCH_DIR
 $ARDUINO_CLI upload -p $PORT --fqbn arduino:avr:leonardo --config-file $CONFIG_FILE $SKETCH_DIR
 
 echo ""
@@ -36,3 +43,4 @@ echo ""
 echo "Testing:"
 echo "  - Trigger switch on pin 9"
 echo "  - Serial monitor: pixi run monitor"
+echo "  - Event log (upload-debug builds): pixi run decode-log"
@@ -27,7 +27,7 @@ echo ""
 
 # Compile and upload
 echo "Compiling and uploading..."
-$ARDUINO_CLI compile --fqbn arduino:avr:leonardo --config-file $CONFIG_FILE $SKETCH_DIR
+$ARDUINO_CLI compile --fqbn arduino:avr:leonardo --config-file $CONFIG_FILE --libraries ../libraries $SKETCH_DIR
 $ARDUINO_CLI upload -p $PORT --fqbn arduino:avr:leonardo --config-file $CONFIG_FILE $SKETCH_DIR
 
 echo ""
@@ -0,0 +1,364 @@
+/*
+ * Host Simulator for hatching_egg.ino
+ *
+ * Compiles the production sketch against host_sim/ (stand-in Arduino core,
+ * mock Wire bus, PCA9685 model) and plays it on a simulated clock:
+ *   1. Idle cycle (resting <-> slow_struggle)
+ *   2. Bouncy trigger press and release -> full 14-step triggered sequence
+ *      -> back to idle
+ *   3. A 0.3 ms press between two loop passes -> the sequence again
+ *   4. A serial status request ('s')
+ *
+ * Reports loop rate, I2C traffic per animation second, bytes on the wire
+ * per frame and the busiest frame's bus time against the frame period,
+ * estimated servo current per animation (average, peak, what the moves
+ * asked for before the budget), output resolution (distinct pulse
+ * positions, largest step),
+ * the sketch's frame lateness/compute histograms (decoded from its binary
+ * event log), event log traffic, trigger-to-motion latency (measured here,
+ * as the sketch logs it and in its serial status) and how many sequences
+ * each press started. Exits non-zero if any servo write leaves its joint's
+ * calibrated range, a frame's I2C writes overrun the frame, a frame's
+ * estimated current passes the budget, bounce restarts the sequence, the
+ * short press is missed or the status doesn't count both presses and print
+ * the I2C counters.
+ *
+ * Builds against the sketch's animation_config.h, or another generated
+ * header given as ANIMATION_CONFIG (pixi run sim-clutch: 8 eggs, 32 servos
+ * on two boards, from clutch-hardware.json).
+ *
+ * Build and run:
+ *   pixi run sim
+ *   pixi run sim-clutch
+ *   ./sim_hatching_egg --idle-seconds 60 --verbose
+ */
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include "Arduino.h"
+#include "sim.h"
+#define LOG_LEVEL LOG_LEVEL_DEBUG  // The reports decode the full event log
+#ifdef ANIMATION_CONFIG
+#include ANIMATION_CONFIG  // Its include guard keeps the sketch's copy out
+#endif
+#include "arduino/hatching_egg/hatching_egg.ino"
+
+#define BOARD_ADDRESS(address) address,
+
+// {a:name} in log_events.h formats
+static const char* animationName(uint16_t index) {
+  return index < ANIMATION_COUNT ? ANIMATIONS[index].name : nullptr;
+}
+
+struct Snapshot {
+  uint64_t micros;
+  uint64_t i2cBytes;
+  uint64_t i2cTransactions;
+  uint64_t busMicros;
+  uint64_t servoWrites;
+
+  static Snapshot take() {
+    return Snapshot{sim::nowMicros, sim::i2c.bytes, sim::i2c.transactions,
+                    sim::i2c.busMicros, sim::servoWrites};
+  }
+};
+
+static void printPhase(const char* label, const Snapshot& from, const Snapshot& to) {
+  double seconds = (to.micros - from.micros) / 1e6;
+  if (seconds <= 0) return;
+  printf("%-28s %8.2f s  %8.0f I2C bytes/s  %6.1f transactions/s  %6.1f servo writes/s  bus %4.1f%%\n",
+         label, seconds,
+         (to.i2cBytes - from.i2cBytes) / seconds,
+         (to.i2cTransactions - from.i2cTransactions) / seconds,
+         (to.servoWrites - from.servoWrites) / seconds,
+         100.0 * (to.busMicros - from.busMicros) / (to.micros - from.micros));
+}
+
+// Output resolution: which pulse values each channel used, largest jump
+struct Resolution {
+  std::set<uint32_t> positions;  // address << 20 | channel << 16 | off
+  std::map<uint16_t, int> lastOff;  // address << 4 | channel
+  int maxStep = 0;
+
+  void record(const sim::ServoWrite& w) {
+    if (w.channel >= 16 || w.off == 0) return;  // 0 = released, not a position
+    positions.insert((uint32_t)w.address << 20 | (uint32_t)w.channel << 16 | w.off);
+    uint16_t key = (uint16_t)(w.address << 4 | w.channel);
+    auto last = lastOff.find(key);
+    if (last != lastOff.end()) maxStep = std::max(maxStep, std::abs(w.off - last->second));
+    lastOff[key] = w.off;
+  }
+};
+
+// Busiest frame's bus time against the frame period
+static bool printBusBudget(const char* label, const sim::LoopStats& stats) {
+  const uint64_t frameMicros = 1000000 / SERVO_FREQ;
+  printf("%-28s max %5llu us of %llu us per frame (%.0f%%), write budget %d us\n", label,
+         (unsigned long long)stats.maxFrameBusMicros, (unsigned long long)frameMicros,
+         100.0 * stats.maxFrameBusMicros / frameMicros, I2C_FRAME_BUDGET_MICROS);
+  return stats.maxFrameBusMicros <= frameMicros;
+}
+
+// Estimated servo current (the sketch's ServoPower) per animation and speed
+struct CurrentByAnimation {
+  struct Row {
+    int animation;
+    SpeedQ8 speed;
+    uint64_t frames = 0;
+    uint64_t milliampFrames = 0;
+    uint16_t peak = 0;
+    uint16_t peakDemand = 0;
+    uint64_t limited = 0;
+  };
+  std::vector<Row> rows;  // First-played order
+
+  // loop(), then the frame it estimated (if it flushed) to what's playing
+  void step() {
+    uint32_t before = power.stats().frames;
+    loop();
+    if (power.stats().frames == before || power.stats().frames == 0) return;
+    Row* row = nullptr;
+    for (Row& r : rows) {
+      if (r.animation == currentAnimation && r.speed == playbackSpeed) row = &r;
+    }
+    if (!row) {
+      rows.push_back(Row{currentAnimation, playbackSpeed});
+      row = &rows.back();
+    }
+    uint16_t milliamps = power.lastMilliamps();
+    uint16_t demand = power.lastDemandMilliamps();
+    row->frames++;
+    row->milliampFrames += milliamps;
+    row->peak = std::max(row->peak, milliamps);
+    row->peakDemand = std::max(row->peakDemand, demand);
+    row->limited += demand > milliamps;
+  }
+
+  uint16_t peak() const {
+    uint16_t peak = 0;
+    for (const Row& r : rows) peak = std::max(peak, r.peak);
+    return peak;
+  }
+
+  void print() const {
+    printf("Servo current (estimated, budget %d mA):\n", CURRENT_BUDGET_MILLIAMPS);
+    for (const Row& r : rows) {
+      printf("  %-36s %4.2fx  avg %5.0f mA  peak %5u mA  asked %5u mA  %4llu of %5llu frames limited\n",
+             ANIMATIONS[r.animation].name, r.speed / 256.0, (double)r.milliampFrames / r.frames,
+             r.peak, r.peakDemand, (unsigned long long)r.limited, (unsigned long long)r.frames);
+    }
+  }
+};
+
+// Trigger contact edges at set times, applied between loop passes (the
+// pin change ISR runs on each)
+struct TriggerScript {
+  std::vector<std::pair<uint64_t, uint8_t>> edges;  // (sim micros, level)
+  size_t next = 0;
+
+  void update() {
+    while (next < edges.size() && edges[next].first <= sim::nowMicros) {
+      sim::setPin(TRIGGER_PIN, edges[next++].second);
+    }
+  }
+};
+
+// Count decoded log lines starting with `prefix`; echo them if asked
+static int logLines(const char* prefix, bool echo) {
+  std::string text = sim::serialText();
+  int count = 0;
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find('\n', start);
+    if (end == std::string::npos) end = text.size();
+    if (text.compare(start, strlen(prefix), prefix) == 0) {
+      count++;
+      if (echo) printf("%s\n", text.substr(start, end - start).c_str());
+    }
+    start = end + 1;
+  }
+  return count;
+}
+
+int main(int argc, char** argv) {
+  double idleSeconds = 30;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--idle-seconds") && i + 1 < argc) {
+      idleSeconds = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--verbose")) {
+      Serial.echo = true;
+    } else {
+      fprintf(stderr, "usage: %s [--idle-seconds N] [--verbose]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  sim::reset();
+  sim::useEventLog({HATCHING_EGG_EVENTS(EVENT_LOG_FORMAT)}, animationName);
+  const uint8_t boardAddresses[BOARD_COUNT] = {BOARD_LIST(BOARD_ADDRESS)};
+  for (const JointConfig& joint : JOINTS) {
+    sim::setSafeWindow(boardAddresses[joint.board], joint.channel,
+                       joint.pulses[0], joint.pulses[JOINT_MAX_DEGREES]);
+  }
+
+  printf("Hatching Egg - Host Simulation\n");
+  printf("==============================\n");
+  printf("%d props, %d joints on %d board%s\n", PROP_COUNT, JOINT_COUNT, BOARD_COUNT,
+         BOARD_COUNT == 1 ? "" : "s");
+
+  setup();
+  CurrentByAnimation current;
+  auto loopCounted = [&] { current.step(); };
+
+  // Phase 1: idle cycle
+  Resolution idleResolution;
+  sim::onServoWrite = [&](const sim::ServoWrite& w) { idleResolution.record(w); };
+  Snapshot idleStart = Snapshot::take();
+  sim::LoopStats idle = sim::runLoop(loopCounted, sim::nowMicros + (uint64_t)(idleSeconds * 1e6));
+  Snapshot idleEnd = Snapshot::take();
+  sim::onServoWrite = nullptr;
+
+  // Phase 2: press trigger (contacts bounce for 2.5 ms), wait for the
+  // first servo write
+  uint64_t pressedAt = sim::nowMicros;
+  uint64_t firstWriteAt = 0;
+  TriggerScript contact;
+  contact.edges = {{pressedAt + 300, HIGH}, {pressedAt + 700, LOW},
+                   {pressedAt + 1500, HIGH}, {pressedAt + 2500, LOW},
+                   // Hold 200 ms, release bounces for 1 ms
+                   {pressedAt + 200000, HIGH}, {pressedAt + 200400, LOW},
+                   {pressedAt + 201000, HIGH}};
+  sim::onServoWrite = [&](const sim::ServoWrite& w) {
+    if (!firstWriteAt) firstWriteAt = w.micros;
+  };
+  sim::setPin(TRIGGER_PIN, LOW);
+  sim::LoopStats reaction = sim::runLoop(loopCounted, pressedAt + 1000000, [&] {
+    contact.update();
+    return firstWriteAt != 0;
+  });
+  sim::onServoWrite = nullptr;
+  uint64_t latencyMicros = firstWriteAt - pressedAt;
+
+  sim::runLoop(loopCounted, pressedAt + 300000, [&] {
+    contact.update();
+    return false;
+  });
+
+  // Phase 3: rest of the triggered sequence
+  sim::LoopStats triggered = sim::runLoop(loopCounted, pressedAt + 120000000, [] {
+    return currentMode == MODE_IDLE_CYCLE;
+  });
+  Snapshot triggeredEnd = Snapshot::take();
+  int bouncyPressSequences = logLines("TRIGGERED!", false);
+
+  // Phase 4: a 0.3 ms press that starts and ends between two loop passes
+  sim::runLoop(loopCounted, sim::nowMicros + 2000000);
+  uint64_t shortPressAt = sim::nowMicros;
+  uint64_t shortPressWriteAt = 0;
+  sim::onServoWrite = [&](const sim::ServoWrite& w) {
+    if (!shortPressWriteAt && currentMode == MODE_TRIGGERED) shortPressWriteAt = w.micros;
+  };
+  sim::setPin(TRIGGER_PIN, LOW);
+  sim::advanceMicros(300);
+  sim::setPin(TRIGGER_PIN, HIGH);
+  sim::runLoop(loopCounted, shortPressAt + 100000, [&] {
+    return shortPressWriteAt != 0;
+  });
+  sim::onServoWrite = nullptr;
+  bool shortPressCaught = shortPressWriteAt != 0;
+  sim::runLoop(loopCounted, shortPressAt + 120000000, [] {
+    return currentMode == MODE_IDLE_CYCLE;
+  });
+
+  // Phase 5: serial status request, 2 s into the idle cycle
+  sim::runLoop(loopCounted, sim::nowMicros + 2000000);
+  Serial.input.push_back('s');
+  sim::runLoop(loopCounted, sim::nowMicros + 100000, [] { return Serial.input.empty(); });
+  bool statusCounted = logLines("Trigger-to-servo: ", false) == 1 &&
+                       sim::serialText().find(", 2 presses)") != std::string::npos;
+  std::string busStatus = "I2C " + std::to_string(bus.clockHz() / 1000) + " kHz:";
+  bool statusBus = logLines(busStatus.c_str(), false) == 1;
+
+  printf("\n");
+  sim::printLoopStats("Idle cycle", idle);
+  sim::printLoopStats("Triggered sequence", triggered);
+  printf("\n");
+  printPhase("Idle cycle", idleStart, idleEnd);
+  printPhase("Triggered sequence", idleEnd, triggeredEnd);
+  printf("\n");
+  sim::printFrameStats("Idle cycle", idle);
+  sim::printFrameStats("Triggered sequence", triggered);
+  bool idleFits = printBusBudget("Idle bus budget", idle);
+  bool triggeredFits = printBusBudget("Triggered bus budget", triggered);
+  printf("\n");
+  sim::printSerialBlock("Idle Frames:");
+  sim::printSerialBlock("Triggered Frames:");
+  sim::printSerialBlock("Idle I2C");
+  sim::printSerialBlock("Triggered I2C");
+  printf("\n");
+  current.print();
+  sim::printSerialBlock("Idle servo current");
+  sim::printSerialBlock("Triggered servo current");
+  printf("\n");
+  sim::EventLogDecoder log({HATCHING_EGG_EVENTS(EVENT_LOG_FORMAT)}, animationName);
+  log.feed(Serial.output);
+  printf("Event log:                   %llu records (%llu bytes), ring high water %u/%u, %lu dropped\n",
+         (unsigned long long)log.records, (unsigned long long)log.records * EVENT_LOG_WIRE_BYTES,
+         eventLog.highWater(), eventLog.capacity(), (unsigned long)eventLog.dropped());
+  printf("Idle pulse positions used:   %zu (largest step %d ticks)\n",
+         idleResolution.positions.size(), idleResolution.maxStep);
+  printf("Trigger-to-motion latency:   %llu us (%llu loop passes)\n",
+         (unsigned long long)latencyMicros, (unsigned long long)reaction.iterations);
+  printf("Sequences per bouncy press:  %d (%u edges, %u ignored as bounce, %llu pin change interrupts)\n",
+         bouncyPressSequences, (unsigned)contact.edges.size() + 1, trigger.bounces(),
+         (unsigned long long)sim::pinChangeInterrupts);
+  if (shortPressCaught) {
+    printf("0.3 ms press:                caught (first servo write %llu us after the press)\n",
+           (unsigned long long)(shortPressWriteAt - shortPressAt));
+  } else {
+    printf("0.3 ms press:                MISSED\n");
+  }
+  printf("Triggered sequence duration: %.2f s\n", (triggeredEnd.micros - pressedAt) / 1e6);
+  printf("setPWM() calls:              %llu\n", (unsigned long long)sim::setPWMCalls);
+  printf("Range violations:            %llu\n", (unsigned long long)sim::rangeViolations);
+  printf("\nSketch reports:\n");
+  logLines("Trigger-to-servo latency:", true);
+  logLines("Trigger-to-servo: ", true);
+  logLines(busStatus.c_str(), true);
+
+  if (currentMode != MODE_IDLE_CYCLE) {
+    printf("\n✗ Triggered sequence did not return to idle\n");
+    return 1;
+  }
+  if (bouncyPressSequences != 1) {
+    printf("\n✗ Contact bounce started %d sequences\n", bouncyPressSequences);
+    return 1;
+  }
+  if (!shortPressCaught) {
+    printf("\n✗ Short trigger press missed\n");
+    return 1;
+  }
+  if (!statusCounted) {
+    printf("\n✗ Serial status doesn't report the trigger latency of both presses\n");
+    return 1;
+  }
+  if (!statusBus) {
+    printf("\n✗ Serial status doesn't report the I2C counters\n");
+    return 1;
+  }
+  if (!idleFits || !triggeredFits) {
+    printf("\n✗ A frame's servo writes took longer than the frame\n");
+    return 1;
+  }
+  if (current.peak() > CURRENT_BUDGET_MILLIAMPS) {
+    printf("\n✗ A frame's estimated servo current passed the budget\n");
+    return 1;
+  }
+  if (sim::rangeViolations) {
+    printf("\n✗ Servo writes outside calibrated range\n");
+    return 1;
+  }
+  printf("\n✓ Simulation OK\n");
+  return 0;
+}
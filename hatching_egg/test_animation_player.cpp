@@ -0,0 +1,577 @@
+/*
+ * Unit Tests for Animation Player Math
+ *
+ * Verifies the fixed-point playback math, packed keyframe decoding and
+ * keyframe cursor in animation_player.h against the float version and
+ * linear keyframe scan they replaced, using the real generated keyframes.
+ * Baked animations are checked frame by frame against the live player
+ * (LIVE_ANIMATIONS keeps their keyframes on the host).
+ * Uses Google Test framework.
+ *
+ * Build and run:
+ *   pixi run test-animation-player
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "Arduino.h"
+#include "servo_lut.h"
+#define ANIMATION_CONFIG_LIVE_TABLE
+#include "arduino/hatching_egg/animation_player.h"
+
+// Same calibration tables as the sketch
+typedef ServoPulseTable<LEFT_SHOULDER_MIN_PULSE, LEFT_SHOULDER_MAX_PULSE> LeftShoulderTable;
+typedef ServoPulseTable<LEFT_ELBOW_MIN_PULSE, LEFT_ELBOW_MAX_PULSE> LeftElbowTable;
+typedef ServoPulseTable<RIGHT_SHOULDER_MIN_PULSE, RIGHT_SHOULDER_MAX_PULSE> RightShoulderTable;
+typedef ServoPulseTable<RIGHT_ELBOW_MIN_PULSE, RIGHT_ELBOW_MAX_PULSE> RightElbowTable;
+
+struct Key {
+    uint32_t time_ms;
+    int angle;
+};
+
+// Independent decoder for one track of a packed animation
+static std::vector<Key> trackKeys(const Animation& anim, int track) {
+    std::vector<Key> keys;
+    const uint8_t* p = anim.data;
+    uint32_t time = 0;
+    if (anim.flags & ANIM_FLAG_SPARSE) {
+        for (int j = 0; j < track; j++) p += 1 + p[0] * 3;
+        int count = *p++;
+        for (int k = 0; k < count; k++, p += 3) {
+            time += p[0] | (p[1] << 8);
+            keys.push_back(Key{time, p[2]});
+        }
+    } else {
+        for (int k = 0; k < anim.keyframe_count; k++, p += 6) {
+            time += p[0] | (p[1] << 8);
+            keys.push_back(Key{time, p[2 + track]});
+        }
+    }
+    return keys;
+}
+
+// Float reference: the original updateAnimation() interpolation
+static int floatLerp(int a, int b, unsigned long elapsed, unsigned long t1, unsigned long t2) {
+    float t = (float)(elapsed - t1) / (float)(t2 - t1);
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    return a + (int)((b - a) * t);
+}
+
+// Both implementations over one animation; returns worst angle difference
+static int worstDifference(const Animation& anim) {
+    int worst = 0;
+    for (int j = 0; j < POSE_JOINTS; j++) {
+        std::vector<Key> keys = trackKeys(anim, j);
+        for (unsigned long ms = 0; ms < anim.duration_ms; ms++) {
+            for (size_t i = 0; i + 1 < keys.size(); i++) {
+                const Key& a = keys[i];
+                const Key& b = keys[i + 1];
+                if (ms < a.time_ms || ms >= b.time_ms) continue;
+                int fixed = lerpQ15(a.angle, b.angle, segmentFraction(ms, a.time_ms, b.time_ms));
+                int reference = floatLerp(a.angle, b.angle, ms, a.time_ms, b.time_ms);
+                worst = std::max(worst, std::abs(fixed - reference));
+            }
+        }
+    }
+    return worst;
+}
+
+// Linear scan reference: the original updateAnimation() keyframe lookup, per track
+static void scanPose(const Animation& anim, unsigned long elapsed, int* pose) {
+    for (int j = 0; j < POSE_JOINTS; j++) {
+        std::vector<Key> keys = trackKeys(anim, j);
+        if (keys.size() == 1) {
+            pose[j] = keys[0].angle;
+            continue;
+        }
+        size_t k1 = keys.size() - 2;  // Past the end: hold the last key
+        for (size_t i = 0; i + 1 < keys.size(); i++) {
+            if (elapsed >= keys[i].time_ms && elapsed < keys[i + 1].time_ms) {
+                k1 = i;
+                break;
+            }
+        }
+        const Key& a = keys[k1];
+        const Key& b = keys[k1 + 1];
+        pose[j] = lerpQ15(a.angle, b.angle, segmentFraction(elapsed, a.time_ms, b.time_ms));
+    }
+}
+
+// Re-encode a dense animation as sparse (holds dropped, like the generator)
+struct SparseCopy {
+    std::vector<uint8_t> bytes;
+    Animation anim;
+};
+
+static SparseCopy makeSparse(const Animation& dense) {
+    SparseCopy copy;
+    for (int j = 0; j < POSE_JOINTS; j++) {
+        std::vector<Key> keys = trackKeys(dense, j);
+        std::vector<Key> kept;
+        for (size_t k = 0; k < keys.size(); k++) {
+            bool hold = k > 0 && k + 1 < keys.size() &&
+                        keys[k - 1].angle == keys[k].angle && keys[k].angle == keys[k + 1].angle;
+            if (!hold) kept.push_back(keys[k]);
+        }
+        copy.bytes.push_back((uint8_t)kept.size());
+        uint32_t previous = 0;
+        for (const Key& key : kept) {
+            uint32_t delta = key.time_ms - previous;
+            copy.bytes.push_back((uint8_t)(delta & 0xFF));
+            copy.bytes.push_back((uint8_t)(delta >> 8));
+            copy.bytes.push_back((uint8_t)key.angle);
+            previous = key.time_ms;
+        }
+    }
+    copy.anim = dense;
+    copy.anim.data = copy.bytes.data();
+    copy.anim.flags |= ANIM_FLAG_SPARSE;
+    copy.anim.keyframe_count = 0;
+    return copy;
+}
+
+static void poseAt(KeyframeCursor* cursor, uint32_t elapsed, int* pose) {
+    cursorSeek(cursor, elapsed);
+    cursorPose(cursor, elapsed, pose);
+}
+
+// Speed Encoding Tests
+TEST(SpeedQ8, SequenceSpeedsEncodeExactly) {
+    EXPECT_EQ(256, SPEED_Q8(1.0));
+    EXPECT_EQ(384, SPEED_Q8(1.5));
+    EXPECT_EQ(512, SPEED_Q8(2.0));
+    EXPECT_EQ(640, SPEED_Q8(2.5));
+}
+
+TEST(SpeedQ8, ExhaustedSpeedWithinHalfPercent) {
+    EXPECT_NEAR(0.3, SPEED_Q8(0.3) / 256.0, 0.005);
+}
+
+TEST(SpeedQ8, HundredthsForPrinting) {
+    EXPECT_EQ(0, speedHundredths(SPEED_Q8(2.0)));
+    EXPECT_EQ(50, speedHundredths(SPEED_Q8(1.5)));
+    EXPECT_EQ(30, speedHundredths(SPEED_Q8(0.3)));
+}
+
+// Elapsed / Duration Scaling Tests
+TEST(ScaleElapsed, NormalSpeedIsIdentity) {
+    EXPECT_EQ(1234u, scaleElapsed(1234, SPEED_Q8(1.0)));
+}
+
+TEST(ScaleElapsed, FasterSpeedsMatchFloat) {
+    for (uint32_t ms = 0; ms < 10000; ms += 7) {
+        EXPECT_EQ((uint32_t)(ms * 1.5f), scaleElapsed(ms, SPEED_Q8(1.5)));
+        EXPECT_EQ((uint32_t)(ms * 2.5f), scaleElapsed(ms, SPEED_Q8(2.5)));
+    }
+}
+
+TEST(ScaleDuration, MatchesFloatForSequenceSpeeds) {
+    EXPECT_EQ(2400u, scaleDuration(2400, SPEED_Q8(1.0)));
+    EXPECT_EQ(1600u, scaleDuration(2400, SPEED_Q8(1.5)));
+    EXPECT_EQ(1200u, scaleDuration(2400, SPEED_Q8(2.0)));
+    EXPECT_EQ(960u, scaleDuration(2400, SPEED_Q8(2.5)));
+}
+
+TEST(ScaleDuration, ExhaustedSpeedWithinOnePercent) {
+    EXPECT_NEAR(8000.0, scaleDuration(2400, SPEED_Q8(0.3)), 80.0);
+}
+
+TEST(ScaleDuration, ZeroSpeedNeverFinishes) {
+    EXPECT_EQ(0xFFFFFFFFu, scaleDuration(2400, 0));
+}
+
+// Segment Fraction Tests
+TEST(SegmentFraction, StartIsZero) {
+    EXPECT_EQ(0, segmentFraction(200, 200, 350));
+}
+
+TEST(SegmentFraction, BeforeStartClampsToZero) {
+    EXPECT_EQ(0, segmentFraction(100, 200, 350));
+}
+
+TEST(SegmentFraction, EndIsOne) {
+    EXPECT_EQ(FRAC_Q15_ONE, segmentFraction(350, 200, 350));
+    EXPECT_EQ(FRAC_Q15_ONE, segmentFraction(900, 200, 350));
+}
+
+TEST(SegmentFraction, Midpoint) {
+    EXPECT_EQ(FRAC_Q15_ONE / 2, segmentFraction(1000, 0, 2000));
+}
+
+TEST(SegmentFraction, ZeroLengthSegment) {
+    EXPECT_EQ(0, segmentFraction(500, 500, 500));
+}
+
+TEST(SegmentFraction, VeryLongSegment) {
+    EXPECT_NEAR(FRAC_Q15_ONE / 4, segmentFraction(50000, 0, 200000), 2);
+}
+
+// Interpolation Tests
+TEST(LerpQ15, Endpoints) {
+    EXPECT_EQ(25, lerpQ15(25, 70, 0));
+    EXPECT_EQ(70, lerpQ15(25, 70, FRAC_Q15_ONE));
+    EXPECT_EQ(70, lerpQ15(70, 25, 0));
+    EXPECT_EQ(25, lerpQ15(70, 25, FRAC_Q15_ONE));
+}
+
+TEST(LerpQ15, TruncatesTowardZeroLikeFloat) {
+    // 3 * 0.5 = 1.5 -> 1 ; -3 * 0.5 = -1.5 -> -1
+    EXPECT_EQ(6, lerpQ15(5, 8, FRAC_Q15_ONE / 2));
+    EXPECT_EQ(7, lerpQ15(8, 5, FRAC_Q15_ONE / 2));
+}
+
+TEST(LerpQ15, FullRangeSweep) {
+    for (int a = 0; a <= 90; a += 15) {
+        for (int b = 0; b <= 90; b += 15) {
+            for (uint32_t f = 0; f <= FRAC_Q15_ONE; f += 512) {
+                int fixed = lerpQ15(a, b, (uint16_t)f);
+                EXPECT_GE(fixed, std::min(a, b));
+                EXPECT_LE(fixed, std::max(a, b));
+            }
+        }
+    }
+}
+
+// Sub-Degree Interpolation Tests
+TEST(LerpQ15Q8, Endpoints) {
+    EXPECT_EQ(25 * 256, lerpQ15Q8(25, 70, 0));
+    EXPECT_EQ(70 * 256, lerpQ15Q8(25, 70, FRAC_Q15_ONE));
+    EXPECT_EQ(70 * 256, lerpQ15Q8(70, 25, 0));
+    EXPECT_EQ(25 * 256, lerpQ15Q8(70, 25, FRAC_Q15_ONE));
+}
+
+TEST(LerpQ15Q8, KeepsFractionOfADegree) {
+    // RESTING 5 -> 8 degrees: halfway is 6.5, not 6
+    EXPECT_EQ(6 * 256 + 128, lerpQ15Q8(5, 8, FRAC_Q15_ONE / 2));
+    EXPECT_EQ(6 * 256 + 128, lerpQ15Q8(8, 5, FRAC_Q15_ONE / 2));
+}
+
+TEST(LerpQ15Q8, WithinHalfStepOfFloat) {
+    for (int a = 0; a <= 90; a += 15) {
+        for (int b = 0; b <= 90; b += 15) {
+            for (uint32_t f = 0; f <= FRAC_Q15_ONE; f += 97) {
+                double exact = (a + (b - a) * (f / 32768.0)) * 256;
+                EXPECT_NEAR(exact, lerpQ15Q8(a, b, (uint16_t)f), 0.5);
+            }
+        }
+    }
+}
+
+// Generated Keyframe Tests (every millisecond of every animation)
+TEST(FixedVsFloat, AllAnimationsWithinOneDegree) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        EXPECT_LE(worstDifference(LIVE_ANIMATIONS[i]), 1) << LIVE_ANIMATIONS[i].name;
+    }
+}
+
+TEST(FixedVsFloat, KeyframesHitExactly) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        for (int j = 0; j < POSE_JOINTS; j++) {
+            std::vector<Key> keys = trackKeys(LIVE_ANIMATIONS[i], j);
+            for (size_t k = 0; k + 1 < keys.size(); k++) {
+                const Key& a = keys[k];
+                const Key& b = keys[k + 1];
+                EXPECT_EQ(a.angle, lerpQ15(a.angle, b.angle, segmentFraction(a.time_ms, a.time_ms, b.time_ms)));
+                EXPECT_EQ(b.angle, lerpQ15(a.angle, b.angle, segmentFraction(b.time_ms, a.time_ms, b.time_ms)));
+            }
+        }
+    }
+}
+
+// Packed Format Tests
+TEST(PackedFormat, TracksEndAtDuration) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        const Animation& anim = LIVE_ANIMATIONS[i];
+        for (int j = 0; j < POSE_JOINTS; j++) {
+            std::vector<Key> keys = trackKeys(anim, j);
+            ASSERT_FALSE(keys.empty()) << anim.name;
+            EXPECT_EQ(0u, keys.front().time_ms) << anim.name;
+            if (keys.size() > 1) {
+                EXPECT_EQ(anim.duration_ms, keys.back().time_ms) << anim.name;
+            }
+            for (size_t k = 1; k < keys.size(); k++) EXPECT_GE(keys[k].time_ms, keys[k - 1].time_ms);
+        }
+    }
+}
+
+TEST(PackedFormat, AnglesWithinServoRange) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        for (int j = 0; j < POSE_JOINTS; j++) {
+            for (const Key& key : trackKeys(LIVE_ANIMATIONS[i], j)) {
+                EXPECT_GE(key.angle, 0);
+                EXPECT_LE(key.angle, 90);
+            }
+        }
+    }
+}
+
+TEST(PackedFormat, DenseKeyIsSixBytes) {
+    static const uint8_t data[] = {KEY_U16(0), 1, 2, 3, 4, KEY_U16(1500), 5, 6, 7, 8};
+    EXPECT_EQ(2u * DENSE_KEY_BYTES, sizeof(data));
+    Animation anim = {"", data, 1500, 0, 2};
+    std::vector<Key> keys = trackKeys(anim, 2);
+    EXPECT_EQ(1500u, keys[1].time_ms);
+    EXPECT_EQ(7, keys[1].angle);
+}
+
+TEST(PackedFormat, SparseTracksDecodeIndependently) {
+    // ls: 0 -> 90 over 1000 ms; le: held at 45; rs: 10 until 500 then to 20; re: held at 0
+    static const uint8_t data[] = {
+        2, KEY_U16(0), 0, KEY_U16(1000), 90,
+        1, KEY_U16(0), 45,
+        3, KEY_U16(0), 10, KEY_U16(500), 10, KEY_U16(500), 20,
+        1, KEY_U16(0), 0,
+    };
+    Animation anim = {"", data, 1000, ANIM_FLAG_SPARSE, 0};
+    KeyframeCursor cursor;
+    cursorReset(&cursor, &anim);
+    int pose[4];
+    poseAt(&cursor, 250, pose);
+    EXPECT_EQ(22, pose[0]);
+    EXPECT_EQ(45, pose[1]);
+    EXPECT_EQ(10, pose[2]);
+    EXPECT_EQ(0, pose[3]);
+    poseAt(&cursor, 750, pose);
+    EXPECT_EQ(67, pose[0]);
+    EXPECT_EQ(15, pose[2]);
+    poseAt(&cursor, 1000, pose);
+    EXPECT_EQ(90, pose[0]);
+    EXPECT_EQ(20, pose[2]);
+}
+
+TEST(PackedFormat, SparseMatchesDenseEveryMillisecond) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        const Animation& dense = LIVE_ANIMATIONS[i];
+        SparseCopy sparse = makeSparse(dense);
+        KeyframeCursor a, b;
+        cursorReset(&a, &dense);
+        cursorReset(&b, &sparse.anim);
+        for (uint32_t ms = 0; ms < dense.duration_ms; ms++) {
+            int expected[4], actual[4];
+            poseAt(&a, ms, expected);
+            poseAt(&b, ms, actual);
+            for (int j = 0; j < 4; j++) {
+                ASSERT_EQ(expected[j], actual[j]) << dense.name << " at " << ms << " ms, joint " << j;
+            }
+        }
+    }
+}
+
+// Keyframe Cursor Tests
+TEST(KeyframeCursor, StartsOnFirstSegment) {
+    const Animation& anim = LIVE_ANIMATIONS[6];
+    std::vector<Key> ls = trackKeys(anim, 0);
+    std::vector<Key> re = trackKeys(anim, 3);
+    KeyframeCursor cursor;
+    cursorReset(&cursor, &anim);
+    EXPECT_EQ(ls[0].time_ms, cursor.tracks[0].t1);
+    EXPECT_EQ(ls[1].time_ms, cursor.tracks[0].t2);
+    EXPECT_EQ(ls[0].angle, cursor.tracks[0].from);
+    EXPECT_EQ(re[1].angle, cursor.tracks[3].to);
+}
+
+TEST(KeyframeCursor, MatchesLinearScanEveryMillisecond) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        const Animation& anim = LIVE_ANIMATIONS[i];
+        KeyframeCursor cursor;
+        cursorReset(&cursor, &anim);
+        int worst = 0;
+        for (unsigned long ms = 0; ms < anim.duration_ms; ms++) {
+            int expected[4], actual[4];
+            scanPose(anim, ms, expected);
+            poseAt(&cursor, ms, actual);
+            for (int j = 0; j < 4; j++) {
+                worst = std::max(worst, std::abs(expected[j] - actual[j]));
+            }
+        }
+        EXPECT_LE(worst, 1) << anim.name;
+    }
+}
+
+TEST(KeyframeCursor, KeyframesHitExactly) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        const Animation& anim = LIVE_ANIMATIONS[i];
+        KeyframeCursor cursor;
+        cursorReset(&cursor, &anim);
+        std::vector<Key> ls = trackKeys(anim, 0);
+        std::vector<Key> re = trackKeys(anim, 3);
+        for (size_t k = 0; k < ls.size(); k++) {
+            int pose[4];
+            poseAt(&cursor, ls[k].time_ms, pose);
+            EXPECT_EQ(ls[k].angle, pose[0]) << anim.name << " kf " << k;
+            EXPECT_EQ(re[k].angle, pose[3]) << anim.name << " kf " << k;
+        }
+    }
+}
+
+TEST(KeyframeCursor, OnlyMovesForward) {
+    const Animation& anim = LIVE_ANIMATIONS[5];
+    KeyframeCursor cursor;
+    cursorReset(&cursor, &anim);
+    uint32_t lastStart = 0;
+    for (unsigned long ms = 0; ms < anim.duration_ms; ms += 20) {
+        cursorSeek(&cursor, ms);
+        EXPECT_GE(cursor.tracks[0].t1, lastStart);
+        lastStart = cursor.tracks[0].t1;
+    }
+    EXPECT_EQ(0, cursor.tracks[0].remaining);
+}
+
+TEST(KeyframeCursor, SkipsSegmentsOnLateUpdate) {
+    // A long gap between updates (e.g. 2.5x speed) can jump several keyframes
+    const Animation& anim = LIVE_ANIMATIONS[6];
+    std::vector<Key> keys = trackKeys(anim, 0);
+    KeyframeCursor cursor;
+    cursorReset(&cursor, &anim);
+    cursorSeek(&cursor, keys[3].time_ms + 1);
+    EXPECT_EQ(keys[3].time_ms, cursor.tracks[0].t1);
+    EXPECT_EQ(keys[4].time_ms, cursor.tracks[0].t2);
+}
+
+TEST(KeyframeCursor, RewindsIfTimeGoesBack) {
+    const Animation& anim = LIVE_ANIMATIONS[6];
+    KeyframeCursor cursor;
+    cursorReset(&cursor, &anim);
+    cursorSeek(&cursor, anim.duration_ms - 1);
+    int expected[4], actual[4];
+    scanPose(anim, 0, expected);
+    poseAt(&cursor, 0, actual);
+    EXPECT_EQ(0u, cursor.tracks[0].t1);
+    EXPECT_EQ(expected[0], actual[0]);
+}
+
+TEST(KeyframeCursor, HoldsLastKeyframePastEnd) {
+    const Animation& anim = LIVE_ANIMATIONS[6];
+    std::vector<Key> ls = trackKeys(anim, 0);
+    std::vector<Key> re = trackKeys(anim, 3);
+    KeyframeCursor cursor;
+    cursorReset(&cursor, &anim);
+    int pose[4];
+    poseAt(&cursor, anim.duration_ms + 5000, pose);
+    EXPECT_EQ(ls.back().angle, pose[0]);
+    EXPECT_EQ(re.back().angle, pose[3]);
+}
+
+TEST(KeyframeCursor, SingleKeyframeHoldsPose) {
+    // zero/max reference poses have one keyframe; never read past it
+    static const uint8_t single[] = {KEY_U16(0), 10, 20, 30, 40};
+    Animation anim = {"", single, 1000, 0, 1};
+    KeyframeCursor cursor;
+    cursorReset(&cursor, &anim);
+    int pose[4];
+    poseAt(&cursor, 1500, pose);
+    EXPECT_EQ(10, pose[0]);
+    EXPECT_EQ(40, pose[3]);
+}
+
+TEST(KeyframeCursor, ReciprocalFractionMatchesDivide) {
+    const uint32_t spans[] = {1, 3, 7, 100, 150, 333, 1000, 2400, 4095, 30000, 65535};
+    for (uint32_t span : spans) {
+        TrackCursor track = {};
+        track.t1 = 0;
+        track.t2 = span;
+        trackLoadSpan(&track);
+        for (uint32_t dt = 0; dt <= span; dt += (span / 500) + 1) {
+            EXPECT_NEAR(segmentFraction(dt, 0, span), trackFraction(&track, dt), 1) << span << " " << dt;
+        }
+    }
+}
+
+TEST(KeyframeCursor, ReciprocalExactAtWholeSteps) {
+    TrackCursor track = {};
+    for (uint32_t span = 2; span <= 4000; span += 2) {
+        track.t1 = 0;
+        track.t2 = span;
+        trackLoadSpan(&track);
+        ASSERT_EQ(FRAC_Q15_ONE / 2, trackFraction(&track, span / 2)) << span;
+    }
+}
+
+TEST(KeyframeCursor, PoseQ8AgreesWithWholeDegreePose) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        const Animation& anim = LIVE_ANIMATIONS[i];
+        KeyframeCursor cursor;
+        cursorReset(&cursor, &anim);
+        for (unsigned long ms = 0; ms < anim.duration_ms; ms++) {
+            int pose[POSE_JOINTS];
+            AngleQ8 fine[POSE_JOINTS];
+            poseAt(&cursor, ms, pose);
+            cursorPoseQ8(&cursor, ms, fine);
+            for (int j = 0; j < POSE_JOINTS; j++) {
+                ASSERT_LE(std::abs((int)fine[j] - pose[j] * 256), 256) << anim.name << " at " << ms;
+            }
+        }
+    }
+}
+
+TEST(KeyframeCursor, LongSegmentFallsBackToDivide) {
+    TrackCursor track = {};
+    track.t1 = 0;
+    track.t2 = 200000;
+    trackLoadSpan(&track);
+    EXPECT_EQ(0u, track.invSpan);
+    EXPECT_NEAR(FRAC_Q15_ONE / 4, trackFraction(&track, 50000), 2);
+}
+
+// Baked Playback Tests
+TEST(BakedPlayback, MatchesLivePlayerEveryFrame) {
+    int baked = 0;
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        if (!animationBaked(&ANIMATIONS[i])) continue;
+        baked++;
+        KeyframeCursor cursor;
+        cursorReset(&cursor, &LIVE_ANIMATIONS[i]);
+        for (uint32_t ms = 0; ms < ANIMATIONS[i].duration_ms; ms += BAKE_FRAME_MS) {
+            AngleQ8 pose[POSE_JOINTS];
+            cursorSeek(&cursor, ms);
+            cursorPoseQ8(&cursor, ms, pose);
+            uint16_t ticks[POSE_JOINTS];
+            bakedPose(&ANIMATIONS[i], ms, ticks);
+            ASSERT_EQ(LeftShoulderTable::lookupQ8(pose[0]), ticks[0]) << ANIMATIONS[i].name << " at " << ms;
+            ASSERT_EQ(LeftElbowTable::lookupQ8(pose[1]), ticks[1]) << ANIMATIONS[i].name << " at " << ms;
+            ASSERT_EQ(RightShoulderTable::lookupQ8(pose[2]), ticks[2]) << ANIMATIONS[i].name << " at " << ms;
+            ASSERT_EQ(RightElbowTable::lookupQ8(pose[3]), ticks[3]) << ANIMATIONS[i].name << " at " << ms;
+        }
+    }
+    EXPECT_GT(baked, 0);
+}
+
+TEST(BakedPlayback, HoldsFrameBetweenSamples) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        if (!animationBaked(&ANIMATIONS[i])) continue;
+        for (uint32_t ms = 0; ms < ANIMATIONS[i].duration_ms; ms++) {
+            uint16_t ticks[POSE_JOINTS];
+            uint16_t sample[POSE_JOINTS];
+            bakedPose(&ANIMATIONS[i], ms, ticks);
+            bakedPose(&ANIMATIONS[i], ms - ms % BAKE_FRAME_MS, sample);
+            ASSERT_EQ(0, memcmp(ticks, sample, sizeof(ticks))) << ANIMATIONS[i].name << " at " << ms;
+        }
+    }
+}
+
+TEST(BakedPlayback, HoldsLastFramePastEnd) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) {
+        if (!animationBaked(&ANIMATIONS[i])) continue;
+        uint16_t last[POSE_JOINTS];
+        uint16_t past[POSE_JOINTS];
+        bakedPose(&ANIMATIONS[i], ANIMATIONS[i].duration_ms - 1, last);
+        bakedPose(&ANIMATIONS[i], ANIMATIONS[i].duration_ms + 5000, past);
+        EXPECT_EQ(0, memcmp(last, past, sizeof(last))) << ANIMATIONS[i].name;
+    }
+}
+
+TEST(BakedPlayback, FrameIndexMatchesDivide) {
+    // The rounded-up reciprocal is exact below 16384 ms (generator enforces it)
+    for (uint32_t ms = 0; ms < 16384; ms++) {
+        ASSERT_EQ(ms / BAKE_FRAME_MS, bakedFrameIndex(ms)) << ms;
+    }
+    EXPECT_NE(16384u / BAKE_FRAME_MS, bakedFrameIndex(16384 + BAKE_FRAME_MS - 1));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,378 @@
+#!/usr/bin/env python3
+"""
+Unit tests for the packed keyframe format in generate_arduino_config.py
+
+Decodes the emitted byte lists back into keyframes and checks they match
+animation-config.json, and that out-of-range data is rejected instead of
+silently wrapping in a uint8/uint16 field. Baked frames are checked at the
+keyframes here; test_animation_player.cpp checks every frame against the
+C++ player. Joints are checked against clutch-hardware.json: every
+(board, channel) used once, and every joint moving fits the I2C bus in one
+servo frame
+at the configured I2C clock, and the servo current models add up against
+the supply budget.
+"""
+
+import copy
+import json
+import re
+import tempfile
+import unittest
+from pathlib import Path
+
+import generate_arduino_config as gen
+
+
+def to_bytes(lines):
+    """Evaluate emitted C initializer lines (KEY_U16 expanded) into bytes."""
+    data = []
+    for line in lines:
+        line = line.split('//')[0]
+        line = re.sub(r'KEY_U16\((\d+)\)', lambda m: f"{int(m.group(1)) & 0xFF}, {int(m.group(1)) >> 8}", line)
+        data.extend(int(v) for v in line.replace(',', ' ').split())
+    return data
+
+
+def decode(data, sparse, keyframe_count):
+    """Per-track [(time_ms, angle)] from packed bytes."""
+    tracks = []
+    if sparse:
+        pos = 0
+        for _ in gen.TRACKS:
+            count = data[pos]
+            pos += 1
+            time, keys = 0, []
+            for _ in range(count):
+                time += data[pos] | (data[pos + 1] << 8)
+                keys.append((time, data[pos + 2]))
+                pos += 3
+            tracks.append(keys)
+        return tracks
+    for j in range(len(gen.TRACKS)):
+        time, keys = 0, []
+        for k in range(keyframe_count):
+            key = data[k * gen.DENSE_KEY_BYTES:(k + 1) * gen.DENSE_KEY_BYTES]
+            time += key[0] | (key[1] << 8)
+            keys.append((time, key[2 + j]))
+        tracks.append(keys)
+    return tracks
+
+
+def interpolate(keys, t):
+    """Track angle at time t (linear, holds past the ends)."""
+    if t <= keys[0][0]:
+        return keys[0][1]
+    for (t1, a1), (t2, a2) in zip(keys, keys[1:]):
+        if t1 <= t <= t2 and t2 > t1:
+            return a1 + (a2 - a1) * (t - t1) / (t2 - t1)
+    return keys[-1][1]
+
+
+class TestPackedKeyframes(unittest.TestCase):
+    """Round-trip the packed format against animation-config.json"""
+
+    @classmethod
+    def setUpClass(cls):
+        """Load configuration"""
+        config_path = Path(__file__).parent / 'animation-config.json'
+        with open(config_path, 'r') as f:
+            cls.config = json.load(f)
+
+    def test_dense_round_trip(self):
+        """Dense encoding decodes to exactly the JSON keyframes"""
+        for anim_id, anim in self.config['animations'].items():
+            tracks = decode(to_bytes(gen.encode_dense(anim)), False, len(anim['keyframes']))
+            for j, track in enumerate(gen.TRACKS):
+                expected = [(kf['time_ms'], kf[track]) for kf in anim['keyframes']]
+                self.assertEqual(expected, tracks[j], f"{anim_id} {track}")
+
+    def test_sparse_round_trip_same_motion(self):
+        """Sparse encoding gives the same angle at every millisecond"""
+        for anim_id, anim in self.config['animations'].items():
+            dense = decode(to_bytes(gen.encode_dense(anim)), False, len(anim['keyframes']))
+            sparse = decode(to_bytes(gen.encode_sparse(anim)), True, 0)
+            for j in range(len(gen.TRACKS)):
+                for t in range(0, anim['duration_ms'] + 1):
+                    self.assertEqual(interpolate(dense[j], t), interpolate(sparse[j], t),
+                                     f"{anim_id} track {j} at {t} ms")
+
+    def test_sparse_drops_only_holds(self):
+        """Stabbing's left leg holds 0/90 from 1000 ms to the end"""
+        stabbing = self.config['animations']['stabbing']
+        left_shoulder = gen.sparse_tracks(stabbing)[0]
+        times = [t for t, _ in left_shoulder]
+        self.assertNotIn(1400, times)
+        self.assertIn(1000, times)
+        self.assertEqual(stabbing['duration_ms'], times[-1])
+
+    def test_byte_counts_match_encoding(self):
+        """Reported sizes are the sizes actually emitted"""
+        for anim in self.config['animations'].values():
+            self.assertEqual(gen.dense_bytes(anim), len(to_bytes(gen.encode_dense(anim))))
+            self.assertEqual(gen.sparse_bytes(anim), len(to_bytes(gen.encode_sparse(anim))))
+
+    def test_auto_picks_smaller_layout(self):
+        """'auto' never emits more bytes than the other layout"""
+        for anim in self.config['animations'].values():
+            sparse, lines = gen.pack_animation(anim)
+            size = len(to_bytes(lines))
+            self.assertEqual(min(gen.dense_bytes(anim), gen.sparse_bytes(anim)), size)
+            self.assertEqual(sparse, gen.sparse_bytes(anim) < gen.dense_bytes(anim))
+
+    def test_packed_smaller_than_legacy(self):
+        """Packed keyframes + table use less PROGMEM than the old structs"""
+        animations = self.config['animations']
+        packed = {anim_id: gen.pack_animation(anim) for anim_id, anim in animations.items()}
+        legacy, new = gen.progmem_bytes(animations, packed)
+        self.assertLess(new, legacy)
+
+    def test_rejects_angle_over_uint8(self):
+        """An angle that would wrap in uint8 is an error, not a silent wrap"""
+        anim = copy.deepcopy(self.config['animations']['resting'])
+        anim['keyframes'][1]['left_elbow_deg'] = 300
+        with self.assertRaises(ValueError):
+            gen.pack_animation(anim)
+
+    def test_rejects_gap_over_uint16(self):
+        """A keyframe gap over 65535 ms does not fit the time delta"""
+        anim = copy.deepcopy(self.config['animations']['resting'])
+        anim['keyframes'][2]['time_ms'] = 70000
+        anim['duration_ms'] = 70000
+        with self.assertRaises(ValueError):
+            gen.pack_animation(anim)
+
+    def test_rejects_duration_over_uint16(self):
+        """Durations are stored as uint16"""
+        anim = copy.deepcopy(self.config['animations']['resting'])
+        anim['duration_ms'] = 70000
+        with self.assertRaises(ValueError):
+            gen.pack_animation(anim)
+
+
+class TestBakedPlayback(unittest.TestCase):
+    """Pre-rendered PCA9685 tick frames"""
+
+    @classmethod
+    def setUpClass(cls):
+        """Load configuration"""
+        config_path = Path(__file__).parent / 'animation-config.json'
+        with open(config_path, 'r') as f:
+            cls.config = json.load(f)
+        cls.hw = cls.config['hardware']
+        cls.frame_ms = gen.bake_frame_ms(cls.hw)
+
+    def test_pulse_table_matches_map(self):
+        """Table entries truncate toward zero like Arduino map()"""
+        table = gen.pulse_table(440, 300)  # Inverted left shoulder
+        self.assertEqual(440, table[0])
+        self.assertEqual(300, table[90])
+        self.assertEqual(439, table[1])  # 440 - 1.55, not 440 - 2
+
+    def test_frames_hit_keyframe_ticks(self):
+        """A frame on a keyframe time is exactly that keyframe's pulse"""
+        bases_tables = [(min(lo, hi), gen.pulse_table(lo, hi)) for lo, hi in gen.pulse_ranges(self.hw)]
+        for anim_id, anim in self.config['animations'].items():
+            frames = gen.bake_animation(anim, self.hw)
+            for kf in anim['keyframes']:
+                k = kf['time_ms'] // self.frame_ms
+                if kf['time_ms'] % self.frame_ms or k >= len(frames):
+                    continue
+                for j, track in enumerate(gen.TRACKS):
+                    base, table = bases_tables[j]
+                    self.assertEqual(table[kf[track]] - base, frames[k][j], f"{anim_id} {track} at {kf['time_ms']}")
+
+    def test_byte_counts_match_encoding(self):
+        """One byte per joint per frame, frames cover the whole duration"""
+        for anim in self.config['animations'].values():
+            frames = gen.bake_animation(anim, self.hw)
+            self.assertEqual(-(-anim['duration_ms'] // self.frame_ms), len(frames))
+            self.assertEqual(gen.baked_bytes(anim, self.frame_ms),
+                             len(to_bytes(gen.encode_baked(frames, self.frame_ms))))
+
+    def test_playback_selection(self):
+        """Live unless the animation asks for baked; typos are errors"""
+        anim = copy.deepcopy(self.config['animations']['grasping'])
+        anim.pop('playback', None)
+        self.assertFalse(gen.is_baked(anim))
+        anim['playback'] = 'baked'
+        self.assertTrue(gen.is_baked(anim))
+        anim['playback'] = 'bake'
+        with self.assertRaises(ValueError):
+            gen.is_baked(anim)
+
+    def test_header_flags_baked_animations(self):
+        """Baked animations get ANIM_FLAG_BAKED and no keyframe count"""
+        config = copy.deepcopy(self.config)
+        for anim in config['animations'].values():
+            anim['playback'] = 'live'
+        config['animations']['grasping']['playback'] = 'baked'
+        with tempfile.TemporaryDirectory() as tmp:
+            config_path = Path(tmp) / 'config.json'
+            header_path = Path(tmp) / 'animation_config.h'
+            config_path.write_text(json.dumps(config))
+            gen.generate_arduino_header(config_path, header_path)
+            header = header_path.read_text()
+        self.assertIn("{GRASPING_NAME, GRASPING_DATA, 3500, ANIM_FLAG_LOOP | ANIM_FLAG_BAKED, 0},", header)
+        self.assertIn("{GRASPING_NAME, GRASPING_KEYS, 3500, ANIM_FLAG_LOOP, 7},", header)
+        self.assertEqual(1, header.count("ANIM_FLAG_LOOP | ANIM_FLAG_BAKED"))
+
+    def test_rejects_pulse_range_over_uint8(self):
+        """Frames store one byte per joint above the range minimum"""
+        hw = copy.deepcopy(self.hw)
+        hw['left_leg']['shoulder_max_pulse'] = hw['left_leg']['shoulder_min_pulse'] + 300
+        with self.assertRaises(ValueError):
+            gen.bake_animation(self.config['animations']['resting'], hw)
+
+    def test_rejects_duration_past_exact_frame_index(self):
+        """The multiply-shift frame index is only exact below ~16 s"""
+        anim = copy.deepcopy(self.config['animations']['resting'])
+        anim['keyframes'][2]['time_ms'] = 20000
+        anim['duration_ms'] = 20000
+        with self.assertRaises(ValueError):
+            gen.bake_animation(anim, self.hw)
+
+
+class TestBoardsAndJoints(unittest.TestCase):
+    """Props mapped to (board, channel) joints, and the I2C time they cost"""
+
+    @classmethod
+    def setUpClass(cls):
+        """Load configuration and the clutch overlay"""
+        here = Path(__file__).parent
+        with open(here / 'animation-config.json', 'r') as f:
+            cls.config = json.load(f)
+        cls.hw = cls.config['hardware']
+        with open(here / 'clutch-hardware.json', 'r') as f:
+            cls.clutch = {**cls.hw, **json.load(f)}
+
+    def live_animations(self):
+        animations = copy.deepcopy(self.config['animations'])
+        for anim in animations.values():
+            anim['playback'] = 'live'
+        return animations
+
+    def test_default_prop_is_the_legacy_legs(self):
+        """No props list: one egg on the first board at the left_leg/right_leg channels"""
+        hw = copy.deepcopy(self.hw)
+        hw.pop('props')
+        hw.pop('boards')
+        hw['i2c_address'] = '0x40'
+        joints = gen.joint_list(hw)
+        self.assertEqual([0x40], gen.board_addresses(hw))
+        self.assertEqual([14, 15, 1, 0], [j['channel'] for j in joints])
+        self.assertEqual(list(range(4)), [j['track'] for j in joints])
+        self.assertEqual(gen.pulse_ranges(hw), [(j['min_pulse'], j['max_pulse']) for j in joints])
+
+    def test_clutch_maps_every_channel_once(self):
+        """8 eggs fill both boards; each keeps its joints on the right tracks"""
+        joints = gen.joint_list(self.clutch)
+        self.assertEqual(32, len(joints))
+        self.assertEqual(32, len({(j['board'], j['channel']) for j in joints}))
+        self.assertEqual(list(range(4)) * 8, [j['track'] for j in joints])
+        self.assertEqual((1, 4), (joints[20]['board'], joints[20]['channel']))
+
+    def test_rejects_bad_board_and_channel(self):
+        """Boards past the list, channels past 15 and shared channels are errors"""
+        for props in ([{'name': 'a', 'board': 1}],
+                      [{'name': 'a', 'board': 0, 'left_leg': {'elbow_channel': 16}}],
+                      [{'name': 'a', 'board': 0}, {'name': 'b', 'board': 0}]):
+            hw = {**self.hw, 'props': props}
+            with self.assertRaises(ValueError, msg=str(props)):
+                gen.joint_list(hw)
+        with self.assertRaises(ValueError):
+            gen.board_addresses({**self.hw, 'boards': [{'i2c_address': '0x40'}] * 2})
+
+    def test_own_pulses_need_live_playback(self):
+        """Baked frames are ticks for the shared calibration"""
+        props = [{'name': 'egg', 'board': 0, 'right_leg': {'elbow_max_pulse': 300}}]
+        joints = gen.joint_list({**self.hw, 'props': props})
+        self.assertEqual(300, joints[3]['max_pulse'])
+        animations = self.live_animations()
+        gen.check_baked_calibration(animations, self.hw, joints)
+        animations['resting']['playback'] = 'baked'
+        with self.assertRaises(ValueError):
+            gen.check_baked_calibration(animations, self.hw, joints)
+
+    def test_batch_runs_match_pca9685_batch(self):
+        """The egg's legs: channels 0-1 in one run, 14-15 in another"""
+        channels = {0, 1, 14, 15}
+        dirty = {4 * ch + i for ch in channels for i in (2, 3)}
+        self.assertEqual([(2, 7), (58, 63)], gen.batch_runs(dirty, channels))
+        # Gaps over BATCH_MERGE_GAP, or through unknown channels, split
+        self.assertEqual([(2, 3), (10, 11)], gen.batch_runs({2, 3, 10, 11}, {0, 1, 2}))
+        self.assertEqual([(2, 3), (6, 7)], gen.batch_runs({2, 3, 6, 7}, {0}))
+        slow = {**self.hw, 'i2c_clock_hz': 100000}
+        self.assertEqual(1480, gen.check_bus_budget(slow, gen.joint_list(self.hw)))  # As host_sim/Wire.h
+        self.assertEqual(370, gen.check_bus_budget(self.hw, gen.joint_list(self.hw)))  # 400 kHz
+
+    def test_rejects_frames_over_the_bus_budget(self):
+        """Every joint moving must fit the frame: at 100 kHz 32 joints fit 50 Hz, not 100 Hz"""
+        joints = gen.joint_list(self.clutch)
+        slow = {**self.clutch, 'i2c_clock_hz': 100000}
+        self.assertEqual(11600, gen.check_bus_budget(slow, joints))
+        self.assertEqual(2900, gen.check_bus_budget(self.clutch, joints))
+        with self.assertRaises(ValueError):
+            gen.check_bus_budget({**slow, 'servo_frequency': 100}, joints)
+
+    def test_i2c_settings(self):
+        """Clock within what the TWI and PCA9685 take, budget within the frame, known joint names"""
+        self.assertEqual(400000, gen.i2c_clock_hz(self.hw))
+        self.assertEqual(4000, gen.i2c_frame_budget_us(self.hw))
+        self.assertEqual(0b1010, gen.low_priority_tracks(self.hw))  # Elbows
+        bare = {k: v for k, v in self.hw.items() if not k.startswith(('i2c_', 'low_priority'))}
+        self.assertEqual((100000, 20000, 0), (gen.i2c_clock_hz(bare), gen.i2c_frame_budget_us(bare),
+                                              gen.low_priority_tracks(bare)))
+        for bad in ({'i2c_clock_hz': 3400000}, {'i2c_frame_budget_us': 20001},
+                    {'i2c_frame_budget_us': 0}, {'low_priority_joints': ['left_knee']}):
+            with self.assertRaises(ValueError, msg=str(bad)):
+                gen.i2c_clock_hz({**self.hw, **bad})
+                gen.i2c_frame_budget_us({**self.hw, **bad})
+                gen.low_priority_tracks({**self.hw, **bad})
+
+    def test_servo_current(self):
+        """A current model per joint type in track order, and a budget above every joint holding still"""
+        models = gen.track_current(self.hw)
+        self.assertEqual(['DS-3225MG', 'HS-322HD', 'DS-3225MG', 'HS-322HD'], [m[3] for m in models])
+        self.assertEqual((60, 5200), gen.frame_current(self.hw, gen.joint_list(self.hw)))
+        self.assertEqual((480, 41600), gen.frame_current(self.clutch, gen.joint_list(self.clutch)))
+        self.assertEqual(4500, gen.current_budget_ma(self.hw, gen.joint_list(self.hw)))
+        with self.assertRaises(ValueError):
+            gen.current_budget_ma({**self.clutch, 'current_budget_ma': 480}, gen.joint_list(self.clutch))
+        elbow_only = {'elbow': self.hw['servo_current']['elbow']}
+        with self.assertRaises(ValueError):
+            gen.track_current({**self.hw, 'servo_current': elbow_only})
+        too_slow = {**self.hw['servo_current'], 'elbow': {'idle_ma': 10, 'full_speed_ma': 600,
+                                                          'degrees_per_second': 0}}
+        with self.assertRaises(ValueError):
+            gen.track_current({**self.hw, 'servo_current': too_slow})
+
+    def test_header_lists_boards_and_joints(self):
+        """The clutch header has both boards, 32 joints and shared pulse tables"""
+        with tempfile.TemporaryDirectory() as tmp:
+            header_path = Path(tmp) / 'animation_config.h'
+            gen.generate_arduino_header(Path(__file__).parent / 'animation-config.json', header_path,
+                                        Path(__file__).parent / 'clutch-hardware.json')
+            header = header_path.read_text()
+        self.assertIn("#define BOARD_LIST(X) X(0x40) X(0x41)", header)
+        self.assertIn("#define JOINT_COUNT 32", header)
+        self.assertIn("#define I2C_CLOCK_HZ 400000UL", header)
+        self.assertIn("#define LOW_PRIORITY_TRACKS 0x0A  // left_elbow, right_elbow", header)
+        self.assertIn("#define CURRENT_BUDGET_MILLIAMPS 19000", header)
+        self.assertIn("#define TRACK_CURRENT_LIST(X) X(20, 2000, 400) X(10, 600, 315) "
+                      "X(20, 2000, 400) X(10, 600, 315)", header)
+        self.assertEqual(32, len(re.findall(r"^  \{\d+, \d+, \d, JOINT_PULSES_", header, re.M)))
+        self.assertEqual(4, len(re.findall(r"^const uint16_t JOINT_PULSES_", header, re.M)))
+
+
+def run_tests():
+    """Run all tests and report results"""
+    loader = unittest.TestLoader()
+    suite = loader.loadTestsFromTestCase(TestPackedKeyframes)
+    suite.addTests(loader.loadTestsFromTestCase(TestBakedPlayback))
+    suite.addTests(loader.loadTestsFromTestCase(TestBoardsAndJoints))
+    result = unittest.TextTestRunner(verbosity=2).run(suite)
+    return 0 if result.wasSuccessful() else 1
+
+
+if __name__ == '__main__':
+    exit(run_tests())
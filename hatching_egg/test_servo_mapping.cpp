@@ -9,7 +9,23 @@
  */
 
 #include <gtest/gtest.h>
-#include "arduino/servo_mapping.h"
+#include <servo_mapping.h>
+#include <servo_lut.h>
+#include "arduino/hatching_egg/animation_config.h"
+
+// The tables hatching_egg.ino writes servos through
+typedef ServoPulseTable<RIGHT_ELBOW_MIN_PULSE, RIGHT_ELBOW_MAX_PULSE> RightElbowTable;
+typedef ServoPulseTable<RIGHT_SHOULDER_MIN_PULSE, RIGHT_SHOULDER_MAX_PULSE> RightShoulderTable;
+typedef ServoPulseTable<LEFT_SHOULDER_MIN_PULSE, LEFT_SHOULDER_MAX_PULSE> LeftShoulderTable;
+typedef ServoPulseTable<LEFT_ELBOW_MIN_PULSE, LEFT_ELBOW_MAX_PULSE> LeftElbowTable;
+
+// twitching_servos.ino: 0-180 deg over 600-2400 us at 50Hz
+typedef ServoPulseTable<600, 2400, 180, 20000> TwitchingTable;
+
+// Table entries are computed at compile time
+static_assert(servoLutEntry(0, 440, 300, 90, 0) == 440, "inverted range starts at min pulse");
+static_assert(servoLutEntry(90, 440, 300, 90, 0) == 300, "inverted range ends at max pulse");
+static_assert(servoLutEntry(180, 600, 2400, 180, 20000) == 491, "2400us is 491 ticks at 50Hz");
 
 // Right Elbow Tests
 TEST(ServoMapping, RightElbow_ZeroDegrees) {
@@ -199,6 +215,99 @@ TEST(AnimationKeyframes, Grasping_RightElbow60) {
     EXPECT_TRUE(isPWMSafe(degreesToPWM(60, SERVO_RIGHT_ELBOW), SERVO_RIGHT_ELBOW));
 }
 
+// Lookup Table Tests
+template <typename Table>
+static void expectTableMatchesDegreesToPWM(int servoIndex) {
+    for (int deg = -20; deg <= 110; deg++) {
+        ASSERT_EQ(degreesToPWM(deg, servoIndex), Table::lookup(deg)) << "degrees " << deg;
+    }
+}
+
+TEST(ServoLookupTable, RightElbowMatchesEveryDegree) {
+    expectTableMatchesDegreesToPWM<RightElbowTable>(SERVO_RIGHT_ELBOW);
+}
+
+TEST(ServoLookupTable, RightShoulderMatchesEveryDegree) {
+    expectTableMatchesDegreesToPWM<RightShoulderTable>(SERVO_RIGHT_SHOULDER);
+}
+
+TEST(ServoLookupTable, LeftShoulderMatchesEveryDegree) {
+    expectTableMatchesDegreesToPWM<LeftShoulderTable>(SERVO_LEFT_SHOULDER);
+}
+
+TEST(ServoLookupTable, LeftElbowMatchesEveryDegree) {
+    expectTableMatchesDegreesToPWM<LeftElbowTable>(SERVO_LEFT_ELBOW);
+}
+
+TEST(ServoLookupTable, ConfigMatchesCalibratedRanges) {
+    EXPECT_EQ(getServoPWMRange(SERVO_RIGHT_ELBOW).min_pwm, RIGHT_ELBOW_MIN_PULSE);
+    EXPECT_EQ(getServoPWMRange(SERVO_RIGHT_ELBOW).max_pwm, RIGHT_ELBOW_MAX_PULSE);
+    EXPECT_EQ(getServoPWMRange(SERVO_RIGHT_SHOULDER).min_pwm, RIGHT_SHOULDER_MIN_PULSE);
+    EXPECT_EQ(getServoPWMRange(SERVO_RIGHT_SHOULDER).max_pwm, RIGHT_SHOULDER_MAX_PULSE);
+    EXPECT_EQ(getServoPWMRange(SERVO_LEFT_SHOULDER).min_pwm, LEFT_SHOULDER_MIN_PULSE);
+    EXPECT_EQ(getServoPWMRange(SERVO_LEFT_SHOULDER).max_pwm, LEFT_SHOULDER_MAX_PULSE);
+    EXPECT_EQ(getServoPWMRange(SERVO_LEFT_ELBOW).min_pwm, LEFT_ELBOW_MIN_PULSE);
+    EXPECT_EQ(getServoPWMRange(SERVO_LEFT_ELBOW).max_pwm, LEFT_ELBOW_MAX_PULSE);
+}
+
+TEST(ServoLookupTable, EveryEntryIsPWMSafe) {
+    for (int deg = 0; deg <= 90; deg++) {
+        EXPECT_TRUE(isPWMSafe(RightElbowTable::lookup(deg), SERVO_RIGHT_ELBOW));
+        EXPECT_TRUE(isPWMSafe(RightShoulderTable::lookup(deg), SERVO_RIGHT_SHOULDER));
+        EXPECT_TRUE(isPWMSafe(LeftShoulderTable::lookup(deg), SERVO_LEFT_SHOULDER));
+        EXPECT_TRUE(isPWMSafe(LeftElbowTable::lookup(deg), SERVO_LEFT_ELBOW));
+    }
+}
+
+TEST(ServoLookupTable, MicrosecondTableMatchesMapAndLongMath) {
+    // setServoAngle(): constrain, map() to us, then (long)us * 4096 / 20000
+    for (int angle = -10; angle <= 190; angle++) {
+        int clamped = constrainValue(angle, 0, 180);
+        int pulse_us = mapValue(clamped, 0, 180, 600, 2400);
+        int pwmVal = ((long)pulse_us * 4096) / 20000;
+        ASSERT_EQ(pwmVal, TwitchingTable::lookup(angle)) << "angle " << angle;
+    }
+}
+
+TEST(ServoLookupTable, Q8WholeDegreesMatchLookup) {
+    for (int deg = 0; deg <= 90; deg++) {
+        EXPECT_EQ(RightElbowTable::lookup(deg), RightElbowTable::lookupQ8(deg * 256));
+        EXPECT_EQ(LeftShoulderTable::lookup(deg), LeftShoulderTable::lookupQ8(deg * 256));
+    }
+    EXPECT_EQ(TwitchingTable::lookup(180), TwitchingTable::lookupQ8(180 * 256));
+}
+
+TEST(ServoLookupTable, Q8ClampsAboveRange) {
+    EXPECT_EQ(RightElbowTable::lookup(90), RightElbowTable::lookupQ8(90 * 256 + 255));
+    EXPECT_EQ(LeftElbowTable::lookup(90), LeftElbowTable::lookupQ8(0xFFFF));
+}
+
+TEST(ServoLookupTable, Q8IsMonotonicAndUsesEveryTick) {
+    // A 0-90 degree sweep in 1/256 degree steps reaches every tick of the range
+    uint16_t previous = RightShoulderTable::lookupQ8(0);
+    int positions = 1;
+    for (int q = 1; q <= 90 * 256; q++) {
+        uint16_t ticks = RightShoulderTable::lookupQ8(q);
+        ASSERT_GE(ticks, previous);
+        ASSERT_LE(ticks - previous, 1);
+        if (ticks != previous) positions++;
+        previous = ticks;
+    }
+    EXPECT_EQ(280 - 150 + 1, positions);
+
+    previous = LeftElbowTable::lookupQ8(0);
+    for (int q = 1; q <= 90 * 256; q++) {
+        uint16_t ticks = LeftElbowTable::lookupQ8(q);
+        ASSERT_LE(ticks, previous);  // Inverted range
+        previous = ticks;
+    }
+}
+
+TEST(ServoLookupTable, TableSizeIsOneWordPerDegree) {
+    EXPECT_EQ(91u * 2, sizeof(RightElbowTable::values));
+    EXPECT_EQ(181u * 2, sizeof(TwitchingTable::values));
+}
+
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
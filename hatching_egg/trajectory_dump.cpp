@@ -0,0 +1,180 @@
+/*
+ * Golden Trajectory Dump - C++ Player Side
+ *
+ * Samples what the firmware would do into a CSV that
+ * compare_trajectories.py diffs against trajectory_dump.js (the browser
+ * preview's interpolation):
+ *   1. Every animation in animation_player.h, from its keyframes (baked
+ *      animations included, via LIVE_ANIMATIONS), as Q8 degrees at fixed
+ *      time steps
+ *   2. The full 14-step triggered sequence, by running hatching_egg.ino on
+ *      the host sim and sampling every frame, at the sketch's millis() for
+ *      the frame: the pulses the player asked ServoOutput for, and the
+ *      pulses the PCA9685 channels were sent (behind them where the power
+ *      budget slowed a servo), ticks mapped back to degrees through the
+ *      calibration
+ *
+ * Rows:
+ *   anim,<index>,<t_ms>,<ls>,<le>,<rs>,<re>   animation time, degrees
+ *   seq,<step>,<t_ms>,<ls>,<le>,<rs>,<re>     frame time since trigger, degrees asked for
+ *   out,<step>,<t_ms>,<ls>,<le>,<rs>,<re>     frame time since trigger, degrees sent
+ *   start,<step>,<t_ms>,,,,                   step start (14 = back to idle)
+ *
+ * The first line is a "# cpp ..." comment with the sampling rate of the
+ * player math (samples/s, host).
+ *
+ * Build and run:
+ *   pixi run compare-preview
+ *   ./trajectory_dump --step-ms 5 --out trajectory_cpp.csv
+ */
+
+#include <chrono>
+#include "Arduino.h"
+#include "sim.h"
+#include "servo_lut.h"
+#define ANIMATION_CONFIG_LIVE_TABLE
+#include "arduino/hatching_egg/hatching_egg.ino"
+
+struct Joint {
+  uint8_t channel;
+  int minPulse;
+  int maxPulse;
+};
+
+// Pose order: left shoulder, left elbow, right shoulder, right elbow
+static const Joint joints[POSE_JOINTS] = {
+  {LEFT_SHOULDER_CHANNEL, LEFT_SHOULDER_MIN_PULSE, LEFT_SHOULDER_MAX_PULSE},
+  {LEFT_ELBOW_CHANNEL, LEFT_ELBOW_MIN_PULSE, LEFT_ELBOW_MAX_PULSE},
+  {RIGHT_SHOULDER_CHANNEL, RIGHT_SHOULDER_MIN_PULSE, RIGHT_SHOULDER_MAX_PULSE},
+  {RIGHT_ELBOW_CHANNEL, RIGHT_ELBOW_MIN_PULSE, RIGHT_ELBOW_MAX_PULSE},
+};
+
+static void printRow(FILE* out, const char* kind, int id, double ms, const double* deg) {
+  fprintf(out, "%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", kind, id, ms, deg[0], deg[1], deg[2], deg[3]);
+}
+
+// Where the benchmark's poses go when no rows are written, so they're computed
+static volatile AngleQ8 poseSink;
+
+// Player math for one animation: sample count, optionally writing rows
+static uint64_t sampleAnimation(int index, uint32_t stepMs, FILE* out) {
+  const Animation& anim = LIVE_ANIMATIONS[index];
+  KeyframeCursor cursor;
+  cursorReset(&cursor, &anim);
+  uint64_t samples = 0;
+  for (uint32_t ms = 0; ms <= anim.duration_ms; ms += stepMs) {
+    AngleQ8 pose[POSE_JOINTS];
+    cursorSeek(&cursor, ms);
+    cursorPoseQ8(&cursor, ms, pose);
+    samples++;
+    if (!out) {
+      poseSink = pose[0] + pose[1] + pose[2] + pose[3];
+      continue;
+    }
+    double deg[POSE_JOINTS];
+    for (int j = 0; j < POSE_JOINTS; j++) deg[j] = pose[j] / 256.0;
+    printRow(out, "anim", index, ms, deg);
+  }
+  return samples;
+}
+
+// Samples per second of the player math over every animation (host)
+static double benchmarkPlayer(uint32_t stepMs) {
+  uint64_t samples = 0;
+  auto start = std::chrono::steady_clock::now();
+  double seconds = 0;
+  while (seconds < 0.2) {
+    for (int i = 0; i < ANIMATION_COUNT; i++) samples += sampleAnimation(i, stepMs, nullptr);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  return samples / seconds;
+}
+
+// Pulse ticks per joint, mapped back to degrees
+static void tickDegrees(const int* ticks, double* deg) {
+  for (int j = 0; j < POSE_JOINTS; j++) {
+    const Joint& joint = joints[j];
+    deg[j] = (ticks[j] - joint.minPulse) * 90.0 / (joint.maxPulse - joint.minPulse);
+  }
+}
+
+// Runs the sketch from a trigger press to the end of the sequence, one
+// row pair per frame
+static void sampleSequence(FILE* out) {
+  int ticks[16] = {0};
+  sim::onServoWrite = [&](const sim::ServoWrite& w) {
+    if (w.channel < 16) ticks[w.channel] = w.off;
+  };
+
+  setup();
+  sim::runLoop(loop, sim::nowMicros + 5000000);  // Settle into the idle cycle
+
+  uint64_t pressedAt = sim::nowMicros;
+  sim::setPin(TRIGGER_PIN, LOW);
+  int step = -1;
+  uint32_t frameCount = frames.stats().frames;
+  while (step != TRIGGERED_SEQUENCE_LENGTH && sim::nowMicros - pressedAt < 120000000ULL) {
+    if (sim::nowMicros - pressedAt >= 200000) sim::setPin(TRIGGER_PIN, HIGH);  // 200 ms press
+    unsigned long frameMillis = millis();  // What updateAnimation() reads if this pass is a frame
+    sim::step(loop);
+    bool frame = frames.stats().frames != frameCount;
+    frameCount = frames.stats().frames;
+
+    int now = currentMode == MODE_TRIGGERED ? triggeredStep : TRIGGERED_SEQUENCE_LENGTH;
+    if (now != step) {
+      // The frame that ends a step only starts the next one's animation
+      step = now;
+      // When the sketch started the step's animation (its own millis() clock)
+      fprintf(out, "start,%d,%.3f,,,,\n", step, animationStartTime - pressedAt / 1000.0);
+      continue;
+    }
+    if (!frame) continue;
+
+    // The first egg's joints are the pose's, in pose order
+    int asked[POSE_JOINTS], sent[POSE_JOINTS];
+    for (int j = 0; j < POSE_JOINTS; j++) {
+      asked[j] = servos.target(j);
+      sent[j] = ticks[joints[j].channel];
+    }
+    double ms = frameMillis - pressedAt / 1000.0;
+    double deg[POSE_JOINTS];
+    tickDegrees(asked, deg);
+    printRow(out, "seq", step, ms, deg);
+    tickDegrees(sent, deg);
+    printRow(out, "out", step, ms, deg);
+  }
+  sim::onServoWrite = nullptr;
+}
+
+int main(int argc, char** argv) {
+  uint32_t stepMs = 10;
+  const char* outPath = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--step-ms") && i + 1 < argc) {
+      stepMs = (uint32_t)atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+      outPath = argv[++i];
+    } else {
+      stepMs = 0;
+      break;
+    }
+  }
+  if (stepMs == 0) {
+    fprintf(stderr, "usage: %s [--step-ms N] [--out FILE]\n", argv[0]);
+    return 2;
+  }
+
+  FILE* out = outPath ? fopen(outPath, "w") : stdout;
+  if (!out) {
+    perror(outPath);
+    return 1;
+  }
+
+  sim::reset();
+  fprintf(out, "# cpp step_ms=%u samples_per_s=%.0f\n", stepMs, benchmarkPlayer(stepMs));
+  for (int i = 0; i < ANIMATION_COUNT; i++) sampleAnimation(i, stepMs, out);
+  sampleSequence(out);
+
+  if (out != stdout) fclose(out);
+  return 0;
+}
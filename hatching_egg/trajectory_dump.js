@@ -0,0 +1,139 @@
+#!/usr/bin/env node
+// Golden Trajectory Dump - JavaScript Preview Side
+//
+// Runs the preview's own interpolation (animation-behaviors.js, loaded as the
+// browser would, with fetch() served from animation-config.json) and writes
+// the same CSV rows as trajectory_dump.cpp:
+//   anim,<index>,<t_ms>,<ls>,<le>,<rs>,<re>   every animation, degrees
+//   seq,<step>,<t_ms>,<ls>,<le>,<rs>,<re>     the 14-step triggered sequence
+//   start,<step>,<t_ms>,,,,                   step start (14 = back to idle)
+//
+// The preview has no triggered sequence of its own; the steps and speeds are
+// read from hatching_egg.ino and played the way the preview plays an
+// animation at a given speed (animation time = wall time * speed). The
+// sequence is sampled the way the firmware moves: one pose per servo frame
+// (hardware.servo_frequency) from each step's start, held until the next.
+//
+// Usage: node trajectory_dump.js [--step-ms N] [--out FILE]
+
+const fs = require('fs');
+const path = require('path');
+const vm = require('vm');
+
+// Load animation-behaviors.js in a sandbox that looks like the browser
+function loadBehaviors(config) {
+    const source = fs.readFileSync(path.join(__dirname, 'animation-behaviors.js'), 'utf8');
+    return new Promise((resolve, reject) => {
+        const context = {
+            console,
+            fetch: () => Promise.resolve({ json: () => Promise.resolve(config) }),
+            window: {}
+        };
+        const timeout = setTimeout(() => reject(new Error('animation-behaviors.js never loaded')), 1000);
+        context.window.animationsLoaded = () => {
+            clearTimeout(timeout);
+            resolve(vm.runInContext('AnimationBehaviors', context));
+        };
+        vm.createContext(context);
+        vm.runInContext(source, context);
+    });
+}
+
+// Triggered sequence (animation ids and speeds) from the sketch's tables
+function parseSequence(sketch) {
+    const steps = /triggeredSequence\[[^\]]*\]\s*=\s*\{([^}]*)\}/.exec(sketch);
+    const speeds = /triggeredSequenceSpeed\[[^\]]*\]\s*=\s*\{([^}]*)\}/.exec(sketch);
+    if (!steps || !speeds) throw new Error('triggered sequence not found in hatching_egg.ino');
+    const ids = [...steps[1].matchAll(/ANIM_([A-Z_]+)/g)].map(m => m[1].toLowerCase());
+    const rates = [...speeds[1].matchAll(/SPEED_Q8\(([\d.]+)\)/g)].map(m => Number(m[1]));
+    if (ids.length !== rates.length) throw new Error('sequence and speed tables differ in length');
+    return ids.map((id, i) => ({ id, speed: rates[i] }));
+}
+
+// All four joints in degrees at animation time timeMs
+function pose(behavior, timeMs) {
+    const left = behavior.getAngles(timeMs / behavior.duration, { side: 'left' });
+    const right = behavior.getAngles(timeMs / behavior.duration, { side: 'right' });
+    return [left.shoulder, left.elbow, right.shoulder, right.elbow].map(rad => rad * 180 / Math.PI);
+}
+
+function row(kind, id, ms, deg) {
+    return `${kind},${id},${ms.toFixed(3)},${deg.map(d => d.toFixed(3)).join(',')}`;
+}
+
+// Samples per second of getAngles() over every animation (both legs = 1 sample)
+function benchmark(behaviors, stepMs) {
+    let samples = 0;
+    let sink = 0;
+    const start = process.hrtime.bigint();
+    let seconds = 0;
+    while (seconds < 0.2) {
+        for (const behavior of behaviors) {
+            for (let ms = 0; ms <= behavior.duration; ms += stepMs) {
+                sink += pose(behavior, ms)[0];
+                samples++;
+            }
+        }
+        seconds = Number(process.hrtime.bigint() - start) / 1e9;
+    }
+    return sink === -1 ? 0 : samples / seconds;
+}
+
+async function main() {
+    let stepMs = 10;
+    let outPath = null;
+    const args = process.argv.slice(2);
+    for (let i = 0; i < args.length; i++) {
+        if (args[i] === '--step-ms' && i + 1 < args.length) {
+            stepMs = Number(args[++i]);
+        } else if (args[i] === '--out' && i + 1 < args.length) {
+            outPath = args[++i];
+        } else {
+            console.error('usage: node trajectory_dump.js [--step-ms N] [--out FILE]');
+            process.exit(2);
+        }
+    }
+
+    const config = JSON.parse(fs.readFileSync(path.join(__dirname, 'animation-config.json'), 'utf8'));
+    const AnimationBehaviors = await loadBehaviors(config);
+    const ids = Object.keys(config.animations);  // Same order as the generated ANIMATIONS table
+    const behaviors = ids.map(id => AnimationBehaviors[id]);
+
+    const lines = [`# js step_ms=${stepMs} samples_per_s=${benchmark(behaviors, stepMs).toFixed(0)}`];
+
+    behaviors.forEach((behavior, index) => {
+        for (let ms = 0; ms <= behavior.duration; ms += stepMs) {
+            lines.push(row('anim', index, ms, pose(behavior, ms)));
+        }
+    });
+
+    const sketch = fs.readFileSync(path.join(__dirname, 'arduino/hatching_egg/hatching_egg.ino'), 'utf8');
+    const sequence = parseSequence(sketch);
+    let start = 0;
+    const starts = sequence.map(step => {
+        const stepStart = start;
+        start += AnimationBehaviors[step.id].duration / step.speed;
+        return stepStart;
+    });
+    starts.push(start);
+    starts.forEach((ms, step) => lines.push(`start,${step},${ms.toFixed(3)},,,,`));
+    const frameMs = 1000 / config.hardware.servo_frequency;
+    sequence.forEach((step, index) => {
+        const behavior = AnimationBehaviors[step.id];
+        for (let t = 0; starts[index] + t < starts[index + 1]; t += frameMs) {
+            lines.push(row('seq', index, starts[index] + t, pose(behavior, t * step.speed)));
+        }
+    });
+
+    const text = lines.join('\n') + '\n';
+    if (outPath) {
+        fs.writeFileSync(outPath, text);
+    } else {
+        process.stdout.write(text);
+    }
+}
+
+main().catch(error => {
+    console.error(error.message);
+    process.exit(1);
+});
@@ -0,0 +1,118 @@
+/*
+ * Host Adafruit_PWMServoDriver Stand-in
+ *
+ * Same public API as the Adafruit library, and the same I2C byte sequence:
+ * setPWM() is one 5-byte write starting at LEDn_ON_L, setPWMFreq() leaves
+ * MODE1 auto-increment on. Bytes go through the mock Wire bus to a
+ * PCA9685Model, so bus time and register state are both accounted for.
+ */
+
+#ifndef HOST_SIM_ADAFRUIT_PWMSERVODRIVER_H
+#define HOST_SIM_ADAFRUIT_PWMSERVODRIVER_H
+
+#include "sim.h"
+
+#define PCA9685_MODE1 0x00
+#define PCA9685_LED0_ON_L 0x06
+#define PCA9685_PRESCALE 0xFE
+#define MODE1_AI 0x20
+#define MODE1_SLEEP 0x10
+#define MODE1_RESTART 0x80
+#define FREQUENCY_OSCILLATOR 25000000
+
+class Adafruit_PWMServoDriver {
+ public:
+  Adafruit_PWMServoDriver(const uint8_t addr = 0x40, TwoWire& i2c = Wire)
+      : address_(addr), wire_(&i2c) {}
+
+  bool begin(uint8_t prescale = 0) {
+    sim::ensurePCA9685(address_);
+    wire_->begin();
+    reset();
+    (void)prescale;
+    setPWMFreq(1000);
+    return true;
+  }
+
+  void reset() {
+    write8(PCA9685_MODE1, MODE1_RESTART);
+    delay(10);
+  }
+
+  void setOscillatorFrequency(uint32_t freq) { oscillator_ = freq; }
+  uint32_t getOscillatorFrequency() const { return oscillator_; }
+
+  void setPWMFreq(float freq) {
+    if (freq < 1) freq = 1;
+    if (freq > 3500) freq = 3500;
+    float prescaleval = ((oscillator_ / (freq * 4096.0f)) + 0.5f) - 1;
+    if (prescaleval < 3) prescaleval = 3;
+    if (prescaleval > 255) prescaleval = 255;
+    uint8_t prescale = (uint8_t)prescaleval;
+
+    uint8_t oldmode = read8(PCA9685_MODE1);
+    uint8_t newmode = (oldmode & ~MODE1_RESTART) | MODE1_SLEEP;
+    write8(PCA9685_MODE1, newmode);
+    write8(PCA9685_PRESCALE, prescale);
+    write8(PCA9685_MODE1, oldmode);
+    delay(5);
+    write8(PCA9685_MODE1, oldmode | MODE1_RESTART | MODE1_AI);
+  }
+
+  uint8_t setPWM(uint8_t num, uint16_t on, uint16_t off) {
+    sim::setPWMCalls++;
+    wire_->beginTransmission(address_);
+    wire_->write((uint8_t)(PCA9685_LED0_ON_L + 4 * num));
+    wire_->write((uint8_t)on);
+    wire_->write((uint8_t)(on >> 8));
+    wire_->write((uint8_t)off);
+    wire_->write((uint8_t)(off >> 8));
+    return wire_->endTransmission();
+  }
+
+  void setPin(uint8_t num, uint16_t val, bool invert = false) {
+    if (val > 4095) val = 4095;
+    if (invert) val = 4095 - val;
+    if (val == 4095) {
+      setPWM(num, 4096, 0);
+    } else if (val == 0) {
+      setPWM(num, 0, 4096);
+    } else {
+      setPWM(num, 0, val);
+    }
+  }
+
+  void writeMicroseconds(uint8_t num, uint16_t microseconds) {
+    double pulse = microseconds;
+    double pulselength = 1000000;
+    uint16_t prescale = readPrescale() + 1;
+    pulselength *= prescale;
+    pulselength /= oscillator_;
+    pulse /= pulselength;
+    setPWM(num, 0, (uint16_t)pulse);
+  }
+
+  uint8_t readPrescale() { return read8(PCA9685_PRESCALE); }
+
+ private:
+  uint8_t read8(uint8_t addr) {
+    wire_->beginTransmission(address_);
+    wire_->write(addr);
+    wire_->endTransmission();
+    wire_->requestFrom(address_, (uint8_t)1);
+    return (uint8_t)wire_->read();
+  }
+
+  void write8(uint8_t addr, uint8_t d) {
+    wire_->beginTransmission(address_);
+    wire_->write(addr);
+    wire_->write(d);
+    wire_->endTransmission();
+  }
+
+  uint8_t address_;
+  TwoWire* wire_;
+  uint32_t oscillator_ = FREQUENCY_OSCILLATOR;
+};
+
+#endif  // HOST_SIM_ADAFRUIT_PWMSERVODRIVER_H
@@ -0,0 +1,400 @@
+/*
+ * Host Arduino Core - Stand-in for Linux Builds
+ *
+ * Just enough of the Arduino API to compile the production sketches
+ * (hatching_egg.ino, twitching_servos.ino) with g++ and drive them from a
+ * simulated clock. Time only moves when something moves it: delay(), the
+ * per-loop overhead charged by sim.h, or I2C traffic on the mock Wire bus.
+ *
+ * Include this first, then sim.h, then the .ino under test:
+ *   g++ -std=c++17 -I../host_sim sim_hatching_egg.cpp
+ */
+
+#ifndef HOST_SIM_ARDUINO_H
+#define HOST_SIM_ARDUINO_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#define HOST_SIM 1
+#define F_CPU 16000000UL  // The Beetle's clock (TWI rate limits)
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define _BV(bit) (1 << (bit))
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+// PROGMEM is plain memory on the host. Reads go through memcpy so that
+// pgm_read_word() on a host-sized int (4 bytes) stays well defined; the low
+// bytes come first on little-endian hosts, just like on the AVR.
+#ifndef PROGMEM
+#define PROGMEM
+#define PSTR(s) (s)
+inline uint8_t host_pgm_read_byte(const void* addr) { uint8_t v; memcpy(&v, addr, 1); return v; }
+inline uint16_t host_pgm_read_word(const void* addr) { uint16_t v; memcpy(&v, addr, 2); return v; }
+inline uint32_t host_pgm_read_dword(const void* addr) { uint32_t v; memcpy(&v, addr, 4); return v; }
+inline void* host_pgm_read_ptr(const void* addr) { void* v; memcpy(&v, addr, sizeof(v)); return v; }
+#define pgm_read_byte(addr) host_pgm_read_byte(addr)
+#define pgm_read_word(addr) host_pgm_read_word(addr)
+#define pgm_read_dword(addr) host_pgm_read_dword(addr)
+#define pgm_read_ptr(addr) host_pgm_read_ptr(addr)
+#endif
+#define strcpy_P(dest, src) strcpy((dest), (src))
+#define strlen_P(src) strlen((src))
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(PSTR(s)))
+
+// ============================================================================
+// Pin change interrupts (ATmega32U4: port B, pins 8-11 and 14-17, one vector)
+// ============================================================================
+
+inline volatile uint8_t PCICR = 0;
+inline volatile uint8_t PCMSK0 = 0;
+#define PCIE0 0
+
+#define digitalPinToPCICR(p) \
+  ((((p) >= 8 && (p) <= 11) || ((p) >= 14 && (p) <= 17)) ? (&PCICR) : ((volatile uint8_t*)0))
+#define digitalPinToPCICRbit(p) 0
+#define digitalPinToPCMSK(p) (digitalPinToPCICR(p) ? (&PCMSK0) : ((volatile uint8_t*)0))
+#define digitalPinToPCMSKbit(p) \
+  (((p) >= 8 && (p) <= 11) ? (p) - 4 : (p) == 14 ? 3 : (p) == 15 ? 1 : (p) == 16 ? 2 : 0)
+
+namespace sim {
+
+inline void (*pcint0Vector)() = nullptr;  // ISR(PCINT0_vect), if the sketch has one
+inline bool interruptsOn = true;
+inline bool pcint0Pending = false;  // Flagged while interrupts were off
+inline uint64_t pinChangeInterrupts = 0;
+
+inline bool attachVector(const char* name, void (*handler)()) {
+  if (!strcmp(name, "PCINT0_vect")) pcint0Vector = handler;
+  return true;
+}
+
+inline void runPinChangeVector() {
+  if (!pcint0Vector || !(PCICR & _BV(PCIE0))) return;
+  if (!interruptsOn) {
+    pcint0Pending = true;
+    return;
+  }
+  pinChangeInterrupts++;
+  pcint0Vector();
+}
+
+}  // namespace sim
+
+// ISR(PCINT0_vect) { ... } defines a handler and registers it; sim::setPin()
+// calls it for pins enabled in PCMSK0, as the hardware would
+#define ISR(vector) \
+  void vector##_handler(); \
+  inline const bool vector##_attached = sim::attachVector(#vector, vector##_handler); \
+  void vector##_handler()
+
+inline void noInterrupts() { sim::interruptsOn = false; }
+
+inline void interrupts() {
+  sim::interruptsOn = true;
+  if (sim::pcint0Pending) {
+    sim::pcint0Pending = false;
+    sim::runPinChangeVector();
+  }
+}
+
+// ============================================================================
+// Port input registers (Leonardo / Beetle pin numbering)
+// ============================================================================
+
+#define NOT_A_PORT 0
+#define PB 2
+#define PC 3
+#define PD 4
+#define PE 5
+#define PF 6
+
+namespace sim {
+
+struct PinPort {
+  uint8_t port;
+  uint8_t bit;
+};
+
+// As the core's digital_pin_to_port_PGM / _bit_mask_PGM for pins 0-23
+inline const PinPort PIN_PORTS[] = {
+  {PD, 2}, {PD, 3}, {PD, 1}, {PD, 0}, {PD, 4}, {PC, 6}, {PD, 7}, {PE, 6},
+  {PB, 4}, {PB, 5}, {PB, 6}, {PB, 7}, {PD, 6}, {PC, 7}, {PB, 3}, {PB, 1},
+  {PB, 2}, {PB, 0}, {PF, 7}, {PF, 6}, {PF, 5}, {PF, 4}, {PF, 1}, {PF, 0},
+};
+const int MAPPED_PINS = sizeof(PIN_PORTS) / sizeof(PIN_PORTS[0]);
+
+inline volatile uint8_t portInput[8];  // PINx, kept in step with pinLevel[]
+
+}  // namespace sim
+
+#define digitalPinToPort(p) ((p) < sim::MAPPED_PINS ? sim::PIN_PORTS[p].port : NOT_A_PORT)
+#define digitalPinToBitMask(p) ((uint8_t)((p) < sim::MAPPED_PINS ? _BV(sim::PIN_PORTS[p].bit) : 0))
+#define portInputRegister(port) (&sim::portInput[(port) & 7])
+
+// ============================================================================
+// Simulated clock and pins
+// ============================================================================
+
+namespace sim {
+
+const int PIN_COUNT = 32;
+
+inline uint64_t nowMicros = 0;       // Simulated time since reset
+inline uint64_t delayMicrosTotal = 0;  // Time spent inside delay()
+inline uint8_t pinLevel[PIN_COUNT];   // Level seen by digitalRead()
+inline uint8_t pinModes[PIN_COUNT];
+inline uint8_t pinOutput[PIN_COUNT];  // Last digitalWrite() value
+
+inline void advanceMicros(uint64_t us) {
+  nowMicros += us;
+}
+
+// Drive an input pin from the outside world (switch, trigger, ...). A
+// level change on a pin enabled in PCMSK0 runs the pin change ISR.
+inline void setPin(int pin, uint8_t level) {
+  if (pin < 0 || pin >= PIN_COUNT) return;
+  level = level ? HIGH : LOW;
+  bool changed = pinLevel[pin] != level;
+  pinLevel[pin] = level;
+  if (pin < MAPPED_PINS) {
+    uint8_t mask = _BV(PIN_PORTS[pin].bit);
+    volatile uint8_t& port = portInput[PIN_PORTS[pin].port];
+    port = level ? (port | mask) : (port & ~mask);
+  }
+  volatile uint8_t* pcmsk = digitalPinToPCMSK(pin);
+  if (changed && pcmsk && (*pcmsk & _BV(digitalPinToPCMSKbit(pin)))) {
+    runPinChangeVector();
+  }
+}
+
+// Deterministic stand-in for avr-libc random(): same seed, same show
+inline uint32_t rngState = 1;
+
+inline void reset() {
+  nowMicros = 0;
+  delayMicrosTotal = 0;
+  rngState = 1;
+  PCICR = 0;
+  PCMSK0 = 0;
+  interruptsOn = true;
+  pcint0Pending = false;
+  pinChangeInterrupts = 0;
+  for (int i = 0; i < PIN_COUNT; i++) {
+    pinLevel[i] = HIGH;  // Unconnected INPUT_PULLUP pins read HIGH
+    pinModes[i] = INPUT;
+    pinOutput[i] = LOW;
+  }
+  for (int i = 0; i < 8; i++) portInput[i] = 0xFF;
+}
+
+}  // namespace sim
+
+inline unsigned long millis() {
+  return (unsigned long)(sim::nowMicros / 1000);
+}
+
+inline unsigned long micros() {
+  return (unsigned long)sim::nowMicros;
+}
+
+inline void delay(unsigned long ms) {
+  sim::advanceMicros((uint64_t)ms * 1000);
+  sim::delayMicrosTotal += (uint64_t)ms * 1000;
+}
+
+inline void delayMicroseconds(unsigned int us) {
+  sim::advanceMicros(us);
+  sim::delayMicrosTotal += us;
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < sim::PIN_COUNT) {
+    sim::pinModes[pin] = mode;
+  }
+}
+
+inline int digitalRead(uint8_t pin) {
+  return pin < sim::PIN_COUNT ? sim::pinLevel[pin] : LOW;
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < sim::PIN_COUNT) {
+    sim::pinOutput[pin] = value ? HIGH : LOW;
+  }
+}
+
+// ============================================================================
+// Math helpers (templates instead of the AVR macros so std:: still works)
+// ============================================================================
+
+template <typename T, typename L, typename H>
+inline T constrain(T value, L low, H high) {
+  if (value < low) return (T)low;
+  if (value > high) return (T)high;
+  return value;
+}
+
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type min(A a, B b) {
+  return a < b ? a : b;
+}
+
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type max(A a, B b) {
+  return a > b ? a : b;
+}
+
+inline long map(long value, long fromLow, long fromHigh, long toLow, long toHigh) {
+  return (value - fromLow) * (toHigh - toLow) / (fromHigh - fromLow) + toLow;
+}
+
+inline void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    sim::rngState = (uint32_t)seed;
+  }
+}
+
+inline long random(long howBig) {
+  if (howBig == 0) return 0;
+  // Park-Miller minimal standard, as used by avr-libc random()
+  sim::rngState = (uint32_t)(((uint64_t)sim::rngState * 16807) % 2147483647);
+  return (long)(sim::rngState % (uint32_t)howBig);
+}
+
+inline long random(long howSmall, long howBig) {
+  if (howSmall >= howBig) return howSmall;
+  return random(howBig - howSmall) + howSmall;
+}
+
+// ============================================================================
+// Print / Serial
+// ============================================================================
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+
+  size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char* str) {
+    return write((const uint8_t*)str, strlen(str));
+  }
+
+  size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+  size_t print(const char* s) { return write(s); }
+  size_t print(const std::string& s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(long n, int base = DEC) {
+    if (base == DEC && n < 0) {
+      return write((uint8_t)'-') + printNumber((unsigned long)(-n), base);
+    }
+    return printNumber((unsigned long)n, base);
+  }
+  size_t print(unsigned long n, int base = DEC) { return printNumber(n, base); }
+  size_t print(double n, int digits = 2) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return write(buf);
+  }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(T value) { size_t n = print(value); return n + println(); }
+  template <typename T>
+  size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+ private:
+  size_t printNumber(unsigned long n, int base) {
+    char buf[8 * sizeof(long) + 1];
+    char* str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+    if (base < 2) base = 10;
+    do {
+      char c = (char)(n % base);
+      n /= base;
+      *--str = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (n);
+    return write(str);
+  }
+};
+
+// USB CDC stand-in: output is captured (and optionally echoed), input is
+// whatever the harness queued with sim::serialInput().
+class HostSerial : public Print {
+ public:
+  std::string output;
+  std::deque<uint8_t> input;
+  bool echo = false;
+  std::function<void(uint8_t)> echoHook;  // Replaces fputc() when echoing (sim::useEventLog())
+  uint64_t bytesWritten = 0;
+
+  void begin(unsigned long) {}
+  void end() {}
+  explicit operator bool() const { return true; }
+
+  size_t write(uint8_t c) override {
+    bytesWritten++;
+    if (echo) {
+      if (echoHook) {
+        echoHook(c);
+      } else {
+        fputc(c, stdout);
+      }
+    }
+    output.push_back((char)c);
+    if (output.size() > 1 << 16) output.erase(0, output.size() / 2);
+    return 1;
+  }
+  using Print::write;
+
+  int available() { return (int)input.size(); }
+  int availableForWrite() { return 64; }
+  int peek() { return input.empty() ? -1 : input.front(); }
+  int read() {
+    if (input.empty()) return -1;
+    int c = input.front();
+    input.pop_front();
+    return c;
+  }
+  void flush() {}
+};
+
+inline HostSerial Serial;
+
+namespace sim {
+
+inline void serialInput(const char* text) {
+  while (*text) Serial.input.push_back((uint8_t)*text++);
+}
+
+}  // namespace sim
+
+#endif  // HOST_SIM_ARDUINO_H
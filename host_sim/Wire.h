@@ -0,0 +1,141 @@
+/*
+ * Host Wire (TWI) Stand-in
+ *
+ * Mirrors the AVR TwoWire API and buffer limits, and charges simulated bus
+ * time for every transaction so throughput numbers from the simulator mean
+ * something: each byte is 9 SCL clocks (8 data + ACK), plus START/STOP.
+ *
+ * Devices attach by 7-bit address (see pca9685_model.h). Every transaction
+ * is counted in sim::i2c so harnesses can report bytes-on-wire.
+ */
+
+#ifndef HOST_SIM_WIRE_H
+#define HOST_SIM_WIRE_H
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32  // AVR twi.h TWI_BUFFER_LENGTH
+
+namespace sim {
+
+// Anything that can sit on the simulated bus
+class I2CDevice {
+ public:
+  virtual ~I2CDevice() {}
+  virtual void onWrite(const uint8_t* data, size_t length) = 0;
+  virtual uint8_t onRead() = 0;
+};
+
+struct I2CStats {
+  uint64_t transactions = 0;  // START ... STOP sequences (writes + reads)
+  uint64_t bytes = 0;         // Bytes on the wire, including address bytes
+  uint64_t busMicros = 0;     // Simulated time the bus was busy
+  uint64_t nacks = 0;         // Transactions to an address nobody answered
+};
+
+inline I2CStats i2c;
+inline I2CDevice* i2cDevices[128];
+
+inline void attachI2CDevice(uint8_t address, I2CDevice* device) {
+  i2cDevices[address & 0x7F] = device;
+}
+
+inline void resetI2CStats() {
+  i2c = I2CStats();
+}
+
+}  // namespace sim
+
+class TwoWire {
+ public:
+  void begin() { clockHz_ = 100000; }  // As AVR twi_init(): setClock() after begin()
+  void end() {}
+  void setClock(uint32_t hz) { clockHz_ = hz ? hz : 100000; }
+  uint32_t getClock() const { return clockHz_; }
+
+  void beginTransmission(uint8_t address) {
+    address_ = address;
+    length_ = 0;
+    overflow_ = false;
+  }
+  void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+
+  size_t write(uint8_t data) {
+    if (length_ >= BUFFER_LENGTH) {
+      overflow_ = true;
+      return 0;
+    }
+    buffer_[length_++] = data;
+    return 1;
+  }
+  size_t write(const uint8_t* data, size_t quantity) {
+    size_t n = 0;
+    while (quantity--) n += write(*data++);
+    return n;
+  }
+
+  // Returns like the AVR core: 0 ok, 1 data too long, 2 NACK on address
+  uint8_t endTransmission(bool sendStop = true) {
+    (void)sendStop;
+    if (overflow_) return 1;
+    sim::I2CDevice* device = sim::i2cDevices[address_ & 0x7F];
+    chargeBus(length_ + 1);
+    if (!device) {
+      sim::i2c.nacks++;
+      return 2;
+    }
+    device->onWrite(buffer_, length_);
+    return 0;
+  }
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true) {
+    (void)sendStop;
+    readLength_ = 0;
+    readIndex_ = 0;
+    sim::I2CDevice* device = sim::i2cDevices[address & 0x7F];
+    if (quantity > BUFFER_LENGTH) quantity = BUFFER_LENGTH;
+    chargeBus(quantity + 1);
+    if (!device) {
+      sim::i2c.nacks++;
+      return 0;
+    }
+    for (uint8_t i = 0; i < quantity; i++) {
+      readBuffer_[readLength_++] = device->onRead();
+    }
+    return readLength_;
+  }
+  uint8_t requestFrom(int address, int quantity) {
+    return requestFrom((uint8_t)address, (uint8_t)quantity);
+  }
+
+  int available() { return readLength_ - readIndex_; }
+  int read() { return readIndex_ < readLength_ ? readBuffer_[readIndex_++] : -1; }
+
+  // Bus time in microseconds for a transaction of `bytes` (address included)
+  uint64_t transactionMicros(size_t bytes) const {
+    uint64_t bits = 9 * (uint64_t)bytes + 2;  // + START and STOP
+    return (bits * 1000000 + clockHz_ - 1) / clockHz_;
+  }
+
+ private:
+  void chargeBus(size_t bytes) {
+    uint64_t us = transactionMicros(bytes);
+    sim::i2c.transactions++;
+    sim::i2c.bytes += bytes;
+    sim::i2c.busMicros += us;
+    sim::advanceMicros(us);  // Wire on AVR busy-waits for the transfer
+  }
+
+  uint32_t clockHz_ = 100000;  // AVR core default
+  uint8_t address_ = 0;
+  uint8_t buffer_[BUFFER_LENGTH];
+  uint8_t length_ = 0;
+  bool overflow_ = false;
+  uint8_t readBuffer_[BUFFER_LENGTH];
+  uint8_t readLength_ = 0;
+  uint8_t readIndex_ = 0;
+};
+
+inline TwoWire Wire;
+
+#endif  // HOST_SIM_WIRE_H
@@ -0,0 +1,231 @@
+/*
+ * Event Log Decoder - Binary Event Records Back to Text
+ *
+ * Turns the Serial byte stream of a sketch using event_log.h into readable
+ * lines. Plain text passes through; each 10-byte record is checked and
+ * formatted with the sketch's event list (the same X-macro the firmware
+ * builds its enum from):
+ *
+ *   sim::EventLogDecoder decoder({HATCHING_EGG_EVENTS(EVENT_LOG_FORMAT)});
+ *   std::string text = decoder.feed(bytes, size);
+ *
+ * Record timestamps are the low 16 bits of millis(); the decoder unwraps
+ * them assuming no gap between records is longer than 65.5 s.
+ *
+ * Used by the host simulators (sim::useEventLog()) and the decode-log
+ * tools, which read a capture of the real serial port.
+ */
+
+#ifndef HOST_SIM_EVENT_LOG_DECODER_H
+#define HOST_SIM_EVENT_LOG_DECODER_H
+
+#include "Arduino.h"
+#include "event_log.h"
+#include "frame_scheduler.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#define EVENT_LOG_FORMAT(name, code, format) sim::EventFormat{code, #name, format},
+
+namespace sim {
+
+struct EventFormat {
+  uint8_t code;
+  const char* name;
+  const char* format;
+};
+
+class EventLogDecoder {
+ public:
+  // Text for a {field:name} value (animation names); nullptr = print the number
+  typedef std::function<const char*(uint16_t value)> NameFn;
+
+  explicit EventLogDecoder(std::vector<EventFormat> formats, NameFn names = nullptr)
+      : formats_(formats), names_(names) {
+    const EventFormat library[] = {EVENT_LOG_LIBRARY_EVENTS(EVENT_LOG_FORMAT)};
+    formats_.insert(formats_.end(), std::begin(library), std::end(library));
+  }
+
+  bool timestamps = false;  // Prefix records with "[   12.345] " (seconds)
+
+  uint64_t records = 0;
+  uint64_t checksumErrors = 0;
+  uint64_t unknownCodes = 0;
+  uint64_t dropped = 0;  // Sum of EVT_DROPPED counts
+
+  // Decoded text for the next chunk of the stream
+  std::string feed(const uint8_t* data, size_t size) {
+    std::string out;
+    for (size_t i = 0; i < size; i++) feedByte(data[i], out);
+    return out;
+  }
+
+  std::string feed(const std::string& bytes) {
+    return feed(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+  }
+
+  // Time of the last record, unwrapped, in milliseconds
+  uint64_t timeMs() const { return epochMs_ + lastTimeMs_; }
+
+  // One record's text, without timestamp or newline
+  std::string format(const EventRecord& record) const {
+    const EventFormat* entry = find(record.code);
+    if (!entry) {
+      char unknown[48];
+      snprintf(unknown, sizeof(unknown), "event 0x%02X a=%u b=%u c=%u",
+               record.code, record.a, record.b, record.c);
+      return unknown;
+    }
+    std::string text;
+    for (const char* p = entry->format; *p; p++) {
+      const char* close = *p == '{' ? strchr(p, '}') : nullptr;
+      if (!close) {
+        text.push_back(*p);
+        continue;
+      }
+      std::string field(p + 1, close);
+      p = close;
+      std::string spec;
+      size_t colon = field.find(':');
+      if (colon != std::string::npos) {
+        spec = field.substr(colon + 1);
+        field.resize(colon);
+      }
+      uint16_t value = field == "a" ? record.a : field == "b" ? record.b : record.c;
+      text += formatValue(value, spec);
+    }
+    return text;
+  }
+
+ private:
+  void feedByte(uint8_t byte, std::string& out) {
+    if (have_ == 0) {
+      if (byte == EVENT_LOG_SYNC) {
+        frame_[have_++] = byte;
+      } else {
+        out.push_back((char)byte);
+        atLineStart_ = byte == '\n';
+      }
+      return;
+    }
+    frame_[have_++] = byte;
+    if (have_ < EVENT_LOG_WIRE_BYTES) return;
+    have_ = 0;
+
+    EventRecord record;
+    uint8_t check[EVENT_LOG_WIRE_BYTES];
+    record.code = frame_[1];
+    record.a = frame_[2];
+    record.timeMs = (uint16_t)(frame_[3] | frame_[4] << 8);
+    record.b = (uint16_t)(frame_[5] | frame_[6] << 8);
+    record.c = (uint16_t)(frame_[7] | frame_[8] << 8);
+    encodeEventRecord(record, check);
+    if (check[EVENT_LOG_WIRE_BYTES - 1] != frame_[EVENT_LOG_WIRE_BYTES - 1]) {
+      // Not a record after all: drop the sync byte, rescan the rest
+      checksumErrors++;
+      uint8_t rest[EVENT_LOG_WIRE_BYTES - 1];
+      memcpy(rest, frame_ + 1, sizeof(rest));
+      for (uint8_t b : rest) feedByte(b, out);
+      return;
+    }
+
+    records++;
+    if (!find(record.code)) unknownCodes++;
+    if (record.code == EVT_DROPPED) dropped += record.b;
+    if (record.timeMs < lastTimeMs_) epochMs_ += 0x10000;
+    lastTimeMs_ = record.timeMs;
+
+    if (!atLineStart_) out.push_back('\n');
+    if (timestamps) {
+      char stamp[24];
+      snprintf(stamp, sizeof(stamp), "[%10.3f] ", timeMs() / 1000.0);
+      out += stamp;
+    }
+    out += format(record);
+    out.push_back('\n');
+    atLineStart_ = true;
+  }
+
+  const EventFormat* find(uint8_t code) const {
+    for (const EventFormat& entry : formats_) {
+      if (entry.code == code) return &entry;
+    }
+    return nullptr;
+  }
+
+  std::string formatValue(uint16_t value, const std::string& spec) const {
+    char buf[32];
+    if (spec == "q8") {
+      uint16_t hundredths = ((uint16_t)(value & 0xFF) * 100 + 128) >> 8;
+      snprintf(buf, sizeof(buf), "%u.%02u", value >> 8, hundredths > 99 ? 99 : hundredths);
+    } else if (spec == "ms") {
+      snprintf(buf, sizeof(buf), "%.2f", value / 1000.0);
+    } else if (spec == "lo" || spec == "hi") {
+      snprintf(buf, sizeof(buf), "%u", spec == "lo" ? value & 0xFF : value >> 8);
+    } else if (spec == "bucket") {
+      bool last = value >= FRAME_HIST_BUCKETS - 1;
+      snprintf(buf, sizeof(buf), "%s%lu", last ? ">=" : "<",
+               (unsigned long)FrameScheduler::bucketMicros(last ? FRAME_HIST_BUCKETS - 1 : value + 1));
+    } else if (spec == "name" && names_ && names_(value)) {
+      return names_(value);
+    } else {
+      snprintf(buf, sizeof(buf), "%u", value);
+    }
+    return buf;
+  }
+
+  std::vector<EventFormat> formats_;
+  NameFn names_;
+  uint8_t frame_[EVENT_LOG_WIRE_BYTES];
+  uint8_t have_ = 0;  // Bytes of the current record so far (0 = text)
+  bool atLineStart_ = true;
+  uint16_t lastTimeMs_ = 0;
+  uint64_t epochMs_ = 0;
+};
+
+// Decode a capture (file, or stdin for "-") to stdout: the decode-log tools
+inline int decodeEventLogMain(int argc, char** argv, std::vector<EventFormat> formats,
+                              EventLogDecoder::NameFn names = nullptr) {
+  const char* path = "-";
+  bool timestamps = true;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--no-timestamps")) {
+      timestamps = false;
+    } else if (argv[i][0] != '-' || !strcmp(argv[i], "-")) {
+      path = argv[i];
+    } else {
+      fprintf(stderr, "usage: %s [--no-timestamps] [capture file | - | /dev/ttyACM0]\n", argv[0]);
+      return 2;
+    }
+  }
+  FILE* in = strcmp(path, "-") ? fopen(path, "rb") : stdin;
+  if (!in) {
+    perror(path);
+    return 1;
+  }
+
+  EventLogDecoder decoder(formats, names);
+  decoder.timestamps = timestamps;
+  uint8_t buf[256];
+  ssize_t n;
+  while ((n = read(fileno(in), buf, sizeof(buf))) > 0) {  // read(): a live port returns what's there
+    std::string text = decoder.feed(buf, n);
+    text.erase(std::remove(text.begin(), text.end(), '\r'), text.end());
+    fputs(text.c_str(), stdout);
+    fflush(stdout);
+  }
+  if (in != stdin) fclose(in);
+  fprintf(stderr, "%llu records, %llu dropped on the device, %llu bad checksums, %llu unknown codes\n",
+          (unsigned long long)decoder.records, (unsigned long long)decoder.dropped,
+          (unsigned long long)decoder.checksumErrors, (unsigned long long)decoder.unknownCodes);
+  return 0;
+}
+
+}  // namespace sim
+
+#endif  // HOST_SIM_EVENT_LOG_DECODER_H
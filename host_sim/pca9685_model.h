@@ -0,0 +1,83 @@
+/*
+ * PCA9685 Register Model
+ *
+ * Decodes I2C writes the way the chip does: first byte is the register
+ * pointer, following bytes land at the pointer and advance it when MODE1
+ * auto-increment (AI) is set. Whenever a transaction touches a channel's
+ * LEDn_ON/LEDn_OFF registers, the model reports the channel's new output so
+ * the harness sees exactly what the servo would see - whether the sketch
+ * used setPWM() or wrote registers directly.
+ */
+
+#ifndef HOST_SIM_PCA9685_MODEL_H
+#define HOST_SIM_PCA9685_MODEL_H
+
+#include "Wire.h"
+
+#include <functional>
+
+namespace sim {
+
+const uint8_t PCA9685_MODE1 = 0x00;
+const uint8_t PCA9685_LED0_ON_L = 0x06;
+const uint8_t PCA9685_PRESCALE = 0xFE;
+const uint8_t PCA9685_MODE1_AI = 0x20;
+const uint8_t PCA9685_MODE1_SLEEP = 0x10;
+const uint8_t PCA9685_MODE1_RESTART = 0x80;
+
+class PCA9685Model : public I2CDevice {
+ public:
+  // Called once per channel per transaction that changed its registers
+  std::function<void(uint8_t address, uint8_t channel, uint16_t on, uint16_t off)> onChannel;
+
+  explicit PCA9685Model(uint8_t address) : address_(address) {
+    memset(reg_, 0, sizeof(reg_));
+    reg_[PCA9685_MODE1] = 0x11;  // Power-on: SLEEP | ALLCALL
+    reg_[PCA9685_PRESCALE] = 0x1E;
+  }
+
+  void onWrite(const uint8_t* data, size_t length) override {
+    if (length == 0) return;
+    pointer_ = data[0];
+    uint16_t touched = 0;
+    for (size_t i = 1; i < length; i++) {
+      reg_[pointer_] = data[i];
+      if (pointer_ >= PCA9685_LED0_ON_L && pointer_ < PCA9685_LED0_ON_L + 64) {
+        touched |= (uint16_t)(1u << ((pointer_ - PCA9685_LED0_ON_L) / 4));
+      }
+      advance();
+    }
+    for (uint8_t ch = 0; ch < 16; ch++) {
+      if ((touched & (1u << ch)) && onChannel) {
+        onChannel(address_, ch, on(ch), off(ch));
+      }
+    }
+  }
+
+  uint8_t onRead() override {
+    uint8_t value = reg_[pointer_];
+    advance();
+    return value;
+  }
+
+  uint8_t reg(uint8_t r) const { return reg_[r]; }
+  uint16_t on(uint8_t ch) const { return word(PCA9685_LED0_ON_L + 4 * ch); }
+  uint16_t off(uint8_t ch) const { return word(PCA9685_LED0_ON_L + 4 * ch + 2); }
+  bool autoIncrement() const { return reg_[PCA9685_MODE1] & PCA9685_MODE1_AI; }
+
+ private:
+  uint16_t word(uint8_t r) const {
+    return (uint16_t)(reg_[r] | ((reg_[r + 1] & 0x1F) << 8));
+  }
+  void advance() {
+    if (autoIncrement()) pointer_++;
+  }
+
+  uint8_t address_;
+  uint8_t reg_[256];
+  uint8_t pointer_ = 0;
+};
+
+}  // namespace sim
+
+#endif  // HOST_SIM_PCA9685_MODEL_H
@@ -0,0 +1,204 @@
+/*
+ * Host Simulation Harness
+ *
+ * Ties the stand-in core, Wire bus and PCA9685 models together and gives
+ * simulator programs a few measuring tools:
+ *   - servo output log (every channel change the chips actually saw)
+ *   - per-channel safe PWM windows (any board, or one board's), with a
+ *     violation counter
+ *   - runLoop(): call loop() until a simulated deadline, charging a fixed
+ *     CPU overhead per pass so free-running loops still advance time
+ *   - per-frame I2C accounting: bytes and bus time of every loop() pass
+ *     that touched the bus
+ */
+
+#ifndef HOST_SIM_SIM_H
+#define HOST_SIM_SIM_H
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "pca9685_model.h"
+#include "event_log_decoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+struct ServoWrite {
+  uint64_t micros;
+  uint8_t address;
+  uint8_t channel;
+  uint16_t off;
+};
+
+struct SafeWindow {
+  bool enabled = false;
+  uint16_t low = 0;
+  uint16_t high = 4095;
+};
+
+inline std::vector<std::unique_ptr<PCA9685Model>> pca9685Boards;
+inline std::function<void(const ServoWrite&)> onServoWrite;
+inline uint64_t servoWrites = 0;       // Channel updates seen by the chips
+inline uint64_t setPWMCalls = 0;       // Calls into Adafruit_PWMServoDriver::setPWM()
+inline uint64_t rangeViolations = 0;
+inline uint64_t loopOverheadMicros = 100;  // Charged per loop() pass
+inline SafeWindow safeWindows[16];             // Channel on any board
+inline SafeWindow boardSafeWindows[128][16];   // Channel on one board (checked first)
+
+inline void setWindow(SafeWindow& window, int a, int b) {
+  window.enabled = true;
+  window.low = (uint16_t)(a < b ? a : b);
+  window.high = (uint16_t)(a < b ? b : a);
+}
+
+// Only an OFF value of 0 (servo released) is allowed outside the window
+inline void setSafeWindow(uint8_t channel, int a, int b) {
+  setWindow(safeWindows[channel & 0x0F], a, b);
+}
+
+inline void setSafeWindow(uint8_t address, uint8_t channel, int a, int b) {
+  setWindow(boardSafeWindows[address & 0x7F][channel & 0x0F], a, b);
+}
+
+inline void recordServoWrite(uint8_t address, uint8_t channel, uint16_t on, uint16_t off) {
+  (void)on;
+  servoWrites++;
+  const SafeWindow& boardWindow = boardSafeWindows[address & 0x7F][channel & 0x0F];
+  const SafeWindow& window = boardWindow.enabled ? boardWindow : safeWindows[channel & 0x0F];
+  if (window.enabled && off != 0 && (off < window.low || off > window.high)) {
+    rangeViolations++;
+    fprintf(stderr, "RANGE VIOLATION t=%llu us 0x%02X ch=%u off=%u (safe %u-%u)\n",
+            (unsigned long long)nowMicros, address, channel, off, window.low, window.high);
+  }
+  if (onServoWrite) {
+    onServoWrite(ServoWrite{nowMicros, address, channel, off});
+  }
+}
+
+// Attach a PCA9685 model at `address` unless one is already there
+inline PCA9685Model* ensurePCA9685(uint8_t address) {
+  I2CDevice* existing = i2cDevices[address & 0x7F];
+  if (existing) {
+    return static_cast<PCA9685Model*>(existing);
+  }
+  pca9685Boards.emplace_back(new PCA9685Model(address));
+  PCA9685Model* model = pca9685Boards.back().get();
+  model->onChannel = recordServoWrite;
+  attachI2CDevice(address, model);
+  return model;
+}
+
+// One loop() pass plus the per-pass CPU overhead
+template <typename LoopFn>
+inline void step(LoopFn loopFn) {
+  loopFn();
+  advanceMicros(loopOverheadMicros);
+}
+
+struct LoopStats {
+  uint64_t iterations = 0;
+  uint64_t simMicros = 0;
+  double hostSeconds = 0;
+  // Frames = loop() passes that put at least one byte on the I2C bus
+  uint64_t frames = 0;
+  uint64_t frameBytes = 0;
+  uint64_t frameTransactions = 0;
+  uint64_t frameBusMicros = 0;
+  uint64_t maxFrameBytes = 0;
+  uint64_t maxFrameBusMicros = 0;
+};
+
+// step() plus I2C accounting for the pass
+template <typename LoopFn>
+inline void stepCounted(LoopFn loopFn, LoopStats& stats) {
+  I2CStats before = i2c;
+  step(loopFn);
+  stats.iterations++;
+  uint64_t bytes = i2c.bytes - before.bytes;
+  if (bytes == 0) return;
+  uint64_t busMicros = i2c.busMicros - before.busMicros;
+  stats.frames++;
+  stats.frameBytes += bytes;
+  stats.frameTransactions += i2c.transactions - before.transactions;
+  stats.frameBusMicros += busMicros;
+  if (bytes > stats.maxFrameBytes) stats.maxFrameBytes = bytes;
+  if (busMicros > stats.maxFrameBusMicros) stats.maxFrameBusMicros = busMicros;
+}
+
+// Run loopFn until simulated time reaches `untilMicros`, or `stop` says so
+template <typename LoopFn>
+inline LoopStats runLoop(LoopFn loopFn, uint64_t untilMicros,
+                         const std::function<bool()>& stop = nullptr) {
+  LoopStats stats;
+  uint64_t start = nowMicros;
+  auto hostStart = std::chrono::steady_clock::now();
+  while (nowMicros < untilMicros) {
+    stepCounted(loopFn, stats);
+    if (stop && stop()) break;
+  }
+  stats.simMicros = nowMicros - start;
+  stats.hostSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - hostStart).count();
+  return stats;
+}
+
+inline void printLoopStats(const char* label, const LoopStats& stats) {
+  double simSeconds = stats.simMicros / 1e6;
+  printf("%-28s %10.0f loops/s (sim)  %8.1f ns/loop (host)\n", label,
+         simSeconds > 0 ? stats.iterations / simSeconds : 0.0,
+         stats.iterations ? stats.hostSeconds * 1e9 / stats.iterations : 0.0);
+}
+
+// Bytes on the wire (address + register + data) per frame that used the bus
+inline void printFrameStats(const char* label, const LoopStats& stats) {
+  if (!stats.frames) return;
+  double frames = (double)stats.frames;
+  printf("%-28s %6.1f bytes/frame (max %llu)  %4.2f transactions/frame  %6.0f us bus/frame (max %llu)\n",
+         label, stats.frameBytes / frames, (unsigned long long)stats.maxFrameBytes,
+         stats.frameTransactions / frames, stats.frameBusMicros / frames,
+         (unsigned long long)stats.maxFrameBusMicros);
+}
+
+// Sketches logging through event_log.h: decode their records in Serial
+// output for --verbose echo and printSerialBlock()
+inline std::vector<EventFormat> eventFormats;
+inline EventLogDecoder::NameFn eventNames;
+
+inline void useEventLog(std::vector<EventFormat> formats, EventLogDecoder::NameFn names = nullptr) {
+  eventFormats = formats;
+  eventNames = names;
+  auto echo = std::make_shared<EventLogDecoder>(formats, names);
+  Serial.echoHook = [echo](uint8_t c) {
+    fputs(echo->feed(&c, 1).c_str(), stdout);
+  };
+}
+
+// Everything the sketch sent to Serial, event records decoded
+inline std::string serialText() {
+  if (eventFormats.empty()) return Serial.output;
+  EventLogDecoder decoder(eventFormats, eventNames);
+  return decoder.feed(Serial.output);
+}
+
+// Echo a report the sketch printed to Serial: the last line starting with
+// `header` and the indented lines after it
+inline void printSerialBlock(const char* header) {
+  std::string text = serialText();
+  text.erase(std::remove(text.begin(), text.end(), '\r'), text.end());
+  size_t start = text.rfind(header);
+  if (start == std::string::npos) return;
+  size_t end = text.find('\n', start);
+  while (end != std::string::npos && text.compare(end + 1, 2, "  ") == 0) {
+    end = text.find('\n', end + 1);
+  }
+  printf("%s\n", text.substr(start, end == std::string::npos ? std::string::npos : end - start).c_str());
+}
+
+}  // namespace sim
+
+#endif  // HOST_SIM_SIM_H
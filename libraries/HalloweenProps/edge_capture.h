@@ -0,0 +1,232 @@
+/*
+ * Edge Capture - Interrupt-Timestamped Input Edges with Debounce
+ *
+ * Polling a trigger with digitalRead() once per loop() misses presses
+ * shorter than a loop pass, sees contact bounce as extra presses, and
+ * reacts only as fast as the slowest thing in the loop. PinEdgeCapture
+ * takes the pin on a pin-change interrupt instead: the ISR stamps each
+ * edge with micros() into a small ring, and the main loop debounces those
+ * timestamps whenever it gets to them.
+ *
+ *   PinEdgeCapture<8> trigger(TRIGGER_DEBOUNCE_MICROS);
+ *   ISR(PCINT0_vect) { trigger.onPinChange(); }
+ *
+ *   trigger.begin(TRIGGER_PIN);          // in setup(): INPUT_PULLUP + PCINT
+ *
+ *   PinEdge press;
+ *   while (trigger.poll(press)) {        // in loop()
+ *     if (press.level == LOW) ...        // press.micros = when it happened
+ *   }
+ *
+ * Debounce is a lockout: the first edge that changes the level is taken at
+ * once (no added latency), then further edges are ignored for the lockout
+ * time. If the pin ended up somewhere else when the lockout runs out (a
+ * press shorter than the lockout), poll() reports that level change,
+ * stamped with the last edge.
+ *
+ * On the ATmega32U4 only port B pins (8-11, 14-17 on a Leonardo/Beetle)
+ * have pin-change interrupts, all on PCINT0_vect. The ISR reads the port
+ * directly; the host sim calls it from sim::setPin().
+ */
+
+#ifndef EDGE_CAPTURE_H
+#define EDGE_CAPTURE_H
+
+#include <Arduino.h>
+
+struct PinEdge {
+  uint32_t micros;  // micros() in the ISR
+  uint8_t level;    // HIGH or LOW after the edge
+};
+
+/**
+ * Single-producer (ISR) / single-consumer (loop) ring of edges. Indices
+ * are one byte, so both sides read them atomically without cli().
+ */
+template <uint8_t Capacity>
+class EdgeQueue {
+  static_assert(Capacity >= 2 && Capacity <= 128 && (Capacity & (Capacity - 1)) == 0,
+                "EdgeQueue capacity must be a power of two, 2-128");
+
+ public:
+  // ISR side: false (and counted) if the loop hasn't kept up
+  bool push(uint32_t micros, uint8_t level) {
+    uint8_t head = head_;
+    if ((uint8_t)(head - tail_) >= Capacity) {
+      if (overflows_ != 0xFF) overflows_++;
+      return false;
+    }
+    volatile PinEdge& edge = ring_[head & (Capacity - 1)];
+    edge.micros = micros;
+    edge.level = level;
+    head_ = head + 1;  // Publish after the slot is written
+    return true;
+  }
+
+  // Loop side
+  bool pop(PinEdge& edge) {
+    uint8_t tail = tail_;
+    if (tail == head_) return false;
+    const volatile PinEdge& slot = ring_[tail & (Capacity - 1)];
+    edge.micros = slot.micros;
+    edge.level = slot.level;
+    tail_ = tail + 1;
+    return true;
+  }
+
+  uint8_t count() const { return (uint8_t)(head_ - tail_); }
+  uint8_t overflows() const { return overflows_; }
+  static uint8_t capacity() { return Capacity; }
+
+ private:
+  volatile PinEdge ring_[Capacity];
+  volatile uint8_t head_ = 0;  // Written by the ISR only
+  volatile uint8_t tail_ = 0;  // Written by the loop only
+  volatile uint8_t overflows_ = 0;
+};
+
+/**
+ * Lockout debounce over timestamped edges. Pure logic: feed it edges and
+ * the current time, get debounced level changes back.
+ */
+class EdgeDebouncer {
+ public:
+  explicit EdgeDebouncer(uint32_t lockoutMicros, uint8_t idleLevel = HIGH)
+      : lockout_(lockoutMicros), stable_(idleLevel), raw_(idleLevel) {}
+
+  /**
+   * One raw edge; true (and `out` set) if it is a debounced level change
+   */
+  bool edge(const PinEdge& in, PinEdge& out) {
+    raw_ = in.level;
+    rawMicros_ = in.micros;
+    if (in.level == stable_) return false;
+    if (changed_ && (uint32_t)(in.micros - changeMicros_) < lockout_) {
+      if (bounces_ != 0xFFFF) bounces_++;
+      return false;
+    }
+    return accept(in.micros, out);
+  }
+
+  /**
+   * No more edges queued: settle on the pin's last level once the lockout
+   * is over. True (and `out` set) if that is a level change.
+   */
+  bool settle(uint32_t nowMicros, PinEdge& out) {
+    if (raw_ == stable_) return false;
+    if (changed_ && (uint32_t)(nowMicros - changeMicros_) < lockout_) return false;
+    return accept(rawMicros_, out);
+  }
+
+  // The pin's level is known some other way (queue overflow): trust it
+  void resync(uint8_t level, uint32_t nowMicros) {
+    raw_ = level;
+    rawMicros_ = nowMicros;
+  }
+
+  uint8_t level() const { return stable_; }
+  uint16_t bounces() const { return bounces_; }  // Edges ignored inside a lockout
+  uint32_t lockoutMicros() const { return lockout_; }
+
+ private:
+  bool accept(uint32_t micros, PinEdge& out) {
+    stable_ = raw_;
+    changed_ = true;
+    changeMicros_ = micros;
+    out.micros = micros;
+    out.level = stable_;
+    return true;
+  }
+
+  uint32_t lockout_;
+  uint8_t stable_;
+  uint8_t raw_;          // Level after the last edge seen
+  uint32_t rawMicros_ = 0;
+  bool changed_ = false;
+  uint32_t changeMicros_ = 0;
+  uint16_t bounces_ = 0;
+};
+
+/**
+ * One input pin on a pin-change interrupt, queued and debounced
+ */
+template <uint8_t Capacity>
+class PinEdgeCapture {
+ public:
+  explicit PinEdgeCapture(uint32_t lockoutMicros, uint8_t idleLevel = HIGH)
+      : debouncer_(lockoutMicros, idleLevel), lastLevel_(idleLevel) {}
+
+  /**
+   * INPUT_PULLUP and enable the pin's change interrupt. False if the pin
+   * has none (not on port B).
+   */
+  bool begin(uint8_t pin) {
+    pin_ = pin;
+    pinMode(pin, INPUT_PULLUP);
+    volatile uint8_t* pcicr = digitalPinToPCICR(pin);
+    if (!pcicr) return false;
+#ifdef __AVR__
+    inputRegister_ = portInputRegister(digitalPinToPort(pin));
+    bitMask_ = digitalPinToBitMask(pin);
+#endif
+    lastLevel_ = readPin();
+    debouncer_.resync(lastLevel_, micros());  // Held at power-up: a press
+    *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+    *pcicr |= _BV(digitalPinToPCICRbit(pin));
+    return true;
+  }
+
+  /**
+   * Call from the port's ISR. Other pins on the port share the vector, so
+   * only a change of this pin's level is queued.
+   */
+  void onPinChange() {
+    uint8_t level = readPin();
+    if (level == lastLevel_) return;
+    lastLevel_ = level;
+    queue_.push(micros(), level);
+  }
+
+  /**
+   * Next debounced level change, oldest first; false when there is none
+   */
+  bool poll(PinEdge& out) {
+    PinEdge in;
+    while (queue_.pop(in)) {
+      if (debouncer_.edge(in, out)) return true;
+    }
+    if (queue_.overflows() != overflowsSeen_) {
+      overflowsSeen_ = queue_.overflows();
+      debouncer_.resync(readPin(), micros());
+    }
+    return debouncer_.settle(micros(), out);
+  }
+
+  // Edges queued by the ISR that poll() hasn't seen yet
+  bool pending() const { return queue_.count() != 0; }
+
+  uint8_t level() const { return debouncer_.level(); }
+  uint16_t bounces() const { return debouncer_.bounces(); }
+  uint8_t overflows() const { return queue_.overflows(); }
+
+ private:
+  uint8_t readPin() const {
+#ifdef __AVR__
+    return (*inputRegister_ & bitMask_) ? HIGH : LOW;
+#else
+    return digitalRead(pin_) ? HIGH : LOW;
+#endif
+  }
+
+  EdgeQueue<Capacity> queue_;
+  EdgeDebouncer debouncer_;
+  uint8_t pin_ = 0;
+  volatile uint8_t lastLevel_;  // ISR only, after begin()
+  uint8_t overflowsSeen_ = 0;
+#ifdef __AVR__
+  volatile uint8_t* inputRegister_ = nullptr;
+  uint8_t bitMask_ = 0;
+#endif
+};
+
+#endif // EDGE_CAPTURE_H
@@ -0,0 +1,170 @@
+/*
+ * Event Log - Non-Blocking Binary Log Records in a RAM Ring
+ *
+ * Serial.print() on the Beetle's USB serial blocks when the host isn't
+ * draining the CDC buffer, stalling whatever called it. Sketches instead
+ * log fixed-size event records into a ring and send them from idle time,
+ * never writing more than the port can take right now:
+ *
+ *   EventLog<32> eventLog;
+ *
+ *   eventLog.log(EVT_ANIM_START, animIndex);      // ~2us, never blocks
+ *   ...
+ *   eventLog.drain(Serial);                       // in loop(), between frames
+ *
+ * A record is an event code, one byte and two 16-bit arguments, stamped
+ * with the low 16 bits of millis(). On the wire it is 10 bytes:
+ *
+ *   0xA5 code a timeLo timeHi bLo bHi cLo cHi check
+ *
+ * where check = ~(code + a + ... + cHi). Plain-text Serial output (setup
+ * banners) can share the port: text is ASCII, so the decoder treats bytes
+ * below 0x80 as text and resyncs on the next 0xA5 after a bad checksum.
+ *
+ * When the ring is full the event is dropped and counted; the next event
+ * that fits is preceded by an EVT_DROPPED record (dropped since last
+ * report, total), so the log shows where the gap is.
+ *
+ * Event codes and their text live in an X-macro list per sketch; the host
+ * decoder (host_sim/event_log_decoder.h) builds its format table from the
+ * same list, so the firmware never stores the strings:
+ *
+ *   #define HATCHING_EGG_EVENTS(X) \
+ *     X(EVT_ANIM_START, 0x12, "Starting: {a:name}")
+ *   enum { HATCHING_EGG_EVENTS(EVENT_LOG_ENUM) };
+ *
+ * Format fields: {a} {b} {c} decimal, {b:q8} Q8 fixed point (1.50),
+ * {c:ms} milliseconds as seconds (3.00), {b:lo} / {b:hi} one byte of a
+ * 16-bit argument, {a:name} looked up by the decoder (animation names),
+ * {a:bucket} a FrameScheduler histogram bucket. Codes 0x01-0x0F are the
+ * library's; sketches start at 0x10.
+ *
+ * Not interrupt safe: log() and drain() belong to the main loop.
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+
+#define EVENT_LOG_SYNC 0xA5
+#define EVENT_LOG_RECORD_BYTES 8   // In the ring
+#define EVENT_LOG_WIRE_BYTES 10    // Sync + record + checksum
+
+#define EVENT_LOG_ENUM(name, code, format) name = code,
+
+// Library events (the ring itself, and logStats() of FrameScheduler, I2CBus
+// and ServoPower)
+#define EVENT_LOG_LIBRARY_EVENTS(X) \
+  X(EVT_DROPPED, 0x01, "... {b} events dropped ({c} total)") \
+  X(EVT_FRAME_TIMES, 0x02, "  late max {b}us  compute max {c}us") \
+  X(EVT_FRAME_HIST, 0x03, "  {a:bucket}us: late {b}  compute {c}") \
+  X(EVT_BUS_MAX, 0x04, "  I2C max {b} bytes, {a} transactions, {c}us in a frame") \
+  X(EVT_BUS_BUDGET, 0x05, "  I2C {b} frames over budget, {c} writes deferred") \
+  X(EVT_POWER_LIMITED, 0x06, "  Servo current asked up to {c} mA, {b} frames limited")
+
+enum { EVENT_LOG_LIBRARY_EVENTS(EVENT_LOG_ENUM) };
+
+struct EventRecord {
+  uint8_t code;
+  uint8_t a;
+  uint16_t timeMs;  // millis() & 0xFFFF
+  uint16_t b;
+  uint16_t c;
+};
+
+// Wire frame for one record; returns EVENT_LOG_WIRE_BYTES
+inline uint8_t encodeEventRecord(const EventRecord& record, uint8_t* out) {
+  out[0] = EVENT_LOG_SYNC;
+  out[1] = record.code;
+  out[2] = record.a;
+  out[3] = (uint8_t)record.timeMs;
+  out[4] = (uint8_t)(record.timeMs >> 8);
+  out[5] = (uint8_t)record.b;
+  out[6] = (uint8_t)(record.b >> 8);
+  out[7] = (uint8_t)record.c;
+  out[8] = (uint8_t)(record.c >> 8);
+  uint8_t sum = 0;
+  for (uint8_t i = 1; i < EVENT_LOG_WIRE_BYTES - 1; i++) sum += out[i];
+  out[EVENT_LOG_WIRE_BYTES - 1] = (uint8_t)~sum;
+  return EVENT_LOG_WIRE_BYTES;
+}
+
+// Pack two 0-255 values (servo targets) into one 16-bit argument
+inline uint16_t eventBytes(uint8_t lo, uint8_t hi) {
+  return (uint16_t)lo | ((uint16_t)hi << 8);
+}
+
+template <uint8_t Capacity>
+class EventLog {
+  static_assert(Capacity >= 2 && Capacity <= 128 && (Capacity & (Capacity - 1)) == 0,
+                "EventLog capacity must be a power of two, 2-128");
+
+ public:
+  /**
+   * Queue an event; false (and counted) if the ring is full
+   */
+  bool log(uint8_t code, uint8_t a = 0, uint16_t b = 0, uint16_t c = 0) {
+    uint8_t needed = pendingDrops_ ? 2 : 1;
+    if ((uint8_t)(Capacity - count()) < needed) {
+      countDrop();
+      return false;
+    }
+    if (pendingDrops_) reportDrops();
+    put(code, a, b, c);
+    return true;
+  }
+
+  /**
+   * Send whole records while the port can take them without blocking.
+   * Returns the number sent.
+   */
+  template <typename Out>
+  uint8_t drain(Out& out) {
+    if (pendingDrops_ && count() == 0) reportDrops();
+    uint8_t sent = 0;
+    uint8_t frame[EVENT_LOG_WIRE_BYTES];
+    while (head_ != tail_ && out.availableForWrite() >= EVENT_LOG_WIRE_BYTES) {
+      out.write(frame, encodeEventRecord(ring_[tail_ & (Capacity - 1)], frame));
+      tail_++;
+      sent++;
+    }
+    return sent;
+  }
+
+  uint8_t count() const { return (uint8_t)(head_ - tail_); }
+  uint8_t highWater() const { return highWater_; }
+  uint32_t dropped() const { return totalDropped_; }
+  static uint8_t capacity() { return Capacity; }
+
+ private:
+  void put(uint8_t code, uint8_t a, uint16_t b, uint16_t c) {
+    EventRecord& record = ring_[head_ & (Capacity - 1)];
+    record.code = code;
+    record.a = a;
+    record.timeMs = (uint16_t)millis();
+    record.b = b;
+    record.c = c;
+    head_++;
+    if (count() > highWater_) highWater_ = count();
+  }
+
+  void countDrop() {
+    totalDropped_++;
+    if (pendingDrops_ != 0xFFFF) pendingDrops_++;
+  }
+
+  void reportDrops() {
+    put(EVT_DROPPED, 0, pendingDrops_, totalDropped_ > 0xFFFF ? 0xFFFF : (uint16_t)totalDropped_);
+    pendingDrops_ = 0;
+  }
+
+  EventRecord ring_[Capacity];
+  uint8_t head_ = 0;  // Free-running; index with & (Capacity - 1)
+  uint8_t tail_ = 0;
+  uint8_t highWater_ = 0;
+  uint16_t pendingDrops_ = 0;
+  uint32_t totalDropped_ = 0;
+};
+
+#endif // EVENT_LOG_H
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+Flash and RAM per log level for a sketch using log_level.h
+
+Compiles the sketch once per LOG_LEVEL (NONE..DEBUG) with arduino-cli,
+passing -DLOG_LEVEL=N through compiler.cpp.extra_flags, and reports what
+flash and RAM bytes per level and the saving against the full-verbosity
+DEBUG build (WARN is the production default).
+
+Each level builds in its own directory under build/log-level-N, so reruns
+are incremental.
+
+Usage (from a project dir, after pixi run setup):
+  pixi run flash-by-log-level
+  python ../libraries/HalloweenProps/extras/log_level_flash.py arduino/twitching_servos
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+from pathlib import Path
+
+LEVELS = ['NONE', 'ERROR', 'WARN', 'INFO', 'DEBUG']
+LIBRARIES = Path(__file__).resolve().parent.parent.parent
+
+FLASH_RE = re.compile(r'Sketch uses (\d+) bytes')
+RAM_RE = re.compile(r'Global variables use (\d+) bytes')
+
+
+def compile_level(args, level):
+    """(flash bytes, RAM bytes) for one LOG_LEVEL build, or None."""
+    build = Path(args.sketch) / 'build' / f'log-level-{level}'
+    cmd = [args.cli, 'compile', '--fqbn', args.fqbn, '--libraries', str(LIBRARIES),
+           '--build-path', str(build),
+           '--build-property', f'compiler.cpp.extra_flags=-DLOG_LEVEL={level}',
+           args.sketch]
+    if args.config:
+        cmd[2:2] = ['--config-file', args.config]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout + result.stderr)
+        return None
+    flash = FLASH_RE.search(result.stdout)
+    ram = RAM_RE.search(result.stdout)
+    if not flash or not ram:
+        sys.stderr.write(result.stdout)
+        return None
+    return int(flash.group(1)), int(ram.group(1))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument('sketch', help='sketch directory, e.g. arduino/hatching_egg')
+    parser.add_argument('--cli', default='.pixi/bin/arduino-cli')
+    parser.add_argument('--config', default='.arduino15/arduino-cli.yaml')
+    parser.add_argument('--fqbn', default='arduino:avr:leonardo')
+    args = parser.parse_args()
+
+    if not Path(args.cli).exists():
+        print(f'{args.cli} not found - run pixi run setup first')
+        return 1
+    if args.config and not Path(args.config).exists():
+        args.config = None
+
+    sizes = {}
+    for level, name in enumerate(LEVELS):
+        print(f'Compiling {args.sketch} at LOG_LEVEL_{name}...', file=sys.stderr)
+        sizes[level] = compile_level(args, level)
+        if sizes[level] is None:
+            print(f'LOG_LEVEL_{name} build failed')
+            return 1
+
+    debug_flash, debug_ram = sizes[len(LEVELS) - 1]
+    print(f'{Path(args.sketch).name}: flash and RAM per log level')
+    print(f'{"Level":<8}{"Flash":>7}{"vs DEBUG":>10}{"RAM":>7}{"vs DEBUG":>10}')
+    for level, name in enumerate(LEVELS):
+        flash, ram = sizes[level]
+        print(f'{name:<8}{flash:>7}{flash - debug_flash:>+10}{ram:>7}{ram - debug_ram:>+10}')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,222 @@
+/*
+ * Frame Scheduler - Fixed-Rate Pose Updates With Jitter Instrumentation
+ *
+ * A servo only takes a new pulse once per PWM period (20ms at 50Hz), so
+ * recomputing the pose faster than that is wasted CPU and I2C time. The
+ * scheduler hands out frames on a fixed grid aligned to the PWM period:
+ *
+ *   FrameScheduler frames(FRAME_PERIOD_MICROS(SERVO_FREQ, 1));
+ *
+ *   void loop() {
+ *     pollInputs();                 // runs every pass
+ *     if (frames.beginFrame()) {
+ *       updatePose();
+ *       servoBatch.flush();
+ *       frames.endFrame();
+ *     }
+ *     frames.idle();                // sleep until the next tick
+ *   }
+ *
+ * Deadlines advance by exactly one period, so frames don't drift. A frame
+ * more than a period late skips the missed slots (counted) instead of
+ * bursting to catch up.
+ *
+ * Each frame records its lateness (start - deadline) and compute time
+ * (beginFrame() to endFrame()) in log2 histograms: bucket 0 is < 64us,
+ * bucket i is [32 << i, 64 << i) us, the last bucket is everything above.
+ *
+ * logStats() sends the same report as event log records (event_log.h)
+ * instead of text, so it never blocks on a full USB serial buffer.
+ *
+ * idle() puts the CPU in SLEEP_MODE_IDLE; the timer0 overflow interrupt
+ * (every 1.024ms) wakes it, so inputs are still polled about once a
+ * millisecond. Within one timer tick of the deadline it busy-waits instead,
+ * for an on-time start.
+ */
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <Arduino.h>
+#include "event_log.h"
+#ifdef __AVR__
+#include <avr/sleep.h>
+#endif
+
+// Frame period for `framesPerPeriod` frames per servo PWM period
+#define FRAME_PERIOD_MICROS(servoFreq, framesPerPeriod) (1000000UL / (servoFreq) / (framesPerPeriod))
+
+#define FRAME_HIST_BUCKETS 10   // <64us ... >=16ms
+#define FRAME_TIMER_TICK_MICROS 1024  // timer0 overflow: longest idle() sleep
+
+struct FrameStats {
+  uint32_t frames;
+  uint16_t skipped;        // Frame slots missed because a frame ran over
+  uint16_t maxLateMicros;
+  uint16_t maxComputeMicros;
+  uint16_t late[FRAME_HIST_BUCKETS];     // Saturating counts
+  uint16_t compute[FRAME_HIST_BUCKETS];
+};
+
+class FrameScheduler {
+ public:
+  explicit FrameScheduler(uint32_t periodMicros) : period_(periodMicros) {
+    resetStats();
+  }
+
+  /**
+   * Make the next frame due now (call on start, or to react to an event
+   * without waiting for the grid)
+   */
+  void restart() {
+    deadline_ = micros();
+    started_ = true;
+  }
+
+  /**
+   * True once per frame slot. Records lateness and starts the compute timer.
+   */
+  bool beginFrame() {
+    uint32_t now = micros();
+    if (!started_) {
+      deadline_ = now;
+      started_ = true;
+    }
+    uint32_t late = now - deadline_;
+    if ((int32_t)late < 0) return false;
+
+    record(stats_.late, late);
+    if (late > stats_.maxLateMicros) stats_.maxLateMicros = clamp16(late);
+    deadline_ += period_;
+    if (late >= period_) {
+      // Ran over: drop the missed slots but stay on the grid
+      uint32_t missed = late / period_;
+      deadline_ += missed * period_;
+      stats_.skipped += missed;
+    }
+    frameStart_ = now;
+    stats_.frames++;
+    return true;
+  }
+
+  /**
+   * Record how long the frame's work took
+   */
+  void endFrame() {
+    uint32_t compute = micros() - frameStart_;
+    record(stats_.compute, compute);
+    if (compute > stats_.maxComputeMicros) stats_.maxComputeMicros = clamp16(compute);
+  }
+
+  /**
+   * Give up the CPU until the next timer tick or the frame deadline
+   */
+  void idle() {
+    uint32_t wait = untilNextFrame();
+    if (wait == 0) return;
+    if (wait <= FRAME_TIMER_TICK_MICROS) {
+      delayMicroseconds((unsigned int)wait);
+      return;
+    }
+#ifdef __AVR__
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_mode();
+#else
+    delayMicroseconds(FRAME_TIMER_TICK_MICROS);  // Host sim: the timer0 wake-up
+#endif
+  }
+
+  uint32_t untilNextFrame() const {
+    if (!started_) return 0;
+    int32_t wait = (int32_t)(deadline_ - micros());
+    return wait > 0 ? (uint32_t)wait : 0;
+  }
+
+  uint32_t periodMicros() const { return period_; }
+  const FrameStats& stats() const { return stats_; }
+
+  void resetStats() {
+    memset(&stats_, 0, sizeof(stats_));
+  }
+
+  // Lower edge of a histogram bucket in microseconds
+  static uint32_t bucketMicros(uint8_t bucket) {
+    return bucket ? (uint32_t)32 << bucket : 0;
+  }
+
+  /**
+   * Frames: 1500 (0 skipped)  late max 980us  compute max 610us
+   *   late    <64:1200 <128:250 ...
+   *   compute <64:0 ...
+   */
+  template <typename Out>
+  void printStats(Out& out) const {
+    out.print(F("Frames: "));
+    out.print(stats_.frames);
+    out.print(F(" ("));
+    out.print(stats_.skipped);
+    out.print(F(" skipped)  late max "));
+    out.print(stats_.maxLateMicros);
+    out.print(F("us  compute max "));
+    out.print(stats_.maxComputeMicros);
+    out.println(F("us"));
+    printHistogram(out, F("  late   "), stats_.late);
+    printHistogram(out, F("  compute"), stats_.compute);
+  }
+
+  /**
+   * printStats() as event records: `headerCode` (frames, skipped), then
+   * EVT_FRAME_TIMES and one EVT_FRAME_HIST per non-empty bucket
+   */
+  template <typename Log>
+  void logStats(Log& log, uint8_t headerCode) const {
+    log.log(headerCode, 0, clamp16(stats_.frames), stats_.skipped);
+    log.log(EVT_FRAME_TIMES, 0, stats_.maxLateMicros, stats_.maxComputeMicros);
+    for (uint8_t i = 0; i < FRAME_HIST_BUCKETS; i++) {
+      if (stats_.late[i] || stats_.compute[i]) {
+        log.log(EVT_FRAME_HIST, i, stats_.late[i], stats_.compute[i]);
+      }
+    }
+  }
+
+ private:
+  static uint8_t bucketFor(uint32_t micros) {
+    uint8_t bucket = 0;
+    micros >>= 6;
+    while (micros && bucket < FRAME_HIST_BUCKETS - 1) {
+      micros >>= 1;
+      bucket++;
+    }
+    return bucket;
+  }
+
+  static void record(uint16_t* histogram, uint32_t micros) {
+    uint16_t& count = histogram[bucketFor(micros)];
+    if (count != 0xFFFF) count++;
+  }
+
+  static uint16_t clamp16(uint32_t value) {
+    return value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+  }
+
+  template <typename Out, typename Label>
+  static void printHistogram(Out& out, Label label, const uint16_t* histogram) {
+    out.print(label);
+    for (uint8_t i = 0; i < FRAME_HIST_BUCKETS; i++) {
+      if (!histogram[i]) continue;
+      out.print(i == FRAME_HIST_BUCKETS - 1 ? F(" >=") : F(" <"));
+      out.print(bucketMicros(i == FRAME_HIST_BUCKETS - 1 ? i : i + 1));
+      out.print(':');
+      out.print(histogram[i]);
+    }
+    out.println();
+  }
+
+  uint32_t period_;
+  uint32_t deadline_ = 0;
+  uint32_t frameStart_ = 0;
+  bool started_ = false;
+  FrameStats stats_;
+};
+
+#endif // FRAME_SCHEDULER_H
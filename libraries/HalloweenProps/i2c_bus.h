@@ -0,0 +1,201 @@
+/*
+ * I2C Bus - Fast-Mode Clock and a Per-Frame Bus Time Budget
+ *
+ * The AVR core's Wire runs SCL at 100 kHz, and Wire.begin() (which
+ * Adafruit's pwm.begin() calls) puts it back there. AVR Wire busy-waits,
+ * so each byte is 90us the loop can't use. The PCA9685 takes 400 kHz fast
+ * mode and 1 MHz fast mode plus; the 32U4's TWI tops out at F_CPU / 16
+ * (1 MHz on the 16 MHz Beetle), and faster requests are clamped to that:
+ *
+ *   I2CBus bus(I2C_BUS_FAST_HZ, 2000);  // 400 kHz, 2ms of writes per frame
+ *
+ *   pwm.begin();                         // Resets SCL to 100 kHz...
+ *   bus.begin();                         // ...so this comes after
+ *
+ *   if (frames.beginFrame()) {
+ *     bus.beginFrame();
+ *     updatePose();
+ *     servos.flush(bus);                 // Low-priority servos wait if over budget
+ *   }
+ *
+ * Bus time is counted in SCL clocks - 9 per byte (8 data + ACK) plus 2 per
+ * transaction for START/STOP, as host_sim/Wire.h charges it - so recording
+ * a write costs no divide. Each frame's bytes, transactions and clocks are
+ * tallied, and beginFrame() rolls the finished frame into the stats:
+ * maxima, frames that ran over the budget and servo writes deferred.
+ * printStats() prints them; logStats() sends them as event records.
+ *
+ * Long wires or weak pull-ups (the PCA9685 breakout's 10k) may not make
+ * clean edges at 1 MHz; 400 kHz is the safe fast setting.
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "event_log.h"
+
+#define I2C_BUS_STANDARD_HZ 100000UL   // AVR Wire default
+#define I2C_BUS_FAST_HZ 400000UL       // Fast mode
+#define I2C_BUS_FAST_PLUS_HZ 1000000UL // Fast mode plus (PCA9685 supports it)
+
+// SCL clocks for one write of `bytes` bytes on the wire, address included
+#define I2C_BUS_TRANSACTION_CLOCKS(bytes) (9 * (bytes) + 2)
+
+struct I2CBusStats {
+  uint32_t frames;        // Frames that put anything on the bus
+  uint32_t bytes;         // On the wire, address and register bytes included
+  uint32_t transactions;
+  uint16_t maxFrameBytes;
+  uint16_t maxFrameTransactions;
+  uint32_t maxFrameClocks;
+  uint16_t overBudget;    // Frames whose writes ran past the budget (saturating)
+  uint16_t deferred;      // Writes held for a later frame (saturating)
+};
+
+class I2CBus {
+ public:
+  explicit I2CBus(uint32_t clockHz = I2C_BUS_FAST_HZ, uint16_t budgetMicros = 2000)
+      : budgetMicros_(budgetMicros) {
+    setClockHz(clockHz);
+    resetStats();
+  }
+
+  /**
+   * Set the Wire clock (after pwm.begin() / Wire.begin())
+   */
+  void begin(TwoWire& wire = Wire) {
+    wire.setClock(clockHz());
+  }
+
+  /**
+   * Close the previous frame into the stats and start counting a new one
+   */
+  void beginFrame() {
+    if (frameTransactions_) {
+      stats_.frames++;
+      if (frameBytes_ > stats_.maxFrameBytes) stats_.maxFrameBytes = frameBytes_;
+      if (frameTransactions_ > stats_.maxFrameTransactions) stats_.maxFrameTransactions = frameTransactions_;
+      if (frameClocks_ > stats_.maxFrameClocks) stats_.maxFrameClocks = frameClocks_;
+      if (frameClocks_ > budgetClocks_ && stats_.overBudget != 0xFFFF) stats_.overBudget++;
+    }
+    frameBytes_ = 0;
+    frameTransactions_ = 0;
+    frameClocks_ = 0;
+  }
+
+  /**
+   * Count writes that went out this frame (PCA9685Batch::lastBytes() and
+   * lastTransactions() after a flush)
+   */
+  void record(uint16_t bytes, uint8_t transactions) {
+    frameBytes_ += bytes;
+    frameTransactions_ += transactions;
+    frameClocks_ += 9UL * bytes + 2 * transactions;
+    stats_.bytes += bytes;
+    stats_.transactions += transactions;
+  }
+
+  /**
+   * Count writes held back for a later frame
+   */
+  void defer(uint8_t writes = 1) {
+    uint16_t room = 0xFFFF - stats_.deferred;
+    stats_.deferred += writes < room ? writes : room;
+  }
+
+  // SCL clocks left in this frame's budget (0 once it's spent)
+  uint32_t remainingClocks() const {
+    return frameClocks_ < budgetClocks_ ? budgetClocks_ - frameClocks_ : 0;
+  }
+
+  bool fits(uint8_t bytes) const {
+    return I2C_BUS_TRANSACTION_CLOCKS((uint32_t)bytes) <= remainingClocks();
+  }
+
+  uint32_t clockHz() const { return (uint32_t)clockKHz_ * 1000; }
+  uint16_t budgetMicros() const { return budgetMicros_; }
+  uint32_t budgetClocks() const { return budgetClocks_; }
+
+  // This frame so far
+  uint16_t frameBytes() const { return frameBytes_; }
+  uint16_t frameTransactions() const { return frameTransactions_; }
+  uint32_t frameClocks() const { return frameClocks_; }
+  uint32_t frameMicros() const { return clocksToMicros(frameClocks_); }
+
+  uint32_t clocksToMicros(uint32_t clocks) const {
+    return (clocks * 1000 + clockKHz_ - 1) / clockKHz_;
+  }
+
+  const I2CBusStats& stats() const { return stats_; }
+
+  void resetStats() {
+    memset(&stats_, 0, sizeof(stats_));
+  }
+
+  /**
+   * I2C 400 kHz: 1500 frames  14.2 bytes/frame  max 20 bytes 2 transactions 470us  0 over 2000us  0 deferred
+   */
+  template <typename Out>
+  void printStats(Out& out) const {
+    out.print(F("I2C "));
+    out.print(clockKHz_);
+    out.print(F(" kHz: "));
+    out.print(stats_.frames);
+    out.print(F(" frames  "));
+    uint32_t tenths = stats_.frames ? stats_.bytes * 10 / stats_.frames : 0;  // No float printing
+    out.print(tenths / 10);
+    out.print('.');
+    out.print(tenths % 10);
+    out.print(F(" bytes/frame  max "));
+    out.print(stats_.maxFrameBytes);
+    out.print(F(" bytes "));
+    out.print(stats_.maxFrameTransactions);
+    out.print(F(" transactions "));
+    out.print(clocksToMicros(stats_.maxFrameClocks));
+    out.print(F("us  "));
+    out.print(stats_.overBudget);
+    out.print(F(" over "));
+    out.print(budgetMicros_);
+    out.print(F("us  "));
+    out.print(stats_.deferred);
+    out.println(F(" deferred"));
+  }
+
+  /**
+   * printStats() as event records: `headerCode` (clock / 100 kHz, frames,
+   * average bytes per frame), then EVT_BUS_MAX and EVT_BUS_BUDGET
+   */
+  template <typename Log>
+  void logStats(Log& log, uint8_t headerCode) const {
+    log.log(headerCode, (uint8_t)(clockKHz_ / 100), clamp16(stats_.frames),
+            stats_.frames ? clamp16(stats_.bytes / stats_.frames) : 0);
+    log.log(EVT_BUS_MAX, (uint8_t)(stats_.maxFrameTransactions > 0xFF ? 0xFF : stats_.maxFrameTransactions),
+            stats_.maxFrameBytes, clamp16(clocksToMicros(stats_.maxFrameClocks)));
+    log.log(EVT_BUS_BUDGET, 0, stats_.overBudget, stats_.deferred);
+  }
+
+ private:
+  void setClockHz(uint32_t hz) {
+#ifdef F_CPU
+    if (hz > F_CPU / 16) hz = F_CPU / 16;  // TWBR = 0: the TWI's fastest
+#endif
+    clockKHz_ = hz >= 1000 ? (uint16_t)(hz / 1000) : 1;
+    budgetClocks_ = (uint32_t)budgetMicros_ * clockKHz_ / 1000;
+  }
+
+  static uint16_t clamp16(uint32_t value) {
+    return value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+  }
+
+  uint16_t clockKHz_;
+  uint16_t budgetMicros_;
+  uint32_t budgetClocks_;
+  uint16_t frameBytes_ = 0;
+  uint16_t frameTransactions_ = 0;
+  uint32_t frameClocks_ = 0;
+  I2CBusStats stats_;
+};
+
+#endif // I2C_BUS_H
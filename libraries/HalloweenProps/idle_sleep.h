@@ -0,0 +1,139 @@
+/*
+ * Idle Sleep - Sleep Between Events, With Duty-Cycle Accounting
+ *
+ * A sketch that only reacts to inputs has nothing to do between them, but
+ * a delay() loop keeps the CPU running flat out anyway. IdleSleep puts it
+ * in SLEEP_MODE_IDLE at the end of each loop() pass instead; any interrupt
+ * wakes it - a pin change (edge_capture.h), USB, or the timer0 overflow
+ * that drives millis() every 1.024ms:
+ *
+ *   IdleSleep idle;
+ *
+ *   void loop() {
+ *     while (trigger.poll(edge)) ...
+ *     readCommands();
+ *     idle.sleep([] { return trigger.pending() || Serial.available() > 0; });
+ *   }
+ *
+ * The work check runs with interrupts off and the CPU only sleeps if it
+ * says there is nothing to do, so an edge that arrives between the loop's
+ * last poll and the sleep can't be left waiting for the next timer tick.
+ * (On AVR, sei followed by sleep always executes the sleep first; a pending
+ * interrupt then wakes it straight away.)
+ *
+ * SLEEP_MODE_IDLE keeps the clocks, USB and timers running, so millis(),
+ * serial and PWM behave as before. The deeper modes stop USB on the 32U4.
+ *
+ * Every pass is counted as awake time (the pass itself) plus asleep time;
+ * counters() gives the totals in milliseconds, good for 49 days, and
+ * dutyBasisPoints() turns two snapshots into an active percentage.
+ */
+
+#ifndef IDLE_SLEEP_H
+#define IDLE_SLEEP_H
+
+#include <Arduino.h>
+#ifdef __AVR__
+#include <avr/sleep.h>
+#endif
+
+#define IDLE_SLEEP_TICK_MICROS 1024  // timer0 overflow: longest sleep without other interrupts
+
+struct IdleCounters {
+  uint32_t activeMillis;  // Awake, running loop()
+  uint32_t totalMillis;   // Awake + asleep
+  uint32_t wakes;         // Sleeps that ended in an interrupt
+};
+
+class IdleSleep {
+ public:
+  IdleSleep() { restart(); }
+
+  /**
+   * Start counting from now (call at the end of setup(), so start-up
+   * delays aren't counted as active time)
+   */
+  void restart() {
+    awakeSince_ = micros();
+    activeMicros_ = 0;
+    totalMicros_ = 0;
+    counters_.activeMillis = 0;
+    counters_.totalMillis = 0;
+    counters_.wakes = 0;
+  }
+
+  /**
+   * Sleep until the next interrupt, unless workPending() (called with
+   * interrupts off) returns true. True if it slept.
+   */
+  template <typename WorkPending>
+  bool sleep(WorkPending workPending) {
+    uint32_t start = micros();
+    uint32_t active = start - awakeSince_;
+    noInterrupts();
+    if (workPending()) {
+      interrupts();
+      return false;
+    }
+#ifdef __AVR__
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_enable();
+    interrupts();  // sei; sleep: the sleep still runs before any pending interrupt
+    sleep_cpu();
+    sleep_disable();
+#else
+    interrupts();
+    delayMicroseconds(IDLE_SLEEP_TICK_MICROS);  // Host sim: the timer0 wake-up
+#endif
+    uint32_t now = micros();
+    account(active, now - start);
+    awakeSince_ = now;
+    if (counters_.wakes != 0xFFFFFFFFUL) counters_.wakes++;
+    return true;
+  }
+
+  /**
+   * Totals since restart(), whole milliseconds
+   */
+  IdleCounters counters() const {
+    IdleCounters now = counters_;
+    now.activeMillis += activeMicros_ / 1000;
+    now.totalMillis += totalMicros_ / 1000;
+    return now;
+  }
+
+  /**
+   * Active share of the time between two snapshots, in hundredths of a
+   * percent (10000 = never slept); 0 if no time passed
+   */
+  static uint16_t dutyBasisPoints(const IdleCounters& since, const IdleCounters& now) {
+    uint32_t active = now.activeMillis - since.activeMillis;
+    uint32_t total = now.totalMillis - since.totalMillis;
+    while (active > 0xFFFFFFFFUL / 10000) {  // Keep active * 10000 in 32 bits
+      active >>= 1;
+      total >>= 1;
+    }
+    if (total == 0) return 0;
+    uint32_t bp = active * 10000 / total;
+    return bp > 10000 ? 10000 : (uint16_t)bp;
+  }
+
+ private:
+  // Microsecond sums are folded into the millisecond totals once a second
+  void account(uint32_t activeMicros, uint32_t sleptMicros) {
+    activeMicros_ += activeMicros;
+    totalMicros_ += activeMicros + sleptMicros;
+    if (totalMicros_ < 1000000UL) return;
+    counters_.activeMillis += activeMicros_ / 1000;
+    activeMicros_ %= 1000;
+    counters_.totalMillis += totalMicros_ / 1000;
+    totalMicros_ %= 1000;
+  }
+
+  IdleCounters counters_;
+  uint32_t awakeSince_;
+  uint32_t activeMicros_;
+  uint32_t totalMicros_;
+};
+
+#endif // IDLE_SLEEP_H
@@ -0,0 +1,98 @@
+/*
+ * Log Levels - Compile-Time Stripping of Serial Text and Event Records
+ *
+ * Every message a sketch prints or logs goes through a level:
+ *
+ *   LogInfo::println(F("Hatching Egg Spider"));
+ *   LogInfo::event(eventLog, EVT_ANIM_START, animIndex);
+ *   LogDebug::event(eventLog, EVT_THRASH, head, eventBytes(left, right));
+ *   if (LogDebug::enabled) frames.logStats(eventLog, EVT_CYCLE_FRAMES);
+ *
+ * Levels above LOG_LEVEL resolve to an empty specialization, so the call,
+ * its argument formatting and its F() string all compile away; nothing
+ * is tested at runtime. LOG_LEVEL defaults to LOG_LEVEL_DEBUG (everything,
+ * what the test and calibration sketches want). A production sketch sets
+ * its own default before including this, and a build can override it:
+ *
+ *   #ifndef LOG_LEVEL
+ *   #define LOG_LEVEL LOG_LEVEL_WARN
+ *   #endif
+ *
+ *   arduino-cli compile --build-property "compiler.cpp.extra_flags=-DLOG_LEVEL=4" ...
+ *
+ * EventLog rings only need their full size when events can be logged:
+ * declare them as EventLog<LOG_EVENT_CAPACITY(32)>.
+ */
+
+#ifndef LOG_LEVEL_H
+#define LOG_LEVEL_H
+
+#include <Arduino.h>
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// Ring size for an EventLog whose events are INFO or DEBUG
+#define LOG_EVENT_CAPACITY(capacity) (LOG_LEVEL >= LOG_LEVEL_INFO ? (capacity) : 2)
+
+constexpr bool logLevelEnabled(uint8_t level) {
+  return level != LOG_LEVEL_NONE && level <= LOG_LEVEL;
+}
+
+template <uint8_t Level, bool Enabled = logLevelEnabled(Level)>
+struct LogStream {
+  static const bool enabled = true;
+
+  template <typename T>
+  static void print(T value) { Serial.print(value); }
+  template <typename T>
+  static void print(T value, int format) { Serial.print(value, format); }
+  static void println() { Serial.println(); }
+  template <typename T>
+  static void println(T value) { Serial.println(value); }
+  template <typename T>
+  static void println(T value, int format) { Serial.println(value, format); }
+
+  template <typename Log>
+  static bool event(Log& log, uint8_t code, uint8_t a = 0, uint16_t b = 0, uint16_t c = 0) {
+    return log.log(code, a, b, c);
+  }
+};
+
+// Above LOG_LEVEL: every call is empty and inlines to nothing
+template <uint8_t Level>
+struct LogStream<Level, false> {
+  static const bool enabled = false;
+
+  template <typename T>
+  static void print(T) {}
+  template <typename T>
+  static void print(T, int) {}
+  static void println() {}
+  template <typename T>
+  static void println(T) {}
+  template <typename T>
+  static void println(T, int) {}
+
+  template <typename Log>
+  static bool event(Log&, uint8_t, uint8_t = 0, uint16_t = 0, uint16_t = 0) { return false; }
+};
+
+template <uint8_t Level, bool Enabled>
+const bool LogStream<Level, Enabled>::enabled;
+template <uint8_t Level>
+const bool LogStream<Level, false>::enabled;
+
+typedef LogStream<LOG_LEVEL_ERROR> LogError;
+typedef LogStream<LOG_LEVEL_WARN> LogWarn;
+typedef LogStream<LOG_LEVEL_INFO> LogInfo;
+typedef LogStream<LOG_LEVEL_DEBUG> LogDebug;
+
+#endif // LOG_LEVEL_H
@@ -0,0 +1,184 @@
+/*
+ * Motion Profile - Speed and Acceleration Limited Servo Motion From Elapsed Time
+ *
+ * "Move 1 degree per loop pass" ties a prop's speed to its loop rate: run
+ * the loop twice as often and everything moves twice as fast. MotionAxis
+ * takes a speed in degrees per second and an acceleration in degrees per
+ * second squared instead, and works out where the servo is from how much
+ * time has passed:
+ *
+ *   const MotionProfile CREEP = motionProfile(25, 50);  // 25 deg/s, 50 deg/s^2
+ *   MotionAxis head(90);
+ *
+ *   void frame() {
+ *     head.update(micros());                  // catch up to now
+ *     if (...) head.moveTo(170, CREEP);
+ *     servoBatch.set(HEAD_CHANNEL, ServoAngleTable::lookupQ8(head.degreesQ8()));
+ *   }
+ *
+ * Motion is integrated on a fixed MOTION_TICK_MICROS grid (the timer0
+ * tick) however often update() is called, so the position at a given time
+ * is the same whether frames come every 5ms, every 20ms or irregularly.
+ * Each tick the axis speeds up, holds or slows down by one acceleration
+ * step, choosing the fastest speed it can still stop from before the
+ * target: a trapezoid (or triangle) velocity profile that never
+ * overshoots a target set from rest. A new target behind a moving axis
+ * decelerates it first, then reverses.
+ *
+ * Positions are Q20 degrees and speeds a whole number of acceleration
+ * steps, so a tick is a few 32-bit adds and compares - no multiply,
+ * divide or float. The stopping distance at full speed, speed^2 / (2 *
+ * accel), must stay under 1000 degrees.
+ */
+
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+#include <Arduino.h>
+
+#define MOTION_TICK_SHIFT 10
+#define MOTION_TICK_MICROS (1UL << MOTION_TICK_SHIFT)  // 1.024ms, as timer0
+#define MOTION_POSITION_SHIFT 20                      // Q20 degrees
+
+struct MotionProfile {
+  int32_t accel;      // Q20 degrees per tick, gained or lost each tick
+  uint16_t maxSteps;  // Top speed in accel steps
+};
+
+constexpr uint32_t motionAtLeastOne(uint64_t value) { return value > 0 ? (uint32_t)value : 1; }
+
+// Q20 degrees gained per tick at `degreesPerSecond2`, rounded
+constexpr int32_t motionAccelQ20(uint32_t degreesPerSecond2) {
+  return motionAtLeastOne((((uint64_t)degreesPerSecond2 * MOTION_TICK_MICROS * MOTION_TICK_MICROS
+                            << MOTION_POSITION_SHIFT) + 500000000000ULL) / 1000000000000ULL);
+}
+
+/**
+ * Profile from degrees per second and degrees per second squared (up to
+ * 1000000), worked out at compile time. The top speed rounds down to a
+ * whole number of acceleration steps.
+ */
+constexpr MotionProfile motionProfile(uint16_t degreesPerSecond, uint32_t degreesPerSecond2) {
+  return MotionProfile{motionAccelQ20(degreesPerSecond2),
+                       (uint16_t)motionAtLeastOne((((uint64_t)degreesPerSecond * MOTION_TICK_MICROS
+                                                    << MOTION_POSITION_SHIFT) / 1000000UL) /
+                                                  motionAccelQ20(degreesPerSecond2))};
+}
+
+class MotionAxis {
+ public:
+  explicit MotionAxis(int16_t degrees = 90) { jumpTo(degrees); }
+
+  /**
+   * Be at `degrees` now, stopped, with nothing left to do (power-up, or a
+   * button that centers the servos)
+   */
+  void jumpTo(int16_t degrees) {
+    position_ = (int32_t)degrees << MOTION_POSITION_SHIFT;
+    target_ = position_;
+    steps_ = 0;
+    speed_ = 0;
+    stopping_ = 0;
+  }
+
+  /**
+   * Head for `degrees` with `profile`, from the current position and
+   * speed. A profile with a lower top speed takes effect at once.
+   */
+  void moveTo(int16_t degrees, const MotionProfile& profile) {
+    target_ = (int32_t)degrees << MOTION_POSITION_SHIFT;
+    if (profile.accel != profile_.accel || profile.maxSteps != profile_.maxSteps) {
+      profile_ = profile;
+      uint32_t steps = speed_ / profile_.accel;  // Same speed in the new steps
+      steps_ = steps > profile_.maxSteps ? profile_.maxSteps : (uint16_t)steps;
+      speed_ = (int32_t)steps_ * profile_.accel;
+      stopping_ = profile_.accel * ((uint32_t)steps_ * (steps_ + 1) / 2);
+    }
+  }
+
+  /**
+   * Advance to `nowMicros` in whole ticks (the remainder carries over to
+   * the next call). The first call only starts the clock. True if the
+   * position changed.
+   */
+  bool update(uint32_t nowMicros) {
+    if (!started_) {
+      lastTick_ = nowMicros;
+      started_ = true;
+      return false;
+    }
+    uint32_t ticks = (nowMicros - lastTick_) >> MOTION_TICK_SHIFT;
+    lastTick_ += ticks << MOTION_TICK_SHIFT;
+    int32_t before = position_;
+    while (ticks-- && step()) {
+    }
+    return position_ != before;
+  }
+
+  /**
+   * Restart the clock from `nowMicros`: time since the last update() is
+   * skipped, not caught up on (after the sketch has been paused)
+   */
+  void restart(uint32_t nowMicros) {
+    lastTick_ = nowMicros;
+    started_ = true;
+  }
+
+  int16_t degrees() const {
+    return (int16_t)((position_ + (1L << (MOTION_POSITION_SHIFT - 1))) >> MOTION_POSITION_SHIFT);
+  }
+  uint16_t degreesQ8() const {  // For ServoPulseTable::lookupQ8()
+    int32_t q8 = (position_ + (1L << (MOTION_POSITION_SHIFT - 9))) >> (MOTION_POSITION_SHIFT - 8);
+    return q8 < 0 ? 0 : (uint16_t)q8;
+  }
+  int16_t target() const { return (int16_t)(target_ >> MOTION_POSITION_SHIFT); }
+  bool moving() const { return steps_ != 0 || position_ != target_; }
+
+  // Q20 degrees, and Q20 degrees per tick (signed), for tests and reports
+  int32_t positionQ20() const { return position_; }
+  int32_t speedQ20() const { return dir_ < 0 ? -speed_ : speed_; }
+
+ private:
+  // One tick; false once at rest on the target
+  bool step() {
+    int32_t remaining = target_ - position_;
+    if (steps_ == 0) {
+      if (remaining == 0) return false;
+      dir_ = remaining > 0 ? 1 : -1;
+    }
+    int32_t ahead = dir_ > 0 ? remaining : -remaining;  // Negative: target is behind
+    int32_t accel = profile_.accel;
+
+    // Fastest speed this tick that can still stop by the target:
+    // stopping_ = accel * steps * (steps + 1) / 2 is this tick's move plus
+    // braking one step per tick after it
+    if (steps_ < profile_.maxSteps && stopping_ + speed_ + accel <= ahead) {
+      steps_++;
+      speed_ += accel;
+      stopping_ += speed_;
+    } else if (steps_ > 0 && stopping_ > ahead) {
+      stopping_ -= speed_;
+      speed_ -= accel;
+      steps_--;
+    }
+
+    if (steps_ == 0) {
+      if (ahead > 0 && ahead < accel) position_ = target_;  // Less than one step short
+      return true;
+    }
+    position_ += dir_ > 0 ? speed_ : -speed_;
+    return true;
+  }
+
+  MotionProfile profile_ = {1, 1};
+  int32_t position_;
+  int32_t target_;
+  int32_t speed_;      // steps_ * accel
+  int32_t stopping_;   // accel * steps_ * (steps_ + 1) / 2
+  uint16_t steps_;
+  int8_t dir_ = 1;
+  bool started_ = false;
+  uint32_t lastTick_ = 0;
+};
+
+#endif // MOTION_PROFILE_H
@@ -0,0 +1,180 @@
+/*
+ * PCA9685 Batched Output - Multi-Channel Writes in Few I2C Transactions
+ *
+ * Adafruit_PWMServoDriver::setPWM() sends one 6-byte transaction per
+ * channel (address, LEDn_ON_L, ON_L, ON_H, OFF_L, OFF_H). Servo pulses
+ * always have ON = 0 and usually only change OFF_L, so most of those bytes
+ * rewrite what the chip already holds.
+ *
+ * PCA9685Batch keeps a shadow copy of the LED registers. Sketches stage
+ * channel values with set() during a frame and call flush() once:
+ *   - only register bytes that differ from the shadow are sent
+ *   - nearby dirty bytes share one transaction via MODE1 auto-increment
+ *     (Adafruit's begin()/setPWMFreq() turn it on)
+ *
+ * A new transaction costs 2 bytes (address + register) plus START/STOP,
+ * about 20 SCL clocks. Re-sending an unchanged byte costs 9. So runs are
+ * merged when at most PCA9685_BATCH_MERGE_GAP clean bytes separate them.
+ *
+ * Channels written any other way (pwm.setPWM(), pwm.reset()) must be
+ * invalidate()d so the next flush rewrites all four of their registers.
+ */
+
+#ifndef PCA9685_BATCH_H
+#define PCA9685_BATCH_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define PCA9685_BATCH_CHANNELS 16
+#define PCA9685_BATCH_LED0_REG 0x06     // LED0_ON_L
+#define PCA9685_BATCH_REGS_PER_CHANNEL 4
+#define PCA9685_BATCH_REG_COUNT (PCA9685_BATCH_CHANNELS * PCA9685_BATCH_REGS_PER_CHANNEL)
+#define PCA9685_BATCH_MERGE_GAP 2       // 2 x 9 clocks < 20 clocks for a new transaction
+
+// Data bytes per transaction: Wire buffer minus the register byte
+#ifdef BUFFER_LENGTH
+#define PCA9685_BATCH_MAX_RUN (BUFFER_LENGTH - 1)
+#else
+#define PCA9685_BATCH_MAX_RUN 31
+#endif
+
+class PCA9685Batch {
+ public:
+  explicit PCA9685Batch(uint8_t address = 0x40, TwoWire& wire = Wire)
+      : address_(address), wire_(&wire) {
+    invalidate();
+  }
+
+  /**
+   * Stage a servo pulse (ON = 0, OFF = `off` ticks) for the next flush()
+   */
+  void set(uint8_t channel, uint16_t off) {
+    if (channel >= PCA9685_BATCH_CHANNELS) return;
+    pending_[channel] = off;
+    staged_ |= (uint16_t)1 << channel;
+  }
+
+  /**
+   * Forget what the chip holds - every channel's next flush sends all
+   * four registers. Call after pwm.begin()/reset().
+   */
+  void invalidate() {
+    known_ = 0;
+    staged_ = 0;
+    memset(regs_, 0, sizeof(regs_));
+  }
+
+  void invalidate(uint8_t channel) {
+    if (channel < PCA9685_BATCH_CHANNELS) known_ &= ~((uint16_t)1 << channel);
+  }
+
+  /**
+   * Send every staged channel. Returns the number of I2C transactions.
+   * A failed transaction leaves its channels staged for the next flush.
+   */
+  uint8_t flush() {
+    lastBytes_ = 0;
+    lastTransactions_ = 0;
+    if (!staged_) return 0;
+
+    // Merge staged values into the shadow, marking bytes that change
+    uint8_t dirty[PCA9685_BATCH_REG_COUNT / 8];
+    memset(dirty, 0, sizeof(dirty));
+    for (uint8_t ch = 0; ch < PCA9685_BATCH_CHANNELS; ch++) {
+      uint16_t bit = (uint16_t)1 << ch;
+      if (!(staged_ & bit)) continue;
+      uint8_t values[PCA9685_BATCH_REGS_PER_CHANNEL] = {
+          0, 0, (uint8_t)pending_[ch], (uint8_t)(pending_[ch] >> 8)};
+      uint8_t base = ch * PCA9685_BATCH_REGS_PER_CHANNEL;
+      for (uint8_t i = 0; i < PCA9685_BATCH_REGS_PER_CHANNEL; i++) {
+        if (!(known_ & bit) || regs_[base + i] != values[i]) {
+          regs_[base + i] = values[i];
+          dirty[(base + i) >> 3] |= 1 << ((base + i) & 7);
+        }
+      }
+      known_ |= bit;
+    }
+    uint16_t sent = staged_;
+    staged_ = 0;
+
+    // Cover the dirty bytes with runs, bridging small gaps of known bytes
+    uint8_t reg = 0;
+    while (reg < PCA9685_BATCH_REG_COUNT) {
+      if (!isDirty(dirty, reg)) {
+        reg++;
+        continue;
+      }
+      uint8_t start = reg;
+      uint8_t end = reg;
+      for (uint8_t next = end + 1; next < PCA9685_BATCH_REG_COUNT; next++) {
+        if (next - start >= PCA9685_BATCH_MAX_RUN) break;
+        if (isDirty(dirty, next)) {
+          end = next;
+        } else if (next - end > PCA9685_BATCH_MERGE_GAP || !isKnown(next)) {
+          break;
+        }
+      }
+      // A full run mustn't end inside a channel with more to send: the chip
+      // would output the half-written pulse until the next transaction
+      uint8_t channelStart = end - end % PCA9685_BATCH_REGS_PER_CHANNEL;
+      if (channelStart > start && end + 1 < channelStart + PCA9685_BATCH_REGS_PER_CHANNEL) {
+        bool splits = false;
+        for (uint8_t r = end + 1; r < channelStart + PCA9685_BATCH_REGS_PER_CHANNEL; r++) {
+          splits |= isDirty(dirty, r);
+        }
+        if (splits) {
+          end = channelStart - 1;
+          while (!isDirty(dirty, end)) end--;  // `start` is dirty
+        }
+      }
+      if (!writeRun(start, end)) {
+        // Chip state unknown for these channels; resend them next flush
+        for (uint8_t ch = start / PCA9685_BATCH_REGS_PER_CHANNEL;
+             ch <= end / PCA9685_BATCH_REGS_PER_CHANNEL; ch++) {
+          uint16_t bit = (uint16_t)1 << ch;
+          known_ &= ~bit;
+          staged_ |= (sent & bit);
+        }
+        errors_++;
+      }
+      reg = end + 1;
+    }
+    return lastTransactions_;
+  }
+
+  // Last flush(): bytes on the wire (address + register + data) and transactions
+  uint8_t lastBytes() const { return lastBytes_; }
+  uint8_t lastTransactions() const { return lastTransactions_; }
+  uint16_t errors() const { return errors_; }
+
+ private:
+  static bool isDirty(const uint8_t* dirty, uint8_t reg) {
+    return dirty[reg >> 3] & (1 << (reg & 7));
+  }
+
+  bool isKnown(uint8_t reg) const {
+    return known_ & ((uint16_t)1 << (reg / PCA9685_BATCH_REGS_PER_CHANNEL));
+  }
+
+  bool writeRun(uint8_t start, uint8_t end) {
+    wire_->beginTransmission(address_);
+    wire_->write((uint8_t)(PCA9685_BATCH_LED0_REG + start));
+    wire_->write(&regs_[start], end - start + 1);
+    lastBytes_ += end - start + 3;
+    lastTransactions_++;
+    return wire_->endTransmission() == 0;
+  }
+
+  uint8_t address_;
+  TwoWire* wire_;
+  uint8_t regs_[PCA9685_BATCH_REG_COUNT];  // Shadow of LED0_ON_L..LED15_OFF_H
+  uint16_t pending_[PCA9685_BATCH_CHANNELS];
+  uint16_t known_;   // Channels whose shadow matches the chip
+  uint16_t staged_;  // Channels waiting for flush()
+  uint8_t lastBytes_ = 0;
+  uint8_t lastTransactions_ = 0;
+  uint16_t errors_ = 0;
+};
+
+#endif // PCA9685_BATCH_H
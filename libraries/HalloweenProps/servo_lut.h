@@ -0,0 +1,134 @@
+/*
+ * Servo Pulse Lookup Tables - Degrees to PCA9685 Ticks at Compile Time
+ *
+ * Every sketch turns an angle into a pulse with constrain() + map(), and
+ * map() is a 32-bit multiply and divide (a library call on AVR). Servo
+ * calibration is fixed at compile time, so the whole curve can be too:
+ *
+ *   typedef ServoPulseTable<150, 330> RightElbowTable;   // 0-90 deg
+ *   servoBatch.set(channel, RightElbowTable::lookup(degrees));
+ *
+ * Each entry is exactly what map(degrees, 0, MaxDegrees, MinPulse, MaxPulse)
+ * returns, so swapping a table in does not change a single output value.
+ * Inverted ranges (MinPulse > MaxPulse, for mirrored servos) work the same.
+ *
+ * If the calibration is in microseconds rather than ticks, pass the PWM
+ * period as PeriodMicros and the table also folds in the microseconds ->
+ * 12-bit tick conversion (pulse * 4096 / period, truncated).
+ *
+ * lookupQ8() takes a Q8 angle (256 = 1 degree) and interpolates between
+ * the two neighbouring entries, so a joint whose range has more ticks than
+ * degrees can use all of them instead of stepping once per degree.
+ *
+ * The table is (MaxDegrees + 1) * 2 bytes of PROGMEM per calibration:
+ * 182 bytes for 0-90, 362 bytes for 0-180. servoLutLookup() and
+ * servoLutLookupQ8() do the same lookups on a table picked at run time
+ * (a ServoCalibration; servo_output.h keeps one per channel).
+ */
+
+#ifndef SERVO_LUT_H
+#define SERVO_LUT_H
+
+#include <Arduino.h>
+
+#define SERVO_LUT_TICKS 4096  // PCA9685 counter steps per PWM period
+
+/**
+ * map(degrees, 0, maxDegrees, minPulse, maxPulse) with Arduino's long math,
+ * optionally converted from microseconds to ticks (periodMicros != 0)
+ */
+constexpr long servoLutPulse(long degrees, long minPulse, long maxPulse, long maxDegrees) {
+  return degrees * (maxPulse - minPulse) / maxDegrees + minPulse;
+}
+
+constexpr uint16_t servoLutEntry(long degrees, long minPulse, long maxPulse, long maxDegrees,
+                                 long periodMicros) {
+  return (uint16_t)(periodMicros
+      ? servoLutPulse(degrees, minPulse, maxPulse, maxDegrees) * SERVO_LUT_TICKS / periodMicros
+      : servoLutPulse(degrees, minPulse, maxPulse, maxDegrees));
+}
+
+/**
+ * Microseconds to 12-bit ticks at `periodMicros`, truncated (the same
+ * conversion the tables fold in)
+ */
+constexpr uint16_t servoMicrosToTicks(long pulseMicros, long periodMicros) {
+  return (uint16_t)(pulseMicros * SERVO_LUT_TICKS / periodMicros);
+}
+
+/**
+ * Pulse for an angle from a PROGMEM table of maxDegrees + 1 entries,
+ * clamped to 0-maxDegrees like constrain()
+ */
+inline uint16_t servoLutLookup(const uint16_t* table, uint8_t maxDegrees, int degrees) {
+  if (degrees < 0) degrees = 0;
+  if (degrees > maxDegrees) degrees = maxDegrees;
+  return pgm_read_word(&table[degrees]);
+}
+
+/**
+ * Pulse for a Q8 angle (degrees * 256), clamped to 0-maxDegrees and
+ * interpolated between whole-degree entries (rounded to nearest tick)
+ */
+inline uint16_t servoLutLookupQ8(const uint16_t* table, uint8_t maxDegrees, uint16_t degreesQ8) {
+  uint16_t whole = degreesQ8 >> 8;
+  if (whole >= maxDegrees) return pgm_read_word(&table[maxDegrees]);
+  uint8_t frac = degreesQ8 & 0xFF;
+  uint16_t lo = pgm_read_word(&table[whole]);
+  if (!frac) return lo;
+  int16_t step = (int16_t)(pgm_read_word(&table[whole + 1]) - lo) * frac;
+  return lo + ((step + 128) >> 8);
+}
+
+/**
+ * A table picked at run time: its PROGMEM entries and the angle at the
+ * last one. SERVO_CALIBRATION(Table) makes one from a ServoPulseTable.
+ */
+struct ServoCalibration {
+  const uint16_t* table;
+  uint8_t maxDegrees;
+};
+
+#define SERVO_CALIBRATION(Table) ServoCalibration{Table::values, Table::MAX_DEGREES}
+
+// 0, 1, ..., N-1 as a parameter pack (std::make_index_sequence is C++14
+// and avr-gcc has no <utility> anyway)
+template <uint16_t... I> struct ServoLutIndices {};
+template <uint16_t N, uint16_t... I>
+struct ServoLutMakeIndices : ServoLutMakeIndices<N - 1, N - 1, I...> {};
+template <uint16_t... I>
+struct ServoLutMakeIndices<0, I...> { typedef ServoLutIndices<I...> type; };
+
+template <int MinPulse, int MaxPulse, int MaxDegrees = 90, long PeriodMicros = 0,
+          typename Indices = typename ServoLutMakeIndices<MaxDegrees + 1>::type>
+struct ServoPulseTable;
+
+template <int MinPulse, int MaxPulse, int MaxDegrees, long PeriodMicros, uint16_t... I>
+struct ServoPulseTable<MinPulse, MaxPulse, MaxDegrees, PeriodMicros, ServoLutIndices<I...> > {
+  static_assert(MaxDegrees > 0 && MaxDegrees < 256, "table covers 1-255 degrees");
+
+  static const uint8_t MAX_DEGREES = MaxDegrees;
+  static const uint16_t values[MaxDegrees + 1];
+
+  /**
+   * Pulse for an angle, clamped to 0-MaxDegrees like constrain()
+   */
+  static uint16_t lookup(int degrees) {
+    return servoLutLookup(values, MaxDegrees, degrees);
+  }
+
+  /**
+   * Pulse for a Q8 angle (degrees * 256), clamped to 0-MaxDegrees and
+   * interpolated between whole-degree entries (rounded to nearest tick)
+   */
+  static uint16_t lookupQ8(uint16_t degreesQ8) {
+    return servoLutLookupQ8(values, MaxDegrees, degreesQ8);
+  }
+};
+
+template <int MinPulse, int MaxPulse, int MaxDegrees, long PeriodMicros, uint16_t... I>
+const uint16_t ServoPulseTable<MinPulse, MaxPulse, MaxDegrees, PeriodMicros,
+                               ServoLutIndices<I...> >::values[MaxDegrees + 1] PROGMEM = {
+    servoLutEntry(I, MinPulse, MaxPulse, MaxDegrees, PeriodMicros)...};
+
+#endif // SERVO_LUT_H
@@ -0,0 +1,415 @@
+/*
+ * Servo Output - Calibrated, Cached, Batched PCA9685 Servo Writes
+ *
+ * The path from "servo N to this angle" to the chip, once for every
+ * sketch: each servo is a PCA9685 channel with a ServoPulseTable
+ * calibration (servo_lut.h), so every write is clamped and rounded the
+ * same way and nothing outside the calibrated pulse range reaches the
+ * chip:
+ *
+ *   typedef ServoPulseTable<150, 330> RightElbowTable;   // 0-90 deg
+ *   PCA9685Batch servoBatch(0x40);
+ *   ServoOutput<4> servos(servoBatch);
+ *
+ *   servos.attach(0, RIGHT_ELBOW_CHANNEL, SERVO_CALIBRATION(RightElbowTable));
+ *
+ *   servos.writeQ8(0, pose[0]);   // Q8 degrees through the table
+ *   servos.writeTicks(1, ticks);  // Already ticks, clamped to the table's ends
+ *   servos.flush();               // Once per frame
+ *
+ * - Write cache: a write that matches the servo's current target is
+ *   dropped before it reaches the batch, so sketches don't keep their own
+ *   "last value" per servo
+ * - Batched flush: changed servos are staged in the PCA9685Batch and sent
+ *   together, only the register bytes that changed
+ * - Slew limit (optional, per servo): flush() moves a servo at most that
+ *   many ticks toward its target, so a big jump becomes a ramp over a few
+ *   frames. The first write after attach(), off() or invalidate() always
+ *   goes straight to its target, as nothing is known about where the horn is
+ *
+ * Several boards: give it an array of batches (one per PCA9685 address)
+ * and attach each servo to a board index; flush() sends every board:
+ *
+ *   PCA9685Batch boards[2] = {PCA9685Batch(0x40), PCA9685Batch(0x41)};
+ *   ServoOutput<32, 2> servos(boards);
+ *   servos.attach(20, 1, 4, calibration);   // Servo 20 is 0x41 channel 4
+ *
+ * Bus budget (i2c_bus.h): flush(bus) records what it sends in an I2CBus
+ * and holds low-priority servos for a later frame once the frame's bus
+ * time is spent, instead of stretching the frame:
+ *
+ *   servos.setLowPriority(1);     // Elbows can lag a frame; shoulders can't
+ *   servos.flush(bus);
+ *
+ * Power budget (servo_power.h): with a current model per servo and a
+ * ServoPower, every flush keeps the estimated supply current under the
+ * budget, slowing or holding servos that would take it over. A first
+ * write jumps straight to its target, so it is costed flat out and waits
+ * for a frame with room for all of it:
+ *
+ *   servos.setCurrentModel(0, HS755MG, SERVO_FREQ);
+ *   servos.setPower(power);
+ *
+ * Channels written around ServoOutput (pwm.setPWM()) must be invalidate()d.
+ */
+
+#ifndef SERVO_OUTPUT_H
+#define SERVO_OUTPUT_H
+
+#include <Arduino.h>
+#include <pca9685_batch.h>
+#include <servo_lut.h>
+#include <i2c_bus.h>
+#include <servo_power.h>
+
+#define SERVO_OUTPUT_UNKNOWN 0xFFFF  // No write since attach/off/invalidate
+#define SERVO_OUTPUT_WRITE_MAX_BYTES 6  // One servo alone: address, register, ON and OFF
+#define SERVO_OUTPUT_NO_LIMIT 0xFFFF    // Step straight to the target
+
+template <uint8_t Servos, uint8_t Boards = 1>
+class ServoOutput {
+  static_assert(Boards > 0 && Servos > 0 && Servos <= PCA9685_BATCH_CHANNELS * Boards,
+                "1-16 servos per PCA9685");
+
+ public:
+  explicit ServoOutput(PCA9685Batch& batch) : batches_(&batch) {
+    static_assert(Boards == 1, "pass an array of batches for several boards");
+  }
+  explicit ServoOutput(PCA9685Batch* batches) : batches_(batches) {}
+
+  /**
+   * Servo `servo` is `channel` on the (first) PCA9685, calibrated by
+   * `calibration`. `slew` is the most ticks it moves per flush() (0: no limit).
+   */
+  void attach(uint8_t servo, uint8_t channel, ServoCalibration calibration, uint8_t slew = 0) {
+    attach(servo, 0, channel, calibration, slew);
+  }
+
+  /**
+   * Same, on board `board` (index into the batches array)
+   */
+  void attach(uint8_t servo, uint8_t board, uint8_t channel, ServoCalibration calibration,
+              uint8_t slew = 0) {
+    if (servo >= Servos || board >= Boards) return;
+    Servo& s = servos_[servo];
+    s.table = calibration.table;
+    s.maxDegrees = calibration.maxDegrees;
+    s.board = board;
+    s.channel = channel;
+    uint16_t first = pgm_read_word(&calibration.table[0]);
+    uint16_t last = pgm_read_word(&calibration.table[calibration.maxDegrees]);
+    s.lo = first < last ? first : last;
+    s.hi = first < last ? last : first;
+    s.slew = slew;
+    s.fullSpeedTicks = 0;
+    s.milliampsPerTick = 0;
+    s.idleMilliamps = 0;
+    sumIdle();
+    forget(servo);
+  }
+
+  void setSlew(uint8_t servo, uint8_t slew) {
+    if (servo < Servos) servos_[servo].slew = slew;
+  }
+
+  /**
+   * Estimate this servo's current from `model` (servo_power.h), at
+   * `framesPerSecond` flushes a second, after attach() (which clears it).
+   * Servos without a model are neither counted nor slowed.
+   */
+  void setCurrentModel(uint8_t servo, const ServoCurrentModel& model, uint8_t framesPerSecond) {
+    if (servo >= Servos || !framesPerSecond) return;
+    Servo& s = servos_[servo];
+    uint32_t ticks = (uint32_t)model.degreesPerSecond * (s.hi - s.lo) /
+                     ((uint32_t)s.maxDegrees * framesPerSecond);
+    s.fullSpeedTicks = ticks < 1 ? 1 : ticks > 0xFF ? 0xFF : (uint8_t)ticks;
+    uint16_t moving = model.fullSpeedMilliamps > model.idleMilliamps
+                          ? model.fullSpeedMilliamps - model.idleMilliamps : 0;
+    s.milliampsPerTick = (moving + s.fullSpeedTicks - 1) / s.fullSpeedTicks;
+    s.idleMilliamps = model.idleMilliamps;
+    sumIdle();
+  }
+
+  /**
+   * Keep every flush() within `power`'s budget, and record its estimates there
+   */
+  void setPower(ServoPower& power) {
+    power_ = &power;
+  }
+
+  /**
+   * A low-priority servo is the first to wait when flush(bus) runs out of
+   * bus time
+   */
+  void setLowPriority(uint8_t servo, bool low = true) {
+    if (servo >= Servos) return;
+    if (low) {
+      lowPriority_[servo >> 3] |= 1 << (servo & 7);
+    } else {
+      lowPriority_[servo >> 3] &= ~(1 << (servo & 7));
+    }
+  }
+
+  /**
+   * Whole degrees, clamped to the calibration's 0-maxDegrees. Returns
+   * false if the servo was already headed there (nothing staged).
+   */
+  bool write(uint8_t servo, int degrees) {
+    if (servo >= Servos) return false;
+    const Servo& s = servos_[servo];
+    return stage(servo, servoLutLookup(s.table, s.maxDegrees, degrees));
+  }
+
+  /**
+   * Q8 degrees (256 = 1 degree), interpolated between table entries
+   */
+  bool writeQ8(uint8_t servo, uint16_t degreesQ8) {
+    if (servo >= Servos) return false;
+    const Servo& s = servos_[servo];
+    return stage(servo, servoLutLookupQ8(s.table, s.maxDegrees, degreesQ8));
+  }
+
+  /**
+   * PCA9685 ticks (baked frames, calibration tools), clamped to the
+   * calibrated range
+   */
+  bool writeTicks(uint8_t servo, uint16_t ticks) {
+    if (servo >= Servos) return false;
+    const Servo& s = servos_[servo];
+    if (ticks < s.lo) ticks = s.lo;
+    if (ticks > s.hi) ticks = s.hi;
+    return stage(servo, ticks);
+  }
+
+  /**
+   * No pulse (the servo stops holding) from the next flush() on
+   */
+  void off(uint8_t servo) {
+    if (servo >= Servos) return;
+    batch(servo).set(servos_[servo].channel, 0);
+    forget(servo);
+  }
+
+  /**
+   * The channel was written some other way: resend it in full next time
+   */
+  void invalidate(uint8_t servo) {
+    if (servo >= Servos) return;
+    batch(servo).invalidate(servos_[servo].channel);
+    forget(servo);
+  }
+
+  /**
+   * Step slewing servos, stage every changed servo and send them, board by
+   * board. Returns the number of I2C transactions (PCA9685Batch::flush()).
+   */
+  uint8_t flush() {
+    PowerFrame power;
+    openBudget(power);
+    stepDirty(power, true);
+    closeBudget(power);
+    return send(nullptr);
+  }
+
+  /**
+   * flush(), counted in `bus` and kept to its per-frame budget. Each
+   * changed servo is costed as a lone write (SERVO_OUTPUT_WRITE_MAX_BYTES,
+   * an upper bound: runs only merge). If they all fit, it's one flush().
+   * Otherwise every other servo goes out first, then low-priority servos
+   * while the budget has room; the rest keep their target for a later
+   * frame and are counted as deferred. The first low-priority servo offered
+   * moves round each time, so a tight budget doesn't always starve the
+   * same one. Other servos are never held back, so a frame can still run
+   * over (counted by the bus). Deferred servos take no share of the power
+   * budget.
+   */
+  uint8_t flush(I2CBus& bus) {
+    PowerFrame power;
+    openBudget(power);
+    const uint32_t cost = I2C_BUS_TRANSACTION_CLOCKS((uint32_t)SERVO_OUTPUT_WRITE_MAX_BYTES);
+    uint8_t changed = 0;
+    bool lowPending = false;
+    for (uint8_t i = 0; i < Servos; i++) {
+      if (!isDirty(i)) continue;
+      changed++;
+      lowPending |= isLowPriority(i);
+    }
+    if (!lowPending || changed * cost <= bus.remainingClocks()) {
+      stepDirty(power, true);
+      closeBudget(power);
+      return send(&bus);
+    }
+
+    stepDirty(power, false);
+    uint8_t transactions = send(&bus);
+    uint32_t room = bus.remainingClocks();
+    uint8_t i = lowNext_;
+    for (uint8_t n = 0; n < Servos; n++, i = i + 1 < Servos ? i + 1 : 0) {
+      if (!isDirty(i) || !isLowPriority(i)) continue;
+      if (room < cost) {
+        bus.defer();
+        continue;
+      }
+      if (step(i, limit(i, power))) room -= cost;
+    }
+    lowNext_ = lowNext_ + 1 < Servos ? lowNext_ + 1 : 0;
+    closeBudget(power);
+    return transactions + send(&bus);
+  }
+
+  // Pulse last staged, and where it's headed (SERVO_OUTPUT_UNKNOWN before
+  // the first write; ticks() until that write goes out)
+  uint16_t ticks(uint8_t servo) const { return servos_[servo].ticks; }
+  uint16_t target(uint8_t servo) const { return servos_[servo].target; }
+  uint8_t board(uint8_t servo) const { return servos_[servo].board; }
+  uint8_t channel(uint8_t servo) const { return servos_[servo].channel; }
+
+  bool settled() const {
+    for (uint8_t i = 0; i < sizeof(dirty_); i++) {
+      if (dirty_[i]) return false;
+    }
+    return true;
+  }
+
+ private:
+  struct Servo {
+    const uint16_t* table;  // PROGMEM
+    uint8_t maxDegrees;
+    uint8_t board;
+    uint8_t channel;
+    uint16_t lo, hi;  // Calibrated tick range
+    uint16_t target;
+    uint16_t ticks;   // Last staged, SERVO_OUTPUT_UNKNOWN until the first write goes out
+    uint8_t slew;     // Ticks per flush, 0 = no limit
+    uint8_t fullSpeedTicks;     // Ticks per flush at top speed, 0 = no current model
+    uint16_t milliampsPerTick;  // Current above idle per tick moved in a flush
+    uint16_t idleMilliamps;     // Holding still
+  };
+
+  // Stage the servo's next pulse: its target, or `limit` ticks toward it.
+  // A limit of 0 holds it where it is (false: nothing staged).
+  bool step(uint8_t servo, uint16_t limit) {
+    Servo& s = servos_[servo];
+    if (!limit) return false;
+    if (s.ticks == SERVO_OUTPUT_UNKNOWN) s.ticks = s.target;  // Nothing to ramp from
+    if (s.target > s.ticks + limit) {
+      s.ticks += limit;
+    } else if (s.ticks > s.target + limit) {
+      s.ticks -= limit;
+    } else {
+      s.ticks = s.target;
+      clearDirty(servo);
+    }
+    batch(servo).set(s.channel, s.ticks);
+    return true;
+  }
+
+  // A flush's share of the power budget, handed out servo by servo
+  struct PowerFrame {
+    uint32_t room;         // Current left above idle
+    uint32_t demand;       // What the servos stepped would draw at their own pace
+    uint32_t drawn;        // What they were allowed
+    uint8_t shortChanged;  // First servo cut short (Servos: none)
+  };
+
+  void openBudget(PowerFrame& frame) const {
+    uint16_t budget = power_ ? power_->budgetMilliamps() : 0;
+    frame.room = budget > idleMilliamps_ ? budget - idleMilliamps_ : 0;
+    frame.demand = 0;
+    frame.drawn = 0;
+    frame.shortChanged = Servos;
+  }
+
+  // Record the frame; whoever was cut short is served first next time
+  void closeBudget(const PowerFrame& frame) {
+    if (!power_) return;
+    if (frame.shortChanged < Servos) powerNext_ = frame.shortChanged;
+    power_->record(clamp16(idleMilliamps_ + frame.drawn), clamp16(idleMilliamps_ + frame.demand));
+  }
+
+  // Step every changed servo (or only those that aren't low priority), in
+  // power budget order
+  void stepDirty(PowerFrame& frame, bool lowPriorityToo) {
+    uint8_t i = powerNext_;
+    for (uint8_t n = 0; n < Servos; n++, i = i + 1 < Servos ? i + 1 : 0) {
+      if (isDirty(i) && (lowPriorityToo || !isLowPriority(i))) step(i, limit(i, frame));
+    }
+  }
+
+  // The servo's step limit for this flush: its slew, and under a power
+  // budget its top speed and what's left of the current, taken from
+  // `frame`. A first write is all or nothing: it jumps, so it costs a
+  // full-speed move, and waits (0) until that fits.
+  uint16_t limit(uint8_t servo, PowerFrame& frame) {
+    const Servo& s = servos_[servo];
+    uint16_t limit = s.slew ? s.slew : SERVO_OUTPUT_NO_LIMIT;
+    if (!power_ || !s.fullSpeedTicks) return limit;
+
+    bool first = s.ticks == SERVO_OUTPUT_UNKNOWN;
+    uint16_t distance = first ? 0 : s.target > s.ticks ? s.target - s.ticks : s.ticks - s.target;
+    if (!first && !distance) return limit;  // Back where it is: nothing moves
+    uint16_t want = first ? s.fullSpeedTicks : distance < limit ? distance : limit;
+    if (want > s.fullSpeedTicks) want = s.fullSpeedTicks;
+    uint32_t cost = (uint32_t)want * s.milliampsPerTick;
+    frame.demand += cost;
+    if (cost > frame.room) {
+      want = first || !s.milliampsPerTick ? 0 : frame.room / s.milliampsPerTick;
+      cost = (uint32_t)want * s.milliampsPerTick;
+      if (frame.shortChanged == Servos) frame.shortChanged = servo;
+    }
+    frame.room -= cost;
+    frame.drawn += cost;
+    return first && want ? SERVO_OUTPUT_NO_LIMIT : want;
+  }
+
+  // Every modelled servo holding still, set aside before any moves
+  void sumIdle() {
+    uint32_t idle = 0;
+    for (uint8_t i = 0; i < Servos; i++) idle += servos_[i].idleMilliamps;
+    idleMilliamps_ = clamp16(idle);
+  }
+
+  static uint16_t clamp16(uint32_t value) {
+    return value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+  }
+
+  // Flush every board; counted in `bus` if there is one
+  uint8_t send(I2CBus* bus) {
+    uint8_t transactions = 0;
+    for (uint8_t b = 0; b < Boards; b++) {
+      transactions += batches_[b].flush();
+      if (bus) bus->record(batches_[b].lastBytes(), batches_[b].lastTransactions());
+    }
+    return transactions;
+  }
+
+  bool stage(uint8_t servo, uint16_t ticks) {
+    Servo& s = servos_[servo];
+    if (ticks == s.target) return false;
+    s.target = ticks;
+    dirty_[servo >> 3] |= 1 << (servo & 7);
+    return true;
+  }
+
+  void forget(uint8_t servo) {
+    servos_[servo].target = SERVO_OUTPUT_UNKNOWN;
+    servos_[servo].ticks = SERVO_OUTPUT_UNKNOWN;
+    clearDirty(servo);
+  }
+
+  bool isDirty(uint8_t servo) const { return dirty_[servo >> 3] & (1 << (servo & 7)); }
+  bool isLowPriority(uint8_t servo) const { return lowPriority_[servo >> 3] & (1 << (servo & 7)); }
+  void clearDirty(uint8_t servo) { dirty_[servo >> 3] &= ~(1 << (servo & 7)); }
+  PCA9685Batch& batch(uint8_t servo) { return batches_[servos_[servo].board]; }
+
+  PCA9685Batch* batches_;
+  Servo servos_[Servos] = {};
+  uint8_t dirty_[(Servos + 7) / 8] = {};  // Servos to stage (and step) at the next flush()
+  uint8_t lowPriority_[(Servos + 7) / 8] = {};
+  uint8_t lowNext_ = 0;  // Low-priority servo flush(bus) offers room to first
+  ServoPower* power_ = nullptr;
+  uint16_t idleMilliamps_ = 0;  // Sum of the servos' idleMilliamps
+  uint8_t powerNext_ = 0;       // Servo served first from the power budget (last cut short)
+};
+
+#endif // SERVO_OUTPUT_H
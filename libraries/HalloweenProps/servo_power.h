@@ -0,0 +1,135 @@
+/*
+ * Servo Power - Estimated Servo Current Against a Supply Budget
+ *
+ * Servos started together draw together: three HS-755MGs thrown across
+ * their range at the same moment can pull more than a 5 A supply gives,
+ * the rail sags and the Beetle browns out mid-show. ServoOutput can keep
+ * an estimate of the total and move servos no faster than the budget
+ * allows:
+ *
+ *   const ServoCurrentModel HS755MG = {30, 1600, 280};  // mA idle, mA flat out, deg/s
+ *   ServoPower power(4500);                              // mA for every servo together
+ *
+ *   servos.setCurrentModel(0, HS755MG, SERVO_FREQ);      // Per servo, after attach()
+ *   servos.setPower(power);
+ *   servos.flush();                                      // Moves within the budget
+ *
+ * The model is linear in commanded speed: a servo holding still draws its
+ * idle current, one turning at its top speed draws fullSpeedMilliamps, and
+ * in between in proportion. Top speed in degrees per second becomes ticks
+ * per frame through the servo's calibration, and under a budget no servo
+ * is sent further than that in one frame - a jump becomes a ramp at the
+ * servo's own speed, which is all the horn could do anyway, and the
+ * estimate covers the whole move instead of its first frame. A first write
+ * (nothing known about where the horn is) counts as a frame flat out.
+ *
+ * Each flush the idle current of every modelled servo is set aside, then
+ * moving servos take what's left in turn: a servo whose full step fits
+ * gets it, the one that doesn't fit gets the ticks that do (rate limited)
+ * and any after it wait a frame (staggered). The first servo cut short is
+ * served first next flush, so no servo is always the one held back.
+ *
+ * ServoPower keeps per-frame stats - average and peak estimated current,
+ * the peak asked for before the budget, frames where the budget bit -
+ * for serial (printStats()) or the event log (logStats()).
+ *
+ * These are estimates from datasheet-style numbers, not measurements: set
+ * fullSpeedMilliamps between the servo's running and stall current (a
+ * reversal under load is close to stall), and leave the budget some room
+ * below the supply's rating for the Beetle and the PCA9685.
+ */
+
+#ifndef SERVO_POWER_H
+#define SERVO_POWER_H
+
+#include <Arduino.h>
+#include "event_log.h"
+
+struct ServoCurrentModel {
+  uint16_t idleMilliamps;       // Holding position
+  uint16_t fullSpeedMilliamps;  // Turning at top speed under load
+  uint16_t degreesPerSecond;    // Top speed at the supply voltage
+};
+
+struct ServoPowerStats {
+  uint32_t frames;               // Flushes estimated
+  uint32_t milliampFrames;       // Sum of every frame's estimate
+  uint16_t peakMilliamps;
+  uint16_t peakDemandMilliamps;  // Largest a frame asked for before the budget
+  uint16_t limitedFrames;        // Frames a servo was slowed or held (saturating)
+};
+
+class ServoPower {
+ public:
+  explicit ServoPower(uint16_t budgetMilliamps) : budgetMilliamps_(budgetMilliamps) {
+    resetStats();
+  }
+
+  /**
+   * One frame's estimate (ServoOutput::flush()): what the servos draw
+   * after scheduling, and what they asked for
+   */
+  void record(uint16_t milliamps, uint16_t demandMilliamps) {
+    lastMilliamps_ = milliamps;
+    lastDemandMilliamps_ = demandMilliamps;
+    stats_.frames++;
+    stats_.milliampFrames += milliamps;
+    if (milliamps > stats_.peakMilliamps) stats_.peakMilliamps = milliamps;
+    if (demandMilliamps > stats_.peakDemandMilliamps) stats_.peakDemandMilliamps = demandMilliamps;
+    if (demandMilliamps > milliamps && stats_.limitedFrames != 0xFFFF) stats_.limitedFrames++;
+  }
+
+  uint16_t budgetMilliamps() const { return budgetMilliamps_; }
+
+  // The last frame recorded
+  uint16_t lastMilliamps() const { return lastMilliamps_; }
+  uint16_t lastDemandMilliamps() const { return lastDemandMilliamps_; }
+
+  uint16_t averageMilliamps() const {
+    return stats_.frames ? (uint16_t)(stats_.milliampFrames / stats_.frames) : 0;
+  }
+
+  const ServoPowerStats& stats() const { return stats_; }
+
+  void resetStats() {
+    memset(&stats_, 0, sizeof(stats_));
+  }
+
+  /**
+   * Servo current: 1500 frames  avg 310 mA  peak 4460 mA of 4500 (asked 4910)  12 limited
+   */
+  template <typename Out>
+  void printStats(Out& out) const {
+    out.print(F("Servo current: "));
+    out.print(stats_.frames);
+    out.print(F(" frames  avg "));
+    out.print(averageMilliamps());
+    out.print(F(" mA  peak "));
+    out.print(stats_.peakMilliamps);
+    out.print(F(" mA of "));
+    out.print(budgetMilliamps_);
+    out.print(F(" (asked "));
+    out.print(stats_.peakDemandMilliamps);
+    out.print(F(")  "));
+    out.print(stats_.limitedFrames);
+    out.println(F(" limited"));
+  }
+
+  /**
+   * printStats() as event records: `headerCode` (average mA, peak mA), then
+   * EVT_POWER_LIMITED (frames limited, peak asked)
+   */
+  template <typename Log>
+  void logStats(Log& log, uint8_t headerCode) const {
+    log.log(headerCode, 0, averageMilliamps(), stats_.peakMilliamps);
+    log.log(EVT_POWER_LIMITED, 0, stats_.limitedFrames, stats_.peakDemandMilliamps);
+  }
+
+ private:
+  uint16_t budgetMilliamps_;
+  uint16_t lastMilliamps_ = 0;
+  uint16_t lastDemandMilliamps_ = 0;
+  ServoPowerStats stats_;
+};
+
+#endif // SERVO_POWER_H
@@ -0,0 +1,220 @@
+/*
+ * Unit Tests for Edge Capture
+ *
+ * Drives a pin through the host sim's pin change interrupt: every edge must
+ * be queued with its ISR timestamp, bounce inside the lockout must be
+ * ignored, and presses shorter than a loop pass (or the lockout) must
+ * still come out of poll() as a press and a release.
+ * Uses Google Test framework.
+ *
+ * Build and run (from hatching_egg/):
+ *   pixi run test-edge-capture
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include "Arduino.h"
+#include "edge_capture.h"
+
+#define TEST_PIN 9           // PB5 / PCINT5 on the 32U4
+#define LOCKOUT_MICROS 20000
+
+std::unique_ptr<PinEdgeCapture<8>> capture;  // Fresh for every test
+
+ISR(PCINT0_vect) {
+  if (capture) capture->onPinChange();
+}
+
+class EdgeCaptureTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::reset();
+    sim::advanceMicros(1000000);
+    capture.reset(new PinEdgeCapture<8>(LOCKOUT_MICROS));
+    ASSERT_TRUE(capture->begin(TEST_PIN));
+  }
+
+  // Everything poll() has right now
+  std::vector<PinEdge> pollAll() {
+    std::vector<PinEdge> events;
+    PinEdge edge;
+    while (capture->poll(edge)) events.push_back(edge);
+    return events;
+  }
+};
+
+// Queue Tests
+TEST(EdgeQueue, PopsInOrder) {
+  EdgeQueue<4> queue;
+  queue.push(10, LOW);
+  queue.push(20, HIGH);
+  PinEdge edge;
+  ASSERT_TRUE(queue.pop(edge));
+  EXPECT_EQ(10u, edge.micros);
+  EXPECT_EQ(LOW, edge.level);
+  ASSERT_TRUE(queue.pop(edge));
+  EXPECT_EQ(20u, edge.micros);
+  EXPECT_FALSE(queue.pop(edge));
+}
+
+TEST(EdgeQueue, FullQueueCountsOverflows) {
+  EdgeQueue<4> queue;
+  for (int i = 0; i < 4; i++) EXPECT_TRUE(queue.push(i, i & 1));
+  EXPECT_FALSE(queue.push(4, LOW));
+  EXPECT_EQ(4, queue.count());
+  EXPECT_EQ(1, queue.overflows());
+}
+
+TEST(EdgeQueue, IndicesWrapAround) {
+  EdgeQueue<4> queue;
+  PinEdge edge;
+  for (uint32_t i = 0; i < 600; i++) {
+    ASSERT_TRUE(queue.push(i, LOW));
+    ASSERT_TRUE(queue.pop(edge));
+    ASSERT_EQ(i, edge.micros);
+  }
+}
+
+// Debouncer Tests
+TEST(EdgeDebouncer, FirstEdgeIsTakenAtOnce) {
+  EdgeDebouncer debouncer(LOCKOUT_MICROS);
+  PinEdge out;
+  ASSERT_TRUE(debouncer.edge(PinEdge{5000, LOW}, out));
+  EXPECT_EQ(5000u, out.micros);
+  EXPECT_EQ(LOW, out.level);
+}
+
+TEST(EdgeDebouncer, BounceInsideLockoutIsIgnored) {
+  EdgeDebouncer debouncer(LOCKOUT_MICROS);
+  PinEdge out;
+  debouncer.edge(PinEdge{0, LOW}, out);
+  EXPECT_FALSE(debouncer.edge(PinEdge{300, HIGH}, out));
+  EXPECT_FALSE(debouncer.edge(PinEdge{700, LOW}, out));
+  EXPECT_FALSE(debouncer.edge(PinEdge{1500, HIGH}, out));
+  EXPECT_FALSE(debouncer.edge(PinEdge{2500, LOW}, out));
+  EXPECT_FALSE(debouncer.settle(30000, out));  // Settled where it was
+  EXPECT_EQ(2, debouncer.bounces());
+  EXPECT_EQ(LOW, debouncer.level());
+}
+
+TEST(EdgeDebouncer, ReleaseAfterLockoutIsTaken) {
+  EdgeDebouncer debouncer(LOCKOUT_MICROS);
+  PinEdge out;
+  debouncer.edge(PinEdge{0, LOW}, out);
+  ASSERT_TRUE(debouncer.edge(PinEdge{LOCKOUT_MICROS, HIGH}, out));
+  EXPECT_EQ(HIGH, out.level);
+}
+
+TEST(EdgeDebouncer, ShortPressSettlesAfterLockout) {
+  EdgeDebouncer debouncer(LOCKOUT_MICROS);
+  PinEdge out;
+  debouncer.edge(PinEdge{0, LOW}, out);
+  EXPECT_FALSE(debouncer.edge(PinEdge{300, HIGH}, out));
+  EXPECT_FALSE(debouncer.settle(LOCKOUT_MICROS - 1, out));
+  ASSERT_TRUE(debouncer.settle(LOCKOUT_MICROS, out));
+  EXPECT_EQ(HIGH, out.level);
+  EXPECT_EQ(300u, out.micros);  // When the pin actually went back
+}
+
+TEST(EdgeDebouncer, LockoutSurvivesMicrosWrap) {
+  EdgeDebouncer debouncer(LOCKOUT_MICROS);
+  PinEdge out;
+  debouncer.edge(PinEdge{0xFFFFFF00u, LOW}, out);
+  EXPECT_FALSE(debouncer.edge(PinEdge{0x00000100u, HIGH}, out));  // 512us later
+  uint32_t lockoutEnds = 0xFFFFFF00u + LOCKOUT_MICROS;                // Wrapped
+  EXPECT_FALSE(debouncer.settle(lockoutEnds - 1, out));
+  EXPECT_TRUE(debouncer.settle(lockoutEnds, out));
+}
+
+// Pin Change Interrupt Tests
+TEST_F(EdgeCaptureTest, BeginEnablesPinChangeInterrupt) {
+  EXPECT_TRUE(PCICR & _BV(PCIE0));
+  EXPECT_TRUE(PCMSK0 & _BV(5));
+  EXPECT_EQ(INPUT_PULLUP, sim::pinModes[TEST_PIN]);
+}
+
+TEST_F(EdgeCaptureTest, PinWithoutPcintIsRefused) {
+  PinEdgeCapture<4> other(LOCKOUT_MICROS);
+  EXPECT_FALSE(other.begin(2));
+}
+
+TEST_F(EdgeCaptureTest, PressIsStampedWithIsrTime) {
+  uint32_t pressAt = micros();
+  sim::setPin(TEST_PIN, LOW);
+  sim::advanceMicros(5000);  // The loop gets there later
+  std::vector<PinEdge> events = pollAll();
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(LOW, events[0].level);
+  EXPECT_EQ(pressAt, events[0].micros);
+}
+
+TEST_F(EdgeCaptureTest, ShortPressBetweenPollsIsNotMissed) {
+  sim::setPin(TEST_PIN, LOW);
+  sim::advanceMicros(300);
+  sim::setPin(TEST_PIN, HIGH);
+  std::vector<PinEdge> events = pollAll();
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(LOW, events[0].level);
+  sim::advanceMicros(LOCKOUT_MICROS);
+  events = pollAll();
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(HIGH, events[0].level);
+}
+
+TEST_F(EdgeCaptureTest, BouncyPressIsOnePress) {
+  const uint32_t bounce[] = {0, 300, 700, 1500, 2500};
+  for (int i = 0; i < 5; i++) {
+    sim::advanceMicros(i ? bounce[i] - bounce[i - 1] : 0);
+    sim::setPin(TEST_PIN, i & 1 ? HIGH : LOW);
+  }
+  EXPECT_EQ(5u, sim::pinChangeInterrupts);
+  sim::advanceMicros(LOCKOUT_MICROS);
+  std::vector<PinEdge> events = pollAll();
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(LOW, events[0].level);
+  EXPECT_EQ(2, capture->bounces());
+}
+
+TEST_F(EdgeCaptureTest, EdgesWhileInterruptsOffArriveAfter) {
+  noInterrupts();
+  sim::setPin(TEST_PIN, LOW);
+  EXPECT_EQ(0u, sim::pinChangeInterrupts);
+  interrupts();
+  EXPECT_EQ(1u, sim::pinChangeInterrupts);
+  EXPECT_EQ(1u, pollAll().size());
+}
+
+TEST_F(EdgeCaptureTest, OverflowResyncsFromPin) {
+  for (int i = 0; i < 12; i++) {  // 8 fit; ends HIGH
+    sim::setPin(TEST_PIN, i & 1 ? HIGH : LOW);
+    sim::advanceMicros(LOCKOUT_MICROS);
+  }
+  sim::setPin(TEST_PIN, LOW);  // Lost: queue still full
+  EXPECT_GT(capture->overflows(), 0);
+  pollAll();
+  sim::advanceMicros(LOCKOUT_MICROS);
+  pollAll();
+  EXPECT_EQ(LOW, capture->level());
+}
+
+TEST_F(EdgeCaptureTest, PendingUntilPolled) {
+  EXPECT_FALSE(capture->pending());
+  sim::setPin(TEST_PIN, LOW);
+  EXPECT_TRUE(capture->pending());  // A sleep check sees it before poll() does
+  pollAll();
+  EXPECT_FALSE(capture->pending());
+}
+
+TEST_F(EdgeCaptureTest, HeldAtStartupIsAPress) {
+  sim::setPin(TEST_PIN, LOW);
+  PinEdgeCapture<4> held(LOCKOUT_MICROS);
+  held.begin(TEST_PIN);
+  PinEdge edge;
+  ASSERT_TRUE(held.poll(edge));
+  EXPECT_EQ(LOW, edge.level);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,267 @@
+/*
+ * Unit Tests for the Event Log
+ *
+ * Runs EventLog against a serial port stand-in with a settable amount of
+ * free buffer: drain() must never write more than the port can take, a
+ * full ring must drop and count events and say so in the log, and every
+ * record must decode back to the text the old Serial.print() calls made.
+ * Uses Google Test framework.
+ *
+ * Build and run (from hatching_egg/):
+ *   pixi run test-event-log
+ */
+
+#include <gtest/gtest.h>
+#include "Arduino.h"
+#include "event_log.h"
+#include "frame_scheduler.h"
+#include "event_log_decoder.h"
+
+#define TEST_EVENTS(X) \
+  X(EVT_START, 0x10, "Starting: {a:name}") \
+  X(EVT_STEP, 0x11, "-> Step {a}/14: {c:name} ({b:q8}x speed)") \
+  X(EVT_STILL, 0x12, "STATE: Still for {c:ms} seconds") \
+  X(EVT_TARGETS, 0x13, "H:{a} LA:{b:lo} RA:{b:hi}") \
+  X(EVT_FRAMES, 0x14, "Frames: {b} ({c} skipped)")
+
+enum { TEST_EVENTS(EVENT_LOG_ENUM) };
+
+static const char* testName(uint16_t index) {
+  static const char* names[] = {"resting", "grasping"};
+  return index < 2 ? names[index] : nullptr;
+}
+
+// USB CDC stand-in: only `space` bytes fit until the host reads
+class PortStandIn {
+ public:
+  std::string bytes;
+  int space = 64;
+  int writes = 0;
+
+  int availableForWrite() { return space; }
+  size_t write(const uint8_t* data, size_t size) {
+    EXPECT_LE((int)size, space) << "drain() wrote more than the port could take";
+    bytes.append(reinterpret_cast<const char*>(data), size);
+    space -= (int)size;
+    writes++;
+    return size;
+  }
+};
+
+class EventLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::reset();
+    sim::advanceMicros(1234000);
+  }
+
+  std::string decode(const std::string& bytes) {
+    sim::EventLogDecoder decoder({TEST_EVENTS(EVENT_LOG_FORMAT)}, testName);
+    return decoder.feed(bytes);
+  }
+
+  EventLog<8> log;
+  PortStandIn port;
+};
+
+// Ring Tests
+TEST_F(EventLogTest, LogQueuesWithoutWriting) {
+  EXPECT_TRUE(log.log(EVT_START, 1));
+  EXPECT_EQ(1, log.count());
+  EXPECT_EQ(0, port.writes);
+}
+
+TEST_F(EventLogTest, DrainSendsWholeRecordsInOrder) {
+  log.log(EVT_START, 0);
+  log.log(EVT_START, 1);
+  EXPECT_EQ(2, log.drain(port));
+  EXPECT_EQ(0, log.count());
+  EXPECT_EQ(2u * EVENT_LOG_WIRE_BYTES, port.bytes.size());
+  EXPECT_EQ("Starting: resting\nStarting: grasping\n", decode(port.bytes));
+}
+
+TEST_F(EventLogTest, DrainStopsWhenPortIsFull) {
+  for (int i = 0; i < 7; i++) log.log(EVT_START, 0);
+  port.space = 25;  // Room for two records and a bit
+  EXPECT_EQ(2, log.drain(port));
+  EXPECT_EQ(5, log.count());
+  port.space = 0;
+  EXPECT_EQ(0, log.drain(port));
+  port.space = 64;
+  EXPECT_EQ(5, log.drain(port));
+  EXPECT_EQ(0, log.count());
+}
+
+TEST_F(EventLogTest, FullRingDropsAndCounts) {
+  for (int i = 0; i < 8; i++) EXPECT_TRUE(log.log(EVT_START, 0));
+  EXPECT_FALSE(log.log(EVT_START, 1));
+  EXPECT_FALSE(log.log(EVT_START, 1));
+  EXPECT_EQ(8, log.count());
+  EXPECT_EQ(2u, log.dropped());
+  EXPECT_EQ(8, log.highWater());
+}
+
+TEST_F(EventLogTest, DropsAreReportedWhereTheyHappened) {
+  for (int i = 0; i < 8; i++) log.log(EVT_START, 0);
+  log.log(EVT_START, 1);  // Dropped
+  log.log(EVT_START, 1);  // Dropped
+  port.space = 3 * EVENT_LOG_WIRE_BYTES;
+  log.drain(port);        // Frees three slots
+  EXPECT_TRUE(log.log(EVT_START, 1));  // Takes two: the drop report, then this
+  port.space = 1000;
+  log.drain(port);
+
+  sim::EventLogDecoder decoder({TEST_EVENTS(EVENT_LOG_FORMAT)}, testName);
+  std::string text = decoder.feed(port.bytes);
+  std::string expected;
+  for (int i = 0; i < 8; i++) expected += "Starting: resting\n";
+  expected += "... 2 events dropped (2 total)\nStarting: grasping\n";
+  EXPECT_EQ(expected, text);
+  EXPECT_EQ(2u, decoder.dropped);
+}
+
+TEST_F(EventLogTest, DropReportNeedsTwoFreeSlots) {
+  for (int i = 0; i < 8; i++) log.log(EVT_START, 0);
+  log.log(EVT_START, 0);  // Dropped
+  port.space = EVENT_LOG_WIRE_BYTES;
+  log.drain(port);        // One free slot: not enough for report + event
+  EXPECT_FALSE(log.log(EVT_START, 0));
+  EXPECT_EQ(2u, log.dropped());
+}
+
+TEST_F(EventLogTest, DrainReportsDropsOnceEmpty) {
+  for (int i = 0; i < 8; i++) log.log(EVT_START, 0);
+  log.log(EVT_START, 0);  // Dropped, and nothing logged after
+  port.space = 1000;
+  EXPECT_EQ(8, log.drain(port));
+  EXPECT_EQ(1, log.drain(port));
+  std::string text = decode(port.bytes);
+  EXPECT_NE(std::string::npos, text.find("... 1 events dropped (1 total)\n"));
+}
+
+TEST_F(EventLogTest, IndicesWrapAround) {
+  for (int i = 0; i < 300; i++) {
+    ASSERT_TRUE(log.log(EVT_START, (uint8_t)(i & 1)));
+    ASSERT_EQ(1, log.drain(port));
+    port.space = 64;
+  }
+  EXPECT_EQ(0, log.count());
+  EXPECT_EQ(300u * EVENT_LOG_WIRE_BYTES, port.bytes.size());
+}
+
+// Wire Format Tests
+TEST_F(EventLogTest, RecordLayout) {
+  log.log(EVT_STEP, 3, 0x1234, 0xABCD);
+  log.drain(port);
+  ASSERT_EQ((size_t)EVENT_LOG_WIRE_BYTES, port.bytes.size());
+  const uint8_t* b = reinterpret_cast<const uint8_t*>(port.bytes.data());
+  EXPECT_EQ(EVENT_LOG_SYNC, b[0]);
+  EXPECT_EQ(EVT_STEP, b[1]);
+  EXPECT_EQ(3, b[2]);
+  EXPECT_EQ(1234 & 0xFF, b[3]);  // millis() low 16 bits, little-endian
+  EXPECT_EQ(1234 >> 8, b[4]);
+  EXPECT_EQ(0x34, b[5]);
+  EXPECT_EQ(0x12, b[6]);
+  EXPECT_EQ(0xCD, b[7]);
+  EXPECT_EQ(0xAB, b[8]);
+  uint8_t sum = 0;
+  for (int i = 1; i < 9; i++) sum += b[i];
+  EXPECT_EQ((uint8_t)~sum, b[9]);
+}
+
+TEST_F(EventLogTest, RecordsAreSmallerThanTheirText) {
+  EXPECT_EQ(8u, sizeof(EventRecord));
+  log.log(EVT_STEP, 8, 384, 1);
+  log.drain(port);
+  EXPECT_LT(port.bytes.size(), decode(port.bytes).size());
+}
+
+// Decoder Tests
+TEST_F(EventLogTest, FormatsMatchOldSerialOutput) {
+  log.log(EVT_STEP, 8, 384, 1);       // 1.5x in Q8
+  log.log(EVT_STEP, 14, 77, 0);       // 0.3x
+  log.log(EVT_STILL, 0, 0, 2500);
+  log.log(EVT_TARGETS, 155, eventBytes(173, 2));
+  log.drain(port);
+  EXPECT_EQ("-> Step 8/14: grasping (1.50x speed)\n"
+            "-> Step 14/14: resting (0.30x speed)\n"
+            "STATE: Still for 2.50 seconds\n"
+            "H:155 LA:173 RA:2\n",
+            decode(port.bytes));
+}
+
+TEST_F(EventLogTest, TextPassesThroughBetweenRecords) {
+  port.bytes = "Hatching Egg Spider\r\n";
+  log.log(EVT_START, 0);
+  log.drain(port);
+  port.bytes += "partial";
+  port.space = 64;
+  log.log(EVT_START, 1);
+  log.drain(port);
+  EXPECT_EQ("Hatching Egg Spider\r\nStarting: resting\npartial\nStarting: grasping\n", decode(port.bytes));
+}
+
+TEST_F(EventLogTest, CorruptRecordIsSkippedAndDecoderResyncs) {
+  log.log(EVT_START, 0);
+  log.log(EVT_START, 1);
+  log.drain(port);
+  port.bytes[4] ^= 0x40;  // Corrupt the first record's timestamp
+  sim::EventLogDecoder decoder({TEST_EVENTS(EVENT_LOG_FORMAT)}, testName);
+  std::string text = decoder.feed(port.bytes);
+  EXPECT_EQ(1u, decoder.records);
+  EXPECT_EQ(1u, decoder.checksumErrors);
+  EXPECT_NE(std::string::npos, text.find("Starting: grasping\n"));
+}
+
+TEST_F(EventLogTest, RecordsSplitAcrossReadsDecode) {
+  log.log(EVT_START, 1);
+  log.drain(port);
+  sim::EventLogDecoder decoder({TEST_EVENTS(EVENT_LOG_FORMAT)}, testName);
+  std::string text;
+  for (char c : port.bytes) text += decoder.feed(std::string(1, c));
+  EXPECT_EQ("Starting: grasping\n", text);
+}
+
+TEST_F(EventLogTest, TimestampsUnwrapPast16Bits) {
+  sim::EventLogDecoder decoder({TEST_EVENTS(EVENT_LOG_FORMAT)}, testName);
+  decoder.timestamps = true;
+  log.log(EVT_START, 0);
+  sim::advanceMicros(65000000);  // 66.234 s: low 16 bits wrapped
+  log.log(EVT_START, 1);
+  log.drain(port);
+  EXPECT_EQ("[     1.234] Starting: resting\n[    66.234] Starting: grasping\n", decoder.feed(port.bytes));
+}
+
+TEST_F(EventLogTest, UnknownCodeShowsRawFields) {
+  log.log(0x7E, 1, 2, 3);
+  log.drain(port);
+  sim::EventLogDecoder decoder({TEST_EVENTS(EVENT_LOG_FORMAT)}, testName);
+  EXPECT_EQ("event 0x7E a=1 b=2 c=3\n", decoder.feed(port.bytes));
+  EXPECT_EQ(1u, decoder.unknownCodes);
+}
+
+// Frame Stats Tests
+TEST_F(EventLogTest, FrameStatsLogLikePrintStats) {
+  FrameScheduler frames(20000);
+  EventLog<16> statsLog;
+  frames.beginFrame();
+  sim::advanceMicros(300);
+  frames.endFrame();
+  sim::advanceMicros(19800);  // 100us late
+  frames.beginFrame();
+  frames.endFrame();
+  frames.logStats(statsLog, EVT_FRAMES);
+  EXPECT_EQ(5, statsLog.count());  // Header, times, three buckets
+  statsLog.drain(port);
+  EXPECT_EQ("Frames: 2 (0 skipped)\n"
+            "  late max 100us  compute max 300us\n"
+            "  <64us: late 1  compute 1\n"
+            "  <128us: late 1  compute 0\n"
+            "  <512us: late 0  compute 1\n",
+            decode(port.bytes));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
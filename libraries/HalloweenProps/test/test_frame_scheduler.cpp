@@ -0,0 +1,179 @@
+/*
+ * Unit Tests for the Frame Scheduler
+ *
+ * Runs FrameScheduler on the host sim clock: frames must land on a fixed
+ * grid, overruns must skip slots rather than burst, and lateness/compute
+ * time must end up in the right histogram buckets.
+ * Uses Google Test framework.
+ *
+ * Build and run (from hatching_egg/):
+ *   pixi run test-frame-scheduler
+ */
+
+#include <gtest/gtest.h>
+#include "Arduino.h"
+#include "frame_scheduler.h"
+
+// Collects printStats() output
+class StringPrint : public Print {
+ public:
+  std::string text;
+  size_t write(uint8_t c) override {
+    text.push_back((char)c);
+    return 1;
+  }
+  using Print::write;
+};
+
+class FrameSchedulerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::reset();
+    sim::advanceMicros(5000);  // Don't start at t = 0
+  }
+
+  FrameScheduler frames{20000};
+};
+
+// Frame Period Tests
+TEST(FramePeriod, AlignedToPwmPeriod) {
+  EXPECT_EQ(20000UL, FRAME_PERIOD_MICROS(50, 1));
+  EXPECT_EQ(10000UL, FRAME_PERIOD_MICROS(50, 2));
+  EXPECT_EQ(16666UL, FRAME_PERIOD_MICROS(60, 1));
+}
+
+// Grid Tests
+TEST_F(FrameSchedulerTest, FirstFrameIsDueImmediately) {
+  EXPECT_TRUE(frames.beginFrame());
+  EXPECT_EQ(1u, frames.stats().frames);
+}
+
+TEST_F(FrameSchedulerTest, NotDueAgainUntilPeriodEnds) {
+  frames.beginFrame();
+  sim::advanceMicros(19999);
+  EXPECT_FALSE(frames.beginFrame());
+  sim::advanceMicros(1);
+  EXPECT_TRUE(frames.beginFrame());
+}
+
+TEST_F(FrameSchedulerTest, LateFramesDoNotDrift) {
+  frames.beginFrame();
+  uint64_t start = sim::nowMicros;
+  for (int i = 1; i <= 10; i++) {
+    // Every frame starts 700us late; the grid must not slide by 700us each time
+    sim::nowMicros = start + i * 20000 + 700;
+    ASSERT_TRUE(frames.beginFrame());
+    EXPECT_EQ(19300u, frames.untilNextFrame());
+  }
+}
+
+TEST_F(FrameSchedulerTest, OverrunSkipsMissedSlots) {
+  frames.beginFrame();
+  sim::advanceMicros(65000);  // Slots at 20, 40 and 60 ms; 40 and 60 are lost
+  EXPECT_TRUE(frames.beginFrame());
+  EXPECT_FALSE(frames.beginFrame());  // No catch-up burst
+  EXPECT_EQ(2, frames.stats().skipped);
+  EXPECT_EQ(15000u, frames.untilNextFrame());
+}
+
+TEST_F(FrameSchedulerTest, RestartMakesFrameDueNow) {
+  frames.beginFrame();
+  sim::advanceMicros(3000);
+  frames.restart();
+  EXPECT_TRUE(frames.beginFrame());
+  EXPECT_EQ(20000u, frames.untilNextFrame());
+}
+
+// Instrumentation Tests
+TEST_F(FrameSchedulerTest, LatenessGoesInLog2Bucket) {
+  frames.beginFrame();                   // 0us late  -> bucket 0
+  sim::advanceMicros(20000 + 100);
+  frames.beginFrame();                   // 100us     -> [64, 128)
+  sim::advanceMicros(19900 + 3000);
+  frames.beginFrame();                   // 3000us    -> [2048, 4096)
+  const FrameStats& stats = frames.stats();
+  EXPECT_EQ(1, stats.late[0]);
+  EXPECT_EQ(1, stats.late[1]);
+  EXPECT_EQ(1, stats.late[6]);
+  EXPECT_EQ(3000, stats.maxLateMicros);
+}
+
+TEST_F(FrameSchedulerTest, ComputeTimeMeasuredToEndFrame) {
+  frames.beginFrame();
+  sim::advanceMicros(900);
+  frames.endFrame();
+  EXPECT_EQ(1, frames.stats().compute[4]);  // [512, 1024)
+  EXPECT_EQ(900, frames.stats().maxComputeMicros);
+}
+
+TEST_F(FrameSchedulerTest, LongFramesLandInLastBucket) {
+  frames.beginFrame();
+  sim::advanceMicros(50000);
+  frames.endFrame();
+  EXPECT_EQ(1, frames.stats().compute[FRAME_HIST_BUCKETS - 1]);
+}
+
+TEST_F(FrameSchedulerTest, BucketEdges) {
+  EXPECT_EQ(0u, FrameScheduler::bucketMicros(0));
+  EXPECT_EQ(64u, FrameScheduler::bucketMicros(1));
+  EXPECT_EQ(16384u, FrameScheduler::bucketMicros(FRAME_HIST_BUCKETS - 1));
+}
+
+TEST_F(FrameSchedulerTest, CountsSaturate) {
+  for (uint32_t i = 0; i < 70000; i++) {
+    frames.restart();
+    frames.beginFrame();
+  }
+  EXPECT_EQ(0xFFFF, frames.stats().late[0]);
+  EXPECT_EQ(70000u, frames.stats().frames);
+}
+
+TEST_F(FrameSchedulerTest, ResetStatsKeepsGrid) {
+  frames.beginFrame();
+  sim::advanceMicros(5000);
+  frames.resetStats();
+  EXPECT_EQ(0u, frames.stats().frames);
+  EXPECT_EQ(15000u, frames.untilNextFrame());
+}
+
+TEST_F(FrameSchedulerTest, PrintStatsShowsNonEmptyBuckets) {
+  frames.beginFrame();
+  sim::advanceMicros(300);
+  frames.endFrame();
+  StringPrint out;
+  frames.printStats(out);
+  EXPECT_NE(std::string::npos, out.text.find("Frames: 1 (0 skipped)"));
+  EXPECT_NE(std::string::npos, out.text.find("compute max 300us"));
+  EXPECT_NE(std::string::npos, out.text.find("compute <512:1"));
+  EXPECT_EQ(std::string::npos, out.text.find("<128:"));
+}
+
+// Idle Tests
+TEST_F(FrameSchedulerTest, IdleSleepsOneTimerTickWhenFarFromDeadline) {
+  frames.beginFrame();
+  uint64_t before = sim::nowMicros;
+  frames.idle();
+  EXPECT_EQ((uint64_t)FRAME_TIMER_TICK_MICROS, sim::nowMicros - before);
+}
+
+TEST_F(FrameSchedulerTest, IdleWaitsExactlyForCloseDeadline) {
+  frames.beginFrame();
+  sim::advanceMicros(19500);
+  frames.idle();
+  EXPECT_EQ(0u, frames.untilNextFrame());
+  EXPECT_TRUE(frames.beginFrame());
+  EXPECT_EQ(0, frames.stats().maxLateMicros);
+}
+
+TEST_F(FrameSchedulerTest, IdleReturnsAtOnceWhenFrameIsDue) {
+  frames.beginFrame();
+  sim::advanceMicros(25000);
+  uint64_t before = sim::nowMicros;
+  frames.idle();
+  EXPECT_EQ(before, sim::nowMicros);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
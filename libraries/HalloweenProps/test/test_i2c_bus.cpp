@@ -0,0 +1,154 @@
+/*
+ * Unit Tests for I2C Bus
+ *
+ * Clock setup against the host mock Wire (which, like the AVR core, puts
+ * SCL back to 100 kHz in begin()), bus time counted the way the mock
+ * charges it, per-frame stats and the serial report. Budget deferral is in
+ * test_servo_output.cpp.
+ * Uses Google Test framework.
+ *
+ * Build and run (from hatching_egg/):
+ *   pixi run test-i2c-bus
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "Arduino.h"
+#include "Wire.h"
+#include "pca9685_model.h"
+#include "pca9685_batch.h"
+#include "i2c_bus.h"
+
+// Collects event records instead of queueing them
+struct RecordingLog {
+  std::vector<EventRecord> records;
+  bool log(uint8_t code, uint8_t a = 0, uint16_t b = 0, uint16_t c = 0) {
+    records.push_back(EventRecord{code, a, 0, b, c});
+    return true;
+  }
+};
+
+class I2CBusTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Wire.begin();
+    sim::attachI2CDevice(0x40, &chip);
+    Wire.beginTransmission(0x40);
+    Wire.write(sim::PCA9685_MODE1);
+    Wire.write(sim::PCA9685_MODE1_AI | 0x01);
+    Wire.endTransmission();
+    sim::resetI2CStats();
+  }
+
+  void TearDown() override {
+    sim::attachI2CDevice(0x40, nullptr);
+    Wire.begin();
+  }
+
+  sim::PCA9685Model chip{0x40};
+  PCA9685Batch batch{0x40};
+};
+
+// Clock Tests
+TEST_F(I2CBusTest, BeginSetsTheClockAfterWireBegin) {
+  I2CBus bus(I2C_BUS_FAST_HZ, 2000);
+  EXPECT_EQ(100000u, Wire.getClock());
+  bus.begin();
+  EXPECT_EQ(400000u, Wire.getClock());
+  Wire.begin();  // What pwm.begin() does
+  EXPECT_EQ(100000u, Wire.getClock());
+  EXPECT_EQ(800u, bus.budgetClocks());  // 2ms at 400 kHz
+}
+
+TEST_F(I2CBusTest, ClampsToTheTWIMaximum) {
+  EXPECT_EQ(1000000u, I2CBus(I2C_BUS_FAST_PLUS_HZ).clockHz());
+  EXPECT_EQ(F_CPU / 16, I2CBus(3400000).clockHz());
+  EXPECT_EQ(100000u, I2CBus(I2C_BUS_STANDARD_HZ).clockHz());
+}
+
+// Counting Tests
+TEST_F(I2CBusTest, CountsTheSameBusTimeAsTheWire) {
+  for (uint32_t hz : {I2C_BUS_STANDARD_HZ, I2C_BUS_FAST_HZ, I2C_BUS_FAST_PLUS_HZ}) {
+    I2CBus bus(hz);
+    bus.begin();
+    sim::resetI2CStats();
+    batch.invalidate();
+    bus.beginFrame();
+    for (uint8_t ch : {0, 1, 14, 15}) batch.set(ch, 300 + ch);
+    batch.flush();
+    bus.record(batch.lastBytes(), batch.lastTransactions());
+    EXPECT_EQ(sim::i2c.bytes, bus.frameBytes());
+    EXPECT_EQ(sim::i2c.transactions, bus.frameTransactions());
+    // The mock rounds each transaction up to a microsecond; the bus rounds the frame
+    EXPECT_LE(bus.frameMicros(), sim::i2c.busMicros) << hz;
+    EXPECT_GE(bus.frameMicros() + sim::i2c.transactions, sim::i2c.busMicros) << hz;
+  }
+  EXPECT_EQ(I2C_BUS_TRANSACTION_CLOCKS(6), 56);
+}
+
+TEST_F(I2CBusTest, FramesRollIntoStats) {
+  I2CBus bus(I2C_BUS_FAST_HZ, 100);  // 40 clocks
+  bus.beginFrame();
+  bus.record(4, 1);  // 38 clocks
+  EXPECT_EQ(2u, bus.remainingClocks());
+  EXPECT_FALSE(bus.fits(1));
+  bus.beginFrame();
+  bus.record(6, 1);  // 56 clocks: over
+  bus.record(3, 1);
+  bus.defer(2);
+  bus.beginFrame();
+  bus.beginFrame();  // Nothing sent: not a bus frame
+  EXPECT_TRUE(bus.fits(4));
+
+  const I2CBusStats& stats = bus.stats();
+  EXPECT_EQ(2u, stats.frames);
+  EXPECT_EQ(13u, stats.bytes);
+  EXPECT_EQ(3u, stats.transactions);
+  EXPECT_EQ(9, stats.maxFrameBytes);
+  EXPECT_EQ(2, stats.maxFrameTransactions);
+  EXPECT_EQ(85u, stats.maxFrameClocks);
+  EXPECT_EQ(1, stats.overBudget);
+  EXPECT_EQ(2, stats.deferred);
+  bus.resetStats();
+  EXPECT_EQ(0u, bus.stats().frames);
+}
+
+// Report Tests
+TEST_F(I2CBusTest, PrintsStats) {
+  I2CBus bus(I2C_BUS_FAST_HZ, 100);
+  bus.beginFrame();
+  bus.record(6, 1);
+  bus.beginFrame();
+  bus.record(7, 1);
+  bus.defer();
+  bus.beginFrame();
+  Serial.output.clear();
+  bus.printStats(Serial);
+  EXPECT_EQ("I2C 400 kHz: 2 frames  6.5 bytes/frame  max 7 bytes 1 transactions 163us  2 over 100us  1 deferred\r\n",
+            Serial.output);
+}
+
+TEST_F(I2CBusTest, LogsStatsAsEvents) {
+  I2CBus bus(I2C_BUS_FAST_PLUS_HZ, 100);
+  bus.beginFrame();
+  bus.record(20, 2);
+  bus.beginFrame();
+  RecordingLog log;
+  bus.logStats(log, 0x40);
+  ASSERT_EQ(3u, log.records.size());
+  EXPECT_EQ(0x40, log.records[0].code);
+  EXPECT_EQ(10, log.records[0].a);  // x 100 kHz
+  EXPECT_EQ(1, log.records[0].b);
+  EXPECT_EQ(20, log.records[0].c);
+  EXPECT_EQ(EVT_BUS_MAX, log.records[1].code);
+  EXPECT_EQ(2, log.records[1].a);
+  EXPECT_EQ(20, log.records[1].b);
+  EXPECT_EQ(184, log.records[1].c);  // 9 x 20 + 2 x 2 clocks at 1 MHz
+  EXPECT_EQ(EVT_BUS_BUDGET, log.records[2].code);
+  EXPECT_EQ(1, log.records[2].b);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,114 @@
+/*
+ * Unit Tests for Idle Sleep
+ *
+ * On the host, a sleep is one timer0 tick of simulated time. Checks that
+ * pending work skips the sleep, that awake and asleep time add up to the
+ * duty cycle, and that the millisecond totals don't drift as microsecond
+ * sums are folded in.
+ * Uses Google Test framework.
+ *
+ * Build and run (from window_spider_trigger/):
+ *   pixi run test-idle-sleep
+ */
+
+#include <gtest/gtest.h>
+#include "Arduino.h"
+#include "idle_sleep.h"
+
+class IdleSleepTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::reset();
+    sim::advanceMicros(5000000);
+    idle.restart();
+  }
+
+  static bool nothingToDo() { return false; }
+
+  IdleSleep idle;
+};
+
+TEST_F(IdleSleepTest, SleepsOneTimerTick) {
+  unsigned long start = micros();
+  EXPECT_TRUE(idle.sleep(nothingToDo));
+  EXPECT_EQ((unsigned long)IDLE_SLEEP_TICK_MICROS, micros() - start);
+  EXPECT_EQ(1u, idle.counters().wakes);
+}
+
+TEST_F(IdleSleepTest, PendingWorkSkipsTheSleep) {
+  unsigned long start = micros();
+  EXPECT_FALSE(idle.sleep([] { return true; }));
+  EXPECT_EQ(start, micros());
+  EXPECT_EQ(0u, idle.counters().wakes);
+}
+
+TEST_F(IdleSleepTest, WorkCheckRunsWithInterruptsOff) {
+  bool interruptsWereOn = true;
+  idle.sleep([&] {
+    interruptsWereOn = sim::interruptsOn;
+    return false;
+  });
+  EXPECT_FALSE(interruptsWereOn);
+  EXPECT_TRUE(sim::interruptsOn);
+}
+
+TEST_F(IdleSleepTest, EdgeDuringTheCheckRunsAfterIt) {
+  idle.sleep([&] {
+    sim::pcint0Pending = true;  // Flagged while interrupts were off
+    return false;
+  });
+  EXPECT_FALSE(sim::pcint0Pending);  // interrupts() delivered it
+}
+
+TEST_F(IdleSleepTest, DutyCycleFromAwakeAndAsleepTime) {
+  for (int i = 0; i < 2000; i++) {
+    sim::advanceMicros(i % 10 == 0 ? 1024 : 0);  // Every 10th pass does 1 ms of work
+    idle.sleep(nothingToDo);
+  }
+  IdleCounters now = idle.counters();
+  IdleCounters boot = {0, 0, 0};
+  EXPECT_EQ(2000u, now.wakes);
+  EXPECT_EQ(204u, now.activeMillis);   // 200 passes x 1.024 ms
+  EXPECT_EQ(2252u, now.totalMillis);   // + 2000 sleeps x 1.024 ms
+  EXPECT_EQ(905, IdleSleep::dutyBasisPoints(boot, now));  // 204 / 2252 ms, rounded down
+}
+
+TEST_F(IdleSleepTest, WorkSkippingASleepStillCountsAsActive) {
+  sim::advanceMicros(3000);
+  idle.sleep([] { return true; });
+  sim::advanceMicros(3000);
+  idle.sleep(nothingToDo);
+  for (int i = 0; i < 1000; i++) idle.sleep(nothingToDo);
+  EXPECT_EQ(6u, idle.counters().activeMillis);
+}
+
+TEST_F(IdleSleepTest, SnapshotsGiveAWindow) {
+  for (int i = 0; i < 1000; i++) idle.sleep(nothingToDo);  // ~1 s asleep
+  IdleCounters first = idle.counters();
+  for (int i = 0; i < 1000; i++) {
+    sim::advanceMicros(1024);
+    idle.sleep(nothingToDo);
+  }
+  IdleCounters second = idle.counters();
+  IdleCounters boot = {0, 0, 0};
+  EXPECT_EQ(5000, IdleSleep::dutyBasisPoints(first, second));
+  EXPECT_NEAR(3333, IdleSleep::dutyBasisPoints(boot, second), 1);
+  EXPECT_EQ(0, IdleSleep::dutyBasisPoints(second, second));
+}
+
+TEST_F(IdleSleepTest, LongRunsDoNotDriftOrOverflow) {
+  // 20 simulated hours of 100 us passes between 1.024 ms sleeps
+  for (uint32_t i = 0; i < 20UL * 3600 * 1000000 / 1124; i++) {
+    sim::advanceMicros(100);
+    idle.sleep(nothingToDo);
+  }
+  IdleCounters now = idle.counters();
+  IdleCounters boot = {0, 0, 0};
+  EXPECT_NEAR(20.0 * 3600 * 1000, now.totalMillis, 2);
+  EXPECT_EQ(889, IdleSleep::dutyBasisPoints(boot, now));  // 100 / 1124, rounded down
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,75 @@
+/*
+ * Unit Tests for Log Levels
+ *
+ * Built at LOG_LEVEL_INFO, the way a sketch would be: INFO and below must
+ * reach Serial and the event log unchanged; DEBUG must print and log
+ * nothing.
+ * Uses Google Test framework.
+ *
+ * Build and run (from hatching_egg/):
+ *   pixi run test-log-level
+ */
+
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+#include <gtest/gtest.h>
+#include "Arduino.h"
+#include "event_log.h"
+#include "log_level.h"
+
+class LogLevelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::reset();
+    Serial.output.clear();
+  }
+
+  EventLog<8> log;
+};
+
+// Level Tests
+TEST(LogLevel, EnabledUpToConfiguredLevel) {
+  EXPECT_TRUE(LogError::enabled);
+  EXPECT_TRUE(LogWarn::enabled);
+  EXPECT_TRUE(LogInfo::enabled);
+  EXPECT_FALSE(LogDebug::enabled);
+  EXPECT_FALSE(logLevelEnabled(LOG_LEVEL_NONE));
+}
+
+TEST(LogLevel, EventRingKeepsItsSizeWhenInfoIsOn) {
+  EXPECT_EQ(32, LOG_EVENT_CAPACITY(32));
+}
+
+// Serial Text Tests
+TEST_F(LogLevelTest, EnabledLevelPrintsLikeSerial) {
+  LogInfo::print(F("Animations: "));
+  LogInfo::println(12);
+  LogWarn::println(255, HEX);
+  LogError::println();
+  EXPECT_EQ("Animations: 12\r\nFF\r\n\r\n", Serial.output);
+}
+
+TEST_F(LogLevelTest, DisabledLevelPrintsNothing) {
+  LogDebug::print(F("thrash "));
+  LogDebug::println(42);
+  LogDebug::println(42, HEX);
+  LogDebug::println();
+  EXPECT_EQ("", Serial.output);
+}
+
+// Event Tests
+TEST_F(LogLevelTest, EnabledLevelLogsEvents) {
+  EXPECT_TRUE(LogInfo::event(log, 0x10, 1, 2, 3));
+  EXPECT_EQ(1, log.count());
+}
+
+TEST_F(LogLevelTest, DisabledLevelLogsNoEvents) {
+  EXPECT_FALSE(LogDebug::event(log, 0x10, 1, 2, 3));
+  EXPECT_EQ(0, log.count());
+  EXPECT_EQ(0u, log.dropped());
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
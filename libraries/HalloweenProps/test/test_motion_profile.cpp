@@ -0,0 +1,263 @@
+/*
+ * Unit Tests for Motion Profiles
+ *
+ * Drives MotionAxis with explicit timestamps: a profile must play the same
+ * trajectory whether update() runs every tick, every frame or at random,
+ * must keep to its speed and acceleration limits, land on its target
+ * without overshooting, and slow down before reversing.
+ * Uses Google Test framework.
+ *
+ * Build and run (from hatching_egg/):
+ *   pixi run test-motion-profile
+ */
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "Arduino.h"
+#include "motion_profile.h"
+
+static const MotionProfile CREEP = motionProfile(25, 50);
+static const MotionProfile RETURN = motionProfile(100, 400);
+static const MotionProfile THRASH = motionProfile(1500, 30000);
+
+static const int32_t ONE_DEGREE = 1L << MOTION_POSITION_SHIFT;
+static const uint32_t START = 7000;  // Not tick aligned
+
+// Position after each tick, calling update() once per tick
+static std::vector<int32_t> everyTick(MotionAxis& axis, uint32_t from, int ticks) {
+  std::vector<int32_t> positions;
+  for (int i = 1; i <= ticks; i++) {
+    axis.update(from + i * MOTION_TICK_MICROS);
+    positions.push_back(axis.positionQ20());
+  }
+  return positions;
+}
+
+// Profile Tests
+TEST(MotionProfile, RoundsToTheTickGrid) {
+  // 400 deg/s^2 * 1.024ms^2 = 0.000419 deg per tick per tick
+  EXPECT_EQ(440, RETURN.accel);
+  // 100 deg/s = 0.1024 deg per tick = 107374 Q20, in whole accel steps
+  EXPECT_EQ(107374 / 440, RETURN.maxSteps);
+  EXPECT_EQ(1, motionProfile(1, 1).accel);
+  EXPECT_GE(motionProfile(1, 1000000).maxSteps, 1);
+}
+
+TEST(MotionProfile, IsAConstantExpression) {
+  static_assert(motionProfile(25, 50).accel > 0, "built at compile time");
+  SUCCEED();
+}
+
+// Trajectory Tests
+TEST(MotionAxis, StartsAtRest) {
+  MotionAxis axis(90);
+  EXPECT_EQ(90, axis.degrees());
+  EXPECT_EQ(90 * 256, axis.degreesQ8());
+  EXPECT_FALSE(axis.moving());
+  EXPECT_FALSE(axis.update(START));  // Starts the clock
+  EXPECT_FALSE(axis.update(START + 1000000));
+}
+
+TEST(MotionAxis, ReachesTheTargetAndStops) {
+  MotionAxis axis(90);
+  axis.update(START);
+  axis.moveTo(180, RETURN);
+  std::vector<int32_t> path = everyTick(axis, START, 2000);
+  EXPECT_EQ(180 * ONE_DEGREE, path.back());
+  EXPECT_FALSE(axis.moving());
+  EXPECT_EQ(180, axis.degrees());
+}
+
+TEST(MotionAxis, TakesAsLongAsTheTrapezoidSays) {
+  // 90 degrees at 100 deg/s, 400 deg/s^2: 0.25s ramps + 0.65s cruise = 1.15s
+  MotionAxis axis(90);
+  axis.update(START);
+  axis.moveTo(0, RETURN);
+  std::vector<int32_t> path = everyTick(axis, START, 2000);
+  int arrived = 0;
+  while (path[arrived] != 0) arrived++;
+  double seconds = (arrived + 1) * MOTION_TICK_MICROS / 1e6;
+  EXPECT_NEAR(1.15, seconds, 0.01);
+}
+
+TEST(MotionAxis, KeepsToSpeedAndAccelerationLimits) {
+  MotionAxis axis(0);
+  axis.update(START);
+  axis.moveTo(180, THRASH);
+  int32_t last = axis.positionQ20(), lastSpeed = 0, maxSpeed = 0;
+  for (int32_t p : everyTick(axis, START, 1000)) {
+    int32_t speed = p - last;
+    EXPECT_GE(speed, 0);
+    EXPECT_LE(speed, (int32_t)THRASH.maxSteps * THRASH.accel);
+    EXPECT_LE(abs(speed - lastSpeed), THRASH.accel);
+    maxSpeed = std::max(maxSpeed, speed);
+    last = p;
+    lastSpeed = speed;
+  }
+  EXPECT_EQ((int32_t)THRASH.maxSteps * THRASH.accel, maxSpeed);
+  EXPECT_NEAR(1500.0, maxSpeed * 1e6 / MOTION_TICK_MICROS / ONE_DEGREE, 1500.0 * 0.02);
+}
+
+TEST(MotionAxis, NeverOvershootsFromRest) {
+  const int16_t targets[] = {91, 100, 3, 177, 90, 89};
+  MotionAxis axis(90);
+  uint32_t now = START;
+  axis.update(now);
+  for (int16_t target : targets) {
+    int32_t from = axis.positionQ20();
+    axis.moveTo(target, CREEP);
+    for (int32_t p : everyTick(axis, now, 10000)) {
+      EXPECT_LE(std::min(from, target * ONE_DEGREE), p);
+      EXPECT_GE(std::max(from, target * ONE_DEGREE), p);
+    }
+    now += 10000 * MOTION_TICK_MICROS;
+    EXPECT_EQ(target, axis.degrees());
+    EXPECT_FALSE(axis.moving());
+  }
+}
+
+TEST(MotionAxis, SlowsDownBeforeReversing) {
+  MotionAxis axis(0);
+  axis.update(START);
+  axis.moveTo(180, THRASH);
+  everyTick(axis, START, 60);  // Up to speed, heading for 180
+  axis.moveTo(10, THRASH);
+  int32_t last = axis.positionQ20(), lastSpeed = axis.speedQ20();
+  ASSERT_GT(lastSpeed, 0);
+  int32_t furthest = last;
+  for (int32_t p : everyTick(axis, START + 60 * MOTION_TICK_MICROS, 1000)) {
+    EXPECT_LE(abs((p - last) - lastSpeed), THRASH.accel);  // No instant reversal
+    furthest = std::max(furthest, p);
+    lastSpeed = p - last;
+    last = p;
+  }
+  EXPECT_GT(furthest, axis.positionQ20());  // Carried on before turning
+  EXPECT_EQ(10, axis.degrees());
+  EXPECT_FALSE(axis.moving());
+}
+
+TEST(MotionAxis, SlowerProfileCapsTheSpeedAtOnce) {
+  MotionAxis axis(0);
+  axis.update(START);
+  axis.moveTo(180, THRASH);
+  everyTick(axis, START, 60);
+  axis.moveTo(180, CREEP);
+  EXPECT_LE(axis.speedQ20(), (int32_t)CREEP.maxSteps * CREEP.accel);
+  everyTick(axis, START + 60 * MOTION_TICK_MICROS, 20000);
+  EXPECT_EQ(180, axis.degrees());
+}
+
+TEST(MotionAxis, JumpToStopsWhereItIs) {
+  MotionAxis axis(0);
+  axis.update(START);
+  axis.moveTo(180, THRASH);
+  everyTick(axis, START, 30);
+  axis.jumpTo(90);
+  EXPECT_FALSE(axis.moving());
+  EXPECT_EQ(0, axis.speedQ20());
+  EXPECT_FALSE(axis.update(START + 100000));
+  EXPECT_EQ(90, axis.degrees());
+}
+
+// Rate Independence Tests
+struct Sample {
+  uint32_t micros;
+  int32_t position;
+};
+
+// Replays one show: retargets at fixed times, updates at the given times
+static std::vector<Sample> play(const std::vector<uint32_t>& updateTimes) {
+  struct Move {
+    uint32_t micros;
+    int16_t degrees;
+    const MotionProfile* profile;
+  };
+  const Move moves[] = {{0, 150, &CREEP},    {400000, 20, &THRASH}, {500000, 170, &THRASH},
+                        {600000, 5, &THRASH}, {700000, 90, &RETURN}};
+  MotionAxis axis(90);
+  std::vector<Sample> samples;
+  size_t next = 0;
+  for (uint32_t t : updateTimes) {
+    axis.update(START + t);
+    while (next < sizeof(moves) / sizeof(moves[0]) && moves[next].micros <= t) {
+      axis.moveTo(moves[next].degrees, *moves[next].profile);
+      next++;
+    }
+    samples.push_back({t, axis.positionQ20()});
+  }
+  return samples;
+}
+
+static std::vector<uint32_t> grid(uint32_t period, uint32_t until) {
+  std::vector<uint32_t> times;
+  for (uint32_t t = 0; t <= until; t += period) times.push_back(t);
+  return times;
+}
+
+TEST(MotionAxis, SameTrajectoryAtAnyUpdateRate) {
+  // 100ms retarget times are on all three grids
+  std::vector<Sample> ref = play(grid(1000, 3000000));
+  for (uint32_t period : {5000u, 20000u, 100000u}) {
+    std::vector<Sample> run = play(grid(period, 3000000));
+    size_t r = 0;
+    for (const Sample& s : run) {
+      while (ref[r].micros != s.micros) r++;
+      ASSERT_EQ(ref[r].position, s.position) << "period " << period << " at " << s.micros;
+    }
+  }
+}
+
+TEST(MotionAxis, SameTrajectoryWithJitteryFrames) {
+  std::vector<Sample> ref = play(grid(1000, 3000000));
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<uint32_t> gap(1, 45);
+  for (int run = 0; run < 5; run++) {
+    // Random gaps of 1-45ms, always landing on the retarget times and the grid
+    std::vector<uint32_t> times;
+    for (uint32_t t = 0; t <= 3000000;) {
+      times.push_back(t);
+      uint32_t next = t + gap(rng) * 1000;
+      uint32_t boundary = (t / 100000 + 1) * 100000;
+      t = std::min(next, boundary);
+    }
+    std::vector<Sample> jittery = play(times);
+    size_t r = 0;
+    for (const Sample& s : jittery) {
+      while (ref[r].micros != s.micros) r++;
+      ASSERT_EQ(ref[r].position, s.position) << "run " << run << " at " << s.micros;
+    }
+  }
+}
+
+TEST(MotionAxis, HandlesTheMicrosWrap) {
+  MotionAxis wrapped(0), plain(0);
+  uint32_t wrapStart = 0xFFFFFFFFUL - 500000;
+  wrapped.update(wrapStart);
+  plain.update(START);
+  wrapped.moveTo(120, RETURN);
+  plain.moveTo(120, RETURN);
+  for (uint32_t t = 20000; t <= 2000000; t += 20000) {
+    wrapped.update(wrapStart + t);
+    plain.update(START + t);
+    ASSERT_EQ(plain.positionQ20(), wrapped.positionQ20()) << "at " << t;
+  }
+  EXPECT_EQ(120, wrapped.degrees());
+}
+
+TEST(MotionAxis, RestartSkipsPausedTime) {
+  MotionAxis axis(0);
+  axis.update(START);
+  axis.moveTo(180, CREEP);
+  axis.update(START + 100000);
+  int32_t paused = axis.positionQ20();
+  axis.restart(START + 5000000);  // 5s held, e.g. by a button
+  EXPECT_EQ(paused, axis.positionQ20());
+  axis.update(START + 5000000 + MOTION_TICK_MICROS);
+  EXPECT_LT(axis.positionQ20() - paused, ONE_DEGREE / 10);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
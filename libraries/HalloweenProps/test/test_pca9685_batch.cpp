@@ -0,0 +1,231 @@
+/*
+ * Unit Tests for PCA9685 Batched Output
+ *
+ * Drives PCA9685Batch through the host mock Wire bus into a PCA9685
+ * register model, checking both what the chip ends up holding and how
+ * many bytes/transactions it took to get there.
+ * Uses Google Test framework.
+ *
+ * Build and run (from hatching_egg/):
+ *   pixi run test-pca9685-batch
+ */
+
+#include <gtest/gtest.h>
+#include "Arduino.h"
+#include "Wire.h"
+#include "pca9685_model.h"
+#include "pca9685_batch.h"
+
+// One setPWM() call on the wire: address, register, 4 data bytes
+static const int SETPWM_BYTES = 6;
+
+class PCA9685BatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::resetI2CStats();
+    sim::attachI2CDevice(0x40, &chip);
+    // Wake with auto-increment, as Adafruit's setPWMFreq() leaves it
+    Wire.beginTransmission(0x40);
+    Wire.write(sim::PCA9685_MODE1);
+    Wire.write(sim::PCA9685_MODE1_AI | 0x01);
+    Wire.endTransmission();
+    sim::resetI2CStats();
+  }
+
+  void TearDown() override {
+    sim::attachI2CDevice(0x40, nullptr);
+  }
+
+  sim::PCA9685Model chip{0x40};
+  PCA9685Batch batch{0x40};
+};
+
+// First Write Tests
+TEST_F(PCA9685BatchTest, FirstFlushWritesAllFourRegisters) {
+  batch.set(0, 300);
+  EXPECT_EQ(1, batch.flush());
+  EXPECT_EQ(0, chip.on(0));
+  EXPECT_EQ(300, chip.off(0));
+  EXPECT_EQ(SETPWM_BYTES, batch.lastBytes());
+}
+
+TEST_F(PCA9685BatchTest, FirstWriteClearsNonZeroOn) {
+  // Something else left ON != 0 (e.g. setPin full-on)
+  Wire.beginTransmission(0x40);
+  Wire.write(sim::PCA9685_LED0_ON_L);
+  Wire.write((uint8_t)0x00);
+  Wire.write((uint8_t)0x10);
+  Wire.endTransmission();
+  batch.set(0, 300);
+  batch.flush();
+  EXPECT_EQ(0, chip.on(0));
+  EXPECT_EQ(300, chip.off(0));
+}
+
+TEST_F(PCA9685BatchTest, NothingStagedSendsNothing) {
+  EXPECT_EQ(0, batch.flush());
+  EXPECT_EQ(0u, sim::i2c.transactions);
+}
+
+// Change Detection Tests
+TEST_F(PCA9685BatchTest, UnchangedValueSendsNothing) {
+  batch.set(3, 400);
+  batch.flush();
+  batch.set(3, 400);
+  EXPECT_EQ(0, batch.flush());
+  EXPECT_EQ(0, batch.lastBytes());
+}
+
+TEST_F(PCA9685BatchTest, LowByteChangeSendsOneDataByte) {
+  batch.set(0, 300);
+  batch.flush();
+  batch.set(0, 301);
+  EXPECT_EQ(1, batch.flush());
+  EXPECT_EQ(3, batch.lastBytes());
+  EXPECT_EQ(301, chip.off(0));
+}
+
+TEST_F(PCA9685BatchTest, HighByteChangeSendsBothOffBytes) {
+  batch.set(0, 250);
+  batch.flush();
+  batch.set(0, 260);  // 0x0FA -> 0x104
+  batch.flush();
+  EXPECT_EQ(4, batch.lastBytes());
+  EXPECT_EQ(260, chip.off(0));
+}
+
+TEST_F(PCA9685BatchTest, LastStagedValueWins) {
+  batch.set(5, 200);
+  batch.set(5, 220);
+  batch.flush();
+  EXPECT_EQ(220, chip.off(5));
+}
+
+// Transaction Merging Tests
+TEST_F(PCA9685BatchTest, AdjacentChannelsShareOneTransaction) {
+  batch.set(0, 300);
+  batch.set(1, 310);
+  EXPECT_EQ(1, batch.flush());
+  EXPECT_EQ(2 + 8, batch.lastBytes());
+  EXPECT_EQ(300, chip.off(0));
+  EXPECT_EQ(310, chip.off(1));
+}
+
+TEST_F(PCA9685BatchTest, SmallGapIsBridged) {
+  batch.set(0, 250);
+  batch.set(1, 300);
+  batch.flush();
+  // ch0 OFF_H (reg 3) and ch1 OFF_L (reg 6) change; ON bytes 4-5 bridged
+  batch.set(0, 260);
+  batch.set(1, 301);
+  EXPECT_EQ(1, batch.flush());
+  EXPECT_EQ(2 + 5, batch.lastBytes());
+  EXPECT_EQ(260, chip.off(0));
+  EXPECT_EQ(301, chip.off(1));
+  EXPECT_EQ(0, chip.on(1));
+}
+
+TEST_F(PCA9685BatchTest, LargeGapSplitsTransactions) {
+  batch.set(0, 300);
+  batch.set(1, 300);
+  batch.flush();
+  // OFF_L of ch0 (reg 2) and ch1 (reg 6): 3 clean bytes between
+  batch.set(0, 301);
+  batch.set(1, 301);
+  EXPECT_EQ(2, batch.flush());
+  EXPECT_EQ(6, batch.lastBytes());
+}
+
+TEST_F(PCA9685BatchTest, RunsSplitAtWireBuffer) {
+  for (uint8_t ch = 0; ch < 16; ch++) batch.set(ch, 200 + ch);
+  EXPECT_EQ(3, batch.flush());  // 64 bytes in runs of <= 31
+  EXPECT_EQ(0u, sim::i2c.nacks);
+  for (uint8_t ch = 0; ch < 16; ch++) {
+    EXPECT_EQ(0, chip.on(ch));
+    EXPECT_EQ(200 + ch, chip.off(ch));
+  }
+}
+
+TEST_F(PCA9685BatchTest, RunsNeverSplitAChannel) {
+  // Every pulse the chip outputs, even between transactions, is a staged one
+  int halfWritten = 0;
+  chip.onChannel = [&](uint8_t, uint8_t ch, uint16_t, uint16_t off) {
+    halfWritten += off != 200 + ch;
+  };
+  for (uint8_t ch = 0; ch < 16; ch++) batch.set(ch, 200 + ch);
+  EXPECT_EQ(3, batch.flush());
+  EXPECT_EQ(0, halfWritten);
+}
+
+TEST_F(PCA9685BatchTest, EggLegFrameHalvesBusBytes) {
+  // Right leg on 0/1, left leg on 14/15 (hatching_egg)
+  const uint8_t channels[] = {0, 1, 14, 15};
+  for (uint8_t ch : channels) batch.set(ch, 300);
+  batch.flush();
+  for (uint8_t ch : channels) batch.set(ch, 302);
+  batch.flush();
+  EXPECT_LE(batch.lastBytes() * 2, 4 * SETPWM_BYTES);
+  for (uint8_t ch : channels) EXPECT_EQ(302, chip.off(ch));
+}
+
+// Invalidation and Error Tests
+TEST_F(PCA9685BatchTest, InvalidatedChannelRewritesAllRegisters) {
+  batch.set(2, 300);
+  batch.flush();
+  batch.invalidate(2);
+  batch.set(2, 300);
+  batch.flush();
+  EXPECT_EQ(SETPWM_BYTES, batch.lastBytes());
+}
+
+TEST_F(PCA9685BatchTest, InvalidateAllForgetsEveryChannel) {
+  batch.set(0, 300);
+  batch.set(8, 300);
+  batch.flush();
+  batch.invalidate();
+  batch.set(0, 300);
+  batch.set(8, 300);
+  EXPECT_EQ(2, batch.flush());
+  EXPECT_EQ(2 * SETPWM_BYTES, batch.lastBytes());
+}
+
+TEST_F(PCA9685BatchTest, FailedWriteIsRetried) {
+  batch.set(4, 300);
+  batch.flush();
+  sim::attachI2CDevice(0x40, nullptr);  // Chip stops answering
+  batch.set(4, 320);
+  batch.flush();
+  EXPECT_EQ(1, batch.errors());
+  sim::attachI2CDevice(0x40, &chip);
+  batch.flush();  // Nothing new staged; the failed channel goes again
+  EXPECT_EQ(SETPWM_BYTES, batch.lastBytes());
+  EXPECT_EQ(320, chip.off(4));
+}
+
+// Randomized Consistency Test
+TEST_F(PCA9685BatchTest, ChipAlwaysMatchesStagedValues) {
+  uint16_t expected[16] = {0};
+  bool written[16] = {false};
+  uint32_t seed = 12345;
+  for (int frame = 0; frame < 2000; frame++) {
+    for (int n = 0; n < 5; n++) {
+      seed = seed * 1103515245 + 12345;
+      uint8_t ch = (seed >> 16) & 0x0F;
+      uint16_t off = 100 + ((seed >> 8) % 500);
+      batch.set(ch, off);
+      expected[ch] = off;
+      written[ch] = true;
+    }
+    batch.flush();
+    for (uint8_t ch = 0; ch < 16; ch++) {
+      if (!written[ch]) continue;
+      ASSERT_EQ(expected[ch], chip.off(ch)) << "frame " << frame << " ch " << (int)ch;
+      ASSERT_EQ(0, chip.on(ch));
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,448 @@
+/*
+ * Unit Tests for Servo Output
+ *
+ * Drives ServoOutput through PCA9685Batch and the host mock Wire bus into
+ * PCA9685 register models: calibrated angles and clamping (the same
+ * values the sketches' old constrain() + map() paths wrote), the write
+ * cache, batching, slew limiting, servos spread over two boards,
+ * low-priority servos held back when a frame's bus budget is spent and
+ * servos slowed or held to keep the estimated current within a budget.
+ * Uses Google Test framework.
+ *
+ * Build and run (from hatching_egg/):
+ *   pixi run test-servo-output
+ */
+
+#include <gtest/gtest.h>
+#include "Arduino.h"
+#include "Wire.h"
+#include "pca9685_model.h"
+#include "servo_output.h"
+
+// hatching_egg's legs (0-90 deg, ticks; left side mirrored)
+typedef ServoPulseTable<150, 330> RightElbowTable;
+typedef ServoPulseTable<440, 300> LeftShoulderTable;
+// twitching_body's HS-755MG (0-180 deg, 600-2400 us at 50 Hz)
+typedef ServoPulseTable<600, 2400, 180, 20000> HS755Table;
+
+class ServoOutputTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::resetI2CStats();
+    sim::attachI2CDevice(0x40, &chip);
+    // Wake with auto-increment, as Adafruit's setPWMFreq() leaves it
+    Wire.beginTransmission(0x40);
+    Wire.write(sim::PCA9685_MODE1);
+    Wire.write(sim::PCA9685_MODE1_AI | 0x01);
+    Wire.endTransmission();
+    sim::resetI2CStats();
+
+    servos.attach(0, 0, SERVO_CALIBRATION(RightElbowTable));
+    servos.attach(1, 1, SERVO_CALIBRATION(RightElbowTable));
+    servos.attach(2, 14, SERVO_CALIBRATION(LeftShoulderTable));
+    servos.attach(3, 15, SERVO_CALIBRATION(HS755Table));
+  }
+
+  void TearDown() override {
+    sim::attachI2CDevice(0x40, nullptr);
+  }
+
+  sim::PCA9685Model chip{0x40};
+  PCA9685Batch batch{0x40};
+  ServoOutput<4> servos{batch};
+};
+
+// Calibration Tests
+TEST_F(ServoOutputTest, WritesThroughTheCalibrationTable) {
+  servos.write(0, 45);
+  servos.writeQ8(2, 45 * 256 + 128);
+  servos.flush();
+  EXPECT_EQ(RightElbowTable::lookup(45), chip.off(0));
+  EXPECT_EQ(0, chip.on(0));
+  EXPECT_EQ(LeftShoulderTable::lookupQ8(45 * 256 + 128), chip.off(14));
+}
+
+TEST_F(ServoOutputTest, MatchesTheOldConstrainAndMap) {
+  // What hatching_egg's and animation_tester's setServo() wrote
+  for (int degrees = -10; degrees <= 100; degrees++) {
+    long expected = map(constrain(degrees, 0, 90), 0, 90, 440, 300);
+    servos.write(2, degrees);
+    EXPECT_EQ(expected, servos.target(2)) << degrees;
+  }
+  // What twitching_body's setServoAngle() -> setServoPulse() wrote
+  for (int angle = -5; angle <= 185; angle++) {
+    long pulse = map(constrain(angle, 0, 180), 0, 180, 600, 2400);
+    servos.write(3, angle);
+    EXPECT_EQ((pulse * 4096) / 20000, servos.target(3)) << angle;
+  }
+}
+
+TEST_F(ServoOutputTest, ClampsTicksToTheCalibratedRange) {
+  servos.writeTicks(0, 100);
+  EXPECT_EQ(150, servos.target(0));
+  servos.writeTicks(0, 400);
+  EXPECT_EQ(330, servos.target(0));
+  servos.writeTicks(2, 250);  // Mirrored: range is 300-440
+  EXPECT_EQ(300, servos.target(2));
+  servos.writeTicks(2, 500);
+  EXPECT_EQ(440, servos.target(2));
+  servos.writeTicks(2, 377);
+  EXPECT_EQ(377, servos.target(2));
+}
+
+TEST_F(ServoOutputTest, MicrosecondsConvertLikeTheTables) {
+  EXPECT_EQ(307, servoMicrosToTicks(1500, 20000));
+  EXPECT_EQ(HS755Table::lookup(0), servoMicrosToTicks(600, 20000));
+  EXPECT_EQ(HS755Table::lookup(180), servoMicrosToTicks(2400, 20000));
+}
+
+TEST_F(ServoOutputTest, IgnoresServosPastTheEnd) {
+  EXPECT_FALSE(servos.write(4, 45));
+  EXPECT_FALSE(servos.writeTicks(200, 300));
+  EXPECT_EQ(0, servos.flush());
+}
+
+// Cache and Batching Tests
+TEST_F(ServoOutputTest, RepeatedWritesAreDropped) {
+  EXPECT_TRUE(servos.write(0, 45));
+  servos.flush();
+  EXPECT_FALSE(servos.write(0, 45));
+  EXPECT_FALSE(servos.writeTicks(0, RightElbowTable::lookup(45)));
+  EXPECT_EQ(0, servos.flush());
+  EXPECT_TRUE(servos.write(0, 46));
+  EXPECT_EQ(1, servos.flush());
+}
+
+TEST_F(ServoOutputTest, FlushSendsChangedServosTogether) {
+  for (int i = 0; i < 4; i++) servos.write(i, 30);
+  EXPECT_EQ(0u, sim::i2c.transactions);  // Nothing until flush()
+  EXPECT_EQ(2, servos.flush());          // Channels 0-1 and 14-15
+  EXPECT_EQ(2u, sim::i2c.transactions);
+  EXPECT_TRUE(servos.settled());
+
+  // One servo one tick: just its OFF_L byte
+  servos.writeTicks(1, RightElbowTable::lookup(30) + 1);
+  EXPECT_EQ(1, servos.flush());
+  EXPECT_EQ(3, batch.lastBytes());
+}
+
+TEST_F(ServoOutputTest, OffStopsThePulse) {
+  servos.write(0, 45);
+  servos.flush();
+  servos.off(0);
+  servos.flush();
+  EXPECT_EQ(0, chip.off(0));
+  EXPECT_EQ(SERVO_OUTPUT_UNKNOWN, servos.target(0));
+  EXPECT_TRUE(servos.write(0, 45));  // Not cached away
+  servos.flush();
+  EXPECT_EQ(RightElbowTable::lookup(45), chip.off(0));
+}
+
+TEST_F(ServoOutputTest, InvalidateResendsAfterADirectWrite) {
+  servos.write(0, 45);
+  servos.flush();
+  // Something else writes the channel behind the batch's back
+  Wire.beginTransmission(0x40);
+  Wire.write((uint8_t)(sim::PCA9685_LED0_ON_L + 2));
+  Wire.write((uint8_t)0x00);
+  Wire.write((uint8_t)0x00);
+  Wire.endTransmission();
+  servos.invalidate(0);
+  EXPECT_TRUE(servos.write(0, 45));
+  servos.flush();
+  EXPECT_EQ(RightElbowTable::lookup(45), chip.off(0));
+}
+
+// Slew Tests
+TEST_F(ServoOutputTest, SlewLimitsTicksPerFlush) {
+  servos.setSlew(0, 5);
+  servos.writeTicks(0, 200);
+  servos.flush();
+  EXPECT_EQ(200, chip.off(0));  // First write: straight there
+
+  servos.writeTicks(0, 223);
+  const int expected[] = {205, 210, 215, 220, 223};
+  for (int step : expected) {
+    EXPECT_FALSE(servos.settled());
+    servos.flush();
+    EXPECT_EQ(step, chip.off(0));
+  }
+  EXPECT_TRUE(servos.settled());
+  EXPECT_EQ(0, servos.flush());
+}
+
+TEST_F(ServoOutputTest, SlewTurnsAroundWhereItIs) {
+  servos.attach(0, 0, SERVO_CALIBRATION(RightElbowTable), 10);
+  servos.writeTicks(0, 150);
+  servos.flush();
+  servos.writeTicks(0, 330);
+  servos.flush();
+  servos.flush();
+  EXPECT_EQ(170, servos.ticks(0));
+  servos.writeTicks(0, 155);
+  servos.flush();
+  EXPECT_EQ(160, servos.ticks(0));
+  servos.flush();
+  EXPECT_EQ(155, chip.off(0));
+  EXPECT_TRUE(servos.settled());
+}
+
+TEST_F(ServoOutputTest, SlewOnlyHoldsBackItsOwnServo) {
+  servos.setSlew(0, 1);
+  servos.write(0, 0);
+  servos.write(1, 0);
+  servos.flush();
+  servos.write(0, 90);
+  servos.write(1, 90);
+  servos.flush();
+  EXPECT_EQ(151, chip.off(0));
+  EXPECT_EQ(330, chip.off(1));
+}
+
+// Several Boards Tests
+class ServoOutputBoardsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::attachI2CDevice(0x40, &chip40);
+    sim::attachI2CDevice(0x41, &chip41);
+    for (uint8_t address : {0x40, 0x41}) {
+      Wire.beginTransmission(address);
+      Wire.write(sim::PCA9685_MODE1);
+      Wire.write(sim::PCA9685_MODE1_AI | 0x01);
+      Wire.endTransmission();
+    }
+    sim::resetI2CStats();
+    // 20 servos: 0-15 on 0x40 channels 0-15, 16-19 on 0x41 channels 12-15
+    for (uint8_t i = 0; i < 20; i++) {
+      servos.attach(i, i / 16, i < 16 ? i : i - 4, SERVO_CALIBRATION(RightElbowTable));
+    }
+  }
+
+  void TearDown() override {
+    sim::attachI2CDevice(0x40, nullptr);
+    sim::attachI2CDevice(0x41, nullptr);
+  }
+
+  sim::PCA9685Model chip40{0x40};
+  sim::PCA9685Model chip41{0x41};
+  PCA9685Batch boards[2] = {PCA9685Batch(0x40), PCA9685Batch(0x41)};
+  ServoOutput<20, 2> servos{boards};
+};
+
+TEST_F(ServoOutputBoardsTest, EachServoGoesToItsBoard) {
+  servos.write(3, 10);
+  servos.write(17, 80);
+  servos.flush();
+  EXPECT_EQ(RightElbowTable::lookup(10), chip40.off(3));
+  EXPECT_EQ(RightElbowTable::lookup(80), chip41.off(13));
+  EXPECT_EQ(0, chip41.off(3));
+  EXPECT_EQ(0, chip40.off(13));
+  EXPECT_EQ(1, servos.board(17));
+  EXPECT_EQ(13, servos.channel(17));
+}
+
+TEST_F(ServoOutputBoardsTest, FlushSendsEveryBoard) {
+  for (uint8_t i = 0; i < 20; i++) servos.write(i, 45);
+  EXPECT_FALSE(servos.settled());
+  uint8_t transactions = servos.flush();
+  EXPECT_EQ(sim::i2c.transactions, transactions);
+  EXPECT_EQ(boards[0].lastTransactions() + boards[1].lastTransactions(), transactions);
+  EXPECT_GE(boards[1].lastTransactions(), 1);
+  EXPECT_TRUE(servos.settled());
+  for (uint8_t ch = 12; ch < 16; ch++) EXPECT_EQ(RightElbowTable::lookup(45), chip41.off(ch));
+
+  // Servo 19 is the last bit of the third dirty byte
+  servos.write(19, 46);
+  EXPECT_FALSE(servos.settled());
+  EXPECT_EQ(1, servos.flush());
+  EXPECT_EQ(0, boards[0].lastTransactions());
+}
+
+// Bus Budget Tests
+TEST_F(ServoOutputTest, BusFlushRecordsWhatWasSent) {
+  I2CBus bus(I2C_BUS_STANDARD_HZ, 20000);
+  servos.setLowPriority(1);  // Room for everything: still merged with channel 0
+  bus.beginFrame();
+  for (int i = 0; i < 4; i++) servos.write(i, 30);
+  EXPECT_EQ(2, servos.flush(bus));
+  EXPECT_EQ(sim::i2c.bytes, bus.frameBytes());
+  EXPECT_EQ(sim::i2c.transactions, bus.frameTransactions());
+  EXPECT_EQ(sim::i2c.busMicros, bus.frameMicros());  // 10us per clock: exact
+}
+
+TEST_F(ServoOutputTest, LowPriorityWaitsForRoom) {
+  servos.setLowPriority(1);
+  servos.setLowPriority(2);
+  servos.setLowPriority(2, false);
+  // Servos 0, 2, 3 first (6 + 10 bytes, 148 clocks), then under a lone write's 56 to spare
+  I2CBus bus(I2C_BUS_STANDARD_HZ, 10 * (148 + 50));
+  bus.beginFrame();
+  for (int i = 0; i < 4; i++) servos.write(i, 30);
+  servos.flush(bus);
+  EXPECT_EQ(RightElbowTable::lookup(30), chip.off(0));
+  EXPECT_EQ(LeftShoulderTable::lookup(30), chip.off(14));
+  EXPECT_EQ(0, chip.off(1));  // Held: target kept, counted
+  EXPECT_EQ(1, bus.stats().deferred);
+  EXPECT_FALSE(servos.settled());
+
+  bus.beginFrame();
+  EXPECT_EQ(1, servos.flush(bus));  // Next frame, with the budget to itself
+  EXPECT_EQ(RightElbowTable::lookup(30), chip.off(1));
+  EXPECT_TRUE(servos.settled());
+  bus.beginFrame();
+  EXPECT_EQ(0, bus.stats().overBudget);
+}
+
+TEST_F(ServoOutputTest, LowPriorityTakesTurns) {
+  for (int i = 0; i < 4; i++) servos.setLowPriority(i);
+  I2CBus bus(I2C_BUS_STANDARD_HZ, 10 * I2C_BUS_TRANSACTION_CLOCKS(SERVO_OUTPUT_WRITE_MAX_BYTES));
+  int firstSent[4] = {};
+  for (int frame = 0; frame < 8; frame++) {
+    bus.beginFrame();
+    for (int i = 0; i < 4; i++) servos.writeTicks(i, 300 + frame % 2);  // All change, every frame
+    servos.flush(bus);
+    for (int i = 0; i < 4; i++) firstSent[i] += servos.ticks(i) == 300 + frame % 2;
+  }
+  for (int i = 0; i < 4; i++) EXPECT_GE(firstSent[i], 1) << "servo " << i;
+  EXPECT_EQ(8 * 3, bus.stats().deferred);
+  EXPECT_EQ(0, bus.stats().overBudget);
+}
+
+// Power Budget Tests
+// 300 deg/s over the elbow's 180 ticks per 90 deg: 12 ticks a frame at 50 Hz,
+// 50 mA a tick above idle
+const ServoCurrentModel ELBOW_CURRENT = {10, 610, 300};
+
+TEST_F(ServoOutputTest, CurrentModelRampsAtTopSpeed) {
+  ServoPower power(5000);
+  servos.setCurrentModel(0, ELBOW_CURRENT, 50);
+  servos.setPower(power);
+  servos.writeTicks(0, 150);
+  servos.flush();
+  EXPECT_EQ(150, chip.off(0));  // First write: straight there, counted flat out
+  EXPECT_EQ(10 + 600, power.lastMilliamps());
+
+  servos.writeTicks(0, 180);
+  const int expected[] = {162, 174, 180};
+  const int milliamps[] = {610, 610, 310};
+  for (int i = 0; i < 3; i++) {
+    servos.flush();
+    EXPECT_EQ(expected[i], chip.off(0));
+    EXPECT_EQ(milliamps[i], power.lastMilliamps());
+  }
+  EXPECT_TRUE(servos.settled());
+  servos.flush();
+  EXPECT_EQ(10, power.lastMilliamps());  // Holding
+  EXPECT_EQ(0, power.stats().limitedFrames);
+}
+
+TEST_F(ServoOutputTest, PowerBudgetSlowsThenHoldsServosInTurn) {
+  ServoPower power(20 + 18 * 50);  // Idle, then 18 ticks of motion a frame
+  servos.setCurrentModel(0, ELBOW_CURRENT, 50);
+  servos.setCurrentModel(1, ELBOW_CURRENT, 50);
+  servos.writeTicks(0, 150);
+  servos.writeTicks(1, 150);
+  servos.flush();
+  servos.setPower(power);
+
+  servos.writeTicks(0, 330);
+  servos.writeTicks(1, 330);
+  servos.flush();
+  EXPECT_EQ(162, chip.off(0));
+  EXPECT_EQ(156, chip.off(1));  // Rate limited to what's left
+  EXPECT_EQ(920, power.lastMilliamps());
+  EXPECT_EQ(1220, power.lastDemandMilliamps());
+  servos.flush();
+  EXPECT_EQ(168, chip.off(1));  // Cut short last time: served first
+  EXPECT_EQ(168, chip.off(0));
+
+  ServoPower tight(20 + 12 * 50);
+  servos.setPower(tight);
+  servos.flush();
+  EXPECT_EQ(180, chip.off(0));
+  EXPECT_EQ(168, chip.off(1));  // Held a frame
+  servos.flush();
+  EXPECT_EQ(180, chip.off(1));
+  EXPECT_EQ(180, chip.off(0));
+  EXPECT_EQ(2, tight.stats().limitedFrames);
+  EXPECT_EQ(620, tight.stats().peakMilliamps);
+}
+
+TEST_F(ServoOutputTest, FirstWritesWaitForRoomForTheWholeJump) {
+  ServoPower power(20 + 18 * 50);  // Idle, then one and a half jumps
+  servos.setCurrentModel(0, ELBOW_CURRENT, 50);
+  servos.setCurrentModel(1, ELBOW_CURRENT, 50);
+  servos.setPower(power);
+  servos.writeTicks(0, 150);
+  servos.writeTicks(1, 150);
+  servos.flush();
+  EXPECT_EQ(150, chip.off(0));
+  EXPECT_EQ(0, chip.off(1));  // Held, not sent part way
+  EXPECT_EQ(SERVO_OUTPUT_UNKNOWN, servos.ticks(1));
+  EXPECT_EQ(20 + 600, power.lastMilliamps());
+  EXPECT_EQ(20 + 1200, power.lastDemandMilliamps());
+
+  servos.writeTicks(1, 200);  // Still never sent: nothing to ramp from
+  servos.flush();
+  EXPECT_EQ(200, chip.off(1));
+  EXPECT_EQ(20 + 600, power.lastMilliamps());
+  EXPECT_TRUE(servos.settled());
+}
+
+TEST_F(ServoOutputTest, DeferredServosLeaveTheirCurrent) {
+  ServoPower power(20 + 18 * 50);
+  servos.setCurrentModel(0, ELBOW_CURRENT, 50);
+  servos.setCurrentModel(1, ELBOW_CURRENT, 50);
+  servos.writeTicks(0, 150);
+  servos.writeTicks(1, 150);
+  servos.flush();
+  servos.setPower(power);
+  servos.setLowPriority(0);
+
+  I2CBus bus(I2C_BUS_STANDARD_HZ, 10 * I2C_BUS_TRANSACTION_CLOCKS(SERVO_OUTPUT_WRITE_MAX_BYTES));
+  bus.beginFrame();
+  servos.writeTicks(0, 330);
+  servos.writeTicks(1, 330);
+  servos.flush(bus);
+  EXPECT_EQ(150, chip.off(0));  // Out of bus time
+  EXPECT_EQ(162, chip.off(1));  // At top speed: servo 0 took none of the current
+  EXPECT_EQ(1, bus.stats().deferred);
+  EXPECT_EQ(20 + 600, power.lastMilliamps());
+  EXPECT_EQ(20 + 600, power.lastDemandMilliamps());
+}
+
+TEST_F(ServoOutputTest, ServosWithoutAModelAreNotBudgeted) {
+  ServoPower power(20);  // Idle only: modelled servos can't move
+  servos.setCurrentModel(0, ELBOW_CURRENT, 50);
+  servos.setCurrentModel(1, ELBOW_CURRENT, 50);
+  servos.writeTicks(0, 150);
+  servos.writeTicks(2, 300);
+  servos.flush();
+  servos.setPower(power);
+  servos.writeTicks(0, 200);
+  servos.writeTicks(2, 440);
+  servos.flush();
+  EXPECT_EQ(150, chip.off(0));
+  EXPECT_EQ(440, chip.off(14));
+  EXPECT_FALSE(servos.settled());
+  EXPECT_EQ(20, power.lastMilliamps());
+}
+
+TEST_F(ServoOutputTest, IdleCurrentCountsEachServoOnce) {
+  ServoPower power(5000);
+  servos.setCurrentModel(0, ELBOW_CURRENT, 50);
+  servos.setCurrentModel(1, ELBOW_CURRENT, 50);
+  servos.setCurrentModel(1, ELBOW_CURRENT, 50);  // Again: replaces, doesn't add
+  servos.setPower(power);
+  servos.flush();
+  EXPECT_EQ(2 * 10, power.lastMilliamps());
+
+  servos.attach(0, 0, SERVO_CALIBRATION(RightElbowTable));  // Re-attached: no model
+  servos.flush();
+  EXPECT_EQ(10, power.lastMilliamps());
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,75 @@
+/*
+ * Unit Tests for Servo Power
+ *
+ * Per-frame current estimates rolled into stats (average, peaks, frames
+ * limited) and the serial and event log reports. Scheduling under the
+ * budget is in test_servo_output.cpp.
+ * Uses Google Test framework.
+ *
+ * Build and run (from hatching_egg/):
+ *   pixi run test-servo-power
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "Arduino.h"
+#include "servo_power.h"
+
+// Collects event records instead of queueing them
+struct RecordingLog {
+  std::vector<EventRecord> records;
+  bool log(uint8_t code, uint8_t a = 0, uint16_t b = 0, uint16_t c = 0) {
+    records.push_back(EventRecord{code, a, 0, b, c});
+    return true;
+  }
+};
+
+TEST(ServoPowerTest, RecordsPeaksAndAverage) {
+  ServoPower power(4500);
+  EXPECT_EQ(0, power.averageMilliamps());
+  power.record(100, 100);
+  power.record(4500, 6000);  // Limited
+  power.record(200, 200);
+  EXPECT_EQ(200, power.lastMilliamps());
+  EXPECT_EQ(200, power.lastDemandMilliamps());
+
+  const ServoPowerStats& stats = power.stats();
+  EXPECT_EQ(3u, stats.frames);
+  EXPECT_EQ(1600, power.averageMilliamps());
+  EXPECT_EQ(4500, stats.peakMilliamps);
+  EXPECT_EQ(6000, stats.peakDemandMilliamps);
+  EXPECT_EQ(1, stats.limitedFrames);
+  power.resetStats();
+  EXPECT_EQ(0u, power.stats().frames);
+  EXPECT_EQ(4500, power.budgetMilliamps());
+}
+
+TEST(ServoPowerTest, PrintsStats) {
+  ServoPower power(4500);
+  power.record(300, 300);
+  power.record(4480, 4910);
+  Serial.output.clear();
+  power.printStats(Serial);
+  EXPECT_EQ("Servo current: 2 frames  avg 2390 mA  peak 4480 mA of 4500 (asked 4910)  1 limited\r\n",
+            Serial.output);
+}
+
+TEST(ServoPowerTest, LogsStatsAsEvents) {
+  ServoPower power(4500);
+  power.record(1000, 1000);
+  power.record(3000, 5000);
+  RecordingLog log;
+  power.logStats(log, 0x40);
+  ASSERT_EQ(2u, log.records.size());
+  EXPECT_EQ(0x40, log.records[0].code);
+  EXPECT_EQ(2000, log.records[0].b);
+  EXPECT_EQ(3000, log.records[0].c);
+  EXPECT_EQ(EVT_POWER_LIMITED, log.records[1].code);
+  EXPECT_EQ(1, log.records[1].b);
+  EXPECT_EQ(5000, log.records[1].c);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
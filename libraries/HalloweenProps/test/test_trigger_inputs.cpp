@@ -0,0 +1,359 @@
+/*
+ * Unit Tests for Trigger Inputs
+ *
+ * The vertical counter is checked bit for bit against a plain per-input
+ * counter, the port reader against the host sim's PINx registers, and the
+ * cooldowns against the rules motion_trigger.ino uses for its one switch.
+ *
+ * Then every bounce trace in traces/ is replayed through the host sim: pin
+ * levels change at the trace's times, loop() passes run every 1.024 ms (a
+ * sleeping sketch's timer tick), and each input's events must match the
+ * trace's "# expect <input> <PRESSED|RELEASED|COOLDOWN>" lines, each within
+ * five sample periods of the edge that settled it.
+ *
+ * Traces are logic analyzer CSV exports: a "Time [s],<channel>,..." header,
+ * then one row of channel levels per change. To see what a new capture
+ * does, pass it on the command line instead of running the tests:
+ *   ./test_trigger_inputs capture.csv [sample_ms] [cooldown_ms]
+ * Column i is input i, on REPLAY_PINS[i].
+ * Uses Google Test framework.
+ *
+ * Build and run (from window_spider_trigger/):
+ *   pixi run test-trigger-inputs
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "trigger_inputs.h"
+
+// Ten inputs on ports B (8-11, 14-16) and F (18-20)
+const uint8_t REPLAY_PINS[] = {8, 9, 10, 11, 14, 15, 16, 18, 19, 20};
+const uint8_t REPLAY_INPUTS = sizeof(REPLAY_PINS);
+const unsigned LOOP_PASS_MICROS = 1024;
+
+// Vertical Counter Tests
+TEST(VerticalDebouncer, ChangesOnTheFourthSampleInARow) {
+  VerticalDebouncer<uint8_t> debouncer;
+  EXPECT_EQ(0, debouncer.sample(0x01));
+  EXPECT_EQ(0, debouncer.sample(0x01));
+  EXPECT_EQ(0, debouncer.sample(0x01));
+  EXPECT_EQ(0x01, debouncer.sample(0x01));
+  EXPECT_EQ(0x01, debouncer.state());
+  EXPECT_EQ(0, debouncer.sample(0x01));
+}
+
+TEST(VerticalDebouncer, AnAgreeingSampleStartsTheCountAgain) {
+  VerticalDebouncer<uint8_t> debouncer;
+  for (int i = 0; i < 3; i++) debouncer.sample(0x80);
+  debouncer.sample(0x00);  // Bounce
+  for (int i = 0; i < 3; i++) EXPECT_EQ(0, debouncer.sample(0x80));
+  EXPECT_EQ(0x80, debouncer.sample(0x80));
+}
+
+TEST(VerticalDebouncer, InputsCountIndependently) {
+  VerticalDebouncer<uint16_t> debouncer(0x00F0);
+  debouncer.sample(0x00F1);
+  debouncer.sample(0x00F3);
+  debouncer.sample(0x00F3);
+  EXPECT_EQ(0x0001, debouncer.sample(0x00F3));  // Input 1 started a sample later
+  EXPECT_EQ(0x0002, debouncer.sample(0x00F3));
+  EXPECT_EQ(0x00F3, debouncer.state());
+}
+
+TEST(VerticalDebouncer, MatchesAPerInputCounter) {
+  std::mt19937 rng(7);
+  VerticalDebouncer<uint32_t> debouncer;
+  uint8_t counts[32] = {};
+  uint32_t state = 0;
+  for (int n = 0; n < 100000; n++) {
+    uint32_t raw = state ^ (rng() & rng());  // Mostly agreeing, some runs of change
+    uint32_t expected = 0;
+    for (int i = 0; i < 32; i++) {
+      bool differs = ((raw ^ state) >> i) & 1;
+      counts[i] = differs ? counts[i] + 1 : 0;
+      if (counts[i] == VERTICAL_DEBOUNCE_SAMPLES) {
+        expected |= 1UL << i;
+        counts[i] = 0;
+      }
+    }
+    state ^= expected;
+    ASSERT_EQ(expected, debouncer.sample(raw)) << "sample " << n;
+  }
+}
+
+// Port Reader Tests
+class PortInputsTest : public ::testing::Test {
+ protected:
+  void SetUp() override { sim::reset(); }
+};
+
+TEST_F(PortInputsTest, PacksEveryInputInListOrder) {
+  PortInputs<uint16_t> inputs;
+  ASSERT_TRUE(inputs.begin(REPLAY_PINS, REPLAY_INPUTS));
+  EXPECT_EQ(2, inputs.ports());
+  EXPECT_EQ(INPUT_PULLUP, sim::pinModes[20]);
+  EXPECT_EQ(0, inputs.read());
+  sim::setPin(9, LOW);   // PB5, input 1
+  sim::setPin(20, LOW);  // PF5, input 9
+  EXPECT_EQ((1 << 1) | (1 << 9), inputs.read());
+  sim::setPin(9, HIGH);
+  EXPECT_EQ(1 << 9, inputs.read());
+}
+
+TEST_F(PortInputsTest, RejectsWhatItCannotRead) {
+  PortInputs<uint8_t> inputs;
+  EXPECT_FALSE(inputs.begin(REPLAY_PINS, REPLAY_INPUTS));  // 10 inputs in 8 bits
+  const uint8_t noPort[] = {9, 30};
+  EXPECT_FALSE(inputs.begin(noPort, 2));
+  const uint8_t fivePorts[] = {8, 5, 0, 7, 18};  // B, C, D, E, F
+  EXPECT_TRUE(inputs.begin(fivePorts, 5));
+  EXPECT_EQ(5, inputs.ports());
+}
+
+// Event and Cooldown Tests
+class TriggerInputsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::reset();
+    sim::advanceMicros(10000000);
+    inputs.reset(new TriggerInputs<uint16_t>(2, 3000));
+    ASSERT_TRUE(inputs->begin(REPLAY_PINS, REPLAY_INPUTS));
+  }
+
+  // Loop passes covering `ms`, collecting events
+  void runFor(unsigned long ms) {
+    unsigned long start = millis();
+    while (millis() - start < ms) {
+      inputs->update(millis(), [this](const TriggerInputEvent& e) { events.push_back(e); });
+      sim::advanceMicros(LOOP_PASS_MICROS);
+    }
+  }
+
+  void press(uint8_t input, unsigned long holdMs) {
+    sim::setPin(REPLAY_PINS[input], LOW);
+    runFor(holdMs);
+    sim::setPin(REPLAY_PINS[input], HIGH);
+    runFor(50);
+  }
+
+  std::unique_ptr<TriggerInputs<uint16_t>> inputs;
+  std::vector<TriggerInputEvent> events;
+};
+
+TEST_F(TriggerInputsTest, PressAndReleaseAfterFourSamples) {
+  unsigned long pressedAt = millis();
+  press(4, 100);
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(4, events[0].input);
+  EXPECT_EQ(INPUT_PRESSED, events[0].type);
+  EXPECT_GE(events[0].millis - pressedAt, 6u);   // Three periods at least...
+  EXPECT_LE(events[0].millis - pressedAt, 10u);  // ...five at most
+  EXPECT_EQ(INPUT_RELEASED, events[1].type);
+}
+
+TEST_F(TriggerInputsTest, CooldownIsPerInput) {
+  press(0, 100);
+  press(1, 100);  // Another input: not held up by input 0's cooldown
+  press(0, 100);  // Input 0 again: cooldown
+  ASSERT_EQ(5u, events.size());
+  EXPECT_EQ(INPUT_PRESSED, events[2].type);
+  EXPECT_EQ(1, events[2].input);
+  EXPECT_EQ(INPUT_COOLDOWN, events[4].type);
+  EXPECT_EQ(0, events[4].input);
+  EXPECT_NEAR(3000 - (events[4].millis - events[0].millis), events[4].value, 1);
+
+  runFor(3000);
+  press(0, 100);
+  ASSERT_EQ(7u, events.size());
+  EXPECT_EQ(INPUT_PRESSED, events[5].type);  // Cooldown over
+}
+
+TEST_F(TriggerInputsTest, SetCooldownAndReset) {
+  inputs->setCooldown(2, 0);
+  press(2, 100);
+  press(2, 100);
+  EXPECT_EQ(4u, events.size());  // No cooldown on input 2
+
+  events.clear();
+  press(3, 100);
+  inputs->resetCooldowns();
+  press(3, 100);
+  ASSERT_EQ(4u, events.size());
+  EXPECT_EQ(INPUT_PRESSED, events[2].type);
+}
+
+TEST_F(TriggerInputsTest, SamplesOnItsPeriodAndNeverBursts) {
+  sim::setPin(REPLAY_PINS[0], LOW);
+  inputs->update(millis(), [](const TriggerInputEvent&) {});
+  sim::advanceMicros(500000);  // A stalled loop
+  int pressed = 0;
+  for (int i = 0; i < 3; i++) {
+    inputs->update(millis(), [&](const TriggerInputEvent&) { pressed++; });
+  }
+  EXPECT_EQ(0, pressed);  // One sample per due period, not a catch-up burst
+  EXPECT_EQ(0, inputs->pressed());
+}
+
+TEST_F(TriggerInputsTest, HeldAtStartupIsAPress) {
+  sim::setPin(REPLAY_PINS[7], LOW);
+  ASSERT_TRUE(inputs->begin(REPLAY_PINS, REPLAY_INPUTS));
+  runFor(20);
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(7, events[0].input);
+  EXPECT_EQ(1 << 7, inputs->pressed());
+}
+
+// Trace Replay
+struct Trace {
+  std::string name;
+  std::vector<std::string> channels;
+  std::vector<std::pair<uint64_t, std::vector<uint8_t>>> rows;  // (micros, levels)
+  std::vector<std::pair<int, std::string>> expected;
+  unsigned sampleMillis = 2;
+  unsigned long cooldownMillis = 3000;
+};
+
+struct ReplayEvent {
+  TriggerInputEvent event;
+  uint64_t settledMicros;  // Last edge of that input before the event
+};
+
+static const char* eventName(uint8_t type) {
+  return type == INPUT_PRESSED ? "PRESSED" : type == INPUT_RELEASED ? "RELEASED" : "COOLDOWN";
+}
+
+static bool loadTrace(const std::string& path, Trace& trace) {
+  std::ifstream in(path);
+  if (!in) return false;
+  trace.name = std::filesystem::path(path).filename().string();
+  std::string line;
+  bool seconds = true;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.empty()) continue;
+    std::istringstream fields(line);
+    if (line[0] == '#') {
+      std::string hash, key;
+      fields >> hash >> key;
+      if (key == "expect") {
+        int input;
+        std::string type;
+        fields >> input >> type;
+        trace.expected.push_back(std::make_pair(input, type));
+      } else if (key == "sample_ms") {
+        fields >> trace.sampleMillis;
+      } else if (key == "cooldown_ms") {
+        fields >> trace.cooldownMillis;
+      }
+      continue;
+    }
+    std::string cell;
+    std::vector<std::string> cells;
+    while (std::getline(fields, cell, ',')) cells.push_back(cell);
+    if (trace.channels.empty() && !cells.empty() && !isdigit((unsigned char)cells[0][0])) {
+      seconds = cells[0].find("[us]") == std::string::npos;
+      trace.channels.assign(cells.begin() + 1, cells.end());
+      continue;
+    }
+    if (cells.size() != trace.channels.size() + 1) return false;
+    double t = atof(cells[0].c_str());
+    std::vector<uint8_t> levels;
+    for (size_t i = 1; i < cells.size(); i++) levels.push_back(atoi(cells[i].c_str()) ? HIGH : LOW);
+    trace.rows.push_back(std::make_pair((uint64_t)(seconds ? t * 1e6 + 0.5 : t), levels));
+  }
+  return !trace.channels.empty() && trace.channels.size() <= REPLAY_INPUTS;
+}
+
+// Play the trace's pin levels into the sim with loop passes every LOOP_PASS_MICROS
+static std::vector<ReplayEvent> replay(const Trace& trace) {
+  sim::reset();
+  sim::advanceMicros(1000000);
+  uint64_t origin = sim::nowMicros;
+  TriggerInputs<uint16_t> inputs(trace.sampleMillis, trace.cooldownMillis);
+  inputs.begin(REPLAY_PINS, trace.channels.size());
+
+  std::vector<ReplayEvent> events;
+  std::vector<uint64_t> lastEdge(trace.channels.size(), 0);
+  size_t row = 0;
+  uint64_t end = (trace.rows.empty() ? 0 : trace.rows.back().first) + 500000;
+  for (uint64_t pass = 0; pass <= end; pass += LOOP_PASS_MICROS) {
+    while (row < trace.rows.size() && trace.rows[row].first <= pass) {
+      sim::nowMicros = origin + trace.rows[row].first;
+      for (size_t i = 0; i < trace.channels.size(); i++) {
+        if (sim::pinLevel[REPLAY_PINS[i]] != trace.rows[row].second[i]) lastEdge[i] = trace.rows[row].first;
+        sim::setPin(REPLAY_PINS[i], trace.rows[row].second[i]);
+      }
+      row++;
+    }
+    sim::nowMicros = origin + pass;
+    inputs.update(millis(), [&](const TriggerInputEvent& e) {
+      events.push_back(ReplayEvent{e, lastEdge[e.input]});
+    });
+  }
+  return events;
+}
+
+static std::string traceDirectory() {
+  return (std::filesystem::path(__FILE__).parent_path() / "traces").string();
+}
+
+TEST(TraceReplay, EveryTraceGivesItsExpectedEvents) {
+  std::vector<std::string> paths;
+  for (const auto& entry : std::filesystem::directory_iterator(traceDirectory())) {
+    if (entry.path().extension() == ".csv") paths.push_back(entry.path().string());
+  }
+  std::sort(paths.begin(), paths.end());
+  ASSERT_FALSE(paths.empty()) << "no traces in " << traceDirectory();
+
+  for (const std::string& path : paths) {
+    Trace trace;
+    ASSERT_TRUE(loadTrace(path, trace)) << path;
+    std::vector<ReplayEvent> events = replay(trace);
+
+    // Per input, in order (inputs that settle in the same sample may swap)
+    std::map<int, std::vector<std::string>> expected, got;
+    for (const auto& e : trace.expected) expected[e.first].push_back(e.second);
+    uint64_t worstMicros = 0;
+    for (const ReplayEvent& r : events) {
+      got[r.event.input].push_back(eventName(r.event.type));
+      uint64_t latency = (uint64_t)r.event.millis * 1000 - 1000000 - r.settledMicros;
+      worstMicros = std::max(worstMicros, latency);
+      EXPECT_LE(latency, (VERTICAL_DEBOUNCE_SAMPLES + 1) * trace.sampleMillis * 1000UL + LOOP_PASS_MICROS)
+          << trace.name << ": input " << (int)r.event.input << " at " << r.event.millis << " ms";
+    }
+    EXPECT_EQ(expected, got) << trace.name;
+    printf("  %-18s %2zu inputs %3zu rows %3zu events, worst settle-to-event %.1f ms\n",
+           trace.name.c_str(), trace.channels.size(), trace.rows.size(), events.size(),
+           worstMicros / 1000.0);
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  if (argc > 1) {
+    Trace trace;
+    if (!loadTrace(argv[1], trace)) {
+      fprintf(stderr, "%s: not a trace (Time [s],<channels>... with at most %u channels)\n",
+              argv[1], REPLAY_INPUTS);
+      return 2;
+    }
+    if (argc > 2) trace.sampleMillis = (unsigned)atoi(argv[2]);
+    if (argc > 3) trace.cooldownMillis = (unsigned long)atol(argv[3]);
+    for (const ReplayEvent& r : replay(trace)) {
+      printf("%10.3f s  %-12s %-8s (%.1f ms after its last edge)\n", (r.event.millis - 1000) / 1000.0,
+             trace.channels[r.event.input].c_str(), eventName(r.event.type),
+             ((uint64_t)r.event.millis * 1000 - 1000000 - r.settledMicros) / 1000.0);
+    }
+    return 0;
+  }
+  return RUN_ALL_TESTS();
+}
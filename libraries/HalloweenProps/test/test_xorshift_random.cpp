@@ -0,0 +1,120 @@
+/*
+ * Unit Tests for Xorshift Random
+ *
+ * The generator must replay the same sequence from the same seed, never
+ * stick at zero, and draw every value of a range equally often without a
+ * divide - checked against a straightforward xorshift32 and a chi-square
+ * bound.
+ * Uses Google Test framework.
+ *
+ * Build and run (from hatching_egg/):
+ *   pixi run test-xorshift-random
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "Arduino.h"
+#include "xorshift_random.h"
+
+// Sequence Tests
+TEST(XorshiftRandom, MatchesXorshift32) {
+  // Marsaglia's 13/17/5 triple; from seed 1 the first value is 270369
+  XorshiftRandom rng(1);
+  uint32_t x = 1;
+  EXPECT_EQ(270369u, rng.next());
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  for (int i = 0; i < 1000; i++) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    ASSERT_EQ(x, rng.next()) << "call " << i;
+  }
+}
+
+TEST(XorshiftRandom, SameSeedSameSequence) {
+  XorshiftRandom a(1234), b(1234), c(4321);
+  bool differs = false;
+  for (int i = 0; i < 1000; i++) {
+    uint16_t fromA = a.below(181);
+    ASSERT_EQ(fromA, b.below(181));
+    differs |= fromA != c.below(181);
+  }
+  EXPECT_TRUE(differs);
+
+  a.seed(1234);
+  b.seed(1234);
+  EXPECT_EQ(a.state(), b.state());
+  EXPECT_EQ(a.next(), b.next());
+}
+
+TEST(XorshiftRandom, ZeroSeedStillRuns) {
+  XorshiftRandom rng(0);
+  EXPECT_EQ(XORSHIFT_ZERO_SEED, rng.state());
+  for (int i = 0; i < 1000; i++) ASSERT_NE(0u, rng.next());
+}
+
+// Range Tests
+TEST(XorshiftRandom, BelowStaysInRange) {
+  XorshiftRandom rng(7);
+  for (uint16_t n : {2, 3, 5, 31, 100, 181, 256, 257, 1000, 65535}) {
+    for (int i = 0; i < 2000; i++) ASSERT_LT(rng.below(n), n) << "n " << n;
+  }
+  EXPECT_EQ(0, rng.below(0));
+  EXPECT_EQ(0, rng.below(1));
+}
+
+TEST(XorshiftRandom, RangeIsHalfOpen) {
+  XorshiftRandom rng(7);
+  bool sawLow = false, sawHigh = false;
+  for (int i = 0; i < 10000; i++) {
+    long r = rng.range(-90, 91);
+    ASSERT_GE(r, -90);
+    ASSERT_LE(r, 90);
+    sawLow |= r == -90;
+    sawHigh |= r == 90;
+  }
+  EXPECT_TRUE(sawLow && sawHigh);
+  EXPECT_EQ(5, rng.range(5, 5));
+  EXPECT_EQ(5, rng.range(5, 2));
+}
+
+TEST(XorshiftRandom, BelowIsUniform) {
+  // Chi-square over every value; 99.9th percentile bounds for the degrees
+  // of freedom, so a fair generator fails about once in a thousand seeds
+  struct Case {
+    uint16_t n;
+    double bound;
+  };
+  for (Case c : {Case{2, 10.8}, Case{3, 13.8}, Case{100, 148.2}, Case{181, 241.6}}) {
+    XorshiftRandom rng(42);
+    std::vector<long> counts(c.n, 0);
+    const long draws = 200L * c.n;
+    for (long i = 0; i < draws; i++) counts[rng.below(c.n)]++;
+    double expected = (double)draws / c.n, chi2 = 0;
+    for (long count : counts) chi2 += (count - expected) * (count - expected) / expected;
+    EXPECT_LT(chi2, c.bound) << "n " << c.n;
+  }
+}
+
+TEST(XorshiftRandom, RejectsFewerThanHalfTheDraws) {
+  // 129 is the worst case under 256: mask 255, 127 of 256 rejected
+  XorshiftRandom counted(3), reference(3);
+  long draws = 0;
+  for (int i = 0; i < 10000; i++) {
+    uint16_t want = counted.below(129);
+    uint16_t r;
+    do {
+      r = (uint16_t)(reference.next() >> 16) & 255;
+      draws++;
+    } while (r >= 129);
+    ASSERT_EQ(want, r);
+  }
+  EXPECT_LT(draws, 2 * 10000);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,237 @@
+/*
+ * Trigger Inputs - Many Switches, Read a Port at a Time, Debounced in Parallel
+ *
+ * One switch can afford its own digitalRead(), timestamps and debounce
+ * state. A room with eight pressure mats and a few switches on one Beetle
+ * can't afford that eight times over. TriggerInputs samples every input
+ * on a fixed period by reading each port's PINx register once, then
+ * debounces all of them together with a vertical counter: bit i of two
+ * masks is a 2-bit counter for input i, so one sample of up to 32 inputs
+ * is a handful of AND/XOR instructions.
+ *
+ *   const uint8_t MAT_PINS[] = {8, 9, 10, 11, 14, 15, 16, 18, 19, 20};
+ *   TriggerInputs<uint16_t> mats(2, 3000);  // sample every 2 ms, 3 s cooldown
+ *
+ *   mats.begin(MAT_PINS, sizeof(MAT_PINS));  // in setup(): INPUT_PULLUP
+ *
+ *   mats.update(millis(), [](const TriggerInputEvent& e) {   // in loop()
+ *     if (e.type == INPUT_PRESSED) ...      // e.input = index in MAT_PINS
+ *   });
+ *
+ * An input changes state after VERTICAL_DEBOUNCE_SAMPLES samples in a row
+ * that disagree with it (8 ms at a 2 ms period); any sample that agrees
+ * starts the count again, so chatter and spikes shorter than that never
+ * get through. The cost is that fixed delay on every press and release.
+ *
+ * Each input has its own cooldown, as COOLDOWN_DELAY in motion_trigger:
+ * a press within the cooldown of that input's last accepted press is an
+ * INPUT_COOLDOWN event (value = ms left) and its release isn't reported.
+ *
+ * Inputs are active low (switch to GND, internal pull-up). The host sim
+ * keeps PINx registers in step with sim::setPin().
+ */
+
+#ifndef TRIGGER_INPUTS_H
+#define TRIGGER_INPUTS_H
+
+#include <Arduino.h>
+
+#define VERTICAL_DEBOUNCE_SAMPLES 4  // 2-bit counter: changes on the 4th sample
+#define TRIGGER_INPUT_MAX_PORTS 5    // B, C, D, E and F on the 32U4
+
+/**
+ * Vertical-counter debounce of up to sizeof(Mask) * 8 inputs at once.
+ * Pure logic: feed it raw samples, get the inputs that changed back.
+ */
+template <typename Mask>
+class VerticalDebouncer {
+ public:
+  explicit VerticalDebouncer(Mask initial = 0) : state_(initial) {}
+
+  /**
+   * One raw sample (bit set = active); returns the bits whose debounced
+   * state flipped on this sample
+   */
+  Mask sample(Mask raw) {
+    Mask delta = raw ^ state_;              // Disagrees with the debounced state
+    Mask changed = delta & count0_ & count1_;  // Fourth disagreeing sample in a row
+    count1_ = (count1_ ^ count0_) & delta;  // Count up where it disagrees,
+    count0_ = ~count0_ & delta;             // back to 0 where it agrees
+    state_ ^= changed;
+    return changed;
+  }
+
+  Mask state() const { return state_; }
+
+ private:
+  Mask state_;
+  Mask count0_ = 0;  // Low bit of each input's counter
+  Mask count1_ = 0;  // High bit
+};
+
+/**
+ * A list of pins, read one PINx register per port and packed into a mask
+ * in list order
+ */
+template <typename Mask>
+class PortInputs {
+ public:
+  static const uint8_t MAX_INPUTS = sizeof(Mask) * 8;
+
+  /**
+   * INPUT_PULLUP on every pin. False if there are too many pins, one has
+   * no port, or they span more than TRIGGER_INPUT_MAX_PORTS ports.
+   */
+  bool begin(const uint8_t* pins, uint8_t count) {
+    count_ = 0;
+    ports_ = 0;
+    if (count > MAX_INPUTS) return false;
+    for (uint8_t i = 0; i < count; i++) {
+      uint8_t port = digitalPinToPort(pins[i]);
+      if (port == NOT_A_PORT) return false;
+      uint8_t slot = 0;
+      while (slot < ports_ && portId_[slot] != port) slot++;
+      if (slot == ports_) {
+        if (ports_ == TRIGGER_INPUT_MAX_PORTS) return false;
+        portId_[slot] = port;
+        registers_[slot] = portInputRegister(port);
+        ports_++;
+      }
+      pinMode(pins[i], INPUT_PULLUP);
+      portSlot_[i] = slot;
+      bitMask_[i] = digitalPinToBitMask(pins[i]);
+    }
+    count_ = count;
+    return true;
+  }
+
+  /**
+   * Every input at once: bit i set if input i is active (pin LOW)
+   */
+  Mask read() const {
+    uint8_t levels[TRIGGER_INPUT_MAX_PORTS];
+    for (uint8_t p = 0; p < ports_; p++) levels[p] = *registers_[p];  // One read per port
+    Mask active = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+      if (!(levels[portSlot_[i]] & bitMask_[i])) active |= (Mask)1 << i;
+    }
+    return active;
+  }
+
+  uint8_t count() const { return count_; }
+  uint8_t ports() const { return ports_; }
+
+ private:
+  volatile uint8_t* registers_[TRIGGER_INPUT_MAX_PORTS];
+  uint8_t portId_[TRIGGER_INPUT_MAX_PORTS];
+  uint8_t portSlot_[MAX_INPUTS];
+  uint8_t bitMask_[MAX_INPUTS];
+  uint8_t ports_ = 0;
+  uint8_t count_ = 0;
+};
+
+enum TriggerInputEventType {
+  INPUT_PRESSED = 1,  // Accepted press (cooldown over)
+  INPUT_RELEASED,     // Release of an accepted press
+  INPUT_COOLDOWN      // Press inside the input's cooldown; value = ms left
+};
+
+struct TriggerInputEvent {
+  uint8_t input;    // Index in the pin list
+  uint8_t type;     // TriggerInputEventType
+  uint32_t millis;  // The sample that confirmed it
+  uint16_t value;
+};
+
+/**
+ * PortInputs + VerticalDebouncer on a fixed sample period, with a
+ * cooldown per input
+ */
+template <typename Mask>
+class TriggerInputs {
+ public:
+  static const uint8_t MAX_INPUTS = PortInputs<Mask>::MAX_INPUTS;
+
+  TriggerInputs(uint8_t samplePeriodMillis, uint32_t cooldownMillis)
+      : period_(samplePeriodMillis) {
+    for (uint8_t i = 0; i < MAX_INPUTS; i++) cooldown_[i] = cooldownMillis;
+  }
+
+  bool begin(const uint8_t* pins, uint8_t count) {
+    if (!inputs_.begin(pins, count)) return false;
+    debouncer_ = VerticalDebouncer<Mask>();  // Held at power-up: a press, once debounced
+    armed_ = 0;
+    cooling_ = 0;
+    started_ = false;
+    return true;
+  }
+
+  void setCooldown(uint8_t input, uint32_t cooldownMillis) {
+    if (input < MAX_INPUTS) cooldown_[input] = cooldownMillis;
+  }
+
+  // Every input ready to trigger again (the RESET command)
+  void resetCooldowns() { cooling_ = 0; }
+
+  /**
+   * Call every loop pass. Takes a sample when one is due and calls
+   * onEvent(const TriggerInputEvent&) for each input that changed, lowest
+   * input first. Returns the inputs that changed.
+   */
+  template <typename Handler>
+  Mask update(uint32_t nowMillis, Handler onEvent) {
+    if (!started_) {
+      nextSample_ = nowMillis;
+      started_ = true;
+    }
+    if ((int32_t)(nowMillis - nextSample_) < 0) return 0;
+    nextSample_ += period_;
+    if ((int32_t)(nowMillis - nextSample_) >= 0) nextSample_ = nowMillis + period_;  // Fell behind: no burst
+
+    Mask changed = debouncer_.sample(inputs_.read());
+    Mask pressed = debouncer_.state();
+    for (uint8_t i = 0; i < inputs_.count(); i++) {
+      Mask bit = (Mask)1 << i;
+      if (!(changed & bit)) continue;
+      TriggerInputEvent event;
+      event.input = i;
+      event.millis = nowMillis;
+      event.value = 0;
+      if (pressed & bit) {
+        uint32_t since = nowMillis - lastPress_[i];
+        if ((cooling_ & bit) && since <= cooldown_[i]) {
+          event.type = INPUT_COOLDOWN;
+          event.value = (uint16_t)min(cooldown_[i] - since, 0xFFFFUL);
+        } else {
+          event.type = INPUT_PRESSED;
+          lastPress_[i] = nowMillis;
+          armed_ |= bit;
+          cooling_ |= bit;
+        }
+      } else {
+        if (!(armed_ & bit)) continue;
+        armed_ &= ~bit;
+        event.type = INPUT_RELEASED;
+      }
+      onEvent(event);
+    }
+    return changed;
+  }
+
+  Mask pressed() const { return debouncer_.state(); }  // Debounced, bit per input
+  uint8_t count() const { return inputs_.count(); }
+  uint8_t ports() const { return inputs_.ports(); }
+
+ private:
+  PortInputs<Mask> inputs_;
+  VerticalDebouncer<Mask> debouncer_;
+  uint8_t period_;
+  uint32_t nextSample_ = 0;
+  bool started_ = false;
+  Mask armed_ = 0;    // Accepted press not yet released
+  Mask cooling_ = 0;  // Has a lastPress_ that may still be in cooldown
+  uint32_t lastPress_[MAX_INPUTS];
+  uint32_t cooldown_[MAX_INPUTS];
+};
+
+#endif // TRIGGER_INPUTS_H
@@ -0,0 +1,79 @@
+/*
+ * Xorshift Random - Small Seedable Generator With Division-Free Ranges
+ *
+ * Arduino's random(min, max) is avr-libc's random() - Park-Miller, two
+ * 32-bit divides per number - followed by a 32-bit modulo for the range:
+ * three calls into libgcc's software divide (several hundred cycles each
+ * on the 32U4). XorshiftRandom is Marsaglia's xorshift32: three shifts and
+ * three XORs per number, and ranges are drawn by masking to the next power
+ * of two and retrying the (under half of) draws that land past the end,
+ * so they are exactly uniform with no divide or multiply:
+ *
+ *   XorshiftRandom rng(seed);      // same seed, same sequence, any board
+ *
+ *   uint16_t r = rng.below(181);   // 0-180
+ *   long d = rng.range(-90, 91);   // -90 to 90, as random(-90, 91)
+ *
+ * Not for anything that needs to be unpredictable to an attacker - it's
+ * for props.
+ */
+
+#ifndef XORSHIFT_RANDOM_H
+#define XORSHIFT_RANDOM_H
+
+#include <Arduino.h>
+
+#define XORSHIFT_ZERO_SEED 0x9E3779B9UL  // Zero would repeat forever; use this instead
+
+class XorshiftRandom {
+ public:
+  explicit XorshiftRandom(uint32_t seed = 1) { this->seed(seed); }
+
+  void seed(uint32_t seed) { state_ = seed ? seed : XORSHIFT_ZERO_SEED; }
+
+  // Never 0; period 2^32 - 1
+  uint32_t next() {
+    uint32_t x = state_;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state_ = x;
+    return x;
+  }
+
+  /**
+   * 0 to n - 1, uniformly (0 if n is 0). Masks the upper 16 bits of each
+   * draw (the better mixed half; a fixed shift is one register move on the
+   * AVR, where shifting by 32 - bits would be a loop), so for n up to 2^k
+   * it reads bits 16 to 16 + k - 1. Fewer than 2 draws on average.
+   */
+  uint16_t below(uint16_t n) {
+    if (n <= 1) return 0;
+    uint16_t mask = n - 1;
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+    mask |= mask >> 8;
+    uint16_t r;
+    do {
+      r = (uint16_t)(next() >> 16) & mask;
+    } while (r >= n);
+    return r;
+  }
+
+  /**
+   * min to max - 1, as Arduino random(min, max) (min if max <= min);
+   * max - min up to 65535
+   */
+  long range(long min, long max) {
+    if (min >= max) return min;
+    return min + below((uint16_t)(max - min));
+  }
+
+  uint32_t state() const { return state_; }
+
+ private:
+  uint32_t state_;
+};
+
+#endif // XORSHIFT_RANDOM_H
@@ -9,11 +9,20 @@
  * - Right Shoulder (CH1): 150 (0°) to 280 (90°)  - normal
  * - Left Shoulder (CH14): 440 (0°) to 300 (90°)  - inverted
  * - Left Elbow (CH15):    530 (0°) to 360 (90°)  - inverted
+ *
+ * degreesToPWM() reads the same compile-time tables every sketch's servo
+ * output uses (servo_lut.h in ../HalloweenProps), so there is one rounding
+ * and clamping rule for all of them.
+ *
+ * An Arduino library so the egg's sketches share one copy: compile with
+ * `--libraries ../libraries`, host builds with -I../libraries/HatchingEgg.
  */
 
 #ifndef SERVO_MAPPING_V2_H
 #define SERVO_MAPPING_V2_H
 
+#include <servo_lut.h>
+
 // Servo indices
 #define SERVO_RIGHT_ELBOW 0
 #define SERVO_RIGHT_SHOULDER 1
@@ -26,6 +35,20 @@
 #define CH_LEFT_SHOULDER 14
 #define CH_LEFT_ELBOW 15
 
+// Calibrated pulse ends (PCA9685 ticks at 0° and 90°), once for this
+// header. The source is animation-config.json (the generated
+// *_MIN_PULSE/*_MAX_PULSE); the sweep test has no generated config, so
+// they're repeated here and test-cpp's ConfigMatchesCalibratedRanges
+// checks the two agree.
+#define PWM_RIGHT_ELBOW_0 150
+#define PWM_RIGHT_ELBOW_90 330
+#define PWM_RIGHT_SHOULDER_0 150
+#define PWM_RIGHT_SHOULDER_90 280
+#define PWM_LEFT_SHOULDER_0 440   // Inverted
+#define PWM_LEFT_SHOULDER_90 300
+#define PWM_LEFT_ELBOW_0 530      // Inverted
+#define PWM_LEFT_ELBOW_90 360
+
 // Per-servo PWM ranges (calibrated with hardware)
 struct ServoPWMRange {
     int min_pwm;  // PWM value for 0°
@@ -35,11 +58,26 @@ struct ServoPWMRange {
 // Calibrated ranges for each servo
 inline ServoPWMRange getServoPWMRange(int servoIndex) {
     switch (servoIndex) {
-        case SERVO_RIGHT_ELBOW:    return {150, 330};  // Normal: 0°=150, 90°=330
-        case SERVO_RIGHT_SHOULDER: return {150, 280};  // Normal: 0°=150, 90°=280
-        case SERVO_LEFT_SHOULDER:  return {440, 300};  // Inverted: 0°=440, 90°=300
-        case SERVO_LEFT_ELBOW:     return {530, 360};  // Inverted: 0°=530, 90°=360
-        default:                   return {150, 330};  // Fallback
+        case SERVO_RIGHT_ELBOW:    return {PWM_RIGHT_ELBOW_0, PWM_RIGHT_ELBOW_90};
+        case SERVO_RIGHT_SHOULDER: return {PWM_RIGHT_SHOULDER_0, PWM_RIGHT_SHOULDER_90};
+        case SERVO_LEFT_SHOULDER:  return {PWM_LEFT_SHOULDER_0, PWM_LEFT_SHOULDER_90};
+        case SERVO_LEFT_ELBOW:     return {PWM_LEFT_ELBOW_0, PWM_LEFT_ELBOW_90};
+        default:                   return {PWM_RIGHT_ELBOW_0, PWM_RIGHT_ELBOW_90};  // Fallback
+    }
+}
+
+// The same ranges as PROGMEM tables (servo_lut.h), 0-90°
+typedef ServoPulseTable<PWM_RIGHT_ELBOW_0, PWM_RIGHT_ELBOW_90> RightElbowPWM;
+typedef ServoPulseTable<PWM_RIGHT_SHOULDER_0, PWM_RIGHT_SHOULDER_90> RightShoulderPWM;
+typedef ServoPulseTable<PWM_LEFT_SHOULDER_0, PWM_LEFT_SHOULDER_90> LeftShoulderPWM;
+typedef ServoPulseTable<PWM_LEFT_ELBOW_0, PWM_LEFT_ELBOW_90> LeftElbowPWM;
+
+inline ServoCalibration getServoCalibration(int servoIndex) {
+    switch (servoIndex) {
+        case SERVO_RIGHT_SHOULDER: return SERVO_CALIBRATION(RightShoulderPWM);
+        case SERVO_LEFT_SHOULDER:  return SERVO_CALIBRATION(LeftShoulderPWM);
+        case SERVO_LEFT_ELBOW:     return SERVO_CALIBRATION(LeftElbowPWM);
+        default:                   return SERVO_CALIBRATION(RightElbowPWM);  // Fallback
     }
 }
 
@@ -74,20 +112,10 @@ inline int mapValue(int value, int fromMin, int fromMax, int toMin, int toMax) {
  * @return PWM value constrained to servo's safe range
  */
 inline int degreesToPWM(int degrees, int servoIndex) {
-    // Constrain angle to safe range
-    degrees = constrainValue(degrees, 0, 90);
-
-    // Get calibrated range for this servo
-    ServoPWMRange range = getServoPWMRange(servoIndex);
-
-    // Map angle to PWM (handles both normal and inverted ranges)
-    int pwm = mapValue(degrees, 0, 90, range.min_pwm, range.max_pwm);
-
-    // Constrain to safe range (handles inverted ranges correctly)
-    int pwmMin = (range.min_pwm < range.max_pwm) ? range.min_pwm : range.max_pwm;
-    int pwmMax = (range.min_pwm > range.max_pwm) ? range.min_pwm : range.max_pwm;
-
-    return constrainValue(pwm, pwmMin, pwmMax);
+    // Constrained to 0-90° and mapped like map() (normal and inverted
+    // ranges alike), one table read
+    ServoCalibration calibration = getServoCalibration(servoIndex);
+    return servoLutLookup(calibration.table, calibration.maxDegrees, degrees);
 }
 
 /**
@@ -17,10 +17,14 @@
 
 #include <Wire.h>
 #include <Adafruit_PWMServoDriver.h>
+#include <pca9685_batch.h>
+#include <servo_lut.h>
+#include <servo_output.h>
 
 // PCA9685 setup
 #define PCA9685_ADDRESS 0x40
 Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(PCA9685_ADDRESS);
+PCA9685Batch servoBatch(PCA9685_ADDRESS);
 
 // Servo channels
 #define HEAD_CHANNEL 0
@@ -34,6 +38,13 @@ Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(PCA9685_ADDRESS);
 #define SERVOMAX  2400  // Maximum pulse (adjust if needed)
 #define SERVO_CENTER 1500 // Center position
 #define SERVO_FREQ 50
+#define SERVO_PERIOD_US (1000000L / SERVO_FREQ)
+
+// Servo index = channel (0=Head, 1=LeftArm, 2=RightArm), clamped to
+// SERVOMIN-SERVOMAX. Raw PWM ('r') and manual calibration ('m') go
+// around it to reach past that window.
+typedef ServoPulseTable<SERVOMIN, SERVOMAX, 180, SERVO_PERIOD_US> ServoAngleTable;
+ServoOutput<3> servos(servoBatch);
 
 #define LED_PIN 13
 
@@ -58,6 +69,9 @@ void setup() {
   Wire.begin();
   Serial.println(F("> Init I2C..."));
   delay(100);
+  for (uint8_t i = 0; i < 3; i++) {
+    servos.attach(i, i, SERVO_CALIBRATION(ServoAngleTable));
+  }
 
   testI2C();
 
@@ -280,24 +294,25 @@ void centerAllServos() {
 
 void disableAllServos() {
   // Turn off PWM signal - servos will stop holding position
-  pwm.setPWM(HEAD_CHANNEL, 0, 0);
-  pwm.setPWM(LEFT_ARM_CHANNEL, 0, 0);
-  pwm.setPWM(RIGHT_ARM_CHANNEL, 0, 0);
+  servos.off(HEAD_CHANNEL);
+  servos.off(LEFT_ARM_CHANNEL);
+  servos.off(RIGHT_ARM_CHANNEL);
+  servos.flush();
 }
 
 void setServoPulse(uint8_t ch, int pulse_us) {
   // Convert microseconds to PWM value (0-4095)
   // At 50Hz, period = 20,000us, each tick = 20000/4096 = 4.88us
-  // Use long to prevent integer overflow (pulse_us * 4096 can exceed 32767)
-  int pwmVal = ((long)pulse_us * 4096) / 20000;
-  pwm.setPWM(ch, 0, pwmVal);
+  // (clamped to the servo's calibrated window)
+  servos.writeTicks(ch, servoMicrosToTicks(pulse_us, SERVO_PERIOD_US));
+  servos.flush();
 
   Serial.print(F("    CH"));
   Serial.print(ch);
   Serial.print(F(": "));
   Serial.print(pulse_us);
   Serial.print(F("us -> PWM "));
-  Serial.println(pwmVal);
+  Serial.println(servos.target(ch));
 }
 
 void rawPWMTest() {
@@ -319,12 +334,13 @@ void rawPWMTest() {
     Serial.print(((long)pwmValues[i] * 20000) / 4096);
     Serial.print(F("us) "));
 
-    // Direct call to PCA9685
+    // Direct call to PCA9685, past any calibration
     pwm.setPWM(HEAD_CHANNEL, 0, pwmValues[i]);
     delay(1000);
 
     Serial.println(F("(watch servo)"));
   }
+  servos.invalidate(HEAD_CHANNEL);  // Written behind ServoOutput's back
 
   Serial.println();
   Serial.println(F("  Done. Did servo move?"));
@@ -342,13 +358,18 @@ void manualCalibration() {
   for (int i = 0; i < numPulses; i++) {
     Serial.print(F("  Setting "));
     Serial.print(pulses[i]);
-    Serial.print(F("us... "));
+    Serial.print(F("us -> PWM "));
 
-    setServoPulse(HEAD_CHANNEL, pulses[i]);
+    // Direct call to PCA9685: the limits lie outside SERVOMIN-SERVOMAX
+    uint16_t ticks = servoMicrosToTicks(pulses[i], SERVO_PERIOD_US);
+    pwm.setPWM(HEAD_CHANNEL, 0, ticks);
+    Serial.print(ticks);
+    Serial.print(F("... "));
     delay(1000);
 
     Serial.println(F("(watch servo)"));
   }
+  servos.invalidate(HEAD_CHANNEL);  // Written behind ServoOutput's back
 
   Serial.println();
   Serial.println(F("  Done. Note which values caused:"));
@@ -360,8 +381,15 @@ void manualCalibration() {
 void setServoAngle(uint8_t ch, int angle) {
   angle = constrain(angle, 0, 180);
   currentAngles[ch] = angle;  // Track current angle
-  int pulse_us = map(angle, 0, 180, SERVOMIN, SERVOMAX);
-  setServoPulse(ch, pulse_us);
+  servos.write(ch, angle);
+  servos.flush();
+
+  Serial.print(F("    CH"));
+  Serial.print(ch);
+  Serial.print(F(": "));
+  Serial.print(angle);
+  Serial.print(F("° -> PWM "));
+  Serial.println(servos.target(ch));
 }
 
 void adjustServo(uint8_t ch, int delta) {
@@ -0,0 +1,29 @@
+/*
+ * Event Log Codes - twitching_servos.ino
+ *
+ * Everything the sketch reports while running its behavior cycle goes
+ * through the binary event log (event_log.h); the text lives only here, for
+ * the host decoder (pixi run decode-log, and the host sim). Servo targets
+ * (0-180) travel as single bytes: H in a, LA/RA packed into b.
+ */
+
+#ifndef TWITCHING_SERVOS_LOG_EVENTS_H
+#define TWITCHING_SERVOS_LOG_EVENTS_H
+
+#include <event_log.h>
+
+#define TWITCHING_SERVOS_EVENTS(X) \
+  X(EVT_STILL, 0x10, "STATE: Still for {c:ms} seconds") \
+  X(EVT_SLOW_MOVEMENT, 0x11, "STATE: Slow movement for {c:ms} seconds (targets: H:{a} LA:{b:lo} RA:{b:hi})") \
+  X(EVT_QUICK_JERK, 0x12, "STATE: QUICK JERK for {c} ms (targets: H:{a} LA:{b:lo} RA:{b:hi})") \
+  X(EVT_THRASH, 0x13, "  THRASH! New targets: H:{a} LA:{b:lo} RA:{b:hi}") \
+  X(EVT_CYCLE, 0x14, ">>> Starting cycle {a} of {b}") \
+  X(EVT_CYCLE_FRAMES, 0x15, "Frames: {b} ({c} skipped)") \
+  X(EVT_CENTER_PRESSED, 0x16, "*** CENTER BUTTON PRESSED *** Servos centered at 90, holding (release to resume)") \
+  X(EVT_CENTER_RELEASED, 0x17, "Button released - resuming behavior") \
+  X(EVT_CYCLE_BUS, 0x18, "I2C at {a}00 kHz: {b} frames, {c} bytes/frame") \
+  X(EVT_CYCLE_POWER, 0x19, "Servo current: avg {b} mA, peak {c} mA")
+
+enum { TWITCHING_SERVOS_EVENTS(EVENT_LOG_ENUM) };
+
+#endif // TWITCHING_SERVOS_LOG_EVENTS_H
@@ -0,0 +1,368 @@
+/*
+ * Twitching Behavior - Pure Behavior Engine (No Hardware Dependencies)
+ *
+ * Everything twitching_servos.ino decides - the cycle table, still / slow
+ * movement / quick jerk transitions, the arm extremes, thrash retargets and
+ * the servo motion itself - with the clock passed in and its own seedable
+ * random generator. The sketch feeds it micros() and writes the servos it
+ * reports as moved; host tools feed it a simulated clock and can run hours
+ * of show in seconds (fast_forward.cpp).
+ *
+ * All of a cycle's random choices are drawn together into a plan before
+ * the cycle starts, so the frame path only reads targets. Define
+ * TWITCH_SCHEDULE_ROUNDS before including this to draw whole rounds of
+ * the show at begin() instead.
+ *
+ *   TwitchingBehavior behavior(seed);       // same seed, same show
+ *
+ *   behavior.begin(micros(), onEvent);      // still state, cycle 1
+ *   uint8_t moved = behavior.update(micros(), onEvent);   // every frame
+ *   if (moved & TWITCH_AXIS_BIT(TWITCH_HEAD)) ... behavior.axis(TWITCH_HEAD)
+ *
+ * onEvent(const TwitchEvent&) is called for each state change, thrash and
+ * new cycle, for logging.
+ */
+
+#ifndef TWITCHING_BEHAVIOR_H
+#define TWITCHING_BEHAVIOR_H
+
+#include <motion_profile.h>
+#include <xorshift_random.h>
+
+// Rest positions (center positions when "still")
+const int HEAD_REST = 90;
+const int LEFT_ARM_REST = 90;
+const int RIGHT_ARM_REST = 90;
+const int CENTER_ANGLE = 90;  // Center button
+
+// Movement ranges - BOTH use full servo range for maximum impact
+const int SLOW_MOVEMENT_RANGE = 90;   // +/- 90 degrees - FULL RANGE slow sweeps (0-180°)
+const int QUICK_JERK_RANGE = 90;      // +/- 90 degrees - FULL RANGE quick jerks (0-180°)
+
+// Movement speeds: degrees/second, degrees/second^2 (the old per-pass steps
+// at their old pace: 1° per 10ms, 1° per 40ms, 15° per 10ms)
+const MotionProfile STILL_PROFILE = motionProfile(100, 400);   // Drift back to rest
+const MotionProfile SLOW_PROFILE = motionProfile(25, 50);      // Creepy slow sweeps
+const MotionProfile JERK_PROFILE = motionProfile(1500, 30000); // Full speed in 50ms
+
+const int SLOW_MOVEMENT_DELAY = 40;   // ms between head retarget rolls
+const int THRASH_DELAY = 100;         // ms between thrash retargets
+
+// Cycle definitions (time in milliseconds)
+// Different cycles for variety
+struct Cycle {
+  unsigned long stillDuration;
+  unsigned long slowMovementDuration;
+  unsigned long quickJerkDuration;
+};
+
+// Define 5 different behavior cycles
+// New behavior: slow movement is dominant (50-70%), less still time (20-40%)
+// Quick jerks LONGER for more visible violent thrashing
+const int NUM_CYCLES = 5;
+const Cycle cycles[NUM_CYCLES] = {
+  {3000, 12000, 800},   // 3s still, 12s slow, 0.8s jerk - LONGER for violence
+  {2000, 15000, 1000},  // 2s still, 15s slow, 1s jerk - LONGEST jerk
+  {4000, 10000, 600},   // 4s still, 10s slow, 0.6s jerk
+  {2500, 18000, 900},   // 2.5s still, 18s slow, 0.9s jerk - very long
+  {5000, 8000, 700}     // 5s still, 8s slow, 0.7s jerk
+};
+
+// Behavior state
+enum BehaviorState {
+  STATE_STILL,
+  STATE_SLOW_MOVEMENT,
+  STATE_QUICK_JERK
+};
+
+enum TwitchAxis {
+  TWITCH_HEAD,
+  TWITCH_LEFT_ARM,
+  TWITCH_RIGHT_ARM,
+  TWITCH_AXES
+};
+
+#define TWITCH_AXIS_BIT(axis) (1 << (axis))
+
+enum TwitchEventType {
+  TWITCH_STILL = 1,     // durationMillis
+  TWITCH_SLOW_MOVEMENT, // durationMillis, targets
+  TWITCH_QUICK_JERK,    // durationMillis, targets
+  TWITCH_THRASH,        // targets
+  TWITCH_CYCLE          // cycle (0-based) about to start
+};
+
+struct TwitchEvent {
+  uint8_t type;
+  uint8_t cycle;
+  int16_t targets[TWITCH_AXES];
+  uint32_t durationMillis;
+};
+
+// Precomputed schedule: how many rounds of the five cycles to draw at
+// begin(). 0 draws each cycle's plan as it starts (one plan in RAM);
+// N > 0 draws N rounds up front (5N plans, 154 bytes each) and replays
+// them in a ring, so update() never touches the generator.
+#ifndef TWITCH_SCHEDULE_ROUNDS
+#define TWITCH_SCHEDULE_ROUNDS 0
+#endif
+
+const int TWITCH_MAX_THRASHES = 9;         // (longest jerk - 1ms) / THRASH_DELAY
+const int TWITCH_MAX_HEAD_RETARGETS = 40;  // Of up to 449 rolls in an 18s sweep; 22 on average
+
+/**
+ * Everything random about one cycle, drawn when it's planned: the slow
+ * movement and jerk targets, the head's retargets during the slow
+ * movement (by 40ms roll number, first roll 1) and each thrash. Targets
+ * are 0-180.
+ */
+struct TwitchCyclePlan {
+  uint8_t slow[TWITCH_AXES];
+  uint8_t jerk[TWITCH_AXES];
+  uint8_t thrash[TWITCH_MAX_THRASHES][TWITCH_AXES];
+  uint8_t headRetargets;
+  uint16_t headRetargetRoll[TWITCH_MAX_HEAD_RETARGETS];
+  uint8_t headRetargetTo[TWITCH_MAX_HEAD_RETARGETS];
+};
+
+/**
+ * Draw cycle `c`'s plan from `random`, in show order: slow movement
+ * targets, its head rolls, jerk targets, thrashes
+ */
+inline void planTwitchCycle(TwitchCyclePlan* plan, uint8_t c, XorshiftRandom* random) {
+  // HEAD: Keep random full range (working perfectly)
+  plan->slow[TWITCH_HEAD] = HEAD_REST + random->range(-SLOW_MOVEMENT_RANGE, SLOW_MOVEMENT_RANGE + 1);
+
+  // ARMS: Always go to EXTREMES for dramatic effect (no small movements!)
+  // Pick extreme positions: either very low (0-30°) or very high (150-180°)
+  // This creates "pulling up" or "dropping down" effect
+  bool pullUp = random->below(2);  // 0 or 1
+
+  if (pullUp) {
+    // Pulling up - arms go high (one higher than the other)
+    plan->slow[TWITCH_LEFT_ARM] = random->range(150, 181);   // 150-180° (very high)
+    plan->slow[TWITCH_RIGHT_ARM] = random->below(31);        // 0-30° (very low)
+  } else {
+    // Dropping down - arms go low/reversed
+    plan->slow[TWITCH_LEFT_ARM] = random->below(31);         // 0-30° (very low)
+    plan->slow[TWITCH_RIGHT_ARM] = random->range(150, 181);  // 150-180° (very high)
+  }
+
+  // Occasionally change head target (head motion is perfect, keep this).
+  // A full plan (about 1 sweep in 10000) holds its last target.
+  plan->headRetargets = 0;
+  uint16_t roll = 1;
+  for (unsigned long at = SLOW_MOVEMENT_DELAY; at < cycles[c].slowMovementDuration; at += SLOW_MOVEMENT_DELAY) {
+    if (plan->headRetargets == TWITCH_MAX_HEAD_RETARGETS) break;
+    if (random->below(100) < 5) {  // 5% chance every 40ms
+      plan->headRetargetRoll[plan->headRetargets] = roll;
+      plan->headRetargetTo[plan->headRetargets] =
+          HEAD_REST + random->range(-SLOW_MOVEMENT_RANGE, SLOW_MOVEMENT_RANGE + 1);
+      plan->headRetargets++;
+    }
+    roll++;
+  }
+
+  // HEAD: Keep random full range (working perfectly)
+  plan->jerk[TWITCH_HEAD] = HEAD_REST + random->range(-QUICK_JERK_RANGE, QUICK_JERK_RANGE + 1);
+
+  // ARMS: CHAOTIC movement - random extreme positions (frustrated/escaping)
+  // Not necessarily opposite - adds to the chaotic/frustrated feeling
+  plan->jerk[TWITCH_LEFT_ARM] = random->below(181);   // Anywhere from 0-180° (chaotic)
+  plan->jerk[TWITCH_RIGHT_ARM] = random->below(181);  // Anywhere from 0-180° (chaotic)
+
+  // THRASH: NEW random extreme positions every 100ms through the jerk
+  uint8_t thrash = 0;
+  for (unsigned long at = THRASH_DELAY; at < cycles[c].quickJerkDuration && thrash < TWITCH_MAX_THRASHES;
+       at += THRASH_DELAY) {
+    for (uint8_t i = 0; i < TWITCH_AXES; i++) plan->thrash[thrash][i] = random->below(181);
+    thrash++;
+  }
+}
+
+/**
+ * The engine, with `Rounds` rounds of cycles precomputed (see
+ * TWITCH_SCHEDULE_ROUNDS). Use the TwitchingBehavior typedef below.
+ */
+template <uint8_t Rounds>
+class TwitchingBehaviorT {
+ public:
+  static const uint8_t PLANS = Rounds ? Rounds * NUM_CYCLES : 1;
+
+  explicit TwitchingBehaviorT(uint32_t seed = 1) : seed_(seed) {
+    targets_[TWITCH_HEAD] = HEAD_REST;
+    targets_[TWITCH_LEFT_ARM] = LEFT_ARM_REST;
+    targets_[TWITCH_RIGHT_ARM] = RIGHT_ARM_REST;
+    for (uint8_t i = 0; i < TWITCH_AXES; i++) axes_[i].jumpTo(targets_[i]);
+  }
+
+  /**
+   * Start cycle 1 with its still period at `nowMicros`. Reseeds, so every
+   * begin() starts the same show; with a schedule, draws all of it here.
+   */
+  template <typename Handler>
+  void begin(uint32_t nowMicros, Handler onEvent) {
+    random_.seed(seed_);
+    cycle_ = 0;
+    plan_ = 0;
+    for (uint8_t p = 0; p < PLANS; p++) planTwitchCycle(&plans_[p], p % NUM_CYCLES, &random_);
+    for (uint8_t i = 0; i < TWITCH_AXES; i++) axes_[i].restart(nowMicros);
+    startStill(nowMicros, onEvent);
+  }
+
+  /**
+   * Advance to `nowMicros`: move the servos up to now, then change state
+   * or targets if it's time. Returns the TWITCH_AXIS_BITs of the servos
+   * that moved.
+   */
+  template <typename Handler>
+  uint8_t update(uint32_t nowMicros, Handler onEvent) {
+    uint8_t moved = 0;
+    for (uint8_t i = 0; i < TWITCH_AXES; i++) {
+      if (axes_[i].update(nowMicros)) moved |= TWITCH_AXIS_BIT(i);
+    }
+
+    // Check if current state duration has elapsed
+    if (nowMicros - stateStart_ >= duration_ * 1000UL) {
+      next(nowMicros, onEvent);
+    }
+
+    const TwitchCyclePlan& plan = plans_[plan_];
+    if (state_ == STATE_SLOW_MOVEMENT) {
+      // Head retargets on the rolls the plan picked
+      while (nowMicros - lastRoll_ >= SLOW_MOVEMENT_DELAY * 1000UL) {
+        roll_++;
+        if (retarget_ < plan.headRetargets && plan.headRetargetRoll[retarget_] == roll_) {
+          targets_[TWITCH_HEAD] = plan.headRetargetTo[retarget_++];
+          axes_[TWITCH_HEAD].moveTo(targets_[TWITCH_HEAD], SLOW_PROFILE);
+        }
+        // DON'T change arm targets during slow movement - let them complete the full sweep!
+        lastRoll_ += SLOW_MOVEMENT_DELAY * 1000UL;
+      }
+    } else if (state_ == STATE_QUICK_JERK) {
+      // THRASH: NEW extreme positions every 100ms - violent back-and-forth
+      // movement instead of just one motion
+      if (nowMicros - lastThrash_ >= THRASH_DELAY * 1000UL && thrash_ < TWITCH_MAX_THRASHES) {
+        for (uint8_t i = 0; i < TWITCH_AXES; i++) targets_[i] = plan.thrash[thrash_][i];
+        thrash_++;
+        aim(JERK_PROFILE);
+        lastThrash_ += THRASH_DELAY * 1000UL;
+        if (nowMicros - lastThrash_ >= THRASH_DELAY * 1000UL) lastThrash_ = nowMicros;  // Fell behind: no burst
+        emit(TWITCH_THRASH, 0, onEvent);
+      }
+    }
+    return moved;
+  }
+
+  /**
+   * Center button: every servo to CENTER_ANGLE at once, stopped
+   */
+  void center() {
+    for (uint8_t i = 0; i < TWITCH_AXES; i++) axes_[i].jumpTo(CENTER_ANGLE);
+  }
+
+  /**
+   * Center button released: the current cycle starts over from its still
+   * period, with the same plan, and time spent centered isn't caught up on
+   */
+  template <typename Handler>
+  void resume(uint32_t nowMicros, Handler onEvent) {
+    for (uint8_t i = 0; i < TWITCH_AXES; i++) axes_[i].restart(nowMicros);
+    startStill(nowMicros, onEvent);
+  }
+
+  BehaviorState state() const { return state_; }
+  uint8_t cycle() const { return cycle_; }
+  int16_t target(uint8_t axis) const { return targets_[axis]; }
+  const MotionAxis& axis(uint8_t axis) const { return axes_[axis]; }
+  const TwitchCyclePlan& plan() const { return plans_[plan_]; }
+
+ private:
+  // State machine: Still -> Slow Movement -> Quick Jerk -> (next cycle) Still
+  template <typename Handler>
+  void next(uint32_t nowMicros, Handler onEvent) {
+    if (state_ == STATE_STILL) {
+      startSlowMovement(nowMicros, onEvent);
+    } else if (state_ == STATE_SLOW_MOVEMENT) {
+      startQuickJerk(nowMicros, onEvent);
+    } else {
+      cycle_ = (cycle_ + 1) % NUM_CYCLES;
+      if (Rounds) {
+        if (++plan_ == PLANS) plan_ = 0;  // Schedule ring
+      } else {
+        planTwitchCycle(&plans_[0], cycle_, &random_);
+      }
+      TwitchEvent event = {TWITCH_CYCLE, cycle_, {0, 0, 0}, 0};
+      onEvent(event);
+      startStill(nowMicros, onEvent);
+    }
+  }
+
+  template <typename Handler>
+  void startStill(uint32_t nowMicros, Handler onEvent) {
+    enter(STATE_STILL, cycles[cycle_].stillDuration, nowMicros);
+    targets_[TWITCH_HEAD] = HEAD_REST;
+    targets_[TWITCH_LEFT_ARM] = LEFT_ARM_REST;
+    targets_[TWITCH_RIGHT_ARM] = RIGHT_ARM_REST;
+    aim(STILL_PROFILE);
+    emit(TWITCH_STILL, duration_, onEvent);
+  }
+
+  template <typename Handler>
+  void startSlowMovement(uint32_t nowMicros, Handler onEvent) {
+    enter(STATE_SLOW_MOVEMENT, cycles[cycle_].slowMovementDuration, nowMicros);
+    lastRoll_ = nowMicros;
+    roll_ = 0;
+    retarget_ = 0;
+    for (uint8_t i = 0; i < TWITCH_AXES; i++) targets_[i] = plans_[plan_].slow[i];
+    aim(SLOW_PROFILE);
+    emit(TWITCH_SLOW_MOVEMENT, duration_, onEvent);
+  }
+
+  template <typename Handler>
+  void startQuickJerk(uint32_t nowMicros, Handler onEvent) {
+    enter(STATE_QUICK_JERK, cycles[cycle_].quickJerkDuration, nowMicros);
+    lastThrash_ = nowMicros;  // First thrash 100ms in
+    thrash_ = 0;
+    for (uint8_t i = 0; i < TWITCH_AXES; i++) targets_[i] = plans_[plan_].jerk[i];
+    aim(JERK_PROFILE);
+    emit(TWITCH_QUICK_JERK, duration_, onEvent);
+  }
+
+  void enter(BehaviorState state, unsigned long durationMillis, uint32_t nowMicros) {
+    state_ = state;
+    duration_ = durationMillis;
+    stateStart_ = nowMicros;
+  }
+
+  // Send every servo toward its target at the given speed
+  void aim(const MotionProfile& profile) {
+    for (uint8_t i = 0; i < TWITCH_AXES; i++) axes_[i].moveTo(targets_[i], profile);
+  }
+
+  template <typename Handler>
+  void emit(uint8_t type, uint32_t durationMillis, Handler onEvent) {
+    TwitchEvent event = {type, cycle_, {targets_[0], targets_[1], targets_[2]}, durationMillis};
+    onEvent(event);
+  }
+
+  uint32_t seed_;
+  XorshiftRandom random_;
+  TwitchCyclePlan plans_[PLANS];
+  uint8_t plan_ = 0;
+  MotionAxis axes_[TWITCH_AXES];
+  int16_t targets_[TWITCH_AXES];
+  BehaviorState state_ = STATE_STILL;
+  uint8_t cycle_ = 0;
+  unsigned long duration_ = 0;  // ms
+  uint32_t stateStart_ = 0;
+  uint32_t lastRoll_ = 0;
+  uint16_t roll_ = 0;
+  uint8_t retarget_ = 0;
+  uint32_t lastThrash_ = 0;
+  uint8_t thrash_ = 0;
+};
+
+typedef TwitchingBehaviorT<TWITCH_SCHEDULE_ROUNDS> TwitchingBehavior;
+
+#endif // TWITCHING_BEHAVIOR_H
@@ -12,7 +12,7 @@
  *   - Brief still periods (20-40% of time)
  *   - VIOLENT THRASHING quick jerks (~5% of time, but MUCH longer 600-1000ms)
  *     - Rapid position changes every 100ms (violent back-and-forth)
- *     - 15° steps at 0ms delay (MAXIMUM SPEED)
+ *     - 1500°/s (MAXIMUM SPEED - the servo is the limit)
  *     - Creates intense frustrated/panicked/violent struggling effect
  *   - Varying cycle lengths for unpredictability
  *
@@ -41,14 +41,69 @@
  *
  *   Optional Button:
  *     Pin 9 -> Button -> GND (uses internal pullup)
+ *
+ * Servo writes go through ServoOutput (../../libraries/HalloweenProps):
+ * calibrated by the HS-755MG pulse table, unchanged pulses dropped, and
+ * head/arms on CH0-2 sent together once per frame, only the changed
+ * register bytes. The bus runs at 400 kHz fast mode (i2c_bus.h), which
+ * counts bytes, transactions and bus time per frame; three servos can't
+ * fill its budget, so none is low priority. Send 's' over serial for the
+ * bus counters since the cycle started, at any log level.
+ *
+ * Three HS-755MGs thrown across their range together can pull more than
+ * the 5A supply gives. ServoOutput estimates each servo's current from how
+ * far it moves per frame (servo_power.h) and keeps the total under 4.5A:
+ * no servo is moved faster than its top speed, and in a thrash the servo
+ * that doesn't fit this frame is slowed or waits one. Average and peak
+ * estimates are logged at the start of every cycle.
+ * Frames run on a fixed 20ms grid, one per PWM period (a servo can't take
+ * pulses any faster), and the CPU sleeps in between. Frame timing
+ * histograms and I2C counters are logged at the start of every cycle.
+ *
+ * What the body does - cycles, states, targets and motion - is in
+ * twitching_behavior.h, free of hardware so host tools can run it
+ * (pixi run fast-forward). Movement speeds are degrees per second with an
+ * acceleration limit (motion_profile.h), worked out from elapsed time on
+ * a fixed 1.024ms grid, so the motion is the same whatever the frame
+ * rate. Only a frame in which an axis has moved sends anything on the bus.
+ *
+ * Runtime messages are binary event records (log_events.h) queued in RAM
+ * and sent between frames only as fast as USB serial takes them, so a full
+ * serial buffer never stalls a thrash. Decode the port with
+ * pixi run decode-log. Messages have levels (log_level.h): the production
+ * build strips everything below WARN; thrash steps and frame histograms
+ * are DEBUG.
  */
 
+// Production default: warnings and errors only, runtime log compiled out.
+// pixi run deploy-debug builds with LOG_LEVEL_DEBUG for decode-log.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_WARN
+#endif
+
 #include <Wire.h>
 #include <Adafruit_PWMServoDriver.h>
+#include <pca9685_batch.h>
+#include <servo_lut.h>
+#include <servo_output.h>
+#include <i2c_bus.h>
+#include <servo_power.h>
+#include <frame_scheduler.h>
+#include <event_log.h>
+#include <log_level.h>
+#include "log_events.h"
+
+// Behavior randomness: 0 draws each cycle's choices as it starts; 1 draws
+// a whole round of the five cycles at boot (770 bytes RAM) and replays it
+#ifndef TWITCH_SCHEDULE_ROUNDS
+#define TWITCH_SCHEDULE_ROUNDS 0
+#endif
+#include "twitching_behavior.h"
 
 // PCA9685 configuration
 #define PCA9685_ADDRESS 0x40
 Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(PCA9685_ADDRESS);
+PCA9685Batch servoBatch(PCA9685_ADDRESS);  // Stages servo writes until flush()
 
 // Servo channels on PCA9685
 #define HEAD_CHANNEL 0
@@ -61,72 +116,54 @@ Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(PCA9685_ADDRESS);
 #define SERVOMAX  2400  // Maximum pulse width
 #define SERVO_FREQ 50   // 50Hz for analog servos
 
+// HS-755MG current at 5V (SERVO_TEST.md): 10-50mA holding, 500-800mA
+// moving, 2.5A stalled; flat out under load (a thrash reversal) is taken
+// as 1.6A. Top speed about 0.21s/60° at 5V (datasheet: 0.23s at 4.8V,
+// 0.18s at 6V)
+const ServoCurrentModel HS755MG_CURRENT = {30, 1600, 280};
+
+// Estimated current for all three servos, kept under the 5A supply
+ServoPower power(4500);
+
+// Behavior frames: one per PWM period (20ms)
+FrameScheduler frames(FRAME_PERIOD_MICROS(SERVO_FREQ, 1));
+
+// Fast-mode I2C; a frame's servo writes (at most ~0.4ms) get 2ms of it
+I2CBus bus(I2C_BUS_FAST_HZ, 2000);
+
+// Runtime messages, sent from idle time (drops counted if serial backs up)
+EventLog<LOG_EVENT_CAPACITY(32)> eventLog;
+
+// Degrees (0-180) to PWM ticks, built at compile time from the pulse widths
+typedef ServoPulseTable<SERVOMIN, SERVOMAX, 180, 1000000L / SERVO_FREQ> ServoAngleTable;
+
 // Pin configuration
 const int CENTER_BUTTON_PIN = 9;  // Button to center servos (optional)
 const int LED_PIN = 13;           // Built-in LED for status
 
-// Rest positions (center positions when "still")
-const int HEAD_REST = 90;
-const int LEFT_ARM_REST = 90;
-const int RIGHT_ARM_REST = 90;
-
-// Movement ranges - BOTH use full servo range for maximum impact
-const int SLOW_MOVEMENT_RANGE = 90;   // +/- 90 degrees - FULL RANGE slow sweeps (0-180°)
-const int QUICK_JERK_RANGE = 90;      // +/- 90 degrees - FULL RANGE quick jerks (0-180°)
-
-// Behavior state
-enum BehaviorState {
-  STATE_STILL,
-  STATE_SLOW_MOVEMENT,
-  STATE_QUICK_JERK
-};
-
-BehaviorState currentState = STATE_STILL;
-unsigned long stateStartTime = 0;
-unsigned long currentStateDuration = 0;
-
-// Movement tracking
-int headTarget = HEAD_REST;
-int leftArmTarget = LEFT_ARM_REST;
-int rightArmTarget = RIGHT_ARM_REST;
-int headCurrent = HEAD_REST;
-int leftArmCurrent = LEFT_ARM_REST;
-int rightArmCurrent = RIGHT_ARM_REST;
-
-unsigned long lastMovementUpdate = 0;
-const int SLOW_MOVEMENT_DELAY = 40;   // ms between position updates (slower for smoother motion)
-const int QUICK_MOVEMENT_DELAY = 0;   // NO DELAY - maximum speed for violent jerks!
-
-// Cycle definitions (time in milliseconds)
-// Different cycles for variety
-struct Cycle {
-  unsigned long stillDuration;
-  unsigned long slowMovementDuration;
-  unsigned long quickJerkDuration;
-};
-
-// Define 5 different behavior cycles
-// New behavior: slow movement is dominant (50-70%), less still time (20-40%)
-// Quick jerks LONGER for more visible violent thrashing
-const int NUM_CYCLES = 5;
-const Cycle cycles[NUM_CYCLES] = {
-  {3000, 12000, 800},   // 3s still, 12s slow, 0.8s jerk - LONGER for violence
-  {2000, 15000, 1000},  // 2s still, 15s slow, 1s jerk - LONGEST jerk
-  {4000, 10000, 600},   // 4s still, 10s slow, 0.6s jerk
-  {2500, 18000, 900},   // 2.5s still, 18s slow, 0.9s jerk - very long
-  {5000, 8000, 700}     // 5s still, 8s slow, 0.7s jerk
-};
-
-int currentCycleIndex = 0;
+// Servos in behavior axis order (head, left arm, right arm), written
+// through the calibration table; only changed pulses reach the batch
+ServoOutput<TWITCH_AXES> servos(servoBatch);
+
+// Cycles, states, targets and motion (twitching_behavior.h)
+TwitchingBehavior behavior;
+
+// Function prototypes (arduino-cli generates these; host builds need them)
+void logBehaviorEvent(const TwitchEvent& event);
+void writeMovedServos(uint8_t moved);
+void handleCenterButton(bool pressed);
+void releaseCenterButton();
+void blinkLED(int count, int delayMs);
+void printStatus();
 
 void setup() {
   // Initialize serial for debugging
   Serial.begin(9600);
   delay(500);
 
-  Serial.println();
-  Serial.println(F("=== Twitching Body Animatronic ==="));
-  Serial.println(F("Initializing..."));
+  LogInfo::println();
+  LogInfo::println(F("=== Twitching Body Animatronic ==="));
+  LogInfo::println(F("Initializing..."));
 
   // Initialize LED and button
   pinMode(LED_PIN, OUTPUT);
@@ -137,28 +174,38 @@ void setup() {
 
   // Initialize I2C
   Wire.begin();
-  Serial.println(F("I2C initialized"));
+  LogInfo::println(F("I2C initialized"));
 
   // Initialize PCA9685
   pwm.begin();
   pwm.setPWMFreq(SERVO_FREQ);
+  bus.begin();  // After pwm.begin(): Wire.begin() resets SCL to 100 kHz
   delay(100);
-  Serial.println(F("PCA9685 initialized (50Hz)"));
-
-  // Move to rest positions
-  Serial.println(F("Moving to rest positions..."));
-  setServoAngle(HEAD_CHANNEL, HEAD_REST);
-  setServoAngle(LEFT_ARM_CHANNEL, LEFT_ARM_REST);
-  setServoAngle(RIGHT_ARM_CHANNEL, RIGHT_ARM_REST);
+  LogInfo::println(F("PCA9685 initialized (50Hz, I2C 400kHz)"));
+  servos.attach(0, HEAD_CHANNEL, SERVO_CALIBRATION(ServoAngleTable));
+  servos.attach(1, LEFT_ARM_CHANNEL, SERVO_CALIBRATION(ServoAngleTable));
+  servos.attach(2, RIGHT_ARM_CHANNEL, SERVO_CALIBRATION(ServoAngleTable));
+  for (uint8_t i = 0; i < TWITCH_AXES; i++) servos.setCurrentModel(i, HS755MG_CURRENT, SERVO_FREQ);
+  servos.setPower(power);
+
+  // Move to rest positions (staggered: all three at once is over budget)
+  LogInfo::println(F("Moving to rest positions..."));
+  servos.write(0, HEAD_REST);
+  servos.write(1, LEFT_ARM_REST);
+  servos.write(2, RIGHT_ARM_REST);
+  while (!servos.settled()) {
+    servos.flush();
+    delay(1000 / SERVO_FREQ);
+  }
   delay(500);
 
   // Check for center button press at startup
   if (digitalRead(CENTER_BUTTON_PIN) == LOW) {
-    Serial.println();
-    Serial.println(F("*** STARTUP CENTER MODE ***"));
-    Serial.println(F("Button held - servos centered"));
-    Serial.println(F("Release to start behavior"));
-    Serial.println();
+    LogInfo::println();
+    LogInfo::println(F("*** STARTUP CENTER MODE ***"));
+    LogInfo::println(F("Button held - servos centered"));
+    LogInfo::println(F("Release to start behavior"));
+    LogInfo::println();
 
     digitalWrite(LED_PIN, HIGH);
 
@@ -169,276 +216,131 @@ void setup() {
 
     digitalWrite(LED_PIN, LOW);
     delay(500);
-    Serial.println(F("Button released - starting"));
+    LogInfo::println(F("Button released - starting"));
   }
 
-  Serial.println(F("Servos initialized at rest positions"));
-  Serial.println(F("Starting behavior cycle..."));
-  Serial.println();
+  LogInfo::println(F("Servos initialized at rest positions"));
+  LogInfo::println(F("Starting behavior cycle..."));
+  LogInfo::println(F("Log: binary events from here on (pixi run decode-log)"));
+  LogInfo::println();
 
   // Visual feedback - ready
   blinkLED(2, 200);
 
   // Start first cycle
-  startStillState();
+  behavior.begin(micros(), logBehaviorEvent);
 }
 
 void loop() {
-  unsigned long currentTime = millis();
+  // Status request from the serial monitor ('s'), whatever the log level
+  while (Serial.available()) {
+    if (Serial.read() == 's') printStatus();
+  }
 
   // Check for center button press (anytime during operation)
+  static bool centerHeld = false;
   if (digitalRead(CENTER_BUTTON_PIN) == LOW) {
-    handleCenterButton();
+    handleCenterButton(!centerHeld);
+    centerHeld = true;
+    if (LogInfo::enabled) eventLog.drain(Serial);
     return;  // Skip normal behavior while button held
   }
-
-  // Check if current state duration has elapsed
-  if (currentTime - stateStartTime >= currentStateDuration) {
-    transitionToNextState();
-  }
-
-  // Execute behavior based on current state
-  switch (currentState) {
-    case STATE_STILL:
-      executeStillBehavior();
-      break;
-
-    case STATE_SLOW_MOVEMENT:
-      executeSlowMovement(currentTime);
-      break;
-
-    case STATE_QUICK_JERK:
-      executeQuickJerk(currentTime);
-      break;
+  if (centerHeld) {
+    centerHeld = false;
+    releaseCenterButton();
   }
 
-  delay(10);  // Small delay for stability
-}
-
-void startStillState() {
-  currentState = STATE_STILL;
-  stateStartTime = millis();
-  currentStateDuration = cycles[currentCycleIndex].stillDuration;
-
-  // Set targets to rest positions
-  headTarget = HEAD_REST;
-  leftArmTarget = LEFT_ARM_REST;
-  rightArmTarget = RIGHT_ARM_REST;
-
-  digitalWrite(LED_PIN, LOW);
-
-  Serial.print(F("STATE: Still for "));
-  Serial.print(currentStateDuration / 1000.0);
-  Serial.println(F(" seconds"));
-}
-
-void startSlowMovementState() {
-  currentState = STATE_SLOW_MOVEMENT;
-  stateStartTime = millis();
-  currentStateDuration = cycles[currentCycleIndex].slowMovementDuration;
-  lastMovementUpdate = millis();
-
-  // HEAD: Keep random full range (working perfectly)
-  headTarget = HEAD_REST + random(-SLOW_MOVEMENT_RANGE, SLOW_MOVEMENT_RANGE + 1);
-
-  // ARMS: Always go to EXTREMES for dramatic effect (no small movements!)
-  // Pick extreme positions: either very low (0-30°) or very high (150-180°)
-  // This creates "pulling up" or "dropping down" effect
-  bool pullUp = random(0, 2);  // 0 or 1
-
-  if (pullUp) {
-    // Pulling up - arms go high (one higher than the other)
-    leftArmTarget = random(150, 181);   // 150-180° (very high)
-    rightArmTarget = random(0, 31);     // 0-30° (very low)
-  } else {
-    // Dropping down - arms go low/reversed
-    leftArmTarget = random(0, 31);      // 0-30° (very low)
-    rightArmTarget = random(150, 181);  // 150-180° (very high)
+  // Between frames: send queued log records the USB buffer has room for,
+  // then sleep until the next behavior frame (button polled ~every 1ms)
+  if (!frames.beginFrame()) {
+    if (LogInfo::enabled) eventLog.drain(Serial);
+    frames.idle();
+    return;
   }
+  // Move the servos up to now, then see what they should do next
+  bus.beginFrame();
+  writeMovedServos(behavior.update(micros(), logBehaviorEvent));
 
-  digitalWrite(LED_PIN, HIGH);
-
-  Serial.print(F("STATE: Slow movement for "));
-  Serial.print(currentStateDuration / 1000.0);
-  Serial.print(F(" seconds (targets: H:"));
-  Serial.print(headTarget);
-  Serial.print(F(" LA:"));
-  Serial.print(leftArmTarget);
-  Serial.print(F(" RA:"));
-  Serial.print(rightArmTarget);
-  Serial.println(F(")"));
+  // Send this frame's servo changes in one batch
+  servos.flush(bus);
+  frames.endFrame();
 }
 
-void startQuickJerkState() {
-  currentState = STATE_QUICK_JERK;
-  stateStartTime = millis();
-  currentStateDuration = cycles[currentCycleIndex].quickJerkDuration;
-  lastMovementUpdate = millis();
-
-  // HEAD: Keep random full range (working perfectly)
-  headTarget = HEAD_REST + random(-QUICK_JERK_RANGE, QUICK_JERK_RANGE + 1);
+// State changes and thrashes from the behavior engine, to the event log
+void logBehaviorEvent(const TwitchEvent& event) {
+  const int16_t* t = event.targets;
+  switch (event.type) {
+    case TWITCH_STILL:
+      digitalWrite(LED_PIN, LOW);
+      LogInfo::event(eventLog, EVT_STILL, 0, 0, event.durationMillis);
+      break;
 
-  // ARMS: CHAOTIC movement - random extreme positions (frustrated/escaping)
-  // Pick completely random extreme positions for erratic, panicked effect
-  leftArmTarget = random(0, 181);   // Anywhere from 0-180° (chaotic)
-  rightArmTarget = random(0, 181);  // Anywhere from 0-180° (chaotic)
-  // Not necessarily opposite - adds to the chaotic/frustrated feeling
+    case TWITCH_SLOW_MOVEMENT:
+      digitalWrite(LED_PIN, HIGH);
+      LogInfo::event(eventLog, EVT_SLOW_MOVEMENT, t[TWITCH_HEAD],
+                     eventBytes(t[TWITCH_LEFT_ARM], t[TWITCH_RIGHT_ARM]), event.durationMillis);
+      break;
 
-  // Blink LED rapidly during jerk
-  digitalWrite(LED_PIN, HIGH);
+    case TWITCH_QUICK_JERK:
+      digitalWrite(LED_PIN, HIGH);  // Blink LED rapidly during jerk
+      LogInfo::event(eventLog, EVT_QUICK_JERK, t[TWITCH_HEAD],
+                     eventBytes(t[TWITCH_LEFT_ARM], t[TWITCH_RIGHT_ARM]), event.durationMillis);
+      break;
 
-  Serial.print(F("STATE: QUICK JERK for "));
-  Serial.print(currentStateDuration);
-  Serial.print(F(" ms (targets: H:"));
-  Serial.print(headTarget);
-  Serial.print(F(" LA:"));
-  Serial.print(leftArmTarget);
-  Serial.print(F(" RA:"));
-  Serial.print(rightArmTarget);
-  Serial.println(F(")"));
-}
+    case TWITCH_THRASH:
+      LogDebug::event(eventLog, EVT_THRASH, t[TWITCH_HEAD], eventBytes(t[TWITCH_LEFT_ARM], t[TWITCH_RIGHT_ARM]));
+      break;
 
-void transitionToNextState() {
-  // State machine: Still -> Slow Movement -> Quick Jerk -> (next cycle) Still
-  if (currentState == STATE_STILL) {
-    startSlowMovementState();
-  } else if (currentState == STATE_SLOW_MOVEMENT) {
-    startQuickJerkState();
-  } else if (currentState == STATE_QUICK_JERK) {
-    // Move to next cycle
-    currentCycleIndex = (currentCycleIndex + 1) % NUM_CYCLES;
-    Serial.print(F(">>> Starting cycle "));
-    Serial.print(currentCycleIndex + 1);
-    Serial.print(F(" of "));
-    Serial.println(NUM_CYCLES);
-    Serial.println();
-    startStillState();
+    case TWITCH_CYCLE:
+      LogInfo::event(eventLog, EVT_CYCLE, event.cycle + 1, NUM_CYCLES);
+      if (LogDebug::enabled) frames.logStats(eventLog, EVT_CYCLE_FRAMES);
+      if (LogDebug::enabled) bus.logStats(eventLog, EVT_CYCLE_BUS);
+      if (LogDebug::enabled) power.logStats(eventLog, EVT_CYCLE_POWER);
+      frames.resetStats();
+      bus.resetStats();
+      power.resetStats();
+      break;
   }
 }
 
-void executeStillBehavior() {
-  // Slowly return to rest positions if not already there
-  moveServoToward(HEAD_CHANNEL, headCurrent, headTarget, 1);
-  moveServoToward(LEFT_ARM_CHANNEL, leftArmCurrent, leftArmTarget, 1);
-  moveServoToward(RIGHT_ARM_CHANNEL, rightArmCurrent, rightArmTarget, 1);
-}
-
-void executeSlowMovement(unsigned long currentTime) {
-  // Smooth slow movements - update positions gradually
-  if (currentTime - lastMovementUpdate >= SLOW_MOVEMENT_DELAY) {
-    moveServoToward(HEAD_CHANNEL, headCurrent, headTarget, 1);
-    moveServoToward(LEFT_ARM_CHANNEL, leftArmCurrent, leftArmTarget, 1);
-    moveServoToward(RIGHT_ARM_CHANNEL, rightArmCurrent, rightArmTarget, 1);
-
-    // Occasionally change head target (head motion is perfect, keep this)
-    if (random(0, 100) < 5) {  // 5% chance each update
-      headTarget = HEAD_REST + random(-SLOW_MOVEMENT_RANGE, SLOW_MOVEMENT_RANGE + 1);
-    }
-
-    // DON'T change arm targets during slow movement - let them complete the full sweep!
-    // This ensures arms always do dramatic full-range movements
-
-    lastMovementUpdate = currentTime;
+// Stage the servos the behavior engine moved this frame
+void writeMovedServos(uint8_t moved) {
+  for (uint8_t i = 0; i < TWITCH_AXES; i++) {
+    if (moved & TWITCH_AXIS_BIT(i)) servos.writeQ8(i, behavior.axis(i).degreesQ8());
   }
 }
 
-void executeQuickJerk(unsigned long currentTime) {
-  // VIOLENT THRASHING - maximum speed, multiple position changes
-  if (currentTime - lastMovementUpdate >= QUICK_MOVEMENT_DELAY) {
-    // Move MUCH faster - 15 degrees per step for violent snapping
-    moveServoToward(HEAD_CHANNEL, headCurrent, headTarget, 15);
-    moveServoToward(LEFT_ARM_CHANNEL, leftArmCurrent, leftArmTarget, 15);
-    moveServoToward(RIGHT_ARM_CHANNEL, rightArmCurrent, rightArmTarget, 15);
-
-    // THRASH: Change targets rapidly during the jerk (every ~100ms)
-    // This creates violent back-and-forth movement instead of just one motion
-    static unsigned long lastThrash = 0;
-    if (currentTime - lastThrash >= 100) {  // Change direction every 100ms
-      // Pick NEW random extreme positions - creates thrashing effect
-      headTarget = random(0, 181);
-      leftArmTarget = random(0, 181);
-      rightArmTarget = random(0, 181);
-      lastThrash = currentTime;
-
-      Serial.print(F("  THRASH! New targets: H:"));
-      Serial.print(headTarget);
-      Serial.print(F(" LA:"));
-      Serial.print(leftArmTarget);
-      Serial.print(F(" RA:"));
-      Serial.println(rightArmTarget);
-    }
-
-    lastMovementUpdate = currentTime;
+// Center button held (can be triggered anytime); `pressed` on the first
+// pass after the press
+void handleCenterButton(bool pressed) {
+  if (pressed) {
+    // Center all servos now (as fast as the power budget allows)
+    for (uint8_t i = 0; i < TWITCH_AXES; i++) servos.write(i, CENTER_ANGLE);
+    servos.flush();
+
+    // Update current positions (stopped)
+    behavior.center();
+    LogInfo::event(eventLog, EVT_CENTER_PRESSED);
   }
-}
 
-// Helper function to move servo toward target position
-void moveServoToward(uint8_t channel, int &current, int target, int step) {
-  if (current < target) {
-    current = min(current + step, target);
-    setServoAngle(channel, current);
-  } else if (current > target) {
-    current = max(current - step, target);
-    setServoAngle(channel, current);
+  // Keep LED on while button held, and finish the move to center one
+  // frame at a time
+  digitalWrite(LED_PIN, HIGH);
+  if (frames.beginFrame()) {
+    servos.flush();
+    frames.endFrame();
   }
 }
 
-// Set servo angle (0-180 degrees)
-void setServoAngle(uint8_t channel, int angle) {
-  angle = constrain(angle, 0, 180);
-  int pulse_us = map(angle, 0, 180, SERVOMIN, SERVOMAX);
-  setServoPulse(channel, pulse_us);
-}
-
-// Set servo pulse width in microseconds
-void setServoPulse(uint8_t channel, int pulse_us) {
-  // Convert microseconds to PWM value (0-4095)
-  // At 50Hz, period = 20,000us, each tick = 20000/4096 = 4.88us
-  // Use long to prevent integer overflow (pulse_us * 4096 can exceed 32767)
-  int pwmVal = ((long)pulse_us * 4096) / 20000;
-  pwm.setPWM(channel, 0, pwmVal);
-}
-
-// Handle center button press (can be triggered anytime)
-void handleCenterButton() {
-  static bool buttonWasPressed = false;
-
-  if (!buttonWasPressed) {
-    // First detection of button press
-    Serial.println();
-    Serial.println(F("*** CENTER BUTTON PRESSED ***"));
-    Serial.println(F("Centering all servos..."));
-
-    // Center all servos immediately
-    setServoAngle(HEAD_CHANNEL, 90);
-    setServoAngle(LEFT_ARM_CHANNEL, 90);
-    setServoAngle(RIGHT_ARM_CHANNEL, 90);
-
-    // Update current positions
-    headCurrent = 90;
-    leftArmCurrent = 90;
-    rightArmCurrent = 90;
-
-    digitalWrite(LED_PIN, HIGH);
-    buttonWasPressed = true;
-
-    Serial.println(F("Servos centered at 90°"));
-    Serial.println(F("Holding... (release to resume)"));
-  }
-
-  // Keep LED on while button held
-  digitalWrite(LED_PIN, HIGH);
-
-  // Check if button was released
-  if (digitalRead(CENTER_BUTTON_PIN) == HIGH && buttonWasPressed) {
-    digitalWrite(LED_PIN, LOW);
-    buttonWasPressed = false;
-    Serial.println(F("Button released - resuming behavior"));
-    Serial.println();
+// Center button released: back to the behavior cycle
+void releaseCenterButton() {
+  digitalWrite(LED_PIN, LOW);
+  LogInfo::event(eventLog, EVT_CENTER_RELEASED);
 
-    // Reset state machine
-    startStillState();
-  }
+  // Reset state machine; frames and motion restart from now (held time
+  // isn't overrun)
+  behavior.resume(micros(), logBehaviorEvent);
+  frames.restart();
 }
 
 // Blink LED for visual feedback
@@ -450,3 +352,8 @@ void blinkLED(int count, int delayMs) {
     delay(delayMs);
   }
 }
+
+// Serial status ('s'): plain text, so it works in the production build
+void printStatus() {
+  bus.printStats(Serial);
+}
@@ -0,0 +1,20 @@
+/*
+ * Event Log Decoder for twitching_servos.ino
+ *
+ * The sketch reports at runtime through binary event records
+ * (arduino/twitching_servos/log_events.h); this turns a serial capture
+ * back into the text lines, with timestamps.
+ *
+ * Build and run:
+ *   pixi run decode-log                      # live from the Beetle
+ *   ./decode_log capture.bin
+ *   ./decode_log --no-timestamps < capture.bin
+ */
+
+#include "Arduino.h"
+#include "event_log_decoder.h"
+#include "arduino/twitching_servos/log_events.h"
+
+int main(int argc, char** argv) {
+  return sim::decodeEventLogMain(argc, argv, {TWITCHING_SERVOS_EVENTS(EVENT_LOG_FORMAT)});
+}
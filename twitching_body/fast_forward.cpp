@@ -0,0 +1,165 @@
+/*
+ * Fast-Forward Behavior Simulation for twitching_servos.ino
+ *
+ * Runs the behavior engine (twitching_behavior.h) on its own clock, one
+ * call per frame with no loop passes, sleeps or serial in between, so
+ * hours of show take seconds. Servo output goes through the sketch's own
+ * writeMovedServos() and ServoOutput into the host_sim bus model.
+ *
+ * Reports time in each state, servo travel and direction reversals per
+ * hour (wear), and servo writes, I2C transactions and bytes per second
+ * (bus load), per state, the busiest frame's bus time against the
+ * sketch's I2C budget, and estimated servo current (average, peak, frames
+ * the power budget slowed a servo). Exits non-zero if any servo write leaves the
+ * SERVOMIN-SERVOMAX window.
+ *
+ * Build and run:
+ *   pixi run fast-forward
+ *   ./fast_forward --hours 8 --seed 1234 --frame-ms 10
+ */
+
+#include <chrono>
+#include <cmath>
+#include "Arduino.h"
+#include "sim.h"
+#include "arduino/twitching_servos/twitching_servos.ino"
+
+static const char* STATE_NAMES[] = {"Still", "Slow movement", "Quick jerk"};
+static const char* AXIS_NAMES[] = {"Head", "Left arm", "Right arm"};
+
+struct StateTotals {
+  uint64_t micros = 0;
+  uint64_t servoWrites = 0;
+  uint64_t transactions = 0;
+  uint64_t i2cBytes = 0;
+};
+
+struct AxisTotals {
+  double travelDegrees = 0;
+  uint64_t reversals = 0;
+  int8_t direction = 0;
+};
+
+int main(int argc, char** argv) {
+  double hours = 1;
+  uint32_t seed = 1;
+  uint32_t frameMicros = FRAME_PERIOD_MICROS(SERVO_FREQ, 1);
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--hours") && i + 1 < argc) {
+      hours = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+      seed = strtoul(argv[++i], nullptr, 0);
+    } else if (!strcmp(argv[i], "--frame-ms") && i + 1 < argc) {
+      frameMicros = (uint32_t)(atof(argv[++i]) * 1000);
+    } else {
+      fprintf(stderr, "usage: %s [--hours N] [--seed S] [--frame-ms F]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (frameMicros == 0) frameMicros = 1;
+
+  sim::reset();
+  int safeLow = (int)(((long)SERVOMIN * 4096) / 20000);
+  int safeHigh = (int)(((long)SERVOMAX * 4096) / 20000);
+  sim::setSafeWindow(HEAD_CHANNEL, safeLow, safeHigh);
+  sim::setSafeWindow(LEFT_ARM_CHANNEL, safeLow, safeHigh);
+  sim::setSafeWindow(RIGHT_ARM_CHANNEL, safeLow, safeHigh);
+
+  printf("Twitching Body - Fast-Forward Behavior\n");
+  printf("======================================\n");
+  printf("%.1f h at %.1f ms frames, seed %lu\n", hours, frameMicros / 1000.0, (unsigned long)seed);
+
+  // The sketch's own setup() brings up the PCA9685 and centers the servos.
+  // From there the engine runs on its own clock; sim::nowMicros only keeps
+  // moving with I2C time.
+  setup();
+  behavior = TwitchingBehavior(seed);
+  uint64_t cycles = 0, thrashes = 0;
+  auto countEvents = [&](const TwitchEvent& e) {
+    if (e.type == TWITCH_CYCLE) cycles++;
+    if (e.type == TWITCH_THRASH) thrashes++;
+  };
+  uint32_t clock = 1000000;
+  behavior.begin(clock, countEvents);
+  power.resetStats();  // Only the run, not setup()'s move to rest
+
+  StateTotals totals[3];
+  AxisTotals axes[TWITCH_AXES];
+  int32_t last[TWITCH_AXES];
+  for (int i = 0; i < TWITCH_AXES; i++) last[i] = behavior.axis(i).positionQ20();
+
+  uint64_t frames = (uint64_t)(hours * 3600e6 / frameMicros);
+  auto wallStart = std::chrono::steady_clock::now();
+  for (uint64_t f = 0; f < frames; f++) {
+    BehaviorState state = behavior.state();
+    uint64_t w0 = sim::servoWrites, t0 = sim::i2c.transactions, b0 = sim::i2c.bytes;
+    clock += frameMicros;
+    bus.beginFrame();
+    writeMovedServos(behavior.update(clock, countEvents));
+    servos.flush(bus);
+
+    StateTotals& s = totals[state];
+    s.micros += frameMicros;
+    s.servoWrites += sim::servoWrites - w0;
+    s.transactions += sim::i2c.transactions - t0;
+    s.i2cBytes += sim::i2c.bytes - b0;
+
+    for (int i = 0; i < TWITCH_AXES; i++) {
+      int32_t p = behavior.axis(i).positionQ20();
+      int32_t delta = p - last[i];
+      last[i] = p;
+      if (!delta) continue;
+      axes[i].travelDegrees += fabs((double)delta) / (1L << MOTION_POSITION_SHIFT);
+      int8_t direction = delta > 0 ? 1 : -1;
+      if (axes[i].direction && direction != axes[i].direction) axes[i].reversals++;
+      axes[i].direction = direction;
+    }
+  }
+  double wallSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+  uint64_t totalMicros = frames * frameMicros;
+  double simHours = totalMicros / 3600e6;
+  printf("\n%-16s %8s %16s %16s %14s\n", "State", "Time %", "servo writes/s", "I2C trans/s", "I2C bytes/s");
+  StateTotals all;
+  for (int s = 0; s < 3; s++) {
+    double seconds = totals[s].micros / 1e6;
+    all.servoWrites += totals[s].servoWrites;
+    all.transactions += totals[s].transactions;
+    all.i2cBytes += totals[s].i2cBytes;
+    if (seconds <= 0) continue;
+    printf("%-16s %7.1f%% %16.1f %16.1f %14.0f\n", STATE_NAMES[s], 100.0 * totals[s].micros / totalMicros,
+           totals[s].servoWrites / seconds, totals[s].transactions / seconds, totals[s].i2cBytes / seconds);
+  }
+  double seconds = totalMicros / 1e6;
+  printf("%-16s %7.1f%% %16.1f %16.1f %14.0f\n", "All", 100.0, all.servoWrites / seconds,
+         all.transactions / seconds, all.i2cBytes / seconds);
+
+  printf("\n%-16s %16s %18s\n", "Servo", "travel deg/h", "reversals/h");
+  for (int i = 0; i < TWITCH_AXES; i++) {
+    printf("%-16s %16.0f %18.0f\n", AXIS_NAMES[i], axes[i].travelDegrees / simHours, axes[i].reversals / simHours);
+  }
+
+  printf("\nCycles:                      %llu (%.0f/h), %llu thrashes\n", (unsigned long long)cycles,
+         cycles / simHours, (unsigned long long)thrashes);
+  printf("Frames:                      %llu\n", (unsigned long long)frames);
+  bus.beginFrame();  // Close the last one
+  const I2CBusStats& busStats = bus.stats();
+  printf("I2C per frame:               max %u bytes, %lu us at %lu kHz (budget %u us), %u deferred\n",
+         busStats.maxFrameBytes, (unsigned long)bus.clocksToMicros(busStats.maxFrameClocks),
+         (unsigned long)(bus.clockHz() / 1000), bus.budgetMicros(), busStats.deferred);
+  const ServoPowerStats& powerStats = power.stats();
+  printf("Servo current (estimated):   avg %u mA, peak %u mA of %u (asked %u), %u frames limited\n",
+         power.averageMilliamps(), powerStats.peakMilliamps, power.budgetMilliamps(),
+         powerStats.peakDemandMilliamps, powerStats.limitedFrames);
+  printf("Wall time:                   %.2f s (%.0fx real time)\n", wallSeconds,
+         wallSeconds > 0 ? seconds / wallSeconds : 0.0);
+  printf("Range violations:            %llu\n", (unsigned long long)sim::rangeViolations);
+
+  if (sim::rangeViolations) {
+    printf("\n✗ Servo writes outside SERVOMIN-SERVOMAX\n");
+    return 1;
+  }
+  printf("\n✓ Fast-forward OK\n");
+  return 0;
+}
@@ -34,7 +34,7 @@ echo ""
 
 # Test 3: Compile Arduino sketch
 echo "▶ Test 3: Compile sketch"
-if .pixi/bin/arduino-cli compile --fqbn arduino:avr:leonardo --config-file .arduino15/arduino-cli.yaml arduino/twitching_servos 2>&1; then
+if .pixi/bin/arduino-cli compile --fqbn arduino:avr:leonardo --config-file .arduino15/arduino-cli.yaml --libraries ../libraries arduino/twitching_servos 2>&1; then
     echo "  ✅ Compilation successful"
 else
     echo "  ❌ Compilation failed"
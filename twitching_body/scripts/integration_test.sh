@@ -60,7 +60,7 @@ echo ""
 
 # Test 5: Sketch compiles
 echo "▶ Test 5: Sketch compilation"
-if .pixi/bin/arduino-cli compile --fqbn arduino:avr:leonardo --config-file .arduino15/arduino-cli.yaml arduino/twitching_servos &> /dev/null; then
+if .pixi/bin/arduino-cli compile --fqbn arduino:avr:leonardo --config-file .arduino15/arduino-cli.yaml --libraries ../libraries arduino/twitching_servos &> /dev/null; then
     echo "  ✅ Sketch compiles successfully"
     ((TESTS_PASSED++))
 else
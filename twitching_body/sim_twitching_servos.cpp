@@ -0,0 +1,202 @@
+/*
+ * Host Simulator for twitching_servos.ino
+ *
+ * Compiles the production sketch against host_sim/ (stand-in Arduino core,
+ * mock Wire bus, PCA9685 model) and runs the behavior cycle on a simulated
+ * clock. Reports loop rate, I2C traffic and bytes on the wire per frame for
+ * each behavior state, estimated servo current per state (average, peak,
+ * what the moves asked for before the power budget), the sketch's frame
+ * lateness/compute histograms (decoded from its binary event log), event
+ * log traffic and center-button-to-motion latency. Presses the center
+ * button twice. Exits non-zero if any servo write leaves the
+ * SERVOMIN-SERVOMAX window, a frame's estimated current passes the budget,
+ * a press doesn't center the servos or the behavior doesn't resume after
+ * its release, or the serial status ('s') doesn't print the I2C counters.
+ *
+ * Build and run:
+ *   pixi run sim
+ *   ./sim_twitching_servos --minutes 10 --verbose
+ */
+
+#include "Arduino.h"
+#include "sim.h"
+#define LOG_LEVEL LOG_LEVEL_DEBUG  // The reports decode the full event log
+#include "arduino/twitching_servos/twitching_servos.ino"
+
+static const char* STATE_NAMES[] = {"Still", "Slow movement", "Quick jerk"};
+
+struct StateTotals {
+  uint64_t micros = 0;
+  uint64_t i2cBytes = 0;
+  uint64_t servoWrites = 0;
+  sim::LoopStats loops;
+  // Estimated servo current (the sketch's ServoPower), per flush
+  uint64_t powerFrames = 0;
+  uint64_t milliampFrames = 0;
+  uint16_t peakMilliamps = 0;
+  uint16_t peakDemandMilliamps = 0;
+  uint64_t limitedFrames = 0;
+};
+
+int main(int argc, char** argv) {
+  double minutes = 5;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--minutes") && i + 1 < argc) {
+      minutes = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--verbose")) {
+      Serial.echo = true;
+    } else {
+      fprintf(stderr, "usage: %s [--minutes N] [--verbose]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  sim::reset();
+  sim::useEventLog({TWITCHING_SERVOS_EVENTS(EVENT_LOG_FORMAT)});
+  int safeLow = (int)(((long)SERVOMIN * 4096) / 20000);
+  int safeHigh = (int)(((long)SERVOMAX * 4096) / 20000);
+  sim::setSafeWindow(HEAD_CHANNEL, safeLow, safeHigh);
+  sim::setSafeWindow(LEFT_ARM_CHANNEL, safeLow, safeHigh);
+  sim::setSafeWindow(RIGHT_ARM_CHANNEL, safeLow, safeHigh);
+
+  printf("Twitching Body - Host Simulation\n");
+  printf("================================\n");
+
+  setup();
+
+  // Behavior cycle, attributing every loop pass to the state it ran in
+  StateTotals totals[3];
+  uint64_t end = sim::nowMicros + (uint64_t)(minutes * 60e6);
+  sim::LoopStats all;
+  while (sim::nowMicros < end) {
+    BehaviorState state = behavior.state();
+    uint64_t t0 = sim::nowMicros, b0 = sim::i2c.bytes, w0 = sim::servoWrites;
+    uint32_t f0 = power.stats().frames;
+    StateTotals& s = totals[state];
+    sim::stepCounted(loop, s.loops);
+    s.micros += sim::nowMicros - t0;
+    s.i2cBytes += sim::i2c.bytes - b0;
+    s.servoWrites += sim::servoWrites - w0;
+    if (power.stats().frames != f0) {
+      uint16_t milliamps = power.lastMilliamps(), demand = power.lastDemandMilliamps();
+      s.powerFrames++;
+      s.milliampFrames += milliamps;
+      if (milliamps > s.peakMilliamps) s.peakMilliamps = milliamps;
+      if (demand > s.peakDemandMilliamps) s.peakDemandMilliamps = demand;
+      if (demand > milliamps) s.limitedFrames++;
+    }
+    all.iterations++;
+    all.simMicros += sim::nowMicros - t0;
+  }
+
+  // Center button, twice: press while off-center (centered servos need no
+  // write), hold until the servos reach center, release and wait for the
+  // behavior to move them again
+  auto offCenter = [] {
+    for (int i = 0; i < TWITCH_AXES; i++) {
+      if (behavior.axis(i).degrees() != CENTER_ANGLE) return true;
+    }
+    return false;
+  };
+  sim::PCA9685Model* chip = sim::ensurePCA9685(PCA9685_ADDRESS);
+  const uint8_t channels[TWITCH_AXES] = {HEAD_CHANNEL, LEFT_ARM_CHANNEL, RIGHT_ARM_CHANNEL};
+  uint64_t latencyMicros = 0;
+  sim::LoopStats reaction;
+  int pressesCentered = 0, pressesResumed = 0;
+  for (int press = 0; press < 2; press++) {
+    sim::runLoop(loop, sim::nowMicros + 600000000, offCenter);
+    uint64_t pressedAt = sim::nowMicros;
+    uint64_t firstWriteAt = 0;
+    sim::onServoWrite = [&](const sim::ServoWrite& w) {
+      if (!firstWriteAt) firstWriteAt = w.micros;
+    };
+    sim::setPin(CENTER_BUTTON_PIN, LOW);
+    sim::LoopStats pressed = sim::runLoop(loop, pressedAt + 1000000, [&] {
+      return firstWriteAt != 0;
+    });
+    sim::onServoWrite = nullptr;
+    if (press == 0) {
+      latencyMicros = firstWriteAt - pressedAt;
+      reaction = pressed;
+    }
+    sim::runLoop(loop, pressedAt + 3000000);
+    bool centered = true;
+    for (int i = 0; i < TWITCH_AXES; i++) {
+      if (chip->off(channels[i]) != ServoAngleTable::lookup(CENTER_ANGLE)) centered = false;
+    }
+    if (centered) pressesCentered++;
+    sim::setPin(CENTER_BUTTON_PIN, HIGH);
+    sim::runLoop(loop, sim::nowMicros + 600000000, offCenter);
+    if (offCenter()) pressesResumed++;
+  }
+
+  // Serial status request: the bus counters as text
+  Serial.input.push_back('s');
+  sim::runLoop(loop, sim::nowMicros + 100000, [] { return Serial.input.empty(); });
+  std::string busStatus = "I2C " + std::to_string(bus.clockHz() / 1000) + " kHz:";
+  bool statusBus = sim::serialText().find("\n" + busStatus) != std::string::npos;
+
+  printf("\n%-16s %8s %10s %14s %16s\n", "State", "Time %", "loops/s", "I2C bytes/s", "servo writes/s");
+  for (int s = 0; s < 3; s++) {
+    double seconds = totals[s].micros / 1e6;
+    if (seconds <= 0) continue;
+    printf("%-16s %7.1f%% %10.0f %14.0f %16.1f\n", STATE_NAMES[s],
+           100.0 * totals[s].micros / all.simMicros,
+           totals[s].loops.iterations / seconds,
+           totals[s].i2cBytes / seconds,
+           totals[s].servoWrites / seconds);
+  }
+  printf("\nServo current (estimated, budget %u mA):\n", power.budgetMilliamps());
+  printf("%-16s %8s %10s %10s %10s\n", "State", "avg mA", "peak mA", "asked mA", "limited");
+  uint16_t peakMilliamps = 0;
+  for (int s = 0; s < 3; s++) {
+    if (!totals[s].powerFrames) continue;
+    printf("%-16s %8.0f %10u %10u %9.1f%%\n", STATE_NAMES[s],
+           (double)totals[s].milliampFrames / totals[s].powerFrames, totals[s].peakMilliamps,
+           totals[s].peakDemandMilliamps, 100.0 * totals[s].limitedFrames / totals[s].powerFrames);
+    if (totals[s].peakMilliamps > peakMilliamps) peakMilliamps = totals[s].peakMilliamps;
+  }
+  printf("\n");
+  for (int s = 0; s < 3; s++) {
+    sim::printFrameStats(STATE_NAMES[s], totals[s].loops);
+  }
+  printf("\n");
+  sim::printSerialBlock("Frames:");  // Last full cycle, as the sketch logs it
+  sim::printSerialBlock("I2C at");
+  sim::printSerialBlock("Servo current:");
+  sim::printSerialBlock(busStatus.c_str());  // Serial status ('s')
+  printf("\n");
+  sim::EventLogDecoder log({TWITCHING_SERVOS_EVENTS(EVENT_LOG_FORMAT)});
+  log.feed(Serial.output);
+  printf("Event log:                   %llu records (%llu bytes), ring high water %u/%u, %lu dropped\n",
+         (unsigned long long)log.records, (unsigned long long)log.records * EVENT_LOG_WIRE_BYTES,
+         eventLog.highWater(), eventLog.capacity(), (unsigned long)eventLog.dropped());
+  printf("Simulated time:              %.1f min (%llu loop passes)\n", all.simMicros / 60e6,
+         (unsigned long long)all.iterations);
+  printf("Time in delay():             %.1f%%\n", 100.0 * sim::delayMicrosTotal / sim::nowMicros);
+  printf("Button-to-motion latency:    %llu us (%llu loop passes)\n",
+         (unsigned long long)latencyMicros, (unsigned long long)reaction.iterations);
+  printf("Center button:               %d of 2 presses centered, %d resumed after release\n",
+         pressesCentered, pressesResumed);
+  printf("setPWM() calls:              %llu\n", (unsigned long long)sim::setPWMCalls);
+  printf("Range violations:            %llu\n", (unsigned long long)sim::rangeViolations);
+
+  if (sim::rangeViolations) {
+    printf("\n✗ Servo writes outside SERVOMIN-SERVOMAX\n");
+    return 1;
+  }
+  if (!statusBus) {
+    printf("\n✗ Serial status doesn't report the I2C counters\n");
+    return 1;
+  }
+  if (pressesCentered != 2 || pressesResumed != 2) {
+    printf("\n✗ Center button didn't center the servos or resume the behavior\n");
+    return 1;
+  }
+  if (peakMilliamps > power.budgetMilliamps()) {
+    printf("\n✗ A frame's estimated servo current passed the budget\n");
+    return 1;
+  }
+  printf("\n✓ Simulation OK\n");
+  return 0;
+}
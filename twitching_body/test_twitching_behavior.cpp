@@ -0,0 +1,290 @@
+/*
+ * Unit Tests for the Twitching Behavior Engine
+ *
+ * Runs twitching_behavior.h on a test clock with no sketch or hardware:
+ * the cycle table and state order, arm extremes, thrash timing, the center
+ * button, seeding, and that the show is the same at any frame rate.
+ * Uses Google Test framework.
+ *
+ * Build and run:
+ *   pixi run test-behavior
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "Arduino.h"
+#include "arduino/twitching_servos/twitching_behavior.h"
+
+static const uint32_t START = 3000000;
+
+struct Recorded {
+  uint32_t micros;
+  TwitchEvent event;
+};
+
+// Runs a behavior for `seconds` at `frameMicros`, recording every event
+template <typename Behavior>
+class ShowOf {
+ public:
+  explicit ShowOf(uint32_t seed = 1, uint32_t frameMicros = 20000) : behavior(seed), frame(frameMicros) {
+    behavior.begin(now, [this](const TwitchEvent& e) { events.push_back({now, e}); });
+  }
+
+  void run(double seconds) {
+    uint32_t end = now + (uint32_t)(seconds * 1e6);
+    while ((int32_t)(end - now) > 0) step();
+  }
+
+  uint8_t step() {
+    now += frame;
+    return behavior.update(now, [this](const TwitchEvent& e) { events.push_back({now, e}); });
+  }
+
+  std::vector<Recorded> ofType(uint8_t type) const {
+    std::vector<Recorded> found;
+    for (const Recorded& r : events) {
+      if (r.event.type == type) found.push_back(r);
+    }
+    return found;
+  }
+
+  Behavior behavior;
+  uint32_t frame;
+  uint32_t now = START;
+  std::vector<Recorded> events;
+};
+
+typedef ShowOf<TwitchingBehavior> Show;
+typedef ShowOf<TwitchingBehaviorT<2> > ScheduledShow;  // Two rounds drawn at begin()
+
+static double roundSeconds() {
+  double total = 0;
+  for (int c = 0; c < NUM_CYCLES; c++) {
+    total += (cycles[c].stillDuration + cycles[c].slowMovementDuration + cycles[c].quickJerkDuration) / 1000.0;
+  }
+  return total;
+}
+
+static bool sameTargets(const TwitchEvent& a, const TwitchEvent& b) {
+  return a.type == b.type && memcmp(a.targets, b.targets, sizeof(a.targets)) == 0;
+}
+
+// State Machine Tests
+TEST(TwitchingBehavior, BeginsStillAtRest) {
+  Show show;
+  ASSERT_EQ(1u, show.events.size());
+  EXPECT_EQ(TWITCH_STILL, show.events[0].event.type);
+  EXPECT_EQ(cycles[0].stillDuration, show.events[0].event.durationMillis);
+  EXPECT_EQ(STATE_STILL, show.behavior.state());
+  for (int i = 0; i < TWITCH_AXES; i++) EXPECT_EQ(90, show.behavior.axis(i).degrees());
+  EXPECT_EQ(0, show.step());  // Nothing to move
+}
+
+TEST(TwitchingBehavior, FollowsTheCycleTable) {
+  Show show;
+  show.run(roundSeconds() + 0.01);
+
+  std::vector<Recorded> states;
+  for (const Recorded& r : show.events) {
+    if (r.event.type != TWITCH_THRASH) states.push_back(r);
+  }
+  // still, slow, jerk, cycle per cycle, then the next cycle's still
+  ASSERT_EQ((size_t)NUM_CYCLES * 4 + 1, states.size());
+  uint32_t at = START;
+  for (int c = 0; c < NUM_CYCLES; c++) {
+    const Recorded* r = &states[c * 4];
+    EXPECT_EQ(TWITCH_STILL, r[0].event.type);
+    EXPECT_EQ(cycles[c].stillDuration, r[0].event.durationMillis);
+    EXPECT_EQ(at, r[0].micros);
+    at += cycles[c].stillDuration * 1000;
+    EXPECT_EQ(TWITCH_SLOW_MOVEMENT, r[1].event.type);
+    EXPECT_EQ(at, r[1].micros);
+    at += cycles[c].slowMovementDuration * 1000;
+    EXPECT_EQ(TWITCH_QUICK_JERK, r[2].event.type);
+    EXPECT_EQ(cycles[c].quickJerkDuration, r[2].event.durationMillis);
+    EXPECT_EQ(at, r[2].micros);
+    at += cycles[c].quickJerkDuration * 1000;
+    EXPECT_EQ(TWITCH_CYCLE, r[3].event.type);
+    EXPECT_EQ((c + 1) % NUM_CYCLES, r[3].event.cycle);
+  }
+  EXPECT_EQ(TWITCH_STILL, states.back().event.type);
+  EXPECT_EQ(0, show.behavior.cycle());
+}
+
+TEST(TwitchingBehavior, SlowMovementArmsGoToOppositeExtremes) {
+  for (uint32_t seed : {1u, 2u, 3u, 99u}) {
+    Show show(seed);
+    show.run(600);
+    std::vector<Recorded> slow = show.ofType(TWITCH_SLOW_MOVEMENT);
+    ASSERT_GT(slow.size(), 10u);
+    for (const Recorded& r : slow) {
+      int16_t left = r.event.targets[TWITCH_LEFT_ARM], right = r.event.targets[TWITCH_RIGHT_ARM];
+      bool pullUp = left >= 150 && left <= 180 && right >= 0 && right <= 30;
+      bool dropDown = left >= 0 && left <= 30 && right >= 150 && right <= 180;
+      EXPECT_TRUE(pullUp || dropDown) << "LA " << left << " RA " << right;
+      EXPECT_GE(r.event.targets[TWITCH_HEAD], 0);
+      EXPECT_LE(r.event.targets[TWITCH_HEAD], 180);
+    }
+  }
+}
+
+TEST(TwitchingBehavior, ThrashesEvery100msThroughTheJerk) {
+  Show show;
+  show.run((cycles[0].stillDuration + cycles[0].slowMovementDuration + cycles[0].quickJerkDuration) / 1000.0);
+  uint32_t jerkAt = show.ofType(TWITCH_QUICK_JERK)[0].micros;
+  std::vector<Recorded> thrashes = show.ofType(TWITCH_THRASH);
+  // 100ms in, then every 100ms; the jerk ends before its last slot
+  ASSERT_EQ(cycles[0].quickJerkDuration / THRASH_DELAY - 1, thrashes.size());
+  for (size_t i = 0; i < thrashes.size(); i++) {
+    EXPECT_EQ(jerkAt + (i + 1) * THRASH_DELAY * 1000UL, thrashes[i].micros);
+    for (int a = 0; a < TWITCH_AXES; a++) {
+      EXPECT_GE(thrashes[i].event.targets[a], 0);
+      EXPECT_LE(thrashes[i].event.targets[a], 180);
+    }
+  }
+}
+
+TEST(TwitchingBehavior, StillReturnsToRestAndStops) {
+  Show show;
+  show.run(16.0);  // Through cycle 1 (15.8s), into cycle 2's 2s still period
+  ASSERT_EQ(STATE_STILL, show.behavior.state());
+  ASSERT_EQ(1, show.behavior.cycle());
+  show.run(1.7);
+  for (int i = 0; i < TWITCH_AXES; i++) {
+    EXPECT_EQ(90, show.behavior.axis(i).degrees());
+    EXPECT_FALSE(show.behavior.axis(i).moving());
+  }
+  EXPECT_EQ(0, show.step());
+}
+
+TEST(TwitchingBehavior, CenterAndResume) {
+  Show show;
+  show.run(5);
+  ASSERT_EQ(STATE_SLOW_MOVEMENT, show.behavior.state());
+  show.behavior.center();
+  for (int i = 0; i < TWITCH_AXES; i++) {
+    EXPECT_EQ(CENTER_ANGLE, show.behavior.axis(i).degrees());
+    EXPECT_FALSE(show.behavior.axis(i).moving());
+  }
+
+  show.now += 30000000;  // Held for 30s
+  size_t before = show.events.size();
+  show.behavior.resume(show.now, [&](const TwitchEvent& e) { show.events.push_back({show.now, e}); });
+  ASSERT_EQ(before + 1, show.events.size());
+  EXPECT_EQ(TWITCH_STILL, show.events.back().event.type);
+  EXPECT_EQ(STATE_STILL, show.behavior.state());
+  EXPECT_EQ(0, show.behavior.cycle());  // Same cycle, from the top
+  EXPECT_EQ(0, show.step());            // Held time isn't caught up on
+}
+
+// Reproducibility Tests
+TEST(TwitchingBehavior, SameSeedSameShow) {
+  Show a(1234), b(1234), c(4321);
+  a.run(120);
+  b.run(120);
+  c.run(120);
+  ASSERT_EQ(a.events.size(), b.events.size());
+  bool differs = false;
+  for (size_t i = 0; i < a.events.size(); i++) {
+    ASSERT_EQ(a.events[i].micros, b.events[i].micros);
+    ASSERT_EQ(0, memcmp(a.events[i].event.targets, b.events[i].event.targets, sizeof(a.events[i].event.targets)));
+  }
+  for (size_t i = 0; i < std::min(a.events.size(), c.events.size()); i++) {
+    differs |= memcmp(a.events[i].event.targets, c.events[i].event.targets, sizeof(a.events[i].event.targets)) != 0;
+  }
+  EXPECT_TRUE(differs);
+}
+
+TEST(TwitchingBehavior, SameShowAtAnyFrameRate) {
+  // Retarget times (40ms rolls, 100ms thrashes, state changes) are on both grids
+  Show fast(1, 10000), slow(1, 20000);
+  for (int f = 0; f < 3000; f++) {  // 60s
+    slow.step();
+    fast.step();
+    fast.step();
+    for (int i = 0; i < TWITCH_AXES; i++) {
+      ASSERT_EQ(fast.behavior.axis(i).positionQ20(), slow.behavior.axis(i).positionQ20())
+          << "axis " << i << " at frame " << f;
+    }
+  }
+  EXPECT_EQ(fast.events.size(), slow.events.size());
+}
+
+// Schedule Tests
+TEST(TwitchSchedule, PlanFitsEveryCycle) {
+  for (int c = 0; c < NUM_CYCLES; c++) {
+    EXPECT_LE((int)((cycles[c].quickJerkDuration - 1) / THRASH_DELAY), TWITCH_MAX_THRASHES) << "cycle " << c;
+  }
+  XorshiftRandom rng(1);
+  for (int i = 0; i < 1000; i++) {
+    TwitchCyclePlan plan;
+    planTwitchCycle(&plan, i % NUM_CYCLES, &rng);
+    unsigned long slow = cycles[i % NUM_CYCLES].slowMovementDuration;
+    for (uint8_t r = 0; r < plan.headRetargets; r++) {
+      ASSERT_LT((unsigned long)plan.headRetargetRoll[r] * SLOW_MOVEMENT_DELAY, slow);
+      if (r) {
+        ASSERT_GT(plan.headRetargetRoll[r], plan.headRetargetRoll[r - 1]);
+      }
+      ASSERT_LE(plan.headRetargetTo[r], 180);
+    }
+    for (int a = 0; a < TWITCH_AXES; a++) {
+      ASSERT_LE(plan.slow[a], 180);
+      ASSERT_LE(plan.jerk[a], 180);
+    }
+  }
+}
+
+TEST(TwitchSchedule, PrecomputedPlaysTheLiveShow) {
+  Show live(77);
+  ScheduledShow scheduled(77);
+  live.run(2 * roundSeconds());
+  scheduled.run(2 * roundSeconds());
+  ASSERT_EQ(live.events.size(), scheduled.events.size());
+  for (size_t i = 0; i < live.events.size(); i++) {
+    ASSERT_EQ(live.events[i].micros, scheduled.events[i].micros) << "event " << i;
+    ASSERT_TRUE(sameTargets(live.events[i].event, scheduled.events[i].event)) << "event " << i;
+  }
+}
+
+TEST(TwitchSchedule, RingRepeatsWithoutDrawing) {
+  // Round 3 replays round 1: nothing new is drawn after begin()
+  ScheduledShow show(5);
+  show.run(3 * roundSeconds());
+  std::vector<std::vector<Recorded> > rounds(1);
+  for (const Recorded& r : show.events) {
+    if (r.event.type == TWITCH_CYCLE && r.event.cycle == 0) {
+      rounds.push_back(std::vector<Recorded>());
+    } else {
+      rounds.back().push_back(r);
+    }
+  }
+  ASSERT_EQ(4u, rounds.size());  // Three rounds and round 4's first still
+  ASSERT_EQ(rounds[0].size(), rounds[2].size());
+  bool secondDiffers = false;
+  for (size_t i = 0; i < rounds[0].size(); i++) {
+    ASSERT_TRUE(sameTargets(rounds[0][i].event, rounds[2][i].event)) << "event " << i;
+    ASSERT_EQ(rounds[0][i].micros - rounds[0][0].micros, rounds[2][i].micros - rounds[2][0].micros);
+    secondDiffers |= i >= rounds[1].size() || !sameTargets(rounds[0][i].event, rounds[1][i].event);
+  }
+  EXPECT_TRUE(secondDiffers);
+}
+
+TEST(TwitchSchedule, BeginReplaysTheSameShow) {
+  Show show(9);
+  show.run(roundSeconds());
+  std::vector<Recorded> first = show.events;
+  show.events.clear();
+  show.now = START;
+  show.behavior.begin(show.now, [&](const TwitchEvent& e) { show.events.push_back({show.now, e}); });
+  show.run(roundSeconds());
+  ASSERT_EQ(first.size(), show.events.size());
+  for (size_t i = 0; i < first.size(); i++) {
+    ASSERT_EQ(first[i].micros, show.events[i].micros);
+    ASSERT_TRUE(sameTargets(first[i].event, show.events[i].event)) << "event " << i;
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
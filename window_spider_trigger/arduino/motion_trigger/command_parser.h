@@ -0,0 +1,145 @@
+/*
+ * Command Parser - Allocation-Free Serial Line Parsing (No Hardware Dependencies)
+ *
+ * Serial.readStringUntil('\n') builds an Arduino String on the heap and
+ * blocks for the Stream timeout (1 s) when a line arrives without its
+ * newline; the switch isn't read while it waits. LineParser takes one byte
+ * at a time into a fixed buffer instead, so the sketch can hand it
+ * whatever Serial.available() has and get back to the switch:
+ *
+ *   LineParser<COMMAND_BUFFER_SIZE> commandLine;
+ *
+ *   while (Serial.available()) {
+ *     if (commandLine.feed(Serial.read()) == LINE_READY) {
+ *       runCommand(parseTriggerCommand(commandLine.line()));
+ *     }
+ *   }
+ *
+ * Lines end at '\n' or '\r' (CRLF gives one line, blank lines are
+ * skipped) and are trimmed of spaces and tabs. A line longer than the
+ * buffer, or with control or non-ASCII bytes in it, is thrown away whole
+ * and reported once at its end, never run truncated. finish() ends a
+ * line that never got its newline (a monitor set to "No line ending").
+ *
+ * Can be included in both the Arduino sketch and host test programs.
+ */
+
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define COMMAND_BUFFER_SIZE 16     // Longest command + NUL ("STATUS" is 6)
+#define COMMAND_TIMEOUT_MS 1000    // Quiet time that ends a line with no newline
+
+enum LineStatus {
+  LINE_PENDING,    // Nothing to do yet
+  LINE_READY,      // line() holds a complete command
+  LINE_TOO_LONG,   // A line overflowed the buffer and was dropped
+  LINE_MALFORMED   // A line had control/non-ASCII bytes and was dropped
+};
+
+template <uint8_t Size>
+class LineParser {
+  static_assert(Size >= 2, "LineParser needs room for one character and the NUL");
+
+ public:
+  /**
+   * Take one received byte
+   */
+  LineStatus feed(char c) {
+    if (c == '\n' || c == '\r') return finish();
+    if (length_ == 0 && !dropping() && (c == ' ' || c == '\t')) return LINE_PENDING;
+    if (((uint8_t)c < 0x20 && c != '\t') || (uint8_t)c >= 0x7F) {
+      malformed_ = true;
+    } else if (length_ >= Size - 1) {
+      tooLong_ = true;
+    } else {
+      buffer_[length_++] = c;
+    }
+    return LINE_PENDING;
+  }
+
+  /**
+   * End the current line as if its newline had arrived
+   */
+  LineStatus finish() {
+    LineStatus status = LINE_PENDING;
+    if (dropping()) length_ = 0;
+    if (tooLong_) {
+      status = LINE_TOO_LONG;
+      countUp(tooLongCount_);
+    } else if (malformed_) {
+      status = LINE_MALFORMED;
+      countUp(malformedCount_);
+    } else {
+      while (length_ > 0 && (buffer_[length_ - 1] == ' ' || buffer_[length_ - 1] == '\t')) {
+        length_--;
+      }
+      if (length_ > 0) {
+        status = LINE_READY;
+        countUp(lineCount_);
+      }
+    }
+    buffer_[length_] = '\0';
+    lineLength_ = status == LINE_READY ? length_ : 0;
+    length_ = 0;
+    tooLong_ = false;
+    malformed_ = false;
+    return status;
+  }
+
+  // The line from the last LINE_READY, until the next feed()
+  const char* line() const { return buffer_; }
+  uint8_t lineLength() const { return lineLength_; }
+
+  // Part of a line is buffered (or being dropped)
+  bool pending() const { return length_ > 0 || dropping(); }
+
+  uint16_t lines() const { return lineCount_; }
+  uint16_t tooLong() const { return tooLongCount_; }
+  uint16_t malformed() const { return malformedCount_; }
+  static uint8_t capacity() { return Size - 1; }
+
+ private:
+  bool dropping() const { return tooLong_ || malformed_; }
+
+  static void countUp(uint16_t& count) {
+    if (count != 0xFFFF) count++;
+  }
+
+  char buffer_[Size] = {};
+  uint8_t length_ = 0;
+  uint8_t lineLength_ = 0;
+  bool tooLong_ = false;
+  bool malformed_ = false;
+  uint16_t lineCount_ = 0;
+  uint16_t tooLongCount_ = 0;
+  uint16_t malformedCount_ = 0;
+};
+
+/**
+ * Commands the sketch understands
+ */
+enum TriggerCommand {
+  CMD_UNKNOWN,
+  CMD_STATUS,   // Switch state and cooldown
+  CMD_RESET,    // Clear the cooldown
+  CMD_TEST,     // Send a TRIGGER as if the switch was pressed
+  CMD_BINARY,   // Send events as trigger_frame.h frames
+  CMD_TEXT,     // Send events as text lines
+  CMD_PING      // Answer at once (link round-trip time)
+};
+
+inline TriggerCommand parseTriggerCommand(const char* line) {
+  if (strcmp(line, "STATUS") == 0) return CMD_STATUS;
+  if (strcmp(line, "RESET") == 0) return CMD_RESET;
+  if (strcmp(line, "TEST") == 0) return CMD_TEST;
+  if (strcmp(line, "BINARY") == 0) return CMD_BINARY;
+  if (strcmp(line, "TEXT") == 0) return CMD_TEXT;
+  if (strcmp(line, "PING") == 0) return CMD_PING;
+  return CMD_UNKNOWN;
+}
+
+#endif // COMMAND_PARSER_H
@@ -14,28 +14,75 @@
  * Serial Output:
  *   Sends "TRIGGER" when switch pressed
  *   Sends "READY" on startup
+ *   After the BINARY command: fixed-size COBS frames with a sequence
+ *   number, millis() timestamp and CRC instead (trigger_frame.h), plus a
+ *   heartbeat every second. TEXT switches back.
+ *
+ * Serial Input:
+ *   Commands are read byte by byte from loop() into a fixed buffer
+ *   (command_parser.h) - no String, no heap, and no blocking on a line
+ *   that hasn't finished arriving.
+ *
+ * Event-driven: the switch is on a pin-change interrupt that stamps each
+ * edge (edge_capture.h), debounce is a lockout on those timestamps, and
+ * the CPU sleeps between passes (idle_sleep.h) instead of delay(10)
+ * polling. STATUS reports the measured wake-to-TRIGGER latency and how
+ * much of the time the CPU was awake.
  */
 
+#include <edge_capture.h>
+#include <idle_sleep.h>
+#include "command_parser.h"
+#include "trigger_frame.h"
+
 // Configuration
 const int SWITCH_PIN = 9;         // Momentary switch pin (Pin 9 for Beetle compatibility)
 const int LED_PIN = 13;           // Built-in LED for visual feedback
-const long DEBOUNCE_DELAY = 50;   // Debounce delay for switch (ms)
+const long DEBOUNCE_DELAY = 50;   // Debounce lockout after a switch edge (ms)
 const long COOLDOWN_DELAY = 3000; // Cooldown between triggers (ms)
 const int BAUD_RATE = 9600;       // Serial communication speed
 
 // State variables
 unsigned long lastTriggerTime = 0;
-unsigned long lastDebounceTime = 0;
-bool switchState = HIGH;          // HIGH = not pressed (pull-up)
-bool lastSwitchState = HIGH;
 bool switchPressed = false;
 
+// Switch on a pin-change interrupt, debounced by a lockout on edge times
+PinEdgeCapture<8> switchEdges(DEBOUNCE_DELAY * 1000UL);
+ISR(PCINT0_vect) { switchEdges.onPinChange(); }
+
+// Sleep between events, and what it measured (STATUS)
+IdleSleep idle;
+IdleCounters idleAtLastStatus = {0, 0, 0};
+unsigned long wakeLatencyLast = 0;   // Switch edge (ISR) to TRIGGER sent, us
+unsigned long wakeLatencyMin = 0;
+unsigned long wakeLatencyMax = 0;
+unsigned long wakeLatencyTotal = 0;
+uint16_t wakeLatencyCount = 0;
+
+// Serial command input
+LineParser<COMMAND_BUFFER_SIZE> commandLine;
+unsigned long lastCommandByteTime = 0;
+
+// Binary frame output (BINARY / TEXT commands)
+bool binaryFrames = false;
+uint16_t frameSequence = 0;
+unsigned long lastFrameTime = 0;
+
+// Function prototypes (arduino-cli generates these; host builds need them)
+void handleSwitchEdge(const PinEdge& edge);
+void recordWakeLatency(unsigned long latency);
+void readCommands();
+void handleCommandLine(LineStatus status);
+void printStatus();
+void printBasisPoints(uint16_t bp);
+void sendFrame(uint8_t type, unsigned long eventTime, uint16_t value);
+
 void setup() {
   // Initialize serial communication
   Serial.begin(BAUD_RATE);
 
   // Initialize pins
-  pinMode(SWITCH_PIN, INPUT_PULLUP); // Enable internal pull-up resistor
+  switchEdges.begin(SWITCH_PIN);     // Internal pull-up + pin-change interrupt
   pinMode(LED_PIN, OUTPUT);
 
   // Visual feedback during startup
@@ -54,67 +101,96 @@ void setup() {
   digitalWrite(LED_PIN, HIGH);
   delay(500);
   digitalWrite(LED_PIN, LOW);
+
+  idle.restart();  // Duty cycle from here, not counting the start-up blinks
 }
 
 void loop() {
-  // Read switch state (LOW = pressed, HIGH = not pressed due to pull-up)
-  int reading = digitalRead(SWITCH_PIN);
-  unsigned long currentTime = millis();
+  // Debounced switch changes, stamped by the ISR (LOW = pressed, pull-up)
+  PinEdge edge;
+  while (switchEdges.poll(edge)) {
+    handleSwitchEdge(edge);
+  }
+
+  // Serial commands (serialEvent() isn't called for the 32U4's USB serial)
+  readCommands();
 
-  // Debounce the switch
-  if (reading != lastSwitchState) {
-    lastDebounceTime = currentTime;
+  // Binary mode: a quiet link still shows it's alive (and loses nothing)
+  if (binaryFrames && millis() - lastFrameTime >= TRIGGER_HEARTBEAT_MS) {
+    sendFrame(FRAME_HEARTBEAT, millis(), 0);
   }
 
-  if ((currentTime - lastDebounceTime) > DEBOUNCE_DELAY) {
-    // Switch state has been stable for debounce period
-    if (reading != switchState) {
-      switchState = reading;
-
-      // Check if switch was just pressed (went from HIGH to LOW)
-      if (switchState == LOW && !switchPressed) {
-        // Switch pressed!
-
-        // Check if enough time has passed since last trigger (cooldown)
-        if (currentTime - lastTriggerTime > COOLDOWN_DELAY) {
-          // Send trigger signal
-          Serial.println("TRIGGER");
-
-          // Visual feedback
-          digitalWrite(LED_PIN, HIGH);
-
-          // Update last trigger time
-          lastTriggerTime = currentTime;
-
-          // Mark as pressed
-          switchPressed = true;
-
-          // Debug info
-          Serial.print("Switch pressed at: ");
-          Serial.print(currentTime / 1000);
-          Serial.println(" seconds");
-        } else {
-          // Still in cooldown period
-          Serial.println("COOLDOWN");
-          unsigned long timeRemaining = COOLDOWN_DELAY - (currentTime - lastTriggerTime);
-          Serial.print("Wait ");
-          Serial.print(timeRemaining / 1000);
-          Serial.println(" more seconds");
-        }
-      } else if (switchState == HIGH && switchPressed) {
-        // Switch released
-        digitalWrite(LED_PIN, LOW);
-        switchPressed = false;
-        Serial.println("SWITCH_RELEASED");
+  // Sleep until the switch, USB or the next millis() tick wakes us
+  idle.sleep([] { return switchEdges.pending() || Serial.available() > 0; });
+}
+
+void handleSwitchEdge(const PinEdge& edge) {
+  unsigned long currentTime = millis();
+  unsigned long edgeTime = currentTime - (micros() - edge.micros) / 1000;  // When the switch moved
+
+  // Check if switch was just pressed (went from HIGH to LOW)
+  if (edge.level == LOW && !switchPressed) {
+    // Switch pressed!
+
+    // Check if enough time has passed since last trigger (cooldown)
+    if (currentTime - lastTriggerTime > COOLDOWN_DELAY) {
+      // Send trigger signal, stamped with when the switch closed
+      if (binaryFrames) {
+        sendFrame(FRAME_TRIGGER, edgeTime, 0);
+      } else {
+        Serial.println("TRIGGER");
+      }
+      recordWakeLatency(micros() - edge.micros);
+
+      // Visual feedback
+      digitalWrite(LED_PIN, HIGH);
+
+      // Update last trigger time
+      lastTriggerTime = currentTime;
+
+      // Mark as pressed
+      switchPressed = true;
+
+      // Debug info (the frame already carries the time)
+      if (!binaryFrames) {
+        Serial.print("Switch pressed at: ");
+        Serial.print(currentTime / 1000);
+        Serial.println(" seconds");
+      }
+    } else {
+      // Still in cooldown period
+      unsigned long timeRemaining = COOLDOWN_DELAY - (currentTime - lastTriggerTime);
+      if (binaryFrames) {
+        sendFrame(FRAME_COOLDOWN, edgeTime, (uint16_t)timeRemaining);
+      } else {
+        Serial.println("COOLDOWN");
+        Serial.print("Wait ");
+        Serial.print(timeRemaining / 1000);
+        Serial.println(" more seconds");
       }
     }
+  } else if (edge.level == HIGH && switchPressed) {
+    // Switch released
+    digitalWrite(LED_PIN, LOW);
+    switchPressed = false;
+    if (binaryFrames) {
+      sendFrame(FRAME_RELEASED, edgeTime, 0);
+    } else {
+      Serial.println("SWITCH_RELEASED");
+    }
   }
+}
 
-  // Update state
-  lastSwitchState = reading;
-
-  // Small delay for stability
-  delay(10);
+void recordWakeLatency(unsigned long latency) {
+  wakeLatencyLast = latency;
+  if (wakeLatencyCount == 0 || latency < wakeLatencyMin) wakeLatencyMin = latency;
+  if (latency > wakeLatencyMax) wakeLatencyMax = latency;
+  if (wakeLatencyCount == 0xFFFF) {  // Keep the average moving
+    wakeLatencyTotal /= 2;
+    wakeLatencyCount /= 2;
+  }
+  wakeLatencyTotal += latency;
+  wakeLatencyCount++;
 }
 
 /*
@@ -124,30 +200,134 @@ void loop() {
  *   "STATUS"  - Get current switch state
  *   "RESET"   - Reset cooldown timer
  *   "TEST"    - Manual trigger (for testing)
+ *   "BINARY"  - Send events as binary frames (trigger_frame.h)
+ *   "TEXT"    - Back to text lines (the power-up default)
+ *   "PING"    - Binary mode: answer with a PONG frame (link round trip)
  */
 
-void serialEvent() {
+void readCommands() {
   while (Serial.available()) {
-    String command = Serial.readStringUntil('\n');
-    command.trim();
-
-    if (command == "STATUS") {
-      Serial.print("Switch: ");
-      Serial.println(switchState == LOW ? "PRESSED" : "RELEASED");
-      Serial.print("Cooldown: ");
-      unsigned long timeSinceTrigger = millis() - lastTriggerTime;
-      if (timeSinceTrigger < COOLDOWN_DELAY) {
-        Serial.print(COOLDOWN_DELAY - timeSinceTrigger);
-        Serial.println(" ms remaining");
-      } else {
-        Serial.println("Ready");
-      }
-    } else if (command == "RESET") {
+    lastCommandByteTime = millis();
+    handleCommandLine(commandLine.feed(Serial.read()));
+  }
+
+  // A line sent without a newline still runs, once the sender goes quiet
+  if (commandLine.pending() && millis() - lastCommandByteTime >= COMMAND_TIMEOUT_MS) {
+    handleCommandLine(commandLine.finish());
+  }
+}
+
+void handleCommandLine(LineStatus status) {
+  if (status == LINE_TOO_LONG) {
+    Serial.println("ERROR: Command too long");
+    return;
+  }
+  if (status == LINE_MALFORMED) {
+    Serial.println("ERROR: Invalid characters in command");
+    return;
+  }
+  if (status != LINE_READY) {
+    return;
+  }
+
+  switch (parseTriggerCommand(commandLine.line())) {
+    case CMD_STATUS:
+      printStatus();
+      break;
+    case CMD_RESET:
       lastTriggerTime = 0;
       Serial.println("Cooldown reset");
-    } else if (command == "TEST") {
-      Serial.println("TRIGGER");
+      break;
+    case CMD_TEST:
+      if (binaryFrames) {
+        sendFrame(FRAME_TRIGGER, millis(), 1);
+      } else {
+        Serial.println("TRIGGER");
+      }
       Serial.println("Manual test trigger");
-    }
+      break;
+    case CMD_BINARY:
+      binaryFrames = true;
+      sendFrame(FRAME_READY, millis(), TRIGGER_FRAME_VERSION);
+      break;
+    case CMD_TEXT:
+      binaryFrames = false;
+      Serial.println("Text mode");
+      break;
+    case CMD_PING:
+      if (binaryFrames) {
+        sendFrame(FRAME_PONG, millis(), 0);
+      } else {
+        Serial.println("PONG");
+      }
+      break;
+    case CMD_UNKNOWN:
+      Serial.print("ERROR: Unknown command: ");
+      Serial.println(commandLine.line());
+      break;
+  }
+}
+
+void printStatus() {
+  Serial.print("Switch: ");
+  Serial.println(switchEdges.level() == LOW ? "PRESSED" : "RELEASED");
+  Serial.print("Cooldown: ");
+  unsigned long timeSinceTrigger = millis() - lastTriggerTime;
+  if (timeSinceTrigger < COOLDOWN_DELAY) {
+    Serial.print(COOLDOWN_DELAY - timeSinceTrigger);
+    Serial.println(" ms remaining");
+  } else {
+    Serial.println("Ready");
+  }
+
+  // Wake-to-TRIGGER: switch edge in the ISR to the TRIGGER written out
+  Serial.print("Wake-to-TRIGGER: ");
+  if (wakeLatencyCount == 0) {
+    Serial.println("no presses yet");
+  } else {
+    Serial.print(wakeLatencyLast);
+    Serial.print(" us (min ");
+    Serial.print(wakeLatencyMin);
+    Serial.print(", avg ");
+    Serial.print(wakeLatencyTotal / wakeLatencyCount);
+    Serial.print(", max ");
+    Serial.print(wakeLatencyMax);
+    Serial.print(", ");
+    Serial.print(wakeLatencyCount);
+    Serial.println(" presses)");
   }
+
+  // Active duty cycle: since the last STATUS, and since boot
+  IdleCounters now = idle.counters();
+  IdleCounters boot = {0, 0, 0};
+  Serial.print("Active: ");
+  printBasisPoints(IdleSleep::dutyBasisPoints(idleAtLastStatus, now));
+  Serial.print("% since last STATUS, ");
+  printBasisPoints(IdleSleep::dutyBasisPoints(boot, now));
+  Serial.print("% since boot, ");
+  unsigned long window = now.totalMillis - idleAtLastStatus.totalMillis;
+  unsigned long wakes = now.wakes - idleAtLastStatus.wakes;
+  Serial.print(window >= 1000 ? wakes / (window / 1000) : window ? wakes * 1000UL / window : 0);
+  Serial.println(" wakes/s");
+  idleAtLastStatus = now;
+}
+
+// 1234 -> "12.34"
+void printBasisPoints(uint16_t bp) {
+  Serial.print(bp / 100);
+  Serial.print('.');
+  if (bp % 100 < 10) Serial.print('0');
+  Serial.print(bp % 100);
+}
+
+void sendFrame(uint8_t type, unsigned long eventTime, uint16_t value) {
+  TriggerFrame frame;
+  frame.type = type;
+  frame.sequence = frameSequence++;
+  frame.millis = eventTime;
+  frame.value = value;
+
+  uint8_t wire[TRIGGER_FRAME_WIRE_SIZE];
+  Serial.write(wire, encodeTriggerFrame(frame, wire));
+  lastFrameTime = millis();
 }
@@ -0,0 +1,153 @@
+/*
+ * Trigger Frames - Binary Serial Messages (No Hardware Dependencies)
+ *
+ * The text protocol makes the server wait for "TRIGGER\r\n" to finish
+ * before it can react, and gives it no way to tell a lost or repeated
+ * message from a quiet switch. In binary mode (the BINARY command) the
+ * sketch sends each event as one fixed-size frame instead:
+ *
+ *   offset  size  field
+ *        0     1  version << 4 | type
+ *        1     2  sequence number (little-endian, +1 per frame, wraps)
+ *        3     4  millis() when the event happened (little-endian)
+ *        7     2  value (type-specific, little-endian)
+ *        9     2  CRC-16/CCITT-FALSE of bytes 0-8 (little-endian)
+ *
+ * The 11 bytes are COBS-encoded (no zero bytes inside) and sent between
+ * two 0x00 delimiters, 14 bytes in all:
+ *
+ *   uint8_t wire[TRIGGER_FRAME_WIRE_SIZE];
+ *   Serial.write(wire, encodeTriggerFrame(frame, wire));
+ *
+ * Text lines (command replies) still go out between frames; they never
+ * contain 0x00 and never start with a byte below 0x20, which is how a
+ * decoder tells them from the COBS code byte that starts every frame.
+ *
+ * Can be included in both the Arduino sketch and host programs
+ * (trigger_frame_decoder.h is the host-side stream decoder).
+ */
+
+#ifndef TRIGGER_FRAME_H
+#define TRIGGER_FRAME_H
+
+#include <stdint.h>
+
+#define TRIGGER_FRAME_VERSION 1
+#define TRIGGER_FRAME_PAYLOAD_SIZE 11                          // Fields + CRC
+#define TRIGGER_FRAME_COBS_SIZE (TRIGGER_FRAME_PAYLOAD_SIZE + 1)
+#define TRIGGER_FRAME_WIRE_SIZE (TRIGGER_FRAME_COBS_SIZE + 2)  // + 0x00 both ends
+#define TRIGGER_HEARTBEAT_MS 1000                              // Idle frame rate
+
+enum TriggerFrameType {
+  FRAME_READY = 1,      // Binary mode on; value = TRIGGER_FRAME_VERSION
+  FRAME_TRIGGER = 2,    // Switch press; value = 1 for the TEST command
+  FRAME_RELEASED = 3,   // Switch released
+  FRAME_COOLDOWN = 4,   // Press ignored; value = cooldown ms remaining
+  FRAME_HEARTBEAT = 5,  // Nothing happened for TRIGGER_HEARTBEAT_MS
+  FRAME_PONG = 6        // Reply to PING, sent as soon as it is read
+};
+
+struct TriggerFrame {
+  uint8_t type;
+  uint16_t sequence;
+  uint32_t millis;
+  uint16_t value;
+};
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF): bitwise, no table in flash
+ */
+inline uint16_t triggerFrameCrc(const uint8_t* data, uint8_t length) {
+  uint16_t crc = 0xFFFF;
+  while (length--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/**
+ * COBS: `length` bytes (< 254) to length + 1 bytes with no zeros
+ */
+inline uint8_t cobsEncode(const uint8_t* in, uint8_t length, uint8_t* out) {
+  uint8_t codeAt = 0;
+  uint8_t code = 1;
+  uint8_t o = 1;
+  for (uint8_t i = 0; i < length; i++) {
+    if (in[i] == 0) {
+      out[codeAt] = code;
+      codeAt = o++;
+      code = 1;
+    } else {
+      out[o++] = in[i];
+      code++;
+    }
+  }
+  out[codeAt] = code;
+  return o;
+}
+
+/**
+ * Inverse of cobsEncode(); the decoded length, or 0 if `in` isn't valid COBS
+ */
+inline uint8_t cobsDecode(const uint8_t* in, uint8_t length, uint8_t* out) {
+  uint8_t o = 0;
+  uint8_t i = 0;
+  while (i < length) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > length) return 0;
+    for (uint8_t k = 1; k < code; k++) {
+      if (in[i] == 0) return 0;
+      out[o++] = in[i++];
+    }
+    if (code < 0xFF && i < length) out[o++] = 0;
+  }
+  return o;
+}
+
+/**
+ * Frame to wire bytes (0x00, COBS, 0x00); returns TRIGGER_FRAME_WIRE_SIZE
+ */
+inline uint8_t encodeTriggerFrame(const TriggerFrame& frame, uint8_t* wire) {
+  uint8_t payload[TRIGGER_FRAME_PAYLOAD_SIZE];
+  payload[0] = (uint8_t)(TRIGGER_FRAME_VERSION << 4 | (frame.type & 0x0F));
+  payload[1] = (uint8_t)frame.sequence;
+  payload[2] = (uint8_t)(frame.sequence >> 8);
+  payload[3] = (uint8_t)frame.millis;
+  payload[4] = (uint8_t)(frame.millis >> 8);
+  payload[5] = (uint8_t)(frame.millis >> 16);
+  payload[6] = (uint8_t)(frame.millis >> 24);
+  payload[7] = (uint8_t)frame.value;
+  payload[8] = (uint8_t)(frame.value >> 8);
+  uint16_t crc = triggerFrameCrc(payload, TRIGGER_FRAME_PAYLOAD_SIZE - 2);
+  payload[9] = (uint8_t)crc;
+  payload[10] = (uint8_t)(crc >> 8);
+
+  wire[0] = 0;
+  uint8_t length = 1 + cobsEncode(payload, TRIGGER_FRAME_PAYLOAD_SIZE, wire + 1);
+  wire[length++] = 0;
+  return length;
+}
+
+/**
+ * COBS bytes between two delimiters to a frame; false if the length,
+ * encoding, CRC or version is wrong
+ */
+inline bool decodeTriggerFrame(const uint8_t* cobs, uint8_t length, TriggerFrame& frame) {
+  if (length != TRIGGER_FRAME_COBS_SIZE) return false;
+  uint8_t payload[TRIGGER_FRAME_COBS_SIZE];
+  if (cobsDecode(cobs, length, payload) != TRIGGER_FRAME_PAYLOAD_SIZE) return false;
+  uint16_t crc = (uint16_t)(payload[9] | payload[10] << 8);
+  if (crc != triggerFrameCrc(payload, TRIGGER_FRAME_PAYLOAD_SIZE - 2)) return false;
+  if (payload[0] >> 4 != TRIGGER_FRAME_VERSION) return false;
+  frame.type = payload[0] & 0x0F;
+  frame.sequence = (uint16_t)(payload[1] | payload[2] << 8);
+  frame.millis = (uint32_t)payload[3] | (uint32_t)payload[4] << 8 |
+                 (uint32_t)payload[5] << 16 | (uint32_t)payload[6] << 24;
+  frame.value = (uint16_t)(payload[7] | payload[8] << 8);
+  return true;
+}
+
+#endif // TRIGGER_FRAME_H
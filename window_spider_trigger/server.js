@@ -9,8 +9,8 @@ const express = require('express');
 const http = require('http');
 const socketIo = require('socket.io');
 const { SerialPort } = require('serialport');
-const { ReadlineParser } = require('@serialport/parser-readline');
 const path = require('path');
+const { FrameType, TriggerStreamParser, SequenceTracker } = require('./trigger_protocol');
 
 // Load environment variables from .env file
 require('dotenv').config();
@@ -39,12 +39,64 @@ let stats = {
   triggers: 0,
   lastTriggerTime: null,
   startTime: new Date(),
-  connected: false
+  connected: false,
+  lostFrames: 0,
+  duplicateFrames: 0,
+  badFrames: 0
 };
 
 // Initialize serial port
 let port;
 let parser;
+let sequence = new SequenceTracker();
+
+function triggerScare(source) {
+  console.log(`🕷️  MOTION DETECTED (${source}) - Triggering scare!`);
+  stats.triggers++;
+  stats.lastTriggerTime = new Date();
+
+  // Send trigger to all connected clients
+  io.emit('trigger-video');
+  io.emit('stats-update', stats);
+}
+
+// Binary frames from the Arduino (after we send BINARY)
+function handleFrame(frame) {
+  if (!sequence.check(frame)) {
+    stats.duplicateFrames = sequence.duplicates;
+    return;
+  }
+  if (sequence.lost !== stats.lostFrames) {
+    console.warn(`⚠ ${sequence.lost - stats.lostFrames} frame(s) lost before #${frame.sequence}`);
+    stats.lostFrames = sequence.lost;
+  }
+
+  if (frame.type === FrameType.TRIGGER) {
+    triggerScare(frame.value ? 'test' : `switch, device ${frame.millis} ms`);
+  } else if (frame.type === FrameType.READY) {
+    console.log('✓ Arduino ready (binary frames)');
+    io.emit('arduino-status', { ready: true });
+  } else if (frame.type === FrameType.COOLDOWN) {
+    console.log(`Arduino: cooldown, ${frame.value} ms remaining`);
+  }
+}
+
+// Text lines from Arduino (command replies, or a sketch in text mode)
+function handleLine(line) {
+  const data = line.trim();
+  console.log(`Arduino: ${data}`);
+
+  if (data === 'TRIGGER') {
+    triggerScare('text');
+  } else if (data === 'READY') {
+    console.log('✓ Arduino ready');
+    io.emit('arduino-status', { ready: true });
+    port.write('BINARY\n');  // It was reset: back to frames
+  } else if (data === 'STARTUP') {
+    console.log('Arduino starting up...');
+    io.emit('arduino-status', { startup: true });
+  }
+}
 
 async function findArduinoPort() {
   const ports = await SerialPort.list();
@@ -89,13 +141,23 @@ async function initSerial() {
       baudRate: BAUD_RATE
     });
 
-    parser = port.pipe(new ReadlineParser({ delimiter: '\n' }));
+    sequence = new SequenceTracker();
+    parser = new TriggerStreamParser({
+      onFrame: handleFrame,
+      onLine: handleLine,
+      onBadFrame: () => {
+        stats.badFrames++;
+        console.warn('⚠ Corrupt frame from Arduino');
+      }
+    });
+    port.on('data', (chunk) => parser.push(chunk));
 
     port.on('open', () => {
       console.log(`✓ Serial port ${port.path} opened`);
       console.log(`  Baud rate: ${BAUD_RATE}`);
       stats.connected = true;
       io.emit('serial-status', { connected: true });
+      port.write('BINARY\n');  // Frames act on arrival; text waits for the line end
     });
 
     port.on('error', (err) => {
@@ -110,28 +172,6 @@ async function initSerial() {
       io.emit('serial-status', { connected: false });
     });
 
-    // Listen for data from Arduino
-    parser.on('data', (line) => {
-      const data = line.trim();
-      console.log(`Arduino: ${data}`);
-
-      if (data === 'TRIGGER') {
-        console.log('🕷️  MOTION DETECTED - Triggering scare!');
-        stats.triggers++;
-        stats.lastTriggerTime = new Date();
-
-        // Send trigger to all connected clients
-        io.emit('trigger-video');
-        io.emit('stats-update', stats);
-      } else if (data === 'READY') {
-        console.log('✓ Arduino ready');
-        io.emit('arduino-status', { ready: true });
-      } else if (data === 'STARTUP') {
-        console.log('Arduino starting up...');
-        io.emit('arduino-status', { startup: true });
-      }
-    });
-
   } catch (err) {
     console.error('✗ Failed to initialize serial port:', err.message);
     console.error('  Make sure:');
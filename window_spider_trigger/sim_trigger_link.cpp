@@ -0,0 +1,209 @@
+/*
+ * Host Simulator for motion_trigger.ino's Binary Frames
+ *
+ * Runs the production sketch against host_sim/ in binary mode and carries
+ * its serial output to a host over a model of the USB CDC link: bytes the
+ * sketch writes wait for the next 1 ms USB frame, then a host-side delay
+ * (driver + scheduler, usually well under a millisecond, sometimes tens).
+ * The host end pings once a second and the switch is pressed every 7 s.
+ *
+ * Frames can be dropped, duplicated or corrupted on the way (--drop,
+ * --dup, --corrupt: probability per frame). The reference decoder's
+ * statistics must find exactly what was injected, and every press that
+ * got through must arrive as one TRIGGER.
+ *
+ * Reports the same latency/loss table as trigger_stats does live.
+ * Exits non-zero if the decoder's counts disagree with what was injected.
+ *
+ * Build and run:
+ *   pixi run sim-trigger-link
+ *   ./sim_trigger_link --minutes 600 --drop 0.01 --dup 0.01 --corrupt 0.01 --seed 3
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <vector>
+#include "Arduino.h"
+#include "arduino/motion_trigger/motion_trigger.ino"
+#include "trigger_frame_decoder.h"
+
+struct SentByte {
+  uint8_t byte;
+  uint64_t micros;
+};
+
+// USB CDC IN path: 1 ms frames, then host driver/scheduler delay, in order
+class UsbLink {
+ public:
+  explicit UsbLink(uint32_t seed) : rng_(seed) {}
+
+  uint64_t deliveryMicros(uint64_t sentMicros) {
+    uint64_t usbFrame = (sentMicros / 1000 + 1) * 1000;
+    if (usbFrame != lastUsbFrame_) {
+      lastUsbFrame_ = usbFrame;
+      std::exponential_distribution<double> stack(1.0 / 250);  // us
+      double delay = 150 + stack(rng_);
+      if (uniform() < 0.01) delay += 2000 + uniform() * 18000;  // Host busy
+      frameDelivery_ = std::max(lastDelivery_, usbFrame + (uint64_t)delay);
+      lastDelivery_ = frameDelivery_;
+    }
+    return frameDelivery_;
+  }
+
+  // Host to device (PING): the bytes are there this long after write()
+  uint64_t outDelayMicros() { return 1000 + (uint64_t)(uniform() * 1000); }
+
+  double uniform() { return std::uniform_real_distribution<double>(0, 1)(rng_); }
+
+ private:
+  std::mt19937 rng_;
+  uint64_t lastUsbFrame_ = 0;
+  uint64_t frameDelivery_ = 0;
+  uint64_t lastDelivery_ = 0;
+};
+
+struct Injected {
+  uint64_t frames = 0;
+  uint64_t dropped = 0;
+  uint64_t duplicated = 0;
+  uint64_t corrupted = 0;
+  uint64_t triggersSent = 0;
+  uint64_t triggersLost = 0;
+};
+
+static std::vector<SentByte> pending;  // Written by the sketch this pass
+
+int main(int argc, char** argv) {
+  double minutes = 60;
+  double dropRate = 0.002;
+  double dupRate = 0.002;
+  double corruptRate = 0.002;
+  uint32_t seed = 1;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--minutes") && i + 1 < argc) minutes = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--drop") && i + 1 < argc) dropRate = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--dup") && i + 1 < argc) dupRate = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--corrupt") && i + 1 < argc) corruptRate = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (uint32_t)atoi(argv[++i]);
+    else {
+      printf("Usage: %s [--minutes N] [--drop P] [--dup P] [--corrupt P] [--seed N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  sim::reset();
+  setup();
+  Serial.output.clear();
+  Serial.echo = true;
+  Serial.echoHook = [](uint8_t c) { pending.push_back(SentByte{c, sim::nowMicros}); };
+  sim::serialInput("BINARY\n");
+
+  UsbLink link(seed);
+  TriggerStreamDecoder decoder;
+  TriggerLinkStats stats;
+  Injected injected;
+  uint64_t triggersReceived = 0;
+  uint64_t endMicros = sim::nowMicros + (uint64_t)(minutes * 60e6);
+  uint64_t faultsUntil = endMicros - 3000000;  // A loss at the very end can't be seen
+  unsigned long nextPressAt = millis() + 2000;
+  unsigned long releaseAt = 0;
+  uint64_t nextPingMicros = sim::nowMicros + 1500000;
+  uint64_t lastPassMicros = 0;
+  std::deque<std::pair<uint64_t, std::string>> toDevice;  // (arrives at, bytes)
+
+  while (sim::nowMicros < endMicros) {
+    unsigned long now = millis();
+    if (now >= nextPressAt) {
+      sim::setPin(SWITCH_PIN, LOW);
+      releaseAt = now + 150;
+      nextPressAt = now + 7000;
+    } else if (releaseAt && now >= releaseAt) {
+      sim::setPin(SWITCH_PIN, HIGH);
+      releaseAt = 0;
+    }
+
+    // Host -> device: a PING sent somewhere in the last pass
+    if (sim::nowMicros >= nextPingMicros) {
+      uint64_t sentAt = sim::nowMicros - (uint64_t)(link.uniform() * lastPassMicros);
+      stats.pingSent(sentAt);
+      toDevice.push_back(std::make_pair(sentAt + link.outDelayMicros(), std::string("PING\n")));
+      nextPingMicros += 1000000;
+    }
+    while (!toDevice.empty() && toDevice.front().first <= sim::nowMicros) {
+      sim::serialInput(toDevice.front().second.c_str());
+      toDevice.pop_front();
+    }
+
+    pending.clear();
+    uint64_t passStart = sim::nowMicros;
+    loop();
+    lastPassMicros = sim::nowMicros - passStart;
+
+    // Device -> host, frame by frame, with faults
+    for (size_t i = 0; i < pending.size();) {
+      TriggerFrame sentFrame;
+      uint8_t cobs[TRIGGER_FRAME_COBS_SIZE];
+      bool isFrame = pending[i].byte == 0 && i + TRIGGER_FRAME_WIRE_SIZE <= pending.size() &&
+                     pending[i + TRIGGER_FRAME_WIRE_SIZE - 1].byte == 0;
+      if (isFrame) {
+        for (int k = 0; k < TRIGGER_FRAME_COBS_SIZE; k++) cobs[k] = pending[i + 1 + k].byte;
+        isFrame = decodeTriggerFrame(cobs, TRIGGER_FRAME_COBS_SIZE, sentFrame);
+      }
+      if (!isFrame) {  // Text
+        uint64_t at = link.deliveryMicros(pending[i].micros);
+        if (decoder.feed(pending[i].byte) == STREAM_FRAME) stats.frame(decoder.frame(), at);
+        i++;
+        continue;
+      }
+
+      std::vector<SentByte> frameBytes(pending.begin() + i, pending.begin() + i + TRIGGER_FRAME_WIRE_SIZE);
+      i += TRIGGER_FRAME_WIRE_SIZE;
+      injected.frames++;
+      bool isTrigger = sentFrame.type == FRAME_TRIGGER;
+      injected.triggersSent += isTrigger;
+      bool faultsOn = frameBytes[0].micros < faultsUntil && injected.frames > 1;
+      double roll = link.uniform();
+      int copies = 1;
+      if (faultsOn && roll < dropRate) {
+        copies = 0;
+        injected.dropped++;
+        injected.triggersLost += isTrigger;
+      } else if (faultsOn && roll < dropRate + corruptRate) {
+        uint8_t& hit = frameBytes[TRIGGER_FRAME_WIRE_SIZE / 2].byte;
+        hit = hit == 0x04 ? 0x40 : hit ^ 0x04;  // Never a 0x00: that would split it in two
+        injected.corrupted++;
+        injected.triggersLost += isTrigger;
+      } else if (faultsOn && roll < dropRate + corruptRate + dupRate) {
+        copies = 2;
+        injected.duplicated++;
+      }
+      for (int copy = 0; copy < copies; copy++) {
+        for (const SentByte& sent : frameBytes) {
+          uint64_t at = link.deliveryMicros(sent.micros);
+          if (decoder.feed(sent.byte) == STREAM_FRAME) {
+            stats.frame(decoder.frame(), at);
+            if (decoder.frame().type == FRAME_TRIGGER && copy == 0) triggersReceived++;
+          }
+        }
+      }
+    }
+  }
+
+  printf("motion_trigger binary frames over simulated USB: %.1f min, seed %u\n", minutes, seed);
+  printf("Injected: %llu frames sent, %llu dropped, %llu duplicated, %llu corrupted\n",
+         (unsigned long long)injected.frames, (unsigned long long)injected.dropped,
+         (unsigned long long)injected.duplicated, (unsigned long long)injected.corrupted);
+  stats.printReport(stdout, decoder.badFrames);
+  printf("Presses: %llu TRIGGER frames sent, %llu received\n",
+         (unsigned long long)injected.triggersSent, (unsigned long long)triggersReceived);
+
+  bool ok = stats.lost == injected.dropped + injected.corrupted &&
+            stats.duplicates == injected.duplicated &&
+            decoder.badFrames == injected.corrupted &&
+            stats.outOfOrder == 0 &&
+            triggersReceived == injected.triggersSent - injected.triggersLost;
+  printf("%s\n", ok ? "OK" : "FAIL: decoder counts don't match what was injected");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+/*
+ * Serial Command Soak Test for motion_trigger.ino
+ *
+ * Runs the production sketch against host_sim/ for a simulated day of
+ * serial traffic - good commands with every line ending, commands split
+ * across loop passes, commands with no newline, overlong lines, control
+ * and non-ASCII garbage, unknown words - while the switch is pressed
+ * every few seconds.
+ *
+ * Every global operator new made while loop() runs is counted, so any
+ * heap use in the command path (an Arduino String, a std::string on the
+ * host) shows up. Also checks each line got exactly its one answer and no
+ * switch press was missed or delayed by serial input.
+ * Exits non-zero on any heap allocation, lost or extra answer, or missed
+ * press.
+ *
+ * Build and run:
+ *   pixi run soak-command-parser
+ *   ./soak_command_parser --hours 168 --seed 7
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include "Arduino.h"
+#include "arduino/motion_trigger/motion_trigger.ino"
+
+// Heap accounting: only allocations made while the sketch runs count
+static bool countingAllocations = false;
+static uint64_t sketchAllocations = 0;
+static uint64_t sketchAllocatedBytes = 0;
+
+void* operator new(size_t size) {
+  if (countingAllocations) {
+    sketchAllocations++;
+    sketchAllocatedBytes += size;
+  }
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// What the sketch should answer with, tallied as traffic is generated
+struct Expected {
+  uint64_t status = 0;
+  uint64_t reset = 0;
+  uint64_t test = 0;
+  uint64_t unknown = 0;
+  uint64_t tooLong = 0;
+  uint64_t malformed = 0;
+  uint64_t presses = 0;
+};
+
+// What it actually answered
+struct Answers {
+  uint64_t status = 0;
+  uint64_t reset = 0;
+  uint64_t test = 0;
+  uint64_t unknown = 0;
+  uint64_t tooLong = 0;
+  uint64_t malformed = 0;
+  uint64_t triggers = 0;
+};
+
+static size_t countOf(const std::string& text, const char* what) {
+  size_t n = 0;
+  for (size_t at = text.find(what); at != std::string::npos; at = text.find(what, at + 1)) n++;
+  return n;
+}
+
+class Traffic {
+ public:
+  explicit Traffic(uint32_t seed) : rng_(seed) {}
+
+  // Next line's bytes, or "" (quiet) - tallies the answer it should get
+  std::string nextLine(Expected& expected, bool& needsQuiet) {
+    static const char* COMMANDS[] = {"STATUS", "RESET", "TEST"};
+    static const char* ENDINGS[] = {"\n", "\r\n", "\r"};
+    needsQuiet = false;
+    std::string line;
+    int kind = pick(100);
+    if (kind < 55) {                      // Good command
+      int c = pick(3);
+      line = std::string(pick(3), ' ') + COMMANDS[c] + std::string(pick(3), ' ');
+      if (pick(10) == 0) {
+        needsQuiet = true;                // No line ending
+      } else {
+        line += ENDINGS[pick(3)];
+      }
+      (c == 0 ? expected.status : c == 1 ? expected.reset : expected.test)++;
+    } else if (kind < 70) {               // Overlong
+      int length = COMMAND_BUFFER_SIZE + pick(64);
+      for (int i = 0; i < length; i++) line += (char)('A' + pick(26));
+      line += ENDINGS[pick(3)];
+      expected.tooLong++;
+    } else if (kind < 85) {               // Garbage bytes in a short line
+      int length = 1 + pick(COMMAND_BUFFER_SIZE - 2);
+      int bad = pick(length);
+      for (int i = 0; i < length; i++) {
+        if (i == bad) {
+          static const char GARBAGE[] = {'\0', '\x01', '\x1B', '\x7F', '\x80', '\xC3', '\xFF'};
+          line += GARBAGE[pick(sizeof(GARBAGE))];
+        } else {
+          line += (char)('a' + pick(26));
+        }
+      }
+      line += ENDINGS[pick(3)];
+      expected.malformed++;
+    } else if (kind < 95) {               // Unknown word
+      line = pick(2) ? "status" : "HELLO";
+      line += ENDINGS[pick(3)];
+      expected.unknown++;
+    } else {
+      line = ENDINGS[pick(3)];            // Blank line: no answer
+    }
+    return line;
+  }
+
+  int pick(int n) { return (int)(rng_() % (uint32_t)n); }
+
+ private:
+  std::mt19937 rng_;
+};
+
+int main(int argc, char** argv) {
+  double hours = 24;
+  uint32_t seed = 1;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--hours") && i + 1 < argc) hours = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (uint32_t)atoi(argv[++i]);
+    else {
+      printf("Usage: %s [--hours N] [--seed N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  sim::reset();
+  setup();
+  Serial.output.clear();
+  Serial.output.reserve(1 << 17);  // Capture never reallocates during the run
+
+  Traffic traffic(seed);
+  Expected expected;
+  Answers answers;
+  std::string pendingBytes;
+  uint64_t bytesSent = 0;
+  uint64_t loops = 0;
+  unsigned long quietUntil = 0;
+  bool quietAfterLine = false;
+  unsigned long nextPressAt = millis() + 5000;
+  unsigned long releaseAt = 0;
+  unsigned long pressedAt = 0;
+  unsigned long worstPressLatency = 0;
+  uint64_t missedPresses = 0;
+  bool waitingForTrigger = false;
+  uint64_t endMicros = sim::nowMicros + (uint64_t)(hours * 3600e6);
+
+  while (sim::nowMicros < endMicros) {
+    unsigned long now = millis();
+
+    // Switch: a 200 ms press every 5 s (cooldown is 3 s)
+    if (now >= nextPressAt) {
+      if (waitingForTrigger) missedPresses++;
+      sim::setPin(SWITCH_PIN, LOW);
+      pressedAt = now;
+      releaseAt = now + 200;
+      nextPressAt = now + 5000;
+      waitingForTrigger = true;
+      expected.presses++;
+    } else if (releaseAt && now >= releaseAt) {
+      sim::setPin(SWITCH_PIN, HIGH);
+      releaseAt = 0;
+    }
+
+    // Serial: a few bytes of the current line per pass, like USB packets
+    bool lastSeconds = sim::nowMicros + 2000000 > endMicros;  // Let the last line finish
+    if (pendingBytes.empty() && now >= quietUntil && !lastSeconds && traffic.pick(4) == 0) {
+      pendingBytes = traffic.nextLine(expected, quietAfterLine);
+    }
+    if (!pendingBytes.empty()) {
+      size_t chunk = std::min(pendingBytes.size(), (size_t)(1 + traffic.pick(8)));
+      for (size_t i = 0; i < chunk; i++) Serial.input.push_back((uint8_t)pendingBytes[i]);
+      pendingBytes.erase(0, chunk);
+      bytesSent += chunk;
+      if (pendingBytes.empty() && quietAfterLine) {
+        quietUntil = now + COMMAND_TIMEOUT_MS + 100;  // Let the sketch time the line out
+        quietAfterLine = false;
+      }
+    }
+
+    countingAllocations = true;
+    loop();
+    countingAllocations = false;
+    loops++;
+
+    const std::string& out = Serial.output;
+    if (!out.empty()) {
+      answers.status += countOf(out, "Switch: ");
+      answers.reset += countOf(out, "Cooldown reset");
+      answers.test += countOf(out, "Manual test trigger");
+      answers.unknown += countOf(out, "ERROR: Unknown command");
+      answers.tooLong += countOf(out, "ERROR: Command too long");
+      answers.malformed += countOf(out, "ERROR: Invalid characters");
+      uint64_t pressTriggers = countOf(out, "Switch pressed at");
+      answers.triggers += pressTriggers;
+      if (pressTriggers && waitingForTrigger) {
+        unsigned long latency = millis() - pressedAt;
+        if (latency > worstPressLatency) worstPressLatency = latency;
+        waitingForTrigger = false;
+      }
+      Serial.output.clear();  // Keeps its capacity
+    }
+  }
+
+  double simHours = sim::nowMicros / 3600e6;
+  printf("motion_trigger serial soak: %.1f simulated hours, seed %u\n", simHours, seed);
+  printf("  loop() passes              %12llu\n", (unsigned long long)loops);
+  printf("  bytes received             %12llu\n", (unsigned long long)bytesSent);
+  printf("  %-12s %10s %10s\n", "answer", "expected", "got");
+  printf("  %-12s %10llu %10llu\n", "STATUS", (unsigned long long)expected.status, (unsigned long long)answers.status);
+  printf("  %-12s %10llu %10llu\n", "RESET", (unsigned long long)expected.reset, (unsigned long long)answers.reset);
+  printf("  %-12s %10llu %10llu\n", "TEST", (unsigned long long)expected.test, (unsigned long long)answers.test);
+  printf("  %-12s %10llu %10llu\n", "unknown", (unsigned long long)expected.unknown, (unsigned long long)answers.unknown);
+  printf("  %-12s %10llu %10llu\n", "too long", (unsigned long long)expected.tooLong, (unsigned long long)answers.tooLong);
+  printf("  %-12s %10llu %10llu\n", "malformed", (unsigned long long)expected.malformed, (unsigned long long)answers.malformed);
+  printf("  %-12s %10llu %10llu   (worst press-to-TRIGGER %lu ms)\n", "presses",
+         (unsigned long long)expected.presses, (unsigned long long)answers.triggers, worstPressLatency);
+  printf("  heap allocations in loop() %12llu (%llu bytes)\n",
+         (unsigned long long)sketchAllocations, (unsigned long long)sketchAllocatedBytes);
+
+  bool ok = sketchAllocations == 0 &&
+            answers.status == expected.status && answers.reset == expected.reset &&
+            answers.test == expected.test && answers.unknown == expected.unknown &&
+            answers.tooLong == expected.tooLong && answers.malformed == expected.malformed &&
+            missedPresses == 0 && answers.triggers + (waitingForTrigger ? 1 : 0) == expected.presses;
+  printf("%s\n", ok ? "OK" : "FAIL");
+  return ok ? 0 : 1;
+}
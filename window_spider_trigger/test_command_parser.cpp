@@ -0,0 +1,282 @@
+/*
+ * Unit Tests for the Serial Command Parser
+ *
+ * Feeds LineParser commands the way USB serial delivers them - split at
+ * any byte, with CR/LF/CRLF endings, overlong and with garbage in them -
+ * then runs motion_trigger.ino against host_sim/ to check the sketch
+ * answers each command once, between switch reads, without blocking.
+ * Uses Google Test framework.
+ *
+ * Build and run:
+ *   pixi run test-command-parser
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include "Arduino.h"
+#include "arduino/motion_trigger/motion_trigger.ino"
+
+typedef LineParser<COMMAND_BUFFER_SIZE> Parser;
+
+// Feed a string; the status of its last byte
+static LineStatus feedAll(Parser& parser, const std::string& bytes) {
+  LineStatus status = LINE_PENDING;
+  for (char c : bytes) status = parser.feed(c);
+  return status;
+}
+
+// Every complete line in `bytes`, one string per LINE_READY
+static std::vector<std::string> readyLines(Parser& parser, const std::string& bytes) {
+  std::vector<std::string> lines;
+  for (char c : bytes) {
+    if (parser.feed(c) == LINE_READY) lines.push_back(parser.line());
+  }
+  return lines;
+}
+
+// Line Tests
+TEST(LineParser, NewlineEndsLine) {
+  Parser parser;
+  EXPECT_EQ(LINE_PENDING, feedAll(parser, "STATUS"));
+  EXPECT_TRUE(parser.pending());
+  EXPECT_EQ(LINE_READY, parser.feed('\n'));
+  EXPECT_STREQ("STATUS", parser.line());
+  EXPECT_EQ(6, parser.lineLength());
+  EXPECT_FALSE(parser.pending());
+}
+
+TEST(LineParser, LineSplitAcrossReadsIsOneLine) {
+  Parser parser;
+  EXPECT_EQ(LINE_PENDING, feedAll(parser, "ST"));
+  EXPECT_EQ(LINE_PENDING, feedAll(parser, "AT"));
+  EXPECT_EQ(LINE_READY, feedAll(parser, "US\n"));
+  EXPECT_STREQ("STATUS", parser.line());
+}
+
+TEST(LineParser, CrLfAndCrEndingsGiveOneLineEach) {
+  Parser parser;
+  std::vector<std::string> lines = readyLines(parser, "TEST\r\nRESET\rSTATUS\n");
+  ASSERT_EQ(3u, lines.size());
+  EXPECT_EQ("TEST", lines[0]);
+  EXPECT_EQ("RESET", lines[1]);
+  EXPECT_EQ("STATUS", lines[2]);
+}
+
+TEST(LineParser, BlankLinesAreSkipped) {
+  Parser parser;
+  EXPECT_EQ(LINE_PENDING, feedAll(parser, "\n\r\n  \t\n"));
+  EXPECT_EQ(0, parser.lines());
+}
+
+TEST(LineParser, WhitespaceIsTrimmed) {
+  Parser parser;
+  EXPECT_EQ(LINE_READY, feedAll(parser, "  \tRESET \t \n"));
+  EXPECT_STREQ("RESET", parser.line());
+}
+
+TEST(LineParser, LongestLineFits) {
+  Parser parser;
+  std::string longest(Parser::capacity(), 'A');
+  EXPECT_EQ(LINE_READY, feedAll(parser, longest + "\n"));
+  EXPECT_EQ(longest, parser.line());
+}
+
+TEST(LineParser, OverlongLineIsDroppedWhole) {
+  Parser parser;
+  std::string overlong(Parser::capacity() + 1, 'A');
+  EXPECT_EQ(LINE_PENDING, feedAll(parser, overlong));
+  EXPECT_TRUE(parser.pending());
+  EXPECT_EQ(LINE_TOO_LONG, parser.feed('\n'));
+  EXPECT_STREQ("", parser.line());
+  EXPECT_EQ(1, parser.tooLong());
+}
+
+TEST(LineParser, OverlongLineEndingInACommandDoesNotRunIt) {
+  Parser parser;
+  std::vector<std::string> lines = readyLines(parser, std::string(40, 'x') + "TEST\nTEST\n");
+  ASSERT_EQ(1u, lines.size());  // Only the real one
+  EXPECT_EQ(1, parser.tooLong());
+}
+
+TEST(LineParser, ControlBytesMakeLineMalformed) {
+  Parser parser;
+  EXPECT_EQ(LINE_MALFORMED, feedAll(parser, std::string("TE\x01ST\n")));
+  EXPECT_EQ(LINE_MALFORMED, feedAll(parser, std::string("TEST\x7F\n")));
+  EXPECT_EQ(LINE_MALFORMED, feedAll(parser, std::string("\xC3\xA9TEST\n")));
+  EXPECT_EQ(LINE_MALFORMED, feedAll(parser, std::string("TE\0ST\n", 6)));
+  EXPECT_EQ(4, parser.malformed());
+  EXPECT_EQ(0, parser.lines());
+}
+
+TEST(LineParser, GoodLineAfterGarbageIsRead) {
+  Parser parser;
+  std::vector<std::string> lines = readyLines(parser, std::string("\xFF\xFE\x80garbage\nSTATUS\n"));
+  ASSERT_EQ(1u, lines.size());
+  EXPECT_EQ("STATUS", lines[0]);
+}
+
+TEST(LineParser, TooLongWinsOverMalformed) {
+  Parser parser;
+  EXPECT_EQ(LINE_TOO_LONG, feedAll(parser, std::string(30, 'A') + "\x01\n"));
+}
+
+TEST(LineParser, FinishEndsLineWithoutNewline) {
+  Parser parser;
+  feedAll(parser, "TEST ");
+  EXPECT_EQ(LINE_READY, parser.finish());
+  EXPECT_STREQ("TEST", parser.line());
+  EXPECT_EQ(LINE_PENDING, parser.finish());  // Nothing left
+}
+
+TEST(LineParser, CountersSaturate) {
+  Parser parser;
+  for (long i = 0; i < 70000; i++) feedAll(parser, "A\n");
+  EXPECT_EQ(0xFFFF, parser.lines());
+}
+
+// Command Tests
+TEST(TriggerCommand, KnownCommands) {
+  EXPECT_EQ(CMD_STATUS, parseTriggerCommand("STATUS"));
+  EXPECT_EQ(CMD_RESET, parseTriggerCommand("RESET"));
+  EXPECT_EQ(CMD_TEST, parseTriggerCommand("TEST"));
+}
+
+TEST(TriggerCommand, CaseAndPrefixesDoNotMatch) {
+  EXPECT_EQ(CMD_UNKNOWN, parseTriggerCommand("status"));
+  EXPECT_EQ(CMD_UNKNOWN, parseTriggerCommand("TESTS"));
+  EXPECT_EQ(CMD_UNKNOWN, parseTriggerCommand("TES"));
+  EXPECT_EQ(CMD_UNKNOWN, parseTriggerCommand(""));
+}
+
+// Sketch Tests
+class MotionTriggerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::reset();
+    Serial.input.clear();
+    commandLine = Parser();
+    switchPressed = false;
+    lastTriggerTime = 0;
+    wakeLatencyCount = 0;
+    wakeLatencyMax = 0;
+    wakeLatencyTotal = 0;
+    idleAtLastStatus = IdleCounters{0, 0, 0};
+    lastCommandByteTime = 0;
+    setup();
+    PinEdge stale;  // The last test's switch state
+    while (switchEdges.poll(stale)) {}
+    Serial.output.clear();
+  }
+
+  // Run loop() passes covering `ms` of simulated time
+  void runFor(unsigned long ms) {
+    unsigned long start = millis();
+    while (millis() - start < ms) loop();
+  }
+
+  static size_t count(const std::string& text, const char* what) {
+    size_t n = 0;
+    for (size_t at = text.find(what); at != std::string::npos; at = text.find(what, at + 1)) n++;
+    return n;
+  }
+};
+
+TEST_F(MotionTriggerTest, CommandRunsOnce) {
+  sim::serialInput("TEST\r\n");
+  runFor(100);
+  EXPECT_EQ(1u, count(Serial.output, "TRIGGER\r\n"));
+  EXPECT_EQ(1u, count(Serial.output, "Manual test trigger"));
+}
+
+TEST_F(MotionTriggerTest, CommandSplitAcrossLoopPassesWaitsForNewline) {
+  sim::serialInput("STA");
+  loop();
+  sim::serialInput("TUS");
+  loop();
+  EXPECT_EQ("", Serial.output);
+  sim::serialInput("\n");
+  loop();
+  EXPECT_NE(std::string::npos, Serial.output.find("Switch: RELEASED"));
+}
+
+TEST_F(MotionTriggerTest, PartialCommandDoesNotBlockTheSwitch) {
+  sim::serialInput("TES");
+  sim::setPin(SWITCH_PIN, LOW);
+  lastTriggerTime = millis() - COOLDOWN_DELAY - 1;
+  runFor(200);
+  EXPECT_EQ(1u, count(Serial.output, "TRIGGER\r\n"));
+  EXPECT_EQ(0u, count(Serial.output, "Manual test trigger"));
+}
+
+TEST_F(MotionTriggerTest, CommandWithoutNewlineRunsAfterTimeout) {
+  sim::serialInput("RESET");
+  runFor(COMMAND_TIMEOUT_MS - 50);
+  EXPECT_EQ("", Serial.output);
+  runFor(100);
+  EXPECT_EQ("Cooldown reset\r\n", Serial.output);
+}
+
+TEST_F(MotionTriggerTest, BadInputIsReportedAndSkipped) {
+  sim::serialInput("THIS IS FAR TOO LONG FOR A COMMAND\n");
+  sim::serialInput("\x01\x02\n");
+  sim::serialInput("HELLO\n");
+  sim::serialInput("TEST\n");
+  runFor(100);
+  EXPECT_EQ(1u, count(Serial.output, "ERROR: Command too long"));
+  EXPECT_EQ(1u, count(Serial.output, "ERROR: Invalid characters in command"));
+  EXPECT_EQ(1u, count(Serial.output, "ERROR: Unknown command: HELLO"));
+  EXPECT_EQ(1u, count(Serial.output, "Manual test trigger"));
+}
+
+TEST_F(MotionTriggerTest, PressShorterThanALoopPassStillTriggers) {
+  lastTriggerTime = millis() - COOLDOWN_DELAY - 1;
+  sim::setPin(SWITCH_PIN, LOW);  // Both edges between two passes
+  sim::setPin(SWITCH_PIN, HIGH);
+  runFor(100);
+  EXPECT_EQ(1u, count(Serial.output, "TRIGGER\r\n"));
+  EXPECT_EQ(1u, count(Serial.output, "SWITCH_RELEASED"));
+}
+
+TEST_F(MotionTriggerTest, BounceInsideTheLockoutIsOnePress) {
+  lastTriggerTime = millis() - COOLDOWN_DELAY - 1;
+  for (int i = 0; i < 5; i++) {
+    sim::setPin(SWITCH_PIN, LOW);
+    loop();
+    sim::setPin(SWITCH_PIN, HIGH);
+    loop();
+  }
+  sim::setPin(SWITCH_PIN, LOW);
+  runFor(200);
+  EXPECT_EQ(1u, count(Serial.output, "TRIGGER\r\n"));
+  EXPECT_EQ(0u, count(Serial.output, "SWITCH_RELEASED"));
+}
+
+TEST_F(MotionTriggerTest, LoopSleepsUntilTheNextInterrupt) {
+  unsigned long start = micros();
+  loop();
+  EXPECT_EQ((unsigned long)IDLE_SLEEP_TICK_MICROS, micros() - start);  // One timer0 tick, not delay(10)
+}
+
+TEST_F(MotionTriggerTest, StatusReportsWakeLatencyAndDutyCycle) {
+  sim::serialInput("STATUS\n");
+  runFor(10);
+  EXPECT_NE(std::string::npos, Serial.output.find("Wake-to-TRIGGER: no presses yet"));
+  EXPECT_NE(std::string::npos, Serial.output.find("Active: 0.00% since last STATUS, 0.00% since boot"));
+
+  lastTriggerTime = millis() - COOLDOWN_DELAY - 1;
+  sim::setPin(SWITCH_PIN, LOW);
+  sim::advanceMicros(20000);  // The pass that handles it is slow
+  runFor(1980);
+  Serial.output.clear();
+  sim::serialInput("STATUS\n");
+  runFor(10);
+  EXPECT_NE(std::string::npos,
+            Serial.output.find("Wake-to-TRIGGER: 20000 us (min 20000, avg 20000, max 20000, 1 presses)"));
+  EXPECT_NE(std::string::npos, Serial.output.find("Active: 0.99% since last STATUS"));  // 20 of 2010 ms
+  EXPECT_NE(std::string::npos, Serial.output.find(" wakes/s"));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
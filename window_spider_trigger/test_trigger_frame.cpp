@@ -0,0 +1,356 @@
+/*
+ * Unit Tests for Binary Trigger Frames
+ *
+ * Checks the frame encoding against fixed vectors (CRC check value, COBS
+ * examples, a golden frame shared with test_trigger_protocol.js), that
+ * the reference decoder finds frames in mixed frame/text streams and
+ * rejects damaged ones, that the link statistics count lost, repeated and
+ * reordered frames, and that motion_trigger.ino sends the right frames in
+ * binary mode.
+ * Uses Google Test framework.
+ *
+ * Build and run:
+ *   pixi run test-trigger-frame
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "arduino/motion_trigger/motion_trigger.ino"
+#include "trigger_frame_decoder.h"
+
+// TRIGGER, sequence 0x0102, millis 0x00ABCDEF, value 0
+static const uint8_t GOLDEN_WIRE[] = {0x00, 0x07, 0x12, 0x02, 0x01, 0xEF, 0xCD,
+                                      0xAB, 0x01, 0x01, 0x03, 0xBC, 0x12, 0x00};
+
+static std::vector<uint8_t> wireFor(uint8_t type, uint16_t sequence, uint32_t millis, uint16_t value = 0) {
+  TriggerFrame frame = {type, sequence, millis, value};
+  uint8_t wire[TRIGGER_FRAME_WIRE_SIZE];
+  uint8_t length = encodeTriggerFrame(frame, wire);
+  return std::vector<uint8_t>(wire, wire + length);
+}
+
+// Encoding Tests
+TEST(TriggerFrame, CrcCheckValue) {
+  EXPECT_EQ(0x29B1, triggerFrameCrc(reinterpret_cast<const uint8_t*>("123456789"), 9));
+}
+
+TEST(TriggerFrame, CobsExamples) {
+  uint8_t out[8];
+  const uint8_t zero[] = {0x00};
+  ASSERT_EQ(2, cobsEncode(zero, 1, out));
+  EXPECT_EQ(0x01, out[0]);
+  EXPECT_EQ(0x01, out[1]);
+
+  const uint8_t mixed[] = {0x11, 0x22, 0x00, 0x33};
+  const uint8_t mixedCobs[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+  ASSERT_EQ(5, cobsEncode(mixed, 4, out));
+  EXPECT_EQ(0, memcmp(mixedCobs, out, 5));
+
+  uint8_t back[8];
+  ASSERT_EQ(4, cobsDecode(mixedCobs, 5, back));
+  EXPECT_EQ(0, memcmp(mixed, back, 4));
+}
+
+TEST(TriggerFrame, GoldenWireBytes) {
+  std::vector<uint8_t> wire = wireFor(FRAME_TRIGGER, 0x0102, 0x00ABCDEF);
+  ASSERT_EQ(sizeof(GOLDEN_WIRE), wire.size());
+  EXPECT_EQ(0, memcmp(GOLDEN_WIRE, wire.data(), wire.size()));
+}
+
+TEST(TriggerFrame, NoZerosBetweenDelimiters) {
+  // All-zero fields are the worst case for COBS
+  std::vector<uint8_t> wire = wireFor(FRAME_HEARTBEAT, 0, 0, 0);
+  ASSERT_EQ((size_t)TRIGGER_FRAME_WIRE_SIZE, wire.size());
+  EXPECT_EQ(0, wire.front());
+  EXPECT_EQ(0, wire.back());
+  for (size_t i = 1; i + 1 < wire.size(); i++) EXPECT_NE(0, wire[i]) << "byte " << i;
+}
+
+TEST(TriggerFrame, RoundTrip) {
+  std::vector<uint8_t> wire = wireFor(FRAME_COOLDOWN, 0xFFFF, 0xFFFFFFFF, 2750);
+  TriggerFrame frame;
+  ASSERT_TRUE(decodeTriggerFrame(&wire[1], TRIGGER_FRAME_COBS_SIZE, frame));
+  EXPECT_EQ(FRAME_COOLDOWN, frame.type);
+  EXPECT_EQ(0xFFFF, frame.sequence);
+  EXPECT_EQ(0xFFFFFFFFu, frame.millis);
+  EXPECT_EQ(2750, frame.value);
+}
+
+TEST(TriggerFrame, EverySingleBitFlipIsRejected) {
+  std::vector<uint8_t> wire = wireFor(FRAME_TRIGGER, 7, 123456);
+  TriggerFrame frame;
+  for (int byte = 1; byte <= TRIGGER_FRAME_COBS_SIZE; byte++) {
+    for (int bit = 0; bit < 8; bit++) {
+      std::vector<uint8_t> bad = wire;
+      bad[byte] ^= (uint8_t)(1 << bit);
+      EXPECT_FALSE(decodeTriggerFrame(&bad[1], TRIGGER_FRAME_COBS_SIZE, frame))
+          << "byte " << byte << " bit " << bit;
+    }
+  }
+}
+
+TEST(TriggerFrame, WrongLengthIsRejected) {
+  std::vector<uint8_t> wire = wireFor(FRAME_TRIGGER, 7, 123456);
+  TriggerFrame frame;
+  EXPECT_FALSE(decodeTriggerFrame(&wire[1], TRIGGER_FRAME_COBS_SIZE - 1, frame));
+}
+
+// Stream Decoder Tests
+class StreamTest : public ::testing::Test {
+ protected:
+  std::vector<TriggerFrame> feed(const std::vector<uint8_t>& bytes) {
+    std::vector<TriggerFrame> frames;
+    for (uint8_t b : bytes) {
+      if (decoder.feed(b) == STREAM_FRAME) frames.push_back(decoder.frame());
+    }
+    return frames;
+  }
+
+  std::vector<uint8_t> text(const char* s) { return std::vector<uint8_t>(s, s + strlen(s)); }
+
+  static void append(std::vector<uint8_t>& to, const std::vector<uint8_t>& bytes) {
+    to.insert(to.end(), bytes.begin(), bytes.end());
+  }
+
+  TriggerStreamDecoder decoder;
+};
+
+TEST_F(StreamTest, TextPassesThrough) {
+  EXPECT_TRUE(feed(text("STARTUP\r\nREADY\r\n")).empty());
+  EXPECT_EQ("STARTUP\r\nREADY\r\n", decoder.takeText());
+  EXPECT_EQ("", decoder.takeText());
+}
+
+TEST_F(StreamTest, FramesBetweenTextLines) {
+  std::vector<uint8_t> stream = text("Cooldown reset\r\n");
+  append(stream, wireFor(FRAME_TRIGGER, 1, 1000));
+  append(stream, text("Manual test trigger\r\n"));
+  append(stream, wireFor(FRAME_HEARTBEAT, 2, 2000));
+  append(stream, wireFor(FRAME_PONG, 3, 2001));
+  std::vector<TriggerFrame> frames = feed(stream);
+  ASSERT_EQ(3u, frames.size());
+  EXPECT_EQ(FRAME_TRIGGER, frames[0].type);
+  EXPECT_EQ(FRAME_PONG, frames[2].type);
+  EXPECT_EQ("Cooldown reset\r\nManual test trigger\r\n", decoder.takeText());
+  EXPECT_EQ(0u, decoder.badFrames);
+}
+
+TEST_F(StreamTest, FrameIsReportedOnItsClosingDelimiter) {
+  std::vector<uint8_t> wire = wireFor(FRAME_TRIGGER, 1, 1000);
+  for (size_t i = 0; i + 1 < wire.size(); i++) EXPECT_EQ(STREAM_NONE, decoder.feed(wire[i]));
+  EXPECT_EQ(STREAM_FRAME, decoder.feed(wire.back()));
+}
+
+TEST_F(StreamTest, CorruptFrameIsCountedNotTreatedAsText) {
+  std::vector<uint8_t> wire = wireFor(FRAME_TRIGGER, 1, 1000);
+  wire[5] ^= 0x10;
+  EXPECT_TRUE(feed(wire).empty());
+  EXPECT_EQ(1u, decoder.badFrames);
+  EXPECT_EQ("", decoder.takeText());
+}
+
+TEST_F(StreamTest, TruncatedFrameDoesNotHideTheNextOne) {
+  std::vector<uint8_t> cut = wireFor(FRAME_TRIGGER, 1, 1000);
+  cut.erase(cut.begin() + 6, cut.end() - 1);  // Bytes lost mid-frame
+  std::vector<uint8_t> stream = cut;
+  append(stream, wireFor(FRAME_TRIGGER, 2, 2000));
+  std::vector<TriggerFrame> frames = feed(stream);
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(2, frames[0].sequence);
+  EXPECT_EQ(1u, decoder.badFrames);
+}
+
+TEST_F(StreamTest, StreamJoinedMidFrameRecovers) {
+  std::vector<uint8_t> wire = wireFor(FRAME_TRIGGER, 1, 1000);
+  std::vector<uint8_t> stream(wire.begin() + 4, wire.end());  // Port opened late
+  append(stream, wireFor(FRAME_HEARTBEAT, 2, 2000));
+  std::vector<TriggerFrame> frames = feed(stream);
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(FRAME_HEARTBEAT, frames[0].type);
+}
+
+// Link Statistics Tests
+static TriggerFrame frameOf(uint8_t type, uint16_t sequence, uint32_t millis) {
+  return TriggerFrame{type, sequence, millis, 0};
+}
+
+TEST(TriggerLinkStats, GapsAreLost) {
+  TriggerLinkStats stats;
+  stats.frame(frameOf(FRAME_HEARTBEAT, 10, 0), 0);
+  stats.frame(frameOf(FRAME_HEARTBEAT, 11, 1000), 1000000);
+  stats.frame(frameOf(FRAME_HEARTBEAT, 14, 4000), 4000000);
+  EXPECT_EQ(2u, stats.lost);
+  EXPECT_EQ(3u, stats.frames);
+}
+
+TEST(TriggerLinkStats, SequenceWrapIsNotLoss) {
+  TriggerLinkStats stats;
+  stats.frame(frameOf(FRAME_HEARTBEAT, 0xFFFE, 0), 0);
+  stats.frame(frameOf(FRAME_HEARTBEAT, 0xFFFF, 1000), 1000000);
+  stats.frame(frameOf(FRAME_HEARTBEAT, 0, 2000), 2000000);
+  EXPECT_EQ(0u, stats.lost);
+}
+
+TEST(TriggerLinkStats, RepeatsAndOldFramesAreCounted) {
+  TriggerLinkStats stats;
+  stats.frame(frameOf(FRAME_TRIGGER, 5, 0), 0);
+  stats.frame(frameOf(FRAME_TRIGGER, 5, 0), 10);
+  stats.frame(frameOf(FRAME_HEARTBEAT, 6, 1000), 1000000);
+  stats.frame(frameOf(FRAME_HEARTBEAT, 3, 900), 1000100);
+  EXPECT_EQ(1u, stats.duplicates);
+  EXPECT_EQ(1u, stats.outOfOrder);
+  EXPECT_EQ(0u, stats.lost);
+}
+
+TEST(TriggerLinkStats, ReadyAfterResetIsARestartNotLoss) {
+  TriggerLinkStats stats;
+  stats.frame(frameOf(FRAME_HEARTBEAT, 500, 500000), 0);
+  stats.frame(frameOf(FRAME_READY, 0, 3000), 1000000);
+  stats.frame(frameOf(FRAME_HEARTBEAT, 1, 4000), 2000000);
+  EXPECT_EQ(1u, stats.restarts);
+  EXPECT_EQ(0u, stats.lost);
+  EXPECT_EQ(0u, stats.outOfOrder);
+}
+
+TEST(TriggerLinkStats, PingRoundTrip) {
+  TriggerLinkStats stats;
+  stats.pingSent(1000000);
+  stats.frame(frameOf(FRAME_PONG, 0, 50), 1012500);
+  ASSERT_EQ(1u, stats.roundTrips().size());
+  EXPECT_DOUBLE_EQ(12.5, stats.roundTrips()[0]);
+  stats.pingSent(2000000);
+  stats.pingSent(3000000);  // First never answered
+  EXPECT_EQ(1u, stats.pingsLost);
+}
+
+TEST(TriggerLinkStats, LatenessIsAboveFastestFrame) {
+  TriggerLinkStats stats;
+  // Device clock starts 5 s behind the host; heartbeats take 1, 3, 1 ms
+  stats.frame(frameOf(FRAME_HEARTBEAT, 0, 1000), 6001000);
+  stats.frame(frameOf(FRAME_HEARTBEAT, 1, 2000), 7003000);
+  stats.frame(frameOf(FRAME_HEARTBEAT, 2, 3000), 8001000);
+  // Press stamped when the switch closed, 60 ms before the frame was sent
+  stats.frame(frameOf(FRAME_TRIGGER, 3, 3500), 8562000);
+  std::vector<double> heartbeats = stats.lateness(FRAME_HEARTBEAT);
+  ASSERT_EQ(3u, heartbeats.size());
+  EXPECT_NEAR(0.0, heartbeats[0], 1e-9);
+  EXPECT_NEAR(2.0, heartbeats[1], 1e-9);
+  std::vector<double> presses = stats.lateness(FRAME_TRIGGER);
+  ASSERT_EQ(1u, presses.size());
+  EXPECT_NEAR(61.0, presses[0], 1e-9);
+}
+
+TEST(TriggerLinkStats, Percentiles) {
+  std::vector<double> values;
+  for (int i = 1; i <= 100; i++) values.push_back(i);
+  EXPECT_EQ(1, TriggerLinkStats::percentile(values, 0));
+  EXPECT_EQ(50, TriggerLinkStats::percentile(values, 50));
+  EXPECT_EQ(99, TriggerLinkStats::percentile(values, 99));
+  EXPECT_EQ(100, TriggerLinkStats::percentile(values, 100));
+  EXPECT_EQ(0, TriggerLinkStats::percentile({}, 50));
+}
+
+// Sketch Tests
+class BinaryModeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sim::reset();
+    Serial.input.clear();
+    commandLine = LineParser<COMMAND_BUFFER_SIZE>();
+    switchPressed = false;
+    lastTriggerTime = 0;
+    wakeLatencyCount = 0;
+    wakeLatencyMax = 0;
+    wakeLatencyTotal = 0;
+    idleAtLastStatus = IdleCounters{0, 0, 0};
+    binaryFrames = false;
+    frameSequence = 0;
+    setup();
+    PinEdge stale;  // The last test's switch state
+    while (switchEdges.poll(stale)) {}
+    Serial.output.clear();
+  }
+
+  void runFor(unsigned long ms) {
+    unsigned long start = millis();
+    while (millis() - start < ms) loop();
+  }
+
+  // Decode everything the sketch sent since the last call
+  std::vector<TriggerFrame> sent() {
+    std::vector<TriggerFrame> frames;
+    for (char c : Serial.output) {
+      if (decoder.feed((uint8_t)c) == STREAM_FRAME) frames.push_back(decoder.frame());
+    }
+    Serial.output.clear();
+    return frames;
+  }
+
+  TriggerStreamDecoder decoder;
+};
+
+TEST_F(BinaryModeTest, TextUntilBinaryCommand) {
+  sim::serialInput("TEST\n");
+  runFor(20);
+  EXPECT_TRUE(sent().empty());
+  EXPECT_NE(std::string::npos, decoder.takeText().find("TRIGGER\r\n"));
+
+  sim::serialInput("BINARY\n");
+  runFor(20);
+  std::vector<TriggerFrame> frames = sent();
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(FRAME_READY, frames[0].type);
+  EXPECT_EQ(TRIGGER_FRAME_VERSION, frames[0].value);
+}
+
+TEST_F(BinaryModeTest, PressIsOneFrameStampedAtTheSwitch) {
+  sim::serialInput("BINARY\n");
+  runFor(20);
+  sent();
+  lastTriggerTime = millis() - COOLDOWN_DELAY - 1;
+  unsigned long pressedAt = millis();
+  sim::setPin(SWITCH_PIN, LOW);
+  runFor(200);
+  std::vector<TriggerFrame> frames = sent();
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(FRAME_TRIGGER, frames[0].type);
+  EXPECT_EQ(0, frames[0].value);
+  EXPECT_EQ(pressedAt, frames[0].millis);  // The ISR's timestamp, not the loop pass's
+  EXPECT_EQ(1, frames[0].sequence);
+  EXPECT_EQ("", decoder.takeText());  // No text on the trigger path
+}
+
+TEST_F(BinaryModeTest, HeartbeatsKeepTheSequenceGoing) {
+  sim::serialInput("BINARY\n");
+  runFor(5500);
+  std::vector<TriggerFrame> frames = sent();
+  ASSERT_EQ(6u, frames.size());  // READY + 5 heartbeats
+  for (size_t i = 1; i < frames.size(); i++) {
+    EXPECT_EQ(FRAME_HEARTBEAT, frames[i].type);
+    EXPECT_EQ(i, frames[i].sequence);
+  }
+}
+
+TEST_F(BinaryModeTest, PingIsAnsweredWithPong) {
+  sim::serialInput("BINARY\nPING\n");
+  runFor(20);
+  std::vector<TriggerFrame> frames = sent();
+  ASSERT_EQ(2u, frames.size());
+  EXPECT_EQ(FRAME_PONG, frames[1].type);
+}
+
+TEST_F(BinaryModeTest, TextCommandSwitchesBack) {
+  sim::serialInput("BINARY\nTEXT\nTEST\n");
+  runFor(20);
+  ASSERT_EQ(1u, sent().size());  // Just READY
+  std::string text = decoder.takeText();
+  EXPECT_NE(std::string::npos, text.find("Text mode\r\n"));
+  EXPECT_NE(std::string::npos, text.find("TRIGGER\r\n"));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
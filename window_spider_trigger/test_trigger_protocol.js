@@ -0,0 +1,109 @@
+#!/usr/bin/env node
+/**
+ * Unit Tests for the Trigger Protocol Decoder (server.js side)
+ *
+ * Decodes the same golden frame as test_trigger_frame.cpp, so the sketch's
+ * encoder, the C++ reference decoder and this one agree byte for byte,
+ * then checks mixed frame/text streams, damaged frames and sequence
+ * tracking.
+ *
+ * Run with: pixi run test-trigger-protocol
+ */
+
+const {
+  FrameType, crc16, cobsDecode, decodeFrame, TriggerStreamParser, SequenceTracker
+} = require('./trigger_protocol.js');
+
+// TRIGGER, sequence 0x0102, millis 0x00ABCDEF, value 0 (from trigger_frame.h)
+const GOLDEN_WIRE = [0x00, 0x07, 0x12, 0x02, 0x01, 0xEF, 0xCD,
+                     0xAB, 0x01, 0x01, 0x03, 0xBC, 0x12, 0x00];
+
+let testsPassed = 0;
+let testsFailed = 0;
+
+function assertEqual(name, expected, actual) {
+  const e = JSON.stringify(expected);
+  const a = JSON.stringify(actual);
+  if (e === a) {
+    console.log(`✓ ${name}`);
+    testsPassed++;
+  } else {
+    console.log(`✗ ${name}: expected ${e}, got ${a}`);
+    testsFailed++;
+  }
+}
+
+function collect(bytes) {
+  const seen = { frames: [], lines: [], bad: 0 };
+  const parser = new TriggerStreamParser({
+    onFrame: (frame) => seen.frames.push(frame),
+    onLine: (line) => seen.lines.push(line),
+    onBadFrame: () => seen.bad++
+  });
+  parser.push(Buffer.from(bytes));
+  return seen;
+}
+
+function text(s) {
+  return Array.from(Buffer.from(s, 'ascii'));
+}
+
+// Encoding
+assertEqual('CRC-16/CCITT-FALSE check value', 0x29B1, crc16(text('123456789')));
+assertEqual('COBS decode', [0x11, 0x22, 0x00, 0x33], cobsDecode([0x03, 0x11, 0x22, 0x02, 0x33]));
+assertEqual('COBS rejects a zero inside', null, cobsDecode([0x03, 0x11, 0x00, 0x02, 0x33]));
+assertEqual('Golden frame decodes',
+  { type: FrameType.TRIGGER, sequence: 0x0102, millis: 0x00ABCDEF, value: 0 },
+  decodeFrame(GOLDEN_WIRE.slice(1, -1)));
+
+const flipped = GOLDEN_WIRE.slice(1, -1);
+flipped[4] ^= 0x01;
+assertEqual('Bit flip is rejected', null, decodeFrame(flipped));
+assertEqual('Short frame is rejected', null, decodeFrame(GOLDEN_WIRE.slice(1, -2)));
+
+// Streams
+let seen = collect(text('STARTUP\r\nREADY\r\n'));
+assertEqual('Text lines pass through', ['STARTUP', 'READY'], seen.lines);
+
+seen = collect([...text('Cooldown reset\r\n'), ...GOLDEN_WIRE, ...text('Manual test trigger\r\n')]);
+assertEqual('Frame between text lines', [1, ['Cooldown reset', 'Manual test trigger']],
+  [seen.frames.length, seen.lines]);
+
+seen = collect([...GOLDEN_WIRE, ...GOLDEN_WIRE]);
+assertEqual('Back-to-back frames', 2, seen.frames.length);
+
+const corrupt = GOLDEN_WIRE.slice();
+corrupt[6] ^= 0x10;
+seen = collect([...corrupt, ...GOLDEN_WIRE]);
+assertEqual('Corrupt frame counted, next one decoded', [1, 1, []],
+  [seen.bad, seen.frames.length, seen.lines]);
+
+seen = collect([...GOLDEN_WIRE.slice(5), ...GOLDEN_WIRE]);
+assertEqual('Joined mid-frame, recovers', 1, seen.frames.length);
+
+let frameAt = -1;
+const parser = new TriggerStreamParser({ onFrame: () => { frameAt = i; } });
+let i;
+for (i = 0; i < GOLDEN_WIRE.length; i++) parser.feed(GOLDEN_WIRE[i]);
+assertEqual('Frame reported on its closing delimiter', GOLDEN_WIRE.length - 1, frameAt);
+
+// Sequence tracking
+const tracker = new SequenceTracker();
+const heartbeats = (sequences) => sequences.map((sequence) => ({ type: FrameType.HEARTBEAT, sequence }));
+const fresh = heartbeats([10, 11, 11, 14, 12, 15]).map((frame) => tracker.check(frame));
+assertEqual('Repeats and old frames are not acted on', [true, true, false, true, false, true], fresh);
+assertEqual('Lost / duplicates / out of order', [2, 1, 1],
+  [tracker.lost, tracker.duplicates, tracker.outOfOrder]);
+
+const wrap = new SequenceTracker();
+heartbeats([0xFFFE, 0xFFFF, 0, 1]).forEach((frame) => wrap.check(frame));
+assertEqual('Sequence wrap is not loss', 0, wrap.lost);
+
+const restart = new SequenceTracker();
+restart.check({ type: FrameType.HEARTBEAT, sequence: 500 });
+restart.check({ type: FrameType.READY, sequence: 0 });
+assertEqual('READY after a reset is not loss', [0, true],
+  [restart.lost, restart.check({ type: FrameType.HEARTBEAT, sequence: 1 })]);
+
+console.log(`\n${testsPassed} passed, ${testsFailed} failed`);
+process.exit(testsFailed ? 1 : 0);
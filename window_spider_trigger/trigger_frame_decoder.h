@@ -0,0 +1,243 @@
+/*
+ * Trigger Frame Decoder - Reference Decoder and Link Statistics (Host)
+ *
+ * Host side of arduino/motion_trigger/trigger_frame.h. TriggerStreamDecoder
+ * splits the serial byte stream into frames and text: a frame is reported
+ * the moment its closing 0x00 arrives, and everything else passes through
+ * as text.
+ *
+ *   TriggerStreamDecoder decoder;
+ *   for (each byte) {
+ *     if (decoder.feed(byte) == STREAM_FRAME) stats.frame(decoder.frame(), hostMicros);
+ *   }
+ *   std::string text = decoder.takeText();
+ *
+ * TriggerLinkStats keeps what's needed to judge the link: lost, repeated
+ * and out-of-order frames from the sequence numbers, PING/PONG round
+ * trips, and how late each frame arrived. The Beetle and the host have no
+ * shared clock, so lateness is measured against the fastest frame within
+ * +-30 s (the link's best case, which also tracks crystal drift); a press
+ * frame carries the time the switch closed (the pin-change ISR's stamp), so
+ * its lateness includes the sketch's own wake-up and handling.
+ *
+ * Used by test_trigger_frame.cpp, sim_trigger_link.cpp and trigger_stats.cpp
+ * (live from the Beetle); server.js has the same decoder in JavaScript.
+ */
+
+#ifndef TRIGGER_FRAME_DECODER_H
+#define TRIGGER_FRAME_DECODER_H
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "arduino/motion_trigger/trigger_frame.h"
+
+enum StreamResult {
+  STREAM_NONE,       // Text, or part of a frame
+  STREAM_FRAME,      // frame() is a new, valid frame
+  STREAM_BAD_FRAME   // A frame-shaped segment failed its length/COBS/CRC check
+};
+
+inline const char* triggerFrameTypeName(uint8_t type) {
+  switch (type) {
+    case FRAME_READY: return "READY";
+    case FRAME_TRIGGER: return "TRIGGER";
+    case FRAME_RELEASED: return "RELEASED";
+    case FRAME_COOLDOWN: return "COOLDOWN";
+    case FRAME_HEARTBEAT: return "HEARTBEAT";
+    case FRAME_PONG: return "PONG";
+    default: return "UNKNOWN";
+  }
+}
+
+class TriggerStreamDecoder {
+ public:
+  uint64_t frames = 0;
+  uint64_t badFrames = 0;
+
+  StreamResult feed(uint8_t byte) {
+    if (byte == 0) {
+      StreamResult result = STREAM_NONE;
+      if (have_ > 0) {
+        if (decodeTriggerFrame(segment_, have_, frame_)) {
+          frames++;
+          result = STREAM_FRAME;
+        } else {
+          badFrames++;
+          result = STREAM_BAD_FRAME;
+        }
+      }
+      have_ = 0;
+      afterDelimiter_ = true;
+      return result;
+    }
+    if (afterDelimiter_ && (have_ > 0 || byte < 0x20)) {
+      if (have_ < TRIGGER_FRAME_COBS_SIZE) {
+        segment_[have_++] = byte;
+        return STREAM_NONE;
+      }
+      text_.append(reinterpret_cast<const char*>(segment_), have_);  // Too long: text after all
+      have_ = 0;
+    }
+    afterDelimiter_ = false;
+    text_.push_back((char)byte);
+    return STREAM_NONE;
+  }
+
+  const TriggerFrame& frame() const { return frame_; }
+
+  // Text received since the last call
+  std::string takeText() {
+    std::string text;
+    text.swap(text_);
+    return text;
+  }
+
+ private:
+  uint8_t segment_[TRIGGER_FRAME_COBS_SIZE];
+  uint8_t have_ = 0;
+  bool afterDelimiter_ = false;
+  TriggerFrame frame_ = {};
+  std::string text_;
+};
+
+class TriggerLinkStats {
+ public:
+  uint64_t frames = 0;
+  uint64_t lost = 0;        // Sequence numbers skipped
+  uint64_t duplicates = 0;  // Same sequence number again
+  uint64_t outOfOrder = 0;  // Older than one already seen
+  uint64_t restarts = 0;    // READY out of sequence (device reset)
+  uint64_t pingsLost = 0;
+  uint64_t byType[16] = {};
+
+  // Sequence accounting and arrival time for one decoded frame
+  void frame(const TriggerFrame& frame, uint64_t hostMicros) {
+    frames++;
+    byType[frame.type & 0x0F]++;
+    if (!haveSequence_) {
+      haveSequence_ = true;
+    } else {
+      uint16_t ahead = (uint16_t)(frame.sequence - nextSequence_);
+      if (ahead == 0xFFFF) {
+        duplicates++;
+        return;
+      }
+      if (ahead >= 0x8000) {
+        if (frame.type == FRAME_READY) {
+          restarts++;
+        } else {
+          outOfOrder++;
+          return;
+        }
+      } else if (frame.type == FRAME_READY && ahead > 0) {
+        restarts++;  // Reset and came back with a sequence that looks ahead
+      } else {
+        lost += ahead;
+      }
+    }
+    nextSequence_ = frame.sequence + 1;
+    if (frame.type == FRAME_READY) samples_.clear();  // New device clock
+    samples_.push_back(Sample{hostMicros, frame.millis, frame.type});
+    if (frame.type == FRAME_PONG && pingOutstanding_) {
+      roundTrips_.push_back((hostMicros - pingSentMicros_) / 1000.0);
+      pingOutstanding_ = false;
+    }
+  }
+
+  // A PING went out (an unanswered earlier one counts as lost)
+  void pingSent(uint64_t hostMicros) {
+    if (pingOutstanding_) pingsLost++;
+    pingOutstanding_ = true;
+    pingSentMicros_ = hostMicros;
+  }
+  bool pingOutstanding() const { return pingOutstanding_; }
+  uint64_t pingSentMicros() const { return pingSentMicros_; }
+
+  // Lateness (ms) above the link's best case of every frame of `type`
+  // (0 = every frame stamped when it was sent)
+  std::vector<double> lateness(uint8_t type = 0) const {
+    std::vector<double> out;
+    size_t lo = 0;
+    size_t hi = 0;
+    for (size_t i = 0; i < samples_.size(); i++) {
+      // Fastest frame within +-30 s of device time (samples are in arrival order)
+      while (lo < i && samples_[lo].deviceMillis + WINDOW_MS < samples_[i].deviceMillis) lo++;
+      while (hi + 1 < samples_.size() && samples_[hi + 1].deviceMillis <= samples_[i].deviceMillis + WINDOW_MS) hi++;
+      if (hi < i) hi = i;
+      double best = offset(samples_[i]);
+      for (size_t k = lo; k <= hi; k++) {
+        if (!measuresLink(samples_[k].type)) continue;
+        best = std::min(best, offset(samples_[k]));
+      }
+      bool wanted = type == 0 ? measuresLink(samples_[i].type) : samples_[i].type == type;
+      if (wanted) out.push_back(offset(samples_[i]) - best);
+    }
+    return out;
+  }
+
+  const std::vector<double>& roundTrips() const { return roundTrips_; }
+
+  // Nearest-rank percentile (0-100) of `values`; 0 if there are none
+  static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    size_t rank = (size_t)(p / 100.0 * values.size() + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > values.size()) rank = values.size();
+    return values[rank - 1];
+  }
+
+  void printReport(FILE* out, uint64_t badFrames) const {
+    uint64_t expected = frames + lost;
+    fprintf(out, "Frames: %llu received, %llu lost (%.3f%%), %llu duplicated, %llu out of order, "
+                 "%llu bad CRC/length, %llu device restarts\n",
+            (unsigned long long)frames, (unsigned long long)lost,
+            expected ? 100.0 * lost / expected : 0.0, (unsigned long long)duplicates,
+            (unsigned long long)outOfOrder, (unsigned long long)badFrames,
+            (unsigned long long)restarts);
+    fprintf(out, "  %-28s %6s %8s %8s %8s %8s %8s\n", "ms", "n", "min", "p50", "p90", "p99", "max");
+    printRow(out, "PING->PONG round trip", roundTrips_);
+    printRow(out, "press -> host", lateness(FRAME_TRIGGER));
+    printRow(out, "heartbeat -> host", lateness(FRAME_HEARTBEAT));
+    printRow(out, "any sent-time frame -> host", lateness());
+    if (pingsLost) fprintf(out, "  %llu PINGs unanswered\n", (unsigned long long)pingsLost);
+    fprintf(out, "  (frame -> host is lateness above the fastest frame within +-%u s)\n",
+            (unsigned)(WINDOW_MS / 1000));
+  }
+
+ private:
+  static const uint32_t WINDOW_MS = 30000;
+
+  struct Sample {
+    uint64_t hostMicros;
+    uint32_t deviceMillis;
+    uint8_t type;
+  };
+
+  // Host arrival minus device time, ms (a constant plus this frame's delay)
+  static double offset(const Sample& s) { return s.hostMicros / 1000.0 - s.deviceMillis; }
+
+  // Frames stamped when they were sent (press frames are stamped earlier)
+  static bool measuresLink(uint8_t type) { return type != FRAME_TRIGGER && type != FRAME_RELEASED && type != FRAME_COOLDOWN; }
+
+  static void printRow(FILE* out, const char* label, const std::vector<double>& values) {
+    if (values.empty()) {
+      fprintf(out, "  %-28s %6u %8s\n", label, 0u, "-");
+      return;
+    }
+    fprintf(out, "  %-28s %6zu %8.2f %8.2f %8.2f %8.2f %8.2f\n", label, values.size(),
+            percentile(values, 0), percentile(values, 50), percentile(values, 90),
+            percentile(values, 99), percentile(values, 100));
+  }
+
+  bool haveSequence_ = false;
+  uint16_t nextSequence_ = 0;
+  bool pingOutstanding_ = false;
+  uint64_t pingSentMicros_ = 0;
+  std::vector<Sample> samples_;
+  std::vector<double> roundTrips_;
+};
+
+#endif  // TRIGGER_FRAME_DECODER_H
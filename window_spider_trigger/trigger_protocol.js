@@ -0,0 +1,145 @@
+/**
+ * Trigger Protocol - Binary Frame Decoder for server.js
+ *
+ * JavaScript twin of trigger_frame_decoder.h (the C++ reference decoder).
+ * The frame layout is in arduino/motion_trigger/trigger_frame.h: 11 bytes
+ * (type, sequence, millis, value, CRC-16), COBS-encoded between two 0x00
+ * bytes. Text lines still arrive between frames; they never start with a
+ * byte below 0x20, which is how they are told apart.
+ *
+ *   const parser = new TriggerStreamParser({
+ *     onFrame: (frame) => { ... },   // the moment its closing 0x00 arrives
+ *     onLine: (line) => { ... },     // text, without the line ending
+ *     onBadFrame: () => { ... }
+ *   });
+ *   port.on('data', (chunk) => parser.push(chunk));
+ */
+
+const FRAME_VERSION = 1;
+const PAYLOAD_SIZE = 11;
+const COBS_SIZE = PAYLOAD_SIZE + 1;
+
+const FrameType = {
+  READY: 1,
+  TRIGGER: 2,
+  RELEASED: 3,
+  COOLDOWN: 4,
+  HEARTBEAT: 5,
+  PONG: 6
+};
+
+// CRC-16/CCITT-FALSE, as triggerFrameCrc()
+function crc16(bytes) {
+  let crc = 0xFFFF;
+  for (const byte of bytes) {
+    crc ^= byte << 8;
+    for (let bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) & 0xFFFF : (crc << 1) & 0xFFFF;
+    }
+  }
+  return crc;
+}
+
+// COBS bytes to the original bytes, or null if they aren't valid COBS
+function cobsDecode(bytes) {
+  const out = [];
+  let i = 0;
+  while (i < bytes.length) {
+    const code = bytes[i++];
+    if (code === 0 || i + code - 1 > bytes.length) return null;
+    for (let k = 1; k < code; k++) {
+      if (bytes[i] === 0) return null;
+      out.push(bytes[i++]);
+    }
+    if (code < 0xFF && i < bytes.length) out.push(0);
+  }
+  return out;
+}
+
+// COBS bytes between two delimiters to a frame, or null (length/COBS/CRC/version)
+function decodeFrame(cobs) {
+  if (cobs.length !== COBS_SIZE) return null;
+  const p = cobsDecode(cobs);
+  if (!p || p.length !== PAYLOAD_SIZE) return null;
+  if ((p[9] | (p[10] << 8)) !== crc16(p.slice(0, 9))) return null;
+  if (p[0] >> 4 !== FRAME_VERSION) return null;
+  return {
+    type: p[0] & 0x0F,
+    sequence: p[1] | (p[2] << 8),
+    millis: (p[3] | (p[4] << 8) | (p[5] << 16) | (p[6] << 24)) >>> 0,
+    value: p[7] | (p[8] << 8)
+  };
+}
+
+class TriggerStreamParser {
+  constructor({ onFrame = () => {}, onLine = () => {}, onBadFrame = () => {} } = {}) {
+    this.onFrame = onFrame;
+    this.onLine = onLine;
+    this.onBadFrame = onBadFrame;
+    this.segment = [];
+    this.afterDelimiter = false;
+    this.text = '';
+  }
+
+  push(chunk) {
+    for (const byte of chunk) this.feed(byte);
+  }
+
+  feed(byte) {
+    if (byte === 0) {
+      if (this.segment.length > 0) {
+        const frame = decodeFrame(this.segment);
+        if (frame) this.onFrame(frame);
+        else this.onBadFrame();
+      }
+      this.segment = [];
+      this.afterDelimiter = true;
+      return;
+    }
+    if (this.afterDelimiter && (this.segment.length > 0 || byte < 0x20)) {
+      if (this.segment.length < COBS_SIZE) {
+        this.segment.push(byte);
+        return;
+      }
+      for (const b of this.segment) this.text += String.fromCharCode(b);  // Too long: text after all
+      this.segment = [];
+    }
+    this.afterDelimiter = false;
+    if (byte === 0x0A) {
+      this.onLine(this.text.replace(/\r$/, ''));
+      this.text = '';
+    } else {
+      this.text += String.fromCharCode(byte);
+    }
+  }
+}
+
+// Lost and repeated frames from the sequence numbers (TriggerLinkStats::frame())
+class SequenceTracker {
+  constructor() {
+    this.next = null;
+    this.lost = 0;
+    this.duplicates = 0;
+    this.outOfOrder = 0;
+  }
+
+  // false if the frame was already seen (don't act on it twice)
+  check(frame) {
+    if (this.next !== null) {
+      const ahead = (frame.sequence - this.next) & 0xFFFF;
+      if (ahead === 0xFFFF) {
+        this.duplicates++;
+        return false;
+      }
+      if (ahead >= 0x8000 && frame.type !== FrameType.READY) {
+        this.outOfOrder++;
+        return false;
+      }
+      if (ahead < 0x8000 && frame.type !== FrameType.READY) this.lost += ahead;
+    }
+    this.next = (frame.sequence + 1) & 0xFFFF;
+    return true;
+  }
+}
+
+module.exports = { FrameType, crc16, cobsDecode, decodeFrame, TriggerStreamParser, SequenceTracker };
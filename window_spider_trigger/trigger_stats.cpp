@@ -0,0 +1,117 @@
+/*
+ * Trigger Link Statistics - Live from the Beetle
+ *
+ * Opens the Beetle's serial port, switches motion_trigger.ino to binary
+ * frames (BINARY), pings it once a second and prints every frame and text
+ * line as it arrives. On Ctrl-C (or after --seconds) it switches the
+ * sketch back to text and prints lost/duplicated/corrupt frame counts and
+ * latency percentiles: PING->PONG round trip, and how late press and
+ * heartbeat frames arrived against the link's best case.
+ *
+ * Stop server.js first; only one program can have the port open.
+ *
+ * Build and run:
+ *   pixi run trigger-stats
+ *   ./trigger_stats /dev/ttyACM0 --seconds 600 --quiet
+ */
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include "trigger_frame_decoder.h"
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static uint64_t hostMicros() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static bool openRaw(const char* path, int& fd) {
+  fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0) return false;
+  termios tty;
+  if (tcgetattr(fd, &tty) == 0) {
+    cfmakeraw(&tty);
+    cfsetspeed(&tty, B9600);  // Ignored by USB CDC, but keep it the sketch's rate
+    tcsetattr(fd, TCSANOW, &tty);
+  }
+  return true;
+}
+
+static void sendCommand(int fd, const char* command) {
+  if (write(fd, command, strlen(command)) < 0) perror("write");
+}
+
+int main(int argc, char** argv) {
+  const char* path = "/dev/ttyACM0";
+  double seconds = 0;  // 0 = until Ctrl-C
+  bool quiet = false;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--quiet")) quiet = true;
+    else if (argv[i][0] != '-') path = argv[i];
+    else {
+      fprintf(stderr, "usage: %s [port] [--seconds N] [--quiet]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  int fd;
+  if (!openRaw(path, fd)) {
+    perror(path);
+    return 1;
+  }
+  signal(SIGINT, [](int) { stopRequested = 1; });
+
+  TriggerStreamDecoder decoder;
+  TriggerLinkStats stats;
+  uint64_t start = hostMicros();
+  uint64_t nextPing = start + 1000000;
+  sendCommand(fd, "BINARY\n");
+
+  while (!stopRequested && (seconds <= 0 || hostMicros() - start < seconds * 1e6)) {
+    pollfd waitFor = {fd, POLLIN, 0};
+    int ready = poll(&waitFor, 1, 50);
+    uint64_t now = hostMicros();
+    if (ready > 0) {
+      uint8_t buf[256];
+      ssize_t n = read(fd, buf, sizeof(buf));
+      if (n <= 0) break;  // Unplugged
+      for (ssize_t i = 0; i < n; i++) {
+        StreamResult result = decoder.feed(buf[i]);
+        if (result != STREAM_NONE && !quiet) fputs(decoder.takeText().c_str(), stdout);  // In order
+        if (result == STREAM_FRAME) {
+          const TriggerFrame& frame = decoder.frame();
+          stats.frame(frame, now);
+          if (!quiet && frame.type != FRAME_HEARTBEAT && frame.type != FRAME_PONG) {
+            printf("[%10.3f] #%-5u %-9s device %lu ms, value %u\n", (now - start) / 1e6,
+                   frame.sequence, triggerFrameTypeName(frame.type), (unsigned long)frame.millis,
+                   frame.value);
+          }
+        } else if (result == STREAM_BAD_FRAME && !quiet) {
+          printf("[%10.3f] bad frame\n", (now - start) / 1e6);
+        }
+      }
+      std::string text = decoder.takeText();
+      if (!quiet && !text.empty()) fputs(text.c_str(), stdout);
+      fflush(stdout);
+    }
+    if (now >= nextPing) {
+      stats.pingSent(hostMicros());
+      sendCommand(fd, "PING\n");
+      nextPing += 1000000;
+    }
+  }
+
+  sendCommand(fd, "TEXT\n");
+  close(fd);
+  printf("\n%s, %.0f s\n", path, (hostMicros() - start) / 1e6);
+  stats.printReport(stdout, decoder.badFrames);
+  return 0;
+}